@@ -0,0 +1,608 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*-----------------------------------------------------------
+* Implementation of functions defined in portable.h for the POSIX/Linux
+* simulator port.
+*
+* Each task is a pthread.  A thread only runs while it owns the (single)
+* simulated CPU; every other task thread is parked on its own wake event.
+* A context switch hands the CPU over by signalling the wake event of the
+* incoming thread and parking the outgoing one.
+*
+* Interrupts (the tick and the simulated peripheral interrupts) are pended
+* in a bit mask and delivered to the running thread with portSIG_INTERRUPT.
+* Masking that signal is how interrupts are disabled.  A yield requested
+* while interrupts are masked is held pending, the same way PendSV stays
+* pending on the Cortex-M4F until BASEPRI is lowered again.
+*----------------------------------------------------------*/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portSIG_INTERRUPT               SIGUSR1
+
+/* How often the interrupt controller thread re-signals the running thread
+ * while an interrupt is still pending (e.g. the previous signal landed on a
+ * thread that was switched out before it could take it). */
+#define portINTERRUPT_RESEND_NS         ( 100000ULL )
+
+#define portNS_PER_SECOND               ( 1000000000ULL )
+#define portTICK_PERIOD_NS              ( portNS_PER_SECOND / configTICK_RATE_HZ )
+
+typedef struct EVENT
+{
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+    BaseType_t xSet;
+} Event_t;
+
+typedef struct THREAD
+{
+    pthread_t pthread;
+    TaskFunction_t pxCode;
+    void * pvParams;
+    volatile BaseType_t xDying;
+    Event_t xWakeEvent;
+} Thread_t;
+
+/* The kernel's current TCB.  The first member of a TCB is pxTopOfStack,
+ * which this port uses to find the thread that belongs to a task. */
+extern void * volatile pxCurrentTCB;
+
+static Thread_t * volatile pxRunningThread = NULL;
+static volatile UBaseType_t uxCriticalNesting = 0;
+static volatile BaseType_t xInterruptsMasked = pdTRUE;
+static volatile BaseType_t xInsideInterrupt = pdFALSE;
+static volatile BaseType_t xSwitchPending = pdFALSE;
+static volatile BaseType_t xSchedulerEnd = pdFALSE;
+
+static volatile uint32_t ulPendingInterrupts[ portMAX_INTERRUPTS / 32UL ];
+static volatile uint32_t ulPendingTicks = 0;
+static void ( * pvInterruptHandlers[ portMAX_INTERRUPTS ] )( void );
+
+static pthread_t xInterruptControllerThread;
+static Event_t xSchedulerEndEvent;
+
+/*-----------------------------------------------------------*/
+
+static void prvEventInit( Event_t * pxEvent )
+{
+    pthread_mutex_init( &pxEvent->xMutex, NULL );
+    pthread_cond_init( &pxEvent->xCond, NULL );
+    pxEvent->xSet = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventDelete( Event_t * pxEvent )
+{
+    pthread_cond_destroy( &pxEvent->xCond );
+    pthread_mutex_destroy( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventSignal( Event_t * pxEvent )
+{
+    pthread_mutex_lock( &pxEvent->xMutex );
+    pxEvent->xSet = pdTRUE;
+    pthread_cond_signal( &pxEvent->xCond );
+    pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventWait( Event_t * pxEvent )
+{
+    pthread_mutex_lock( &pxEvent->xMutex );
+
+    while( pxEvent->xSet == pdFALSE )
+    {
+        pthread_cond_wait( &pxEvent->xCond, &pxEvent->xMutex );
+    }
+
+    pxEvent->xSet = pdFALSE;
+    pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNowNs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( ( uint64_t ) xNow.tv_sec * portNS_PER_SECOND ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static Thread_t * prvGetThreadFromTask( void * pvTask )
+{
+    StackType_t * pxTopOfStack = *( StackType_t ** ) pvTask;
+
+    return ( Thread_t * ) ( pxTopOfStack + 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMaskInterrupts( void )
+{
+    sigset_t xSignals;
+
+    sigemptyset( &xSignals );
+    sigaddset( &xSignals, portSIG_INTERRUPT );
+    pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+    xInterruptsMasked = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnmaskInterrupts( void )
+{
+    sigset_t xSignals;
+
+    sigemptyset( &xSignals );
+    sigaddset( &xSignals, portSIG_INTERRUPT );
+    xInterruptsMasked = pdFALSE;
+    pthread_sigmask( SIG_UNBLOCK, &xSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvKickRunningThread( void )
+{
+    Thread_t * pxThread = pxRunningThread;
+
+    if( pxThread != NULL )
+    {
+        ( void ) pthread_kill( pxThread->pthread, portSIG_INTERRUPT );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInterruptIsPending( void )
+{
+    uint32_t ulWord;
+
+    if( __atomic_load_n( &ulPendingTicks, __ATOMIC_ACQUIRE ) != 0UL )
+    {
+        return pdTRUE;
+    }
+
+    for( ulWord = 0; ulWord < ( portMAX_INTERRUPTS / 32UL ); ulWord++ )
+    {
+        if( __atomic_load_n( &ulPendingInterrupts[ ulWord ], __ATOMIC_ACQUIRE ) != 0UL )
+        {
+            return pdTRUE;
+        }
+    }
+
+    return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/* Must be called with interrupts masked.  Hands the CPU to whichever task
+ * the kernel selects and parks the calling thread until it is selected
+ * again. */
+static void prvSwitchContext( void )
+{
+    Thread_t * pxFrom;
+    Thread_t * pxTo;
+
+    if( pxRunningThread == NULL )
+    {
+        return;
+    }
+
+    xSwitchPending = pdFALSE;
+    pxFrom = prvGetThreadFromTask( pxCurrentTCB );
+    vTaskSwitchContext();
+    pxTo = prvGetThreadFromTask( pxCurrentTCB );
+
+    if( pxTo != pxFrom )
+    {
+        pxRunningThread = pxTo;
+        prvEventSignal( &pxTo->xWakeEvent );
+        prvEventWait( &pxFrom->xWakeEvent );
+
+        if( pxFrom->xDying != pdFALSE )
+        {
+            pthread_exit( NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvServiceInterrupts( void )
+{
+    uint32_t ulWord;
+    uint32_t ulPending;
+    uint32_t ulBit;
+    BaseType_t xServiced;
+
+    do
+    {
+        xServiced = pdFALSE;
+
+        /* The tick has the highest priority, as it does on the target where
+         * SysTick is the only exception that is serviced here. */
+        if( __atomic_load_n( &ulPendingTicks, __ATOMIC_ACQUIRE ) != 0UL )
+        {
+            __atomic_fetch_sub( &ulPendingTicks, 1UL, __ATOMIC_ACQ_REL );
+
+            if( xTaskIncrementTick() != pdFALSE )
+            {
+                xSwitchPending = pdTRUE;
+            }
+
+            xServiced = pdTRUE;
+            continue;
+        }
+
+        /* Lower interrupt numbers first, one at a time. */
+        for( ulWord = 0; ( ulWord < ( portMAX_INTERRUPTS / 32UL ) ) && ( xServiced == pdFALSE ); ulWord++ )
+        {
+            ulPending = __atomic_load_n( &ulPendingInterrupts[ ulWord ], __ATOMIC_ACQUIRE );
+
+            if( ulPending != 0UL )
+            {
+                ulBit = ( uint32_t ) __builtin_ctz( ulPending );
+                __atomic_fetch_and( &ulPendingInterrupts[ ulWord ], ~( 1U << ulBit ), __ATOMIC_ACQ_REL );
+
+                if( pvInterruptHandlers[ ( ulWord * 32UL ) + ulBit ] != NULL )
+                {
+                    pvInterruptHandlers[ ( ulWord * 32UL ) + ulBit ]();
+                }
+
+                xServiced = pdTRUE;
+            }
+        }
+    } while( xServiced != pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int lSignal )
+{
+    Thread_t * pxThread = pxRunningThread;
+    int lSavedErrno = errno;
+
+    ( void ) lSignal;
+
+    /* A stale signal for a thread that has since been switched out.  The
+     * interrupt stays pending and is re-signalled to the running thread. */
+    if( ( pxThread == NULL ) || ( pthread_equal( pthread_self(), pxThread->pthread ) == 0 ) )
+    {
+        errno = lSavedErrno;
+        return;
+    }
+
+    xInterruptsMasked = pdTRUE;
+    xInsideInterrupt = pdTRUE;
+    prvServiceInterrupts();
+    xInsideInterrupt = pdFALSE;
+
+    if( xSwitchPending != pdFALSE )
+    {
+        prvSwitchContext();
+    }
+
+    xInterruptsMasked = pdFALSE;
+    errno = lSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+/* Simulated interrupt controller: generates the tick and keeps poking the
+ * running thread while anything is pending. */
+static void * prvInterruptControllerThread( void * pvParams )
+{
+    uint64_t ullNextTick = prvNowNs() + portTICK_PERIOD_NS;
+    uint64_t ullNow;
+    uint64_t ullWakeUp;
+    struct timespec xWakeUp;
+
+    ( void ) pvParams;
+
+    while( xSchedulerEnd == pdFALSE )
+    {
+        ullNow = prvNowNs();
+
+        if( ullNow >= ullNextTick )
+        {
+            __atomic_fetch_add( &ulPendingTicks, 1UL, __ATOMIC_ACQ_REL );
+            ullNextTick += portTICK_PERIOD_NS;
+            prvKickRunningThread();
+            continue;
+        }
+
+        ullWakeUp = ullNextTick;
+
+        if( prvInterruptIsPending() != pdFALSE )
+        {
+            prvKickRunningThread();
+
+            if( ( ullNow + portINTERRUPT_RESEND_NS ) < ullWakeUp )
+            {
+                ullWakeUp = ullNow + portINTERRUPT_RESEND_NS;
+            }
+        }
+
+        xWakeUp.tv_sec = ( time_t ) ( ullWakeUp / portNS_PER_SECOND );
+        xWakeUp.tv_nsec = ( long ) ( ullWakeUp % portNS_PER_SECOND );
+        ( void ) clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xWakeUp, NULL );
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvThreadEntry( void * pvParams )
+{
+    Thread_t * pxThread = ( Thread_t * ) pvParams;
+
+    /* Wait to be scheduled for the first time. */
+    prvEventWait( &pxThread->xWakeEvent );
+
+    if( pxThread->xDying != pdFALSE )
+    {
+        return NULL;
+    }
+
+    prvUnmaskInterrupts();
+
+    pxThread->pxCode( pxThread->pvParams );
+
+    /* Tasks must not return. */
+    vTaskDelete( NULL );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    Thread_t * pxThread;
+    sigset_t xInterruptSignal;
+    sigset_t xSavedSignals;
+    int lResult;
+
+    /* The thread bookkeeping lives at the top of the task's stack, which
+     * the kernel never touches otherwise in this port. */
+    pxThread = ( Thread_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pxTopOfStack + 1 ) - sizeof( Thread_t ) ) &
+                                ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) );
+    pxTopOfStack = ( ( StackType_t * ) pxThread ) - 1;
+
+    pxThread->pxCode = pxCode;
+    pxThread->pvParams = pvParameters;
+    pxThread->xDying = pdFALSE;
+    prvEventInit( &pxThread->xWakeEvent );
+
+    /* The new thread inherits a mask with the interrupt signal blocked; it
+     * unmasks it itself once it is first scheduled.  Synchronous signals are
+     * left alone, the simulator's register traps rely on them. */
+    sigemptyset( &xInterruptSignal );
+    sigaddset( &xInterruptSignal, portSIG_INTERRUPT );
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignal, &xSavedSignals );
+    lResult = pthread_create( &pxThread->pthread, NULL, prvThreadEntry, pxThread );
+    pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+
+    configASSERT( lResult == 0 );
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+    struct sigaction xAction = { 0 };
+    sigset_t xInterruptSignal;
+    sigset_t xSavedSignals;
+    Thread_t * pxFirstThread;
+
+    xAction.sa_handler = prvInterruptSignalHandler;
+    sigemptyset( &xAction.sa_mask );
+    sigaddset( &xAction.sa_mask, portSIG_INTERRUPT );
+    xAction.sa_flags = SA_RESTART;
+    sigaction( portSIG_INTERRUPT, &xAction, NULL );
+
+    prvEventInit( &xSchedulerEndEvent );
+    uxCriticalNesting = 0;
+
+    sigemptyset( &xInterruptSignal );
+    sigaddset( &xInterruptSignal, portSIG_INTERRUPT );
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignal, &xSavedSignals );
+    pthread_create( &xInterruptControllerThread, NULL, prvInterruptControllerThread, NULL );
+    pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+
+    /* Start the first task.  This thread is not a task and just waits for
+     * vPortEndScheduler(). */
+    pxFirstThread = prvGetThreadFromTask( pxCurrentTCB );
+    pxRunningThread = pxFirstThread;
+    prvEventSignal( &pxFirstThread->xWakeEvent );
+
+    prvEventWait( &xSchedulerEndEvent );
+
+    pthread_join( xInterruptControllerThread, NULL );
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+    xSchedulerEnd = pdTRUE;
+    prvEventSignal( &xSchedulerEndEvent );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    if( ( xInsideInterrupt != pdFALSE ) || ( uxCriticalNesting > 0U ) || ( xInterruptsMasked != pdFALSE ) )
+    {
+        /* Taken as soon as interrupts are unmasked again. */
+        xSwitchPending = pdTRUE;
+        return;
+    }
+
+    prvMaskInterrupts();
+    prvSwitchContext();
+    prvUnmaskInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    if( xInsideInterrupt != pdFALSE )
+    {
+        xSwitchPending = pdTRUE;
+    }
+    else
+    {
+        vPortYield();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    if( xInsideInterrupt == pdFALSE )
+    {
+        prvMaskInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    if( xInsideInterrupt != pdFALSE )
+    {
+        return;
+    }
+
+    if( ( xSwitchPending != pdFALSE ) && ( uxCriticalNesting == 0U ) )
+    {
+        prvMaskInterrupts();
+        prvSwitchContext();
+    }
+
+    prvUnmaskInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t xPortSetInterruptMask( void )
+{
+    UBaseType_t uxSavedMask = ( UBaseType_t ) xInterruptsMasked;
+
+    vPortDisableInterrupts();
+
+    return uxSavedMask;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+    if( uxMask == ( UBaseType_t ) pdFALSE )
+    {
+        vPortEnableInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    vPortDisableInterrupts();
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    if( uxCriticalNesting > 0U )
+    {
+        uxCriticalNesting--;
+
+        if( uxCriticalNesting == 0U )
+        {
+            vPortEnableInterrupts();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                               void ( * pvHandler )( void ) )
+{
+    if( ulInterruptNumber < portMAX_INTERRUPTS )
+    {
+        pvInterruptHandlers[ ulInterruptNumber ] = pvHandler;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+    if( ulInterruptNumber < portMAX_INTERRUPTS )
+    {
+        __atomic_fetch_or( &ulPendingInterrupts[ ulInterruptNumber / 32UL ],
+                           1U << ( ulInterruptNumber % 32UL ), __ATOMIC_ACQ_REL );
+
+        /* If the caller is the running task with interrupts unmasked, the
+         * handler runs before pthread_kill() returns, just like an interrupt
+         * pended by a peripheral register write on the target. */
+        prvKickRunningThread();
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortIsInsideInterrupt( void )
+{
+    return xInsideInterrupt;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCancelThread( void * pxTaskToDelete )
+{
+    Thread_t * pxThread = prvGetThreadFromTask( pxTaskToDelete );
+
+    pxThread->xDying = pdTRUE;
+
+    if( pthread_equal( pxThread->pthread, pthread_self() ) == 0 )
+    {
+        prvEventSignal( &pxThread->xWakeEvent );
+        pthread_join( pxThread->pthread, NULL );
+        prvEventDelete( &pxThread->xWakeEvent );
+    }
+}
+/*-----------------------------------------------------------*/
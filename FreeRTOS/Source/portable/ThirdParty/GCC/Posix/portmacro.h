@@ -0,0 +1,144 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+#ifndef PORTMACRO_H
+    #define PORTMACRO_H
+
+    #ifdef __cplusplus
+        extern "C" {
+    #endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * POSIX/Linux simulator port.  Every task runs in its own pthread and only
+ * one of them is ever allowed to run at a time.  Interrupts are simulated
+ * with a signal delivered to the running thread, so "disabling interrupts"
+ * means masking that signal.
+ *
+ * The settings in this file configure FreeRTOS correctly for the
+ * given hardware and compiler.
+ *
+ * These settings should not be altered.
+ *-----------------------------------------------------------
+ */
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+/* Type definitions. */
+    #define portCHAR          char
+    #define portFLOAT         float
+    #define portDOUBLE        double
+    #define portLONG          long
+    #define portSHORT         short
+    /* Stack depths are counted in 32-bit words as on the Cortex-M4F, so the
+     * application's stack sizes cost the same heap as on the target.  The task
+     * code itself runs on the pthread's own stack. */
+    #define portSTACK_TYPE    uint32_t
+    #define portBASE_TYPE     long
+    #define portPOINTER_SIZE_TYPE    size_t
+
+    typedef portSTACK_TYPE   StackType_t;
+    typedef long             BaseType_t;
+    typedef unsigned long    UBaseType_t;
+
+    #if ( configUSE_16_BIT_TICKS == 1 )
+        typedef uint16_t     TickType_t;
+        #define portMAX_DELAY              ( TickType_t ) 0xffff
+    #else
+        typedef uint32_t     TickType_t;
+        #define portMAX_DELAY              ( TickType_t ) 0xffffffffUL
+
+/* 32/64-bit tick type on a 64-bit architecture, so reads of the tick
+ * count do not need to be guarded with a critical section. */
+        #define portTICK_TYPE_IS_ATOMIC    1
+    #endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+    #define portSTACK_GROWTH      ( -1 )
+    #define portTICK_PERIOD_MS    ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+    #define portBYTE_ALIGNMENT    8
+    #define portNOP()
+    #define portMEMORY_BARRIER()    __sync_synchronize()
+/*-----------------------------------------------------------*/
+
+/* Scheduler utilities. */
+    extern void vPortYield( void );
+    extern void vPortYieldFromISR( void );
+
+    #define portYIELD()                                  vPortYield()
+    #define portEND_SWITCHING_ISR( xSwitchRequired )     do { if( ( xSwitchRequired ) != pdFALSE ) { vPortYieldFromISR(); } } while( 0 )
+    #define portYIELD_FROM_ISR( x )                      portEND_SWITCHING_ISR( x )
+/*-----------------------------------------------------------*/
+
+/* Critical section management. */
+    extern void vPortDisableInterrupts( void );
+    extern void vPortEnableInterrupts( void );
+    extern UBaseType_t xPortSetInterruptMask( void );
+    extern void vPortClearInterruptMask( UBaseType_t uxMask );
+    extern void vPortEnterCritical( void );
+    extern void vPortExitCritical( void );
+
+    #define portSET_INTERRUPT_MASK_FROM_ISR()         xPortSetInterruptMask()
+    #define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )    vPortClearInterruptMask( x )
+    #define portDISABLE_INTERRUPTS()                  vPortDisableInterrupts()
+    #define portENABLE_INTERRUPTS()                   vPortEnableInterrupts()
+    #define portENTER_CRITICAL()                      vPortEnterCritical()
+    #define portEXIT_CRITICAL()                       vPortExitCritical()
+/*-----------------------------------------------------------*/
+
+/* Simulated interrupt controller.  Interrupt numbers are the TM4C123 NVIC
+ * interrupt numbers (vector number - 16).  A handler registered with
+ * vPortSetInterruptHandler() runs in interrupt context on the thread of
+ * the running task as soon as the interrupt is pended and not masked. */
+    #define portMAX_INTERRUPTS    ( 160UL )
+
+    extern void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                                          void ( * pvHandler )( void ) );
+    extern void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+    extern BaseType_t xPortIsInsideInterrupt( void );
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+    #define portTASK_FUNCTION_PROTO( vFunction, pvParameters )    void vFunction( void * pvParameters )
+    #define portTASK_FUNCTION( vFunction, pvParameters )          void vFunction( void * pvParameters )
+/*-----------------------------------------------------------*/
+
+/* Each task owns a pthread that has to be reclaimed once the TCB is freed. */
+    extern void vPortCancelThread( void * pxTaskToDelete );
+    #define portCLEAN_UP_TCB( pxTCB )    vPortCancelThread( pxTCB )
+/*-----------------------------------------------------------*/
+
+    #ifdef __cplusplus
+        }
+    #endif
+
+#endif /* PORTMACRO_H */
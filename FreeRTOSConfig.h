@@ -18,8 +18,10 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
+#include "clock.h"
 #include "GPTM.h"
 #include "std_types.h"
+#include "trace.h"
 /******************************************************************************/
 /* Scheduling behavior related definitions. **********************************/
 /******************************************************************************/
@@ -27,8 +29,8 @@
 /* configCPU_CLOCK_HZ must be set to the frequency of the clock that drives 
  * the peripheral used to generate the kernels periodic tick interrupt.
  * This is very often, but not always, equal to the main system clock frequency.
- * Default frequency in Tiva-C Micro-controllers is 16Mhz */
-#define configCPU_CLOCK_HZ                    (( unsigned long )16000000)
+ * The system clock is set up by CLOCK_vInit(), see clock.h */
+#define configCPU_CLOCK_HZ                    (( unsigned long )CLOCK_SYSTEM_HZ)
 
 /* configTICK_RATE_HZ sets frequency of the tick interrupt in Hz, so
  * in our case Tick time will be 1ms */
@@ -57,11 +59,14 @@
 /* Memory allocation related definitions. *************************************/
 /******************************************************************************/
 
-/* Sets the total size of the FreeRTOS heap, in bytes, when heap_1.c, heap_2.c
- * or heap_4.c are included in the build. This value is defaulted to 4096 bytes but
- * it must be tailored to each application. Note the heap will appear in the .bss
- * section. */
-#define configTOTAL_HEAP_SIZE                 ((size_t)(15 * 1024))
+/* Every kernel object, task stacks and TCBs included, is a static variable
+ * handed to its xCreateStatic() function, so the RAM map is fixed at link time.
+ * The idle and timer service tasks get theirs from vApplicationGetIdleTaskMemory()
+ * and vApplicationGetTimerTaskMemory() in main.c. Dynamic allocation is compiled
+ * out and no heap_x.c is linked, so nothing can allocate before or after the
+ * scheduler starts: a call to a dynamic create function fails to build. */
+#define configSUPPORT_STATIC_ALLOCATION       1
+#define configSUPPORT_DYNAMIC_ALLOCATION      0
 
 /******************************************************************************/
 /* Definitions that include or exclude functionality. *************************/
@@ -74,10 +79,34 @@
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_vTaskSuspend                    1
 #define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
 
 /* Set the following configUSE_* constants to 1 to include the named feature in
  * the build, or 0 to exclude the named feature from the build. */
-#define configUSE_APPLICATION_TASK_TAG         1
+
+/* Per-buffer send/receive completed callbacks for stream and message buffers,
+ * used by the log gatekeeper to be woken by any of its producer buffers. */
+#define configUSE_SB_COMPLETED_CALLBACK        1
+
+/* Control architecture of main.c: 0 for a task per control activity (heater
+ * level, heater intensity, temperature print), 1 for a single run to
+ * completion control task blocking on a queue set. Queue sets are only built
+ * in for the latter. */
+#ifndef CONTROL_QUEUE_SET
+#define CONTROL_QUEUE_SET                      0
+#endif
+#define configUSE_QUEUE_SETS                   CONTROL_QUEUE_SET
+
+/* Heater outputs (heater.h): 0 for the PWM module, 1 for GPIO pins time
+ * proportioned from the tick hook. The tick hook is only built in for the latter. */
+#ifndef HEATER_SOFTWARE_PWM
+#define HEATER_SOFTWARE_PWM                    0
+#endif
+
+/* Index 0 of the task notifications is used by the stream buffers and the log
+ * service, index 1 by the direct signals of main.c (CONTROL_NOTIFY_INDEX). */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES  2
 
 /* Set the following INCLUDE_* constants to 1 to include the named API function,
  * or 0 to exclude the named API function.  Most linkers will remove unused
@@ -120,7 +149,7 @@
  * build.  The application writer is responsible for providing the hook function
  * for any set to 1. */
 #define configUSE_IDLE_HOOK                   0
-#define configUSE_TICK_HOOK                   0
+#define configUSE_TICK_HOOK                   HEATER_SOFTWARE_PWM
 
 /******************************************************************************/
 /* ARM Cortex-M Specific Definitions. *****************************************/
@@ -154,22 +183,66 @@ PRIORITY THAN THIS! (higher priorities are lower numeric values. */
 /* Normal assert() semantics without relying on the provision of an assert.h header file. */
 #define configASSERT( x ) if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ;; ); }
 
-extern uint32 ullTasksOutTime[9];
-extern uint32 ullTasksInTime[9];
-extern uint32 ullTasksTotalTime[9];
-
-#define traceTASK_SWITCHED_IN()                                    \
-do{                                                                \
-    uint32 taskInTag = (uint32)(pxCurrentTCB->pxTaskTag);          \
-    ullTasksInTime[taskInTag] = GPTM_WTimer0Read();                \
-}while(0);
-
-#define traceTASK_SWITCHED_OUT()                                                                 \
-do{                                                                                              \
-    uint32 taskOutTag = (uint32)(pxCurrentTCB->pxTaskTag);                                       \
-    ullTasksOutTime[taskOutTag] = GPTM_WTimer0Read();                                            \
-    ullTasksTotalTime[taskOutTag] += ullTasksOutTime[taskOutTag] - ullTasksInTime[taskOutTag];   \
-}while(0);
+/* Stack overflows hit the MPU guard kept under the running task's stack, see
+ * stack.h, instead of a pattern check at every switch. The TCB records the
+ * top of each stack so the monitor knows its depth. */
+#define configCHECK_FOR_STACK_OVERFLOW           0
+#define configRECORD_STACK_HIGH_ADDRESS          1
+#define traceTASK_CREATE( pxNewTCB )             Stack_vTaskCreated( pxNewTCB, pxNewTCB->pxStack, pxNewTCB->pxEndOfStack, pxNewTCB->uxTCBNumber )
+#define traceTASK_DELETE( pxTCB )                Stack_vTaskDeleted( pxTCB )
+extern void Stack_vTaskCreated(void *pvTask, void *pvStack, void *pvEndOfStack, uint32 u32Number);
+extern void Stack_vTaskDeleted(void *pvTask);
+extern void Stack_vTaskSwitchedIn(void *pvStack);
+
+/* Kernel events recorded in the trace ring, see trace.h. Each object takes
+ * the next trace number as it is created, in the number field the kernel
+ * keeps for trace tools. Semaphores are queues: a give is a send and a take
+ * a receive. */
+#define traceTASK_SWITCHED_IN()                  do { Stack_vTaskSwitchedIn( pxCurrentTCB->pxStack ); \
+                                                      Trace_vTaskSwitchedIn( pxCurrentTCB->uxTCBNumber ); } while( 0 )
+#if TRACE_TICKS
+#define traceTASK_INCREMENT_TICK( xTickCount )   Trace_vRecord( TRACE_EVENT_TICK, 0, ( uint8 ) ( xTickCount ) )
+#endif
+#define traceQUEUE_CREATE( pxNewQueue )          ( pxNewQueue )->uxQueueNumber = Trace_u8NewObject( ( pxNewQueue )->ucQueueType )
+#define traceQUEUE_SEND( pxQueue )               Trace_vRecord( TRACE_EVENT_QUEUE_SEND, ( uint8 ) ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )      Trace_vRecord( TRACE_EVENT_QUEUE_SEND_FROM_ISR, ( uint8 ) ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_RECEIVE( pxQueue )            Trace_vRecord( TRACE_EVENT_QUEUE_RECEIVE, ( uint8 ) ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )   Trace_vRecord( TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR, ( uint8 ) ( pxQueue )->uxQueueNumber, 0 )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue ) Trace_vRecord( TRACE_EVENT_QUEUE_BLOCK, ( uint8 ) ( pxQueue )->uxQueueNumber, 0 )
+#define traceEVENT_GROUP_CREATE( pxEventBits )   ( pxEventBits )->uxEventGroupNumber = Trace_u8NewObject( TRACE_OBJECT_EVENT_GROUP )
+#define traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet ) \
+    Trace_vRecord( TRACE_EVENT_GROUP_SET, ( uint8 ) uxEventGroupGetNumber( xEventGroup ), ( uint8 ) ( uxBitsToSet ) )
+#define traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet ) \
+    Trace_vRecord( TRACE_EVENT_GROUP_SET_FROM_ISR, ( uint8 ) uxEventGroupGetNumber( xEventGroup ), ( uint8 ) ( uxBitsToSet ) )
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor ) \
+    Trace_vRecord( TRACE_EVENT_GROUP_WAIT_BLOCK, ( uint8 ) uxEventGroupGetNumber( xEventGroup ), ( uint8 ) ( uxBitsToWaitFor ) )
+#define traceEVENT_GROUP_WAIT_BITS_END( xEventGroup, uxBitsToWaitFor, xTimeoutOccurred ) \
+    Trace_vRecord( TRACE_EVENT_GROUP_WAIT_END, ( uint8 ) uxEventGroupGetNumber( xEventGroup ), ( uint8 ) ( uxBitsToWaitFor ) )
+#define traceTASK_NOTIFY( uxIndexToNotify )      Trace_vRecord( TRACE_EVENT_NOTIFY, 0, ( uint8 ) pxTCB->uxTCBNumber )
+#define traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify ) Trace_vRecord( TRACE_EVENT_NOTIFY_FROM_ISR, 0, ( uint8 ) pxTCB->uxTCBNumber )
+#define traceTASK_NOTIFY_GIVE_FROM_ISR( uxIndexToNotify ) Trace_vRecord( TRACE_EVENT_NOTIFY_FROM_ISR, 0, ( uint8 ) pxTCB->uxTCBNumber )
+#define traceTASK_NOTIFY_TAKE( uxIndexToWait )   Trace_vRecord( TRACE_EVENT_NOTIFY_TAKE, 0, 0 )
+#define traceTASK_NOTIFY_WAIT( uxIndexToWait )   Trace_vRecord( TRACE_EVENT_NOTIFY_TAKE, 0, 0 )
+#define traceTIMER_CREATE( pxNewTimer )          ( pxNewTimer )->uxTimerNumber = Trace_u8NewObject( TRACE_OBJECT_TIMER )
+#define traceTIMER_COMMAND_SEND( xTimer, xMessageID, xMessageValueValue, xReturn ) \
+    Trace_vRecord( TRACE_EVENT_TIMER_COMMAND, ( uint8 ) uxTimerGetTimerNumber( xTimer ), ( uint8 ) ( xMessageID ) )
+#define traceTIMER_EXPIRED( pxTimer )            Trace_vRecord( TRACE_EVENT_TIMER_EXPIRED, ( uint8 ) ( pxTimer )->uxTimerNumber, 0 )
+
+/******************************************************************************/
+/* Run time statistics. *******************************************************/
+/******************************************************************************/
+
+/* Every TCB keeps a 64-bit count of the CPU cycles its task has run, so the
+ * counters never wrap; see runtime.h for the sliding window loads. The clock
+ * is the WTimer0 timebase, started by prvSetupHardware() before the
+ * scheduler. */
+#define configGENERATE_RUN_TIME_STATS            1
+#define configRUN_TIME_COUNTER_TYPE              uint64
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()         GPTM_WTimer0Read()
+
+/* uxTaskGetSystemState() lists every task with its run time counter */
+#define configUSE_TRACE_FACILITY                 1
 
 #endif /* FREERTOS_CONFIG_H */
 
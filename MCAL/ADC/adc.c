@@ -1,98 +1,187 @@
 /*************************************************************/
 /* Author  : Zeyad El-Gedawy 								 */
-/* Version : V01			 								 */
+/* Version : V02			 								 */
 /* Date	   : 03 October		 								 */
 /*************************************************************/
 
 #include "adc.h"
+#include "udma.h"
 #include "tm4c123gh6pm_registers.h"
 
-void ADC_vInit(void)
+#define ADC_PORT_B      1
+#define ADC_PORT_D      3
+#define ADC_PORT_E      4
+
+// GPIO port and pin of each analog input AIN0 .. AIN11
+
+static const uint8 ADC_au8ChannelPort[ADC_CHANNELS_NUM] =
 {
-	// Enable the ADC clock
-	
-	SYSCTL_RCGCADC_REG |= 0x00000003;
-	while(!(SYSCTL_PRADC_REG & 0x03));
-	
-	// Enable the clock to GPIO_E
-	
-	SET_BIT(SYSCTL_RCGCGPIO_REG,4);
-	
-	// Set the GPIO_E AFSEL bits for the ADC 
-	
-	SET_BIT(GPIO_PORTE_AFSEL_REG,2);
-	SET_BIT(GPIO_PORTE_AFSEL_REG,3);
-	
-	// Configure the analog input by clearing the corresponding DEN bit 
-	
-	CLR_BIT(GPIO_PORTE_DEN_REG,2);
-	CLR_BIT(GPIO_PORTE_DEN_REG,3);
+	ADC_PORT_E, ADC_PORT_E, ADC_PORT_E, ADC_PORT_E,
+	ADC_PORT_D, ADC_PORT_D, ADC_PORT_D, ADC_PORT_D,
+	ADC_PORT_E, ADC_PORT_E, ADC_PORT_B, ADC_PORT_B
+};
+static const uint8 ADC_au8ChannelPin[ADC_CHANNELS_NUM] =
+{
+	3, 2, 1, 0,
+	3, 2, 1, 0,
+	5, 4, 4, 5
+};
+
+// uDMA control word of the capture: 16-bit FIFO reads into consecutive 16-bit entries
+
+#define ADC_CAPTURE_UDMA_CONTROL    (UDMA_CTL_DST_INC_16 | UDMA_CTL_DST_SIZE_16 | \
+                                     UDMA_CTL_SRC_INC_NONE | UDMA_CTL_SRC_SIZE_16 | UDMA_CTL_ARB_1)
+
+static uint16* ADC_apu16CaptureHalf[2];
+static uint16  ADC_u16CaptureSamples;
+
+static void ADC_vAnalogPinInit(uint8 ADC_u8Channel)
+{
+	uint8 u8Port = ADC_au8ChannelPort[ADC_u8Channel];
+	uint8 u8Pin  = ADC_au8ChannelPin[ADC_u8Channel];
+
+	// Enable the clock to the GPIO port of the channel
+	
+	SET_BIT(SYSCTL_RCGCGPIO_REG,u8Port);
+	while(!(SYSCTL_PRGPIO_REG & (1 << u8Port)));
+	
+	// Set the AFSEL bit, clear the DEN bit and disable the analog isolation circuit
+	
+	switch(u8Port)
+	{
+	case ADC_PORT_B:
+		SET_BIT(GPIO_PORTB_AFSEL_REG,u8Pin);
+		CLR_BIT(GPIO_PORTB_DEN_REG,u8Pin);
+		SET_BIT(GPIO_PORTB_AMSEL_REG,u8Pin);
+		break;
+	case ADC_PORT_D:
+		SET_BIT(GPIO_PORTD_AFSEL_REG,u8Pin);
+		CLR_BIT(GPIO_PORTD_DEN_REG,u8Pin);
+		SET_BIT(GPIO_PORTD_AMSEL_REG,u8Pin);
+		break;
+	default:
+		SET_BIT(GPIO_PORTE_AFSEL_REG,u8Pin);
+		CLR_BIT(GPIO_PORTE_DEN_REG,u8Pin);
+		SET_BIT(GPIO_PORTE_AMSEL_REG,u8Pin);
+		break;
+	}
+}
+
+void ADC_vInit(const uint8 *ADC_pu8Channels, uint8 ADC_u8Samples, uint8 ADC_u8Trigger)
+{
+	uint32 u32Mux = 0;
+	uint32 u32Ctl = 0;
+	uint8  u8Step;
+
+	if(ADC_u8Samples > ADC_SEQ0_MAX_SAMPLES)
+	{
+		ADC_u8Samples = ADC_SEQ0_MAX_SAMPLES;
+	}
 	
-	// Disable the analog isolation circuit for ADC input pins 
+	// Enable the ADC clock
 	
-	SET_BIT(GPIO_PORTE_AMSEL_REG,2);
-	SET_BIT(GPIO_PORTE_AMSEL_REG,3);
+	SET_BIT(SYSCTL_RCGCADC_REG,0);
+	while(!(SYSCTL_PRADC_REG & 0x01));
 	
 	// Ensure that the sample sequencer is disabled by clearing the corresponding ASEN bit
 	
-	ADC0_ACTSS &= 0x00;
-
+	CLR_BIT(ADC0_ACTSS,0);
 	
 	// Configure the trigger event for the sample sequencer in the ADCEMUX register
 	
-	ADC0_EMUX   &= ~(0x0000F000);
+	ADC0_EMUX   = (ADC0_EMUX & ~ADC_EMUX_SS0_MASK) | ((uint32)ADC_u8Trigger << ADC_EMUX_SS0_BITS_POS);
 	
-
-	// Configure the sample sequence input source (ADC channel 0 & 1)
-	
-	ADC0_SSMUX3 = (0x00000000);
-
+	// Configure the input source of each step, only the last one ends the sequence and interrupts
 	
-	// Configuration information for each sample
-	
-	SET_BIT(ADC0_SSCTL3,1);
-	SET_BIT(ADC0_SSCTL3,2);
+	for(u8Step = 0; u8Step < ADC_u8Samples; u8Step++)
+	{
+		ADC_vAnalogPinInit(ADC_pu8Channels[u8Step]);
+		u32Mux |= (uint32)(ADC_pu8Channels[u8Step] & 0x0F) << (u8Step * 4);
+	}
+	if(ADC_u8Samples != 0)
+	{
+		u32Ctl = (uint32)0x6 << ((ADC_u8Samples - 1) * 4);    // END and IE of the last step
+	}
+	ADC0_SSMUX0 = u32Mux;
+	ADC0_SSCTL0 = u32Ctl;
 	
 	// If interrupts are to be used, set the corresponding MASK bit in the ADCIM register.
-	SET_BIT(ADC0_ISC,3);    // Clear ADC 0 Interrupt flag
-	SET_BIT(ADC0_IM,3);
-	NVIC_PRI4_REG = (NVIC_PRI4_REG & ADC0_SEQ3_PRIORITY_MASK) | (ADC0_SEQ3_INTERRUPT_PRIORITY<<ADC0_SEQ3_PRIORITY_BITS_POS); // Set ADC 0 Priority
-	SET_BIT(NVIC_EN0_REG,17);
 	
-	// Enable the sample sequencer 
+	SET_BIT(ADC0_ISC,0);    // Clear ADC 0 sequencer 0 Interrupt flag
+	SET_BIT(ADC0_IM,0);
+	NVIC_PRI3_REG = (NVIC_PRI3_REG & ADC0_SEQ0_PRIORITY_MASK) | (ADC0_SEQ0_INTERRUPT_PRIORITY<<ADC0_SEQ0_PRIORITY_BITS_POS); // Set ADC 0 Sequencer 0 Priority
+	SET_BIT(NVIC_EN0_REG,14);
 	
-	SET_BIT(ADC0_ACTSS,3);
+	// Enable the sample sequencer 
 	
-	/***************************/
-	ADC1_ACTSS &= 0x00;
-
-	ADC1_EMUX   &= ~(0x0000F000);
-
-	ADC1_SSMUX3 =   0x00000001 ;
-
-	SET_BIT(ADC1_SSCTL3,1);
-    SET_BIT(ADC1_SSCTL3,2);
-
-    SET_BIT(ADC1_ISC,3);    // Clear ADC 1 Interrupt flag
-    SET_BIT(ADC1_IM,3);
-    NVIC_PRI12_REG = (NVIC_PRI12_REG & ADC1_SEQ3_PRIORITY_MASK) | (ADC1_SEQ3_INTERRUPT_PRIORITY<<ADC1_SEQ3_PRIORITY_BITS_POS); // Set ADC 1 Priority
-    SET_BIT(NVIC_EN1_REG,19);
-
-    SET_BIT(ADC1_ACTSS,3);
+	SET_BIT(ADC0_ACTSS,0);
 }
 void ADC0_vStartConversion(void)
 {
-	SET_BIT(ADC0_PSSI,3);
+	SET_BIT(ADC0_PSSI,0);
 }
-void ADC1_vStartConversion(void)
+uint8 ADC0_u8ReadSequence(uint32* ADC_pu32Values, uint8 ADC_u8MaxSamples)
 {
-	SET_BIT(ADC1_PSSI,3);
+	uint8 u8Count = 0;
+
+	while(!(ADC0_SSFSTAT0 & (1 << ADC_SSFSTAT_EMPTY_BIT)))
+	{
+		if(u8Count < ADC_u8MaxSamples)
+		{
+			ADC_pu32Values[u8Count++] = ADC0_FIFO0;
+		}
+		else
+		{
+			(void)ADC0_FIFO0;    // Drop what does not fit so the FIFO is left empty
+		}
+	}
+	return u8Count;
 }
-void ADC0_vRead(uint32* ADC_u32Value)
-{	
-	*ADC_u32Value = ADC0_FIFO3;
+static void ADC_vCaptureArm(uint8 ADC_u8Half)
+{
+	UDMA_vSetTransfer(UDMA_CHANNEL_ADC0_SS0, ADC_u8Half, &ADC0_FIFO0, ADC_apu16CaptureHalf[ADC_u8Half],
+	                  ADC_CAPTURE_UDMA_CONTROL, ADC_u16CaptureSamples, UDMA_MODE_PINGPONG);
 }
-void ADC1_vRead(uint32* ADC_u32Value)
-{	
-	*ADC_u32Value = ADC1_FIFO3;
+void ADC_vCaptureInit(uint16* ADC_pu16Buffer, uint16 ADC_u16Samples)
+{
+	if(ADC_u16Samples > ADC_CAPTURE_MAX_SAMPLES)
+	{
+		ADC_u16Samples = ADC_CAPTURE_MAX_SAMPLES;
+	}
+	ADC_u16CaptureSamples = ADC_u16Samples;
+	ADC_apu16CaptureHalf[UDMA_PRIMARY]   = ADC_pu16Buffer;
+	ADC_apu16CaptureHalf[UDMA_ALTERNATE] = ADC_pu16Buffer + ADC_u16Samples;
+	
+	// The uDMA completion interrupt replaces the end of sequence interrupt
+	
+	CLR_BIT(ADC0_ACTSS,0);
+	CLR_BIT(ADC0_IM,0);
+	
+	// Ping (primary) fills first, pong (alternate) takes over when it is full
+	
+	ADC_vCaptureArm(UDMA_PRIMARY);
+	ADC_vCaptureArm(UDMA_ALTERNATE);
+	UDMA_ALTCLR_REG = (1UL << UDMA_CHANNEL_ADC0_SS0);
+	UDMA_REQMASKCLR_REG = (1UL << UDMA_CHANNEL_ADC0_SS0);
+	UDMA_vChannelEnable(UDMA_CHANNEL_ADC0_SS0);
+	
+	SET_BIT(ADC0_ACTSS,0);
+}
+const uint16* ADC0_pu16CaptureDone(void)
+{
+	uint8 u8Half;
+
+	UDMA_vClearInterrupt(UDMA_CHANNEL_ADC0_SS0);
+	for(u8Half = UDMA_PRIMARY; u8Half <= UDMA_ALTERNATE; u8Half++)
+	{
+		if(UDMA_u8TransferMode(UDMA_CHANNEL_ADC0_SS0, u8Half) == UDMA_MODE_STOP)
+		{
+			// Re-arm the full half, and restart the channel in case both halves had filled up
+			
+			ADC_vCaptureArm(u8Half);
+			UDMA_vChannelEnable(UDMA_CHANNEL_ADC0_SS0);
+			return ADC_apu16CaptureHalf[u8Half];
+		}
+	}
+	return NULL_PTR;
 }
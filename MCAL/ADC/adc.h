@@ -1,6 +1,6 @@
 /*************************************************************/
 /* Author  : Zeyad El-Gedawy 								 */
-/* Version : V01			 								 */
+/* Version : V02			 								 */
 /* Date	   : 03 October		 								 */
 /*************************************************************/
 
@@ -10,20 +10,53 @@
 #include "std_types.h"
 
 
-#define ADC0_SEQ3_PRIORITY_MASK             0xFFFF1FFF
-#define ADC0_SEQ3_PRIORITY_BITS_POS         13
-#define ADC0_SEQ3_INTERRUPT_PRIORITY        5
+#define ADC0_SEQ0_PRIORITY_MASK             0xFF1FFFFF
+#define ADC0_SEQ0_PRIORITY_BITS_POS         21
+#define ADC0_SEQ0_INTERRUPT_PRIORITY        5
 
-#define ADC1_SEQ3_PRIORITY_MASK             0x1FFFFFFF
-#define ADC1_SEQ3_PRIORITY_BITS_POS         29
-#define ADC1_SEQ3_INTERRUPT_PRIORITY        5
+/* Sample sequencer 0 converts up to 8 channels per trigger */
+#define ADC_SEQ0_MAX_SAMPLES                8
+#define ADC_CHANNELS_NUM                    12      /* AIN0 .. AIN11 */
 
-void ADC_vInit(void);
+/* Sample sequencer 0 trigger source (ADCEMUX EM0 field) */
+#define ADC_EMUX_SS0_MASK                   0x0000000F
+#define ADC_EMUX_SS0_BITS_POS               0
+#define ADC_TRIGGER_PROCESSOR               0x0     /* ADC0_vStartConversion() */
+#define ADC_TRIGGER_TIMER                   0x5     /* GPTM with its ADC trigger output enabled */
+
+#define ADC_SSFSTAT_EMPTY_BIT               8
+
+/* Samples per capture buffer half, limited by the uDMA transfer size */
+#define ADC_CAPTURE_MAX_SAMPLES             1024
+
+/*
+ * Configure ADC0 sample sequencer 0 to convert ADC_u8Samples channels, step i
+ * on analog input ADC_pu8Channels[i], with a single interrupt at the end of the
+ * sequence. The analog pins of the channels are configured as well.
+ */
+void ADC_vInit(const uint8 *ADC_pu8Channels, uint8 ADC_u8Samples, uint8 ADC_u8Trigger);
 
 void ADC0_vStartConversion(void);
-void ADC1_vStartConversion(void);
 
-void ADC0_vRead(uint32* ADC_u32Value);
-void ADC1_vRead(uint32* ADC_u32Value);
+/*
+ * Drain the sequencer 0 FIFO into ADC_pu32Values, in sequence step order.
+ * Returns the number of samples read (at most ADC_u8MaxSamples).
+ */
+uint8 ADC0_u8ReadSequence(uint32* ADC_pu32Values, uint8 ADC_u8MaxSamples);
+
+/*
+ * Capture mode: the uDMA moves every conversion of sequencer 0 into a ping-pong
+ * buffer of 2 * ADC_u16Samples entries (ping half first, then pong half), in
+ * sequence step order, and the ADC0 SS0 interrupt fires only when a half is
+ * full. UDMA_vInit() and ADC_vInit() must have been called first.
+ */
+void ADC_vCaptureInit(uint16* ADC_pu16Buffer, uint16 ADC_u16Samples);
+
+/*
+ * From the ADC0 SS0 interrupt: returns a half that the uDMA has filled and
+ * re-arms it behind the half being filled, or NULL_PTR when there is none.
+ * The returned samples stay valid until the uDMA is back to that half.
+ */
+const uint16* ADC0_pu16CaptureDone(void);
 
 #endif
@@ -0,0 +1,37 @@
+ /******************************************************************************
+ *
+ * Module: CLOCK
+ *
+ * File Name: clock.c
+ *
+ * Description: Source file for the TM4C123GH6PM system clock configuration
+ *
+ *******************************************************************************/
+
+#include "clock.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void CLOCK_vInit(void)
+{
+#if (CLOCK_USE_PLL == 1)
+    /* Use RCC2 and run from the undivided oscillator while the PLL is set up */
+    SYSCTL_RCC2_REG |= CLOCK_RCC2_USERCC2_MASK | CLOCK_RCC2_BYPASS2_MASK;
+    SYSCTL_RCC_REG &= ~CLOCK_RCC_USESYSDIV_MASK;
+
+    /* Main oscillator with the 16 MHz crystal as the PLL reference, PLL powered */
+    SYSCTL_RCC_REG = (SYSCTL_RCC_REG & ~(CLOCK_RCC_XTAL_MASK | CLOCK_RCC_MOSCDIS_MASK)) | CLOCK_RCC_XTAL_16MHZ;
+    SYSCTL_RCC2_REG &= ~(CLOCK_RCC2_OSCSRC2_MASK | CLOCK_RCC2_PWRDN2_MASK);
+
+    /* Divide the 400 MHz PLL output down to the system clock */
+    SYSCTL_RCC2_REG = (SYSCTL_RCC2_REG & ~CLOCK_RCC2_SYSDIV2_MASK) | CLOCK_RCC2_DIV400_MASK |
+                      ((CLOCK_PLL_DIVISOR - 1UL) << CLOCK_RCC2_SYSDIV2_POS);
+
+    while(!(SYSCTL_RIS_REG & CLOCK_RIS_PLLLRIS_MASK));     /* Wait for the PLL to lock */
+
+    SYSCTL_RCC2_REG &= ~CLOCK_RCC2_BYPASS2_MASK;            /* Switch the system clock to the PLL */
+#endif
+}
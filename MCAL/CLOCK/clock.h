@@ -0,0 +1,82 @@
+ /******************************************************************************
+ *
+ * Module: CLOCK
+ *
+ * File Name: clock.h
+ *
+ * Description: Header file for the TM4C123GH6PM system clock configuration.
+ *              CLOCK_SYSTEM_HZ is the single definition of the CPU clock; the
+ *              kernel tick, the UART divisors and the timer prescalers are all
+ *              derived from it at compile time with the macros below.
+ *
+ *******************************************************************************/
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define CLOCK_PIOSC_HZ                  16000000UL      /* Precision internal oscillator, the reset clock */
+#define CLOCK_PLL_HZ                    400000000UL     /* PLL output with DIV400 */
+#define CLOCK_MAX_HZ                    80000000UL
+
+/*
+ * System clock, may be overridden from the build (-DCLOCK_SYSTEM_HZ=...).
+ * 16 MHz runs from PIOSC without the PLL; any other value must divide the
+ * 400 MHz PLL by 5 to 128 (80, 66.67, 57.14, 50, 40, 20, 10 MHz ...).
+ */
+#ifndef CLOCK_SYSTEM_HZ
+#define CLOCK_SYSTEM_HZ                 80000000UL
+#endif
+
+#if (CLOCK_SYSTEM_HZ == CLOCK_PIOSC_HZ)
+#define CLOCK_USE_PLL                   0
+#elif (CLOCK_SYSTEM_HZ > CLOCK_MAX_HZ) || ((CLOCK_PLL_HZ % CLOCK_SYSTEM_HZ) != 0) || ((CLOCK_PLL_HZ / CLOCK_SYSTEM_HZ) > 128)
+#error "CLOCK_SYSTEM_HZ must be 16 MHz or 400 MHz divided by 5 to 128"
+#else
+#define CLOCK_USE_PLL                   1
+#define CLOCK_PLL_DIVISOR               (CLOCK_PLL_HZ / CLOCK_SYSTEM_HZ)
+#endif
+
+/* Derived timing constants */
+#define CLOCK_CYCLES_PER_US             (CLOCK_SYSTEM_HZ / 1000000UL)
+#define CLOCK_CYCLES_PER_MS             (CLOCK_SYSTEM_HZ / 1000UL)
+#define CLOCK_MS_TO_CYCLES(MS)          (CLOCK_CYCLES_PER_MS * (MS))
+
+/* Prescaler register value for a timer counting at TICK_HZ */
+#define CLOCK_PRESCALER(TICK_HZ)        ((CLOCK_SYSTEM_HZ / (TICK_HZ)) - 1UL)
+
+/* UART baud rate divisor (clock / (16 * baud)) in 1/64ths, rounded, split into IBRD and FBRD */
+#define CLOCK_UART_DIVISOR_X64(BAUD)    (((CLOCK_SYSTEM_HZ * 4UL) + ((BAUD) / 2UL)) / (BAUD))
+#define CLOCK_UART_IBRD(BAUD)           (CLOCK_UART_DIVISOR_X64(BAUD) >> 6)
+#define CLOCK_UART_FBRD(BAUD)           (CLOCK_UART_DIVISOR_X64(BAUD) & 0x3FUL)
+
+/* RCC and RCC2 fields */
+#define CLOCK_RCC_MOSCDIS_MASK          0x00000001
+#define CLOCK_RCC_XTAL_MASK             0x000007C0
+#define CLOCK_RCC_XTAL_16MHZ            0x00000540
+#define CLOCK_RCC_USESYSDIV_MASK        0x00400000
+#define CLOCK_RCC2_USERCC2_MASK         0x80000000
+#define CLOCK_RCC2_DIV400_MASK          0x40000000
+#define CLOCK_RCC2_SYSDIV2_MASK         0x1FC00000      /* SYSDIV2 with SYSDIV2LSB, divides the 400 MHz PLL */
+#define CLOCK_RCC2_SYSDIV2_POS          22
+#define CLOCK_RCC2_PWRDN2_MASK          0x00002000
+#define CLOCK_RCC2_BYPASS2_MASK         0x00000800
+#define CLOCK_RCC2_OSCSRC2_MASK         0x00000070      /* 0 = main oscillator */
+#define CLOCK_RIS_PLLLRIS_MASK          0x00000040
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/*
+ * Run the system from the PLL at CLOCK_SYSTEM_HZ, locked to the 16 MHz crystal
+ * of the LaunchPad. Call first, before any driver that depends on the clock.
+ */
+void CLOCK_vInit(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,28 @@
+ /******************************************************************************
+ *
+ * Module: DWT
+ *
+ * File Name: dwt.c
+ *
+ * Description: Source file for the Cortex-M4 DWT cycle counter
+ *
+ *******************************************************************************/
+
+#include "dwt.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void DWT_CycleCounterInit(void)
+{
+    CORE_DEBUG_DEMCR_REG |= CORE_DEBUG_DEMCR_TRCENA_MASK;   /* Enable the DWT and ITM blocks */
+    DWT_CYCCNT_REG = 0;                                     /* Start counting from zero */
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA_MASK;                /* Enable the cycle counter */
+}
+
+uint32 DWT_CycleCounterRead(void)
+{
+    return DWT_CYCCNT_REG;
+}
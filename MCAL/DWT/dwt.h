@@ -0,0 +1,32 @@
+ /******************************************************************************
+ *
+ * Module: DWT
+ *
+ * File Name: dwt.h
+ *
+ * Description: Header file for the Cortex-M4 DWT cycle counter, used to measure
+ *              execution time in CPU clock cycles
+ *
+ *******************************************************************************/
+
+#ifndef DWT_H_
+#define DWT_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+#define CORE_DEBUG_DEMCR_TRCENA_MASK    0x01000000
+#define DWT_CTRL_CYCCNTENA_MASK         0x00000001
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void DWT_CycleCounterInit(void);
+
+/* Free running 32-bit count of CPU clock cycles, wraps every 2^32 cycles */
+extern uint32 DWT_CycleCounterRead(void);
+
+#endif /* DWT_H_ */
@@ -0,0 +1,88 @@
+ /******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom.c
+ *
+ * Description: Source file for the TM4C123GH6PM EEPROM driver
+ *
+ *******************************************************************************/
+
+#include "eeprom.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void EEPROM_vWait(void)
+{
+    while(EEPROM_EEDONE_REG & EEPROM_EEDONE_WORKING);
+}
+
+static boolean EEPROM_bInBlock(uint16 u16Block, uint8 u8Offset, uint8 u8Words)
+{
+    return ((u16Block < EEPROM_BLOCKS_NUM) && (((uint16)u8Offset + u8Words) <= EEPROM_BLOCK_WORDS)) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+boolean EEPROM_bInit(void)
+{
+    SYSCTL_RCGCEEPROM_REG |= (1<<0);              /* Enable clock of the EEPROM */
+    while(!(SYSCTL_PREEPROM_REG & (1<<0)));
+    EEPROM_vWait();
+    if(EEPROM_EESUPP_REG & EEPROM_EESUPP_ERRORS)
+    {
+        return FALSE;
+    }
+
+    /* A reset completes or rolls back a write cut by a power loss */
+    SYSCTL_SREEPROM_REG |= (1<<0);
+    SYSCTL_SREEPROM_REG &= ~(1<<0);
+    while(!(SYSCTL_PREEPROM_REG & (1<<0)));
+    EEPROM_vWait();
+    return (EEPROM_EESUPP_REG & EEPROM_EESUPP_ERRORS) ? FALSE : TRUE;
+}
+
+boolean EEPROM_bRead(uint16 u16Block, uint8 u8Offset, uint32 *pu32Data, uint8 u8Words)
+{
+    uint8 u8Word;
+
+    if(!EEPROM_bInBlock(u16Block, u8Offset, u8Words))
+    {
+        return FALSE;
+    }
+    EEPROM_EEBLOCK_REG = u16Block;
+    EEPROM_EEOFFSET_REG = u8Offset;
+    for(u8Word = 0; u8Word < u8Words; u8Word++)
+    {
+        pu32Data[u8Word] = EEPROM_EERDWRINC_REG;
+    }
+    return TRUE;
+}
+
+boolean EEPROM_bWrite(uint16 u16Block, uint8 u8Offset, const uint32 *pu32Data, uint8 u8Words)
+{
+    uint8 u8Word;
+
+    if(!EEPROM_bInBlock(u16Block, u8Offset, u8Words))
+    {
+        return FALSE;
+    }
+    EEPROM_vWait();
+    EEPROM_EEBLOCK_REG = u16Block;
+    EEPROM_EEOFFSET_REG = u8Offset;
+    for(u8Word = 0; u8Word < u8Words; u8Word++)
+    {
+        EEPROM_EERDWRINC_REG = pu32Data[u8Word];
+        EEPROM_vWait();
+        if(EEPROM_EEDONE_REG & (EEPROM_EEDONE_NOPERM | EEPROM_EEDONE_WRBUSY))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
@@ -0,0 +1,52 @@
+ /******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom.h
+ *
+ * Description: Header file for the TM4C123GH6PM EEPROM driver: 2 KB in
+ *              EEPROM_BLOCKS_NUM blocks of EEPROM_BLOCK_WORDS 32-bit words,
+ *              read and written a word at a time. A word that was never
+ *              written reads 0xFFFFFFFF.
+ *
+ *              A write waits for the EEPROM to finish, tens of microseconds a
+ *              word and longer when it has to copy a block on the way: write
+ *              from a task that can afford it, never from an interrupt.
+ *
+ *******************************************************************************/
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define EEPROM_BLOCKS_NUM               32
+#define EEPROM_BLOCK_WORDS              16
+
+/* EEDONE and EESUPP fields */
+#define EEPROM_EEDONE_WORKING           0x00000001
+#define EEPROM_EEDONE_NOPERM            0x00000010      /* Write to a protected block */
+#define EEPROM_EEDONE_WRBUSY            0x00000020      /* Write while the EEPROM was busy */
+#define EEPROM_EESUPP_ERRORS            0x0000000C      /* PRETRY and ERETRY: a program or erase failed */
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/*
+ * Clock the EEPROM and recover it from an interrupted write, as the datasheet
+ * asks before its first use. FALSE when it reports a failed program or erase.
+ */
+boolean EEPROM_bInit(void);
+
+/* Read u8Words words from offset u8Offset of block u16Block, FALSE out of the block */
+boolean EEPROM_bRead(uint16 u16Block, uint8 u8Offset, uint32 *pu32Data, uint8 u8Words);
+
+/* Write u8Words words from offset u8Offset of block u16Block, FALSE out of the block or on an error */
+boolean EEPROM_bWrite(uint16 u16Block, uint8 u8Offset, const uint32 *pu32Data, uint8 u8Words);
+
+#endif /* EEPROM_H_ */
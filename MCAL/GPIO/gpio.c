@@ -151,3 +151,34 @@ void GPIO_ExternalEdgeTriggeredInterruptInit(void)
     NVIC_PRI0_REG = (NVIC_PRI0_REG & GPIO_PORTA_PRIORITY_MASK) | (GPIO_PORTA_INTERRUPT_PRIORITY<<GPIO_PORTA_PRIORITY_BITS_POS);
     NVIC_EN0_REG         |= 0x00000001;   /* Enable NVIC Interrupt for GPIO PORTA by set bit number 0 in EN0 Register */
 }
+void GPIO_ButtonsEdgeInterruptsDisable(void)
+{
+    GPIO_PORTF_IM_REG    &= ~((1<<0) | (1<<4));   /* Mask PF0 (SW2) & PF4 (SW1) edge interrupts */
+    GPIO_PORTA_IM_REG    &= ~(1<<4);              /* Mask PA4 (Ext button) edge interrupt */
+    GPIO_PORTF_ICR_REG   |= ((1<<0) | (1<<4));    /* Clear Trigger flags for PF0 & PF4 */
+    GPIO_PORTA_ICR_REG   |= (1<<4);               /* Clear Trigger flag for PA4 */
+}
+void GPIO_ButtonsEdgeInterruptsEnable(void)
+{
+    GPIO_PORTF_ICR_REG   |= ((1<<0) | (1<<4));    /* Drop edges latched while the interrupts were masked */
+    GPIO_PORTA_ICR_REG   |= (1<<4);
+    GPIO_PORTF_IM_REG    |= ((1<<0) | (1<<4));    /* Unmask PF0 (SW2) & PF4 (SW1) edge interrupts */
+    GPIO_PORTA_IM_REG    |= (1<<4);               /* Unmask PA4 (Ext button) edge interrupt */
+}
+
+void GPIO_PortBOutputsInit(uint8 u8Pins)
+{
+    SYSCTL_RCGCGPIO_REG |= 0x02;
+    while(!(SYSCTL_PRGPIO_REG & 0x02));
+
+    GPIO_PORTB_AMSEL_REG &= ~u8Pins;
+    GPIO_PORTB_AFSEL_REG &= ~u8Pins;
+    GPIO_PORTB_DIR_REG   |= u8Pins;
+    GPIO_PORTB_DEN_REG   |= u8Pins;
+    GPIO_PORTB_DATA_MASKED(u8Pins) = 0;         /* Start low */
+}
+
+void GPIO_PortBWrite(uint8 u8Pins, uint8 u8Levels)
+{
+    GPIO_PORTB_DATA_MASKED(u8Pins) = u8Levels;  /* Only the u8Pins bits are written */
+}
@@ -23,6 +23,9 @@
 #define GPIO_PORTA_PRIORITY_BITS_POS  5
 #define GPIO_PORTA_INTERRUPT_PRIORITY 5
 
+/* PORTB DATA at the address that masks the access to the pins of PINS: word PINS of the port */
+#define GPIO_PORTB_DATA_MASKED(PINS)  (((volatile uint32 *)0x40005000)[(PINS)])
+
 #define PRESSED                ((uint8)0x00)
 #define RELEASED               ((uint8)0x01)
 
@@ -47,5 +50,13 @@ uint8 GPIO_ExtButtonGetState(void);
 
 void GPIO_SW1EdgeTriggeredInterruptInit(void);
 void GPIO_SW2EdgeTriggeredInterruptInit(void);
+void GPIO_ExternalEdgeTriggeredInterruptInit(void);
+
+void GPIO_ButtonsEdgeInterruptsDisable(void);
+void GPIO_ButtonsEdgeInterruptsEnable(void);
+
+/* Pins of PORTB as plain outputs, driven low, and a write of only the u8Pins levels */
+void GPIO_PortBOutputsInit(uint8 u8Pins);
+void GPIO_PortBWrite(uint8 u8Pins, uint8 u8Levels);
 
 #endif /* GPIO_H_ */
@@ -10,21 +10,61 @@
  *
  *******************************************************************************/
 #include "GPTM.h"
+#include "clock.h"
 #include "tm4c123gh6pm_registers.h"
 
 void GPTM_WTimer0Init(void)
 {
-    /* Configure one shot down 32bit timer with tick time = 0.1msec */
+    /* Configure periodic up 64bit timer with tick time = 1 system clock cycle (no prescaler when concatenated) */
     SYSCTL_RCGCWTIMER_REG |= (1<<0);  /* Enable clock WTimer0 in run mode */
-    WTIMER0_CTL_REG = 0;              /* Disable WTimer0 output */
-    WTIMER0_CFG_REG = 0x04;           /* Select 32-bit configuration option */
-    WTIMER0_TAMR_REG = 0x01;          /* Select one-shot down counter mode of WTimer0A */
-    WTIMER0_TAPR_REG = 1600 -1;       /* Set the prescaler for WTimer0A */
-    WTIMER0_CTL_REG |= (0x01);        /* Enable WTimer0A module */
+    WTIMER0_CTL_REG = 0;              /* Disable WTimer0 while configuring it */
+    WTIMER0_CFG_REG = GPTM_CFG_CONCATENATED;                /* Select 64-bit configuration option */
+    WTIMER0_TAMR_REG = GPTM_TAMR_PERIODIC | GPTM_TAMR_TACDIR_UP;  /* Select periodic up counter mode */
+    WTIMER0_TAILR_REG = 0xFFFFFFFF;   /* Count through the whole 64-bit range */
+    WTIMER0_TBILR_REG = 0xFFFFFFFF;
+    WTIMER0_CTL_REG = GPTM_CTL_TAEN_MASK;  /* Enable WTimer0 */
 }
 
-uint32 GPTM_WTimer0Read(void)
+uint64 GPTM_WTimer0Read(void)
 {
-    return (uint32) (0xFFFFFFFFUL - WTIMER0_TAR_REG);
+    uint32 u32High;
+    uint32 u32Low;
+
+    /* TAR holds the low word and TBR the high word; read again if the low word wrapped in between */
+    do
+    {
+        u32High = WTIMER0_TBR_REG;
+        u32Low = WTIMER0_TAR_REG;
+    }
+    while(u32High != WTIMER0_TBR_REG);
+
+    return ((uint64)u32High << 32) | u32Low;
+}
+
+uint32 GPTM_WTimer0Read32(void)
+{
+    return WTIMER0_TAR_REG;
+}
+
+uint64 GPTM_WTimer0ReadUs(void)
+{
+    return GPTM_WTimer0Read() / CLOCK_CYCLES_PER_US;
 }
 
+void GPTM_WTimer0DelayUs(uint32 u32Us)
+{
+    uint64 u64End = GPTM_WTimer0Read() + ((uint64)u32Us * CLOCK_CYCLES_PER_US);
+
+    while(GPTM_WTimer0Read() < u64End);
+}
+
+void GPTM_Timer0ADCTriggerInit(uint32 u32PeriodTicks)
+{
+    SYSCTL_RCGCTIMER_REG |= (1<<0);               /* Enable clock Timer0 in run mode */
+    while(!(SYSCTL_PRTIMER_REG & (1<<0)));        /* Wait until Timer0 is ready */
+    TIMER0_CTL_REG = 0;                           /* Disable Timer0 while configuring it */
+    TIMER0_CFG_REG = 0x00;                        /* Select 32-bit configuration option */
+    TIMER0_TAMR_REG = 0x02;                       /* Select periodic down counter mode of Timer0A */
+    TIMER0_TAILR_REG = u32PeriodTicks - 1;        /* Timeout (and ADC trigger) every u32PeriodTicks */
+    TIMER0_CTL_REG = GPTM_CTL_TAOTE_MASK | GPTM_CTL_TAEN_MASK;  /* Enable Timer0A with its ADC trigger */
+}
@@ -15,8 +15,46 @@
 
 #include "std_types.h"
 
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define GPTM_CTL_TAEN_MASK          0x00000001      /* Timer A enable */
+#define GPTM_CTL_TAOTE_MASK         0x00000020      /* Timer A ADC trigger output enable */
+
+#define GPTM_CFG_CONCATENATED       0x00000000      /* 32-bit (TIMER) or 64-bit (WTIMER) timer */
+#define GPTM_TAMR_PERIODIC          0x00000002
+#define GPTM_TAMR_TACDIR_UP         0x00000010      /* Count up from zero */
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/*
+ * WTimer0 as the system timebase: a free running 64-bit counter of system
+ * clock cycles, periodic and counting up, so it never stops and does not
+ * wrap in the life of the device. The reads take no lock and are safe from
+ * task and interrupt context.
+ */
 void GPTM_WTimer0Init(void);
-uint32 GPTM_WTimer0Read(void);
+
+/* System clock cycles since GPTM_WTimer0Init */
+uint64 GPTM_WTimer0Read(void);
+
+/* Low 32 bits of the count, one register read; for intervals shorter than 2^32 cycles */
+uint32 GPTM_WTimer0Read32(void);
+
+/* Microseconds since GPTM_WTimer0Init, costs a 64-bit division by a constant */
+uint64 GPTM_WTimer0ReadUs(void);
+
+/* Busy wait u32Us microseconds, to the system clock cycle */
+void GPTM_WTimer0DelayUs(uint32 u32Us);
+
+/*
+ * Timer0A as a 32-bit periodic timer that triggers the ADC sample sequencers
+ * configured with ADC_TRIGGER_TIMER every u32PeriodTicks system clock cycles.
+ */
+void GPTM_Timer0ADCTriggerInit(uint32 u32PeriodTicks);
 
 
 #endif /* GPTM_H_ */
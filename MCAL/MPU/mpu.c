@@ -0,0 +1,42 @@
+ /******************************************************************************
+ *
+ * Module: MPU
+ *
+ * File Name: mpu.c
+ *
+ * Description: Source file for the Cortex-M4 MPU
+ *
+ *******************************************************************************/
+
+#include "mpu.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* SIZE field of a MPU_GUARD_SIZE region: 2^(4 + 1) = 32 bytes */
+#define MPU_GUARD_SIZE_FIELD            4
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void MPU_vInit(void)
+{
+    MPU_CTRL_REG = MPU_CTRL_ENABLE_MASK | MPU_CTRL_PRIVDEFENA_MASK;
+    NVIC_SYSTEM_SYSHNDCTRL |= MPU_SYSHNDCTRL_MEM_MASK;     /* MPU fault instead of a hard fault */
+}
+
+void MPU_vSetGuard(uint8 u8Region, uint32 u32Address)
+{
+    MPU_BASE_REG = u32Address | MPU_BASE_VALID_MASK | u8Region;
+    MPU_ATTR_REG = MPU_ATTR_XN_MASK | MPU_ATTR_AP_NO_ACCESS |
+                   (MPU_GUARD_SIZE_FIELD << MPU_ATTR_SIZE_SHIFT) | MPU_ATTR_ENABLE_MASK;
+}
+
+void MPU_vMoveGuard(uint8 u8Region, uint32 u32Address)
+{
+    /* The attributes of the region stay, the base register also selects it */
+    MPU_BASE_REG = u32Address | MPU_BASE_VALID_MASK | u8Region;
+}
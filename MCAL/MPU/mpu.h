@@ -0,0 +1,55 @@
+ /******************************************************************************
+ *
+ * Module: MPU
+ *
+ * File Name: mpu.h
+ *
+ * Description: Header file for the Cortex-M4 MPU, used for no access guard
+ *              regions under the stacks. The default memory map stays in
+ *              force everywhere else (PRIVDEFENA), so the guards cost nothing
+ *              until something touches them, which raises the MPU fault.
+ *
+ *******************************************************************************/
+
+#ifndef MPU_H_
+#define MPU_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define MPU_CTRL_ENABLE_MASK            0x00000001
+#define MPU_CTRL_PRIVDEFENA_MASK        0x00000004      /* Default memory map outside the regions */
+#define MPU_BASE_VALID_MASK             0x00000010      /* Region number taken from the base register */
+#define MPU_ATTR_ENABLE_MASK            0x00000001
+#define MPU_ATTR_SIZE_SHIFT             1               /* Region of 2^(SIZE + 1) bytes */
+#define MPU_ATTR_AP_NO_ACCESS           0x00000000
+#define MPU_ATTR_XN_MASK                0x10000000
+#define MPU_SYSHNDCTRL_MEM_MASK         0x00010000      /* MPU fault enable */
+
+/* Smallest region, a guard is one of these, aligned on its size */
+#define MPU_GUARD_SIZE                  32
+
+/* Regions used by the stack guards */
+#define MPU_REGION_MAIN_STACK_GUARD     0
+#define MPU_REGION_TASK_STACK_GUARD     1
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Enable the MPU and its fault, the regions set with MPU_vSetGuard only */
+void MPU_vInit(void);
+
+/*
+ * Make the MPU_GUARD_SIZE bytes at u32Address, which must be aligned on
+ * MPU_GUARD_SIZE, a no access region
+ */
+void MPU_vSetGuard(uint8 u8Region, uint32 u32Address);
+
+/* Move a guard set by MPU_vSetGuard, a single register write */
+void MPU_vMoveGuard(uint8 u8Region, uint32 u32Address);
+
+#endif /* MPU_H_ */
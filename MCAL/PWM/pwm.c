@@ -0,0 +1,92 @@
+ /******************************************************************************
+ *
+ * Module: PWM
+ *
+ * File Name: pwm.c
+ *
+ * Description: Source file for the TM4C123GH6PM PWM driver
+ *
+ *******************************************************************************/
+
+#include "pwm.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 PWM0_u32Load;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void PWM0_vInit(uint16 u16PeriodCycles)
+{
+    SYSCTL_RCGCPWM_REG |= (1<<0);                 /* Enable clock of PWM0 */
+    SYSCTL_RCGCGPIO_REG |= (1<<1);                /* Enable clock of PORTB */
+    while(!(SYSCTL_PRPWM_REG & (1<<0)));
+    while(!(SYSCTL_PRGPIO_REG & (1<<1)));
+
+    PWM0_u32Load = (uint32)u16PeriodCycles - 1;
+
+    /* Generators stopped while they are set up, counting down from LOAD */
+    PWM0_0_CTL_REG = 0;
+    PWM0_1_CTL_REG = 0;
+    PWM0_0_LOAD_REG = PWM0_u32Load;
+    PWM0_1_LOAD_REG = PWM0_u32Load;
+    PWM0_0_GENA_REG = PWM_GEN_ALWAYS_LOW;
+    PWM0_0_GENB_REG = PWM_GEN_ALWAYS_LOW;
+    PWM0_1_GENA_REG = PWM_GEN_ALWAYS_LOW;
+    PWM0_1_GENB_REG = PWM_GEN_ALWAYS_LOW;
+    PWM0_0_CTL_REG = PWM_GEN_CTL_ENABLE;
+    PWM0_1_CTL_REG = PWM_GEN_CTL_ENABLE;
+    PWM0_ENABLE_REG |= 0x0F;                      /* M0PWM0..3 driven by their generators */
+
+    /* PB4..PB7 as M0PWM outputs */
+    GPIO_PORTB_AMSEL_REG &= ~PWM0_PINS_MASK;
+    GPIO_PORTB_PCTL_REG  = (GPIO_PORTB_PCTL_REG & 0x0000FFFF) |
+                           (PWM_PCTL_M0PWM << 16) | (PWM_PCTL_M0PWM << 20) |
+                           (PWM_PCTL_M0PWM << 24) | (PWM_PCTL_M0PWM << 28);
+    GPIO_PORTB_AFSEL_REG |= PWM0_PINS_MASK;
+    GPIO_PORTB_DEN_REG   |= PWM0_PINS_MASK;
+}
+
+void PWM0_vSetDuty(uint8 u8Output, uint16 u16Permille)
+{
+    /* Generator 0 drives outputs 0 (A) and 1 (B), generator 1 outputs 2 and 3 */
+    volatile uint32 *pu32Gen;
+    volatile uint32 *pu32Cmp;
+    uint32 u32Action;
+
+    if(u8Output >= PWM0_OUTPUTS_NUM)
+    {
+        return;
+    }
+    if(u8Output < 2)
+    {
+        pu32Gen = (u8Output == 0) ? &PWM0_0_GENA_REG : &PWM0_0_GENB_REG;
+        pu32Cmp = (u8Output == 0) ? &PWM0_0_CMPA_REG : &PWM0_0_CMPB_REG;
+    }
+    else
+    {
+        pu32Gen = (u8Output == 2) ? &PWM0_1_GENA_REG : &PWM0_1_GENB_REG;
+        pu32Cmp = (u8Output == 2) ? &PWM0_1_CMPA_REG : &PWM0_1_CMPB_REG;
+    }
+    u32Action = ((u8Output & 1) == 0) ? PWM_GENA_HIGH_TO_CMPA : PWM_GENB_HIGH_TO_CMPB;
+
+    if(u16Permille == 0)
+    {
+        *pu32Gen = PWM_GEN_ALWAYS_LOW;
+    }
+    else if(u16Permille >= PWM_DUTY_FULL)
+    {
+        *pu32Gen = PWM_GEN_ALWAYS_HIGH;
+    }
+    else
+    {
+        /* High from LOAD down to the compare value */
+        *pu32Cmp = PWM0_u32Load - (((PWM0_u32Load + 1) * u16Permille) / PWM_DUTY_FULL);
+        *pu32Gen = u32Action;
+    }
+}
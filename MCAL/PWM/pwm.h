@@ -0,0 +1,54 @@
+ /******************************************************************************
+ *
+ * Module: PWM
+ *
+ * File Name: pwm.h
+ *
+ * Description: Header file for the TM4C123GH6PM PWM driver: the four outputs of
+ *              PWM0 generators 0 and 1, edge aligned at one common period
+ *
+ *******************************************************************************/
+
+#ifndef PWM_H_
+#define PWM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Outputs M0PWM0..3 on PB6, PB7, PB4 and PB5 */
+#define PWM0_OUTPUTS_NUM                4
+#define PWM0_PINS_MASK                  0xF0
+
+#define PWM_DUTY_FULL                   1000    /* Duty cycles are in permille */
+
+/* PWMnCTL, PWMnGENA/B fields */
+#define PWM_GEN_CTL_ENABLE              0x00000001      /* Count down from LOAD, compares update at zero */
+#define PWM_GEN_ALWAYS_LOW              0x00000008      /* Low on LOAD, no other action */
+#define PWM_GEN_ALWAYS_HIGH             0x0000000C      /* High on LOAD, no other action */
+#define PWM_GENA_HIGH_TO_CMPA           0x0000008C      /* High on LOAD, low on CMPA counting down */
+#define PWM_GENB_HIGH_TO_CMPB           0x0000080C      /* High on LOAD, low on CMPB counting down */
+
+#define PWM_PCTL_M0PWM                  4
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/*
+ * Run PWM0 generators 0 and 1 at a period of u16PeriodCycles system clock
+ * cycles (at least PWM_DUTY_FULL), PWM clock undivided, and route outputs
+ * 0..3 to their pins. Every output starts low.
+ */
+void PWM0_vInit(uint16 u16PeriodCycles);
+
+/*
+ * Duty cycle of output u8Output in permille, taken at the next end of its
+ * period so that no pulse is cut short. 0 and PWM_DUTY_FULL hold the output low
+ * and high, without any edge.
+ */
+void PWM0_vSetDuty(uint8 u8Output, uint16 u16Permille);
+
+#endif /* PWM_H_ */
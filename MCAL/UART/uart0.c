@@ -11,8 +11,37 @@
  *******************************************************************************/
 
 #include "uart0.h"
+#include "udma.h"
+#include "clock.h"
 #include "tm4c123gh6pm_registers.h"
 
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define UART0_TX_RING_MASK       (UART0_TX_RING_SIZE - 1)
+#define UART0_TX_UDMA_CHANNEL    9       /* UART0 TX, channel encoding 0 */
+
+/* Bytes from the ring into the data register, 8 per arbitration (the FIFO has 14 free at the trigger level) */
+#define UART0_TX_UDMA_CONTROL    (UDMA_CTL_DST_INC_NONE | UDMA_CTL_DST_SIZE_8 | \
+                                  UDMA_CTL_SRC_INC_8 | UDMA_CTL_SRC_SIZE_8 | UDMA_CTL_ARB_8)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/*
+ * The producer only moves u16TxHead and the interrupt/uDMA side only moves
+ * u16TxTail, so the ring needs no lock. The indices run free and are masked
+ * on access; Head - Tail is the number of queued bytes.
+ */
+static uint8 UART0_au8TxRing[UART0_TX_RING_SIZE];
+static volatile uint16 UART0_u16TxHead;
+static volatile uint16 UART0_u16TxTail;
+static volatile uint16 UART0_u16TxDmaLength;     /* Bytes of the uDMA transfer in progress */
+static uint8 UART0_u8TxMode = UART0_TX_MODE_POLLING;
+static uint32 UART0_u32TxDropped;
+
 /*******************************************************************************
  *                         Private Functions Definitions                       *
  *******************************************************************************/
@@ -31,6 +60,64 @@ static void GPIO_SetupUART0Pins(void)
     GPIO_PORTA_DEN_REG   |= 0x03;         /* Enable Digital I/O on PA0 & PA1 */
 }
 
+/* Top the TX FIFO up from the ring; keep the TX interrupt on while the ring holds bytes */
+static void UART0_TxRefill(void)
+{
+    uint16 u16Tail = UART0_u16TxTail;
+
+    while((u16Tail != UART0_u16TxHead) && !(UART0_FR_REG & UART_FR_TXFF_MASK))
+    {
+        UART0_DR_REG = UART0_au8TxRing[u16Tail & UART0_TX_RING_MASK];
+        u16Tail++;
+    }
+    UART0_u16TxTail = u16Tail;
+
+    if(u16Tail != UART0_u16TxHead)
+    {
+        UART0_IM_REG |= UART_IM_TXIM_MASK;
+    }
+    else
+    {
+        UART0_IM_REG &= ~UART_IM_TXIM_MASK;
+    }
+}
+
+/* Hand the ring to the uDMA, up to its end; the rest goes with the next transfer */
+static void UART0_TxDmaStart(void)
+{
+    uint16 u16Tail = UART0_u16TxTail;
+    uint16 u16Length = (uint16)(UART0_u16TxHead - u16Tail);
+    uint16 u16ToEnd = UART0_TX_RING_SIZE - (u16Tail & UART0_TX_RING_MASK);
+
+    if(u16Length == 0)
+    {
+        return;
+    }
+    if(u16Length > u16ToEnd)
+    {
+        u16Length = u16ToEnd;
+    }
+    UART0_u16TxDmaLength = u16Length;
+    UDMA_vSetTransfer(UART0_TX_UDMA_CHANNEL, UDMA_PRIMARY, &UART0_au8TxRing[u16Tail & UART0_TX_RING_MASK],
+                      &UART0_DR_REG, UART0_TX_UDMA_CONTROL, u16Length, UDMA_MODE_BASIC);
+    UDMA_vChannelEnable(UART0_TX_UDMA_CHANNEL);
+}
+
+/* Start the transmitter on newly queued bytes, with the UART interrupt held off */
+static void UART0_TxKick(void)
+{
+    NVIC_DIS0_REG = (1UL << UART0_IRQ_NUM);
+    if(UART0_u8TxMode == UART0_TX_MODE_INTERRUPT)
+    {
+        UART0_TxRefill();
+    }
+    else if(UART0_u16TxDmaLength == 0)
+    {
+        UART0_TxDmaStart();
+    }
+    NVIC_EN0_REG = (1UL << UART0_IRQ_NUM);
+}
+
 /*******************************************************************************
  *                         Public Functions Definitions                        *
  *******************************************************************************/
@@ -47,20 +134,24 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
 
     UART0_CC_REG  = 0;                    /* Use System Clock*/
     
-    /* To Configure UART0 with Baud Rate 9600 */
-    UART0_IBRD_REG = 104;
-    UART0_FBRD_REG = 11;
+    /* To Configure UART0 with Baud Rate 9600, divisors derived from the system clock */
+    UART0_IBRD_REG = CLOCK_UART_IBRD(UART0_BAUD_RATE);
+    UART0_FBRD_REG = CLOCK_UART_FBRD(UART0_BAUD_RATE);
     
     /* UART Line Control Register Settings
      * BRK = 0 Normal Use
      * PEN = 0 Disable Parity
      * EPS = 0 No affect as the parity is disabled
      * STP2 = 0 1-stop bit at end of the frame
-     * FEN = 0 FIFOs are disabled
+     * FEN = 1 FIFOs are enabled
      * WLEN = 0x3 8-bits data frame
      * SPS = 0 no stick parity
      */
-    UART0_LCRH_REG = (UART_DATA_8BITS << UART_LCRH_WLEN_BITS_POS);
+    UART0_LCRH_REG = (UART_DATA_8BITS << UART_LCRH_WLEN_BITS_POS) | UART_LCRH_FEN_MASK;
+
+    /* TX interrupt (and uDMA burst request) when the TX FIFO is down to 1/8 */
+    UART0_IFLS_REG = UART_IFLS_TX1_8;
+    NVIC_PRI1_REG = (NVIC_PRI1_REG & UART0_PRIORITY_MASK) | (UART0_INTERRUPT_PRIORITY << UART0_PRIORITY_BITS_POS);
     
     /* UART Control Register Settings
      * RXE = 1 Enable UART Receive
@@ -71,10 +162,105 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
     UART0_CTL_REG = UART_CTL_UARTEN_MASK | UART_CTL_TXE_MASK | UART_CTL_RXE_MASK;
 }
        
+void UART0_SetTxMode(uint8 u8Mode)
+{
+    NVIC_DIS0_REG = (1UL << UART0_IRQ_NUM);
+    UART0_IM_REG &= ~UART_IM_TXIM_MASK;
+    UART0_u8TxMode = u8Mode;
+
+    if(u8Mode == UART0_TX_MODE_DMA)
+    {
+        UDMA_vChannelDisable(UART0_TX_UDMA_CHANNEL);
+        UDMA_ALTCLR_REG = (1UL << UART0_TX_UDMA_CHANNEL);
+        UDMA_REQMASKCLR_REG = (1UL << UART0_TX_UDMA_CHANNEL);
+        UART0_DMACTL_REG |= UART_DMACTL_TXDMAE_MASK;
+    }
+    else
+    {
+        UART0_DMACTL_REG &= ~UART_DMACTL_TXDMAE_MASK;
+    }
+
+    if(u8Mode != UART0_TX_MODE_POLLING)
+    {
+        NVIC_EN0_REG = (1UL << UART0_IRQ_NUM);
+    }
+}
+
+uint16 UART0_Write(const uint8 *pData, uint16 u16Length)
+{
+    uint16 u16Head = UART0_u16TxHead;
+    uint16 u16Free = UART0_TX_RING_SIZE - (uint16)(u16Head - UART0_u16TxTail);
+    uint16 u16Counter;
+
+    if(UART0_u8TxMode == UART0_TX_MODE_POLLING)
+    {
+        for(u16Counter = 0; u16Counter < u16Length; u16Counter++)
+        {
+            while(UART0_FR_REG & UART_FR_TXFF_MASK); /* Wait until the transmit FIFO has room */
+            UART0_DR_REG = pData[u16Counter]; /* Send the byte */
+        }
+        return u16Length;
+    }
+
+    if(u16Length > u16Free)
+    {
+        UART0_u32TxDropped += u16Length - u16Free;
+        u16Length = u16Free;
+    }
+    for(u16Counter = 0; u16Counter < u16Length; u16Counter++)
+    {
+        UART0_au8TxRing[u16Head & UART0_TX_RING_MASK] = pData[u16Counter];
+        u16Head++;
+    }
+    UART0_u16TxHead = u16Head;  /* Publish the bytes only once they are in the ring */
+
+    if(u16Length != 0)
+    {
+        UART0_TxKick();
+    }
+    return u16Length;
+}
+
+uint16 UART0_TxSpace(void)
+{
+    return UART0_TX_RING_SIZE - (uint16)(UART0_u16TxHead - UART0_u16TxTail);
+}
+
+boolean UART0_TxIdle(void)
+{
+    return ((UART0_u16TxHead == UART0_u16TxTail) && (UART0_u16TxDmaLength == 0) &&
+            !(UART0_FR_REG & UART_FR_BUSY_MASK)) ? TRUE : FALSE;
+}
+
+uint32 UART0_TxDroppedBytes(void)
+{
+    return UART0_u32TxDropped;
+}
+
+void UART0_Handler(void)
+{
+    UART0_ICR_REG = UART_ICR_TXIC_MASK;
+
+    if(UART0_u8TxMode == UART0_TX_MODE_DMA)
+    {
+        /* The uDMA completion of the TX channel is signalled on the UART0 vector */
+        if(UDMA_CHIS_REG & (1UL << UART0_TX_UDMA_CHANNEL))
+        {
+            UDMA_vClearInterrupt(UART0_TX_UDMA_CHANNEL);
+            UART0_u16TxTail += UART0_u16TxDmaLength;
+            UART0_u16TxDmaLength = 0;
+            UART0_TxDmaStart();
+        }
+    }
+    else
+    {
+        UART0_TxRefill();
+    }
+}
+
 void UART0_SendByte(uint8 data)
 {
-    while(!(UART0_FR_REG & UART_FR_TXFE_MASK)); /* Wait until the transmit FIFO is empty */
-    UART0_DR_REG = data; /* Send the byte */
+    (void)UART0_Write(&data, 1);
 }
 
 uint8 UART0_ReceiveByte(void)
@@ -83,41 +269,54 @@ uint8 UART0_ReceiveByte(void)
     return UART0_DR_REG; /* Read the byte */
 }
 
+boolean UART0_TryReceiveByte(uint8 *pData)
+{
+    if(UART0_FR_REG & UART_FR_RXFE_MASK)
+    {
+        return FALSE;
+    }
+    *pData = (uint8)UART0_DR_REG;
+    return TRUE;
+}
+
 void UART0_SendString(const uint8 *pData)
 {
     uint32 uCounter =0;
-	/* Transmit the whole string */
+    /* Find the end of the string and transmit it in one go */
     while(pData[uCounter] != '\0')
     {
-        UART0_SendByte(pData[uCounter]); /* Send the byte */
         uCounter++; /* increment the counter to the next byte */
     }
+    (void)UART0_Write(pData, (uint16)uCounter);
 }
 
 void UART0_SendInteger(sint64 sNumber)
 {
 
-    uint8 uDigits[20];
-    sint8 uCounter = 0;
+    uint8 uDigits[21];
+    sint8 uCounter = sizeof(uDigits);
+    boolean bNegative = FALSE;
 
     /* Send the negative sign in case of negative numbers */
     if (sNumber < 0)
     {
-        UART0_SendByte('-');
+        bNegative = TRUE;
         sNumber *= -1;
     }
 
-    /* Convert the number to an array of characters */
+    /* Convert the number to characters, filling the array from its end as the digits come right to left */
     do
     {
-        uDigits[uCounter++] = sNumber % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
+        uDigits[--uCounter] = sNumber % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
         sNumber /= 10; /* Remove the already converted digit */
     }
     while (sNumber != 0);
 
-    /* Send the array of characters in a reverse order as the digits were converted from right to left */
-    for( uCounter--; uCounter>= 0; uCounter--)
+    if (bNegative)
     {
-        UART0_SendByte(uDigits[uCounter]);
+        uDigits[--uCounter] = '-';
     }
+
+    /* Send the whole number in one go */
+    (void)UART0_Write(&uDigits[uCounter], (uint16)(sizeof(uDigits) - uCounter));
 }
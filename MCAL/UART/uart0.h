@@ -28,6 +28,28 @@
 #define UART_CTL_RXE_MASK        0x00000200
 #define UART_FR_TXFE_MASK        0x00000080
 #define UART_FR_RXFE_MASK        0x00000010
+#define UART_FR_TXFF_MASK        0x00000020
+#define UART_FR_BUSY_MASK        0x00000008
+#define UART_LCRH_FEN_MASK       0x00000010
+#define UART_IFLS_TX1_8          0x00000000      /* TX interrupt when the FIFO is down to 2 bytes */
+#define UART_IM_TXIM_MASK        0x00000020
+#define UART_ICR_TXIC_MASK       0x00000020
+#define UART_DMACTL_TXDMAE_MASK  0x00000002
+
+#define UART0_BAUD_RATE          9600
+
+#define UART0_IRQ_NUM            5
+#define UART0_PRIORITY_MASK      0xFFFF1FFF
+#define UART0_PRIORITY_BITS_POS  13
+#define UART0_INTERRUPT_PRIORITY 5
+
+/* Transmit ring, a power of 2 so the free running indices wrap with it */
+#define UART0_TX_RING_SIZE       512
+
+/* How the transmitter is fed, see UART0_SetTxMode() */
+#define UART0_TX_MODE_POLLING    0       /* Send functions wait for room in the TX FIFO */
+#define UART0_TX_MODE_INTERRUPT  1       /* TX interrupt refills the FIFO from the ring */
+#define UART0_TX_MODE_DMA        2       /* uDMA feeds the FIFO from the ring */
 
 /*******************************************************************************
  *                            Functions Prototypes                             *
@@ -35,10 +57,37 @@
 
 extern void UART0_Init(void);
 
+/*
+ * Select how transmitted bytes reach the FIFO. In the interrupt and DMA modes
+ * the send functions copy into the transmit ring and return at once; bytes that
+ * do not fit are dropped and counted. The ring has a single producer: callers
+ * must not send from several tasks at the same time. Switch modes only while
+ * UART0_TxIdle() is TRUE. The DMA mode needs UDMA_vInit() first.
+ */
+extern void UART0_SetTxMode(uint8 u8Mode);
+
+/* Queue (or, polling, send) u16Length bytes; returns how many were accepted */
+extern uint16 UART0_Write(const uint8 *pData, uint16 u16Length);
+
+/* Bytes UART0_Write can take right now without dropping any (interrupt and DMA modes) */
+extern uint16 UART0_TxSpace(void);
+
+/* TRUE once every byte sent so far has left the transmitter */
+extern boolean UART0_TxIdle(void);
+
+/* Bytes dropped because the transmit ring was full */
+extern uint32 UART0_TxDroppedBytes(void);
+
+/* UART0 interrupt, transmit side */
+extern void UART0_Handler(void);
+
 extern void UART0_SendByte(uint8 data);
 
 extern uint8 UART0_ReceiveByte(void);
 
+/* Take a received byte without waiting: FALSE when the receive FIFO is empty */
+extern boolean UART0_TryReceiveByte(uint8 *pData);
+
 extern void UART0_SendString(const uint8 *pData);
 
 extern void UART0_SendInteger(sint64 sNumber);
@@ -0,0 +1,87 @@
+ /******************************************************************************
+ *
+ * Module: UDMA
+ *
+ * File Name: udma.c
+ *
+ * Description: Source file for the TM4C123GH6PM micro DMA controller driver
+ *
+ *******************************************************************************/
+
+#include "udma.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    volatile uint32 u32SrcEnd;
+    volatile uint32 u32DstEnd;
+    volatile uint32 u32Control;
+    uint32 u32Reserved;
+} UDMA_ControlStructure;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Primary structures of channels 0..31 followed by their alternate structures,
+ * the controller requires the table on a 1024 byte boundary */
+static UDMA_ControlStructure UDMA_axControlTable[2 * UDMA_CHANNELS_NUM] __attribute__((aligned(1024)));
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Address increment in bytes of a DSTINC/SRCINC field, 0 for no increment */
+static uint32 UDMA_u32Increment(uint32 u32IncField)
+{
+    return (u32IncField == 3) ? 0 : (1UL << u32IncField);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void UDMA_vInit(void)
+{
+    SYSCTL_RCGCDMA_REG |= (1<<0);                 /* Enable clock of the uDMA module */
+    while(!(SYSCTL_PRDMA_REG & (1<<0)));          /* Wait until the uDMA module is ready */
+    UDMA_CFG_REG = UDMA_CFG_MASTEN_MASK;          /* Enable the controller */
+    UDMA_CTLBASE_REG = (uint32)UDMA_axControlTable;
+}
+
+void UDMA_vSetTransfer(uint8 u8Channel, uint8 u8Structure, const volatile void *pvSrc,
+                       volatile void *pvDst, uint32 u32Control, uint16 u16Items, uint8 u8Mode)
+{
+    UDMA_ControlStructure *pxStructure = &UDMA_axControlTable[(u8Structure * UDMA_CHANNELS_NUM) + u8Channel];
+    uint32 u32Last = (uint32)u16Items - 1;
+
+    pxStructure->u32SrcEnd = (uint32)pvSrc + (u32Last * UDMA_u32Increment((u32Control >> 26) & 0x3));
+    pxStructure->u32DstEnd = (uint32)pvDst + (u32Last * UDMA_u32Increment((u32Control >> 30) & 0x3));
+    pxStructure->u32Control = (u32Control & ~(UDMA_CTL_XFERSIZE_MASK | UDMA_CTL_MODE_MASK)) |
+                              ((u32Last << UDMA_CTL_XFERSIZE_BITS_POS) & UDMA_CTL_XFERSIZE_MASK) |
+                              (u8Mode & UDMA_CTL_MODE_MASK);
+}
+
+uint8 UDMA_u8TransferMode(uint8 u8Channel, uint8 u8Structure)
+{
+    return (uint8)(UDMA_axControlTable[(u8Structure * UDMA_CHANNELS_NUM) + u8Channel].u32Control & UDMA_CTL_MODE_MASK);
+}
+
+void UDMA_vChannelEnable(uint8 u8Channel)
+{
+    UDMA_ENASET_REG = (1UL << u8Channel);
+}
+
+void UDMA_vChannelDisable(uint8 u8Channel)
+{
+    UDMA_ENACLR_REG = (1UL << u8Channel);
+}
+
+void UDMA_vClearInterrupt(uint8 u8Channel)
+{
+    UDMA_CHIS_REG = (1UL << u8Channel);
+}
@@ -0,0 +1,89 @@
+ /******************************************************************************
+ *
+ * Module: UDMA
+ *
+ * File Name: udma.h
+ *
+ * Description: Header file for the TM4C123GH6PM micro DMA controller driver
+ *
+ *******************************************************************************/
+
+#ifndef UDMA_H_
+#define UDMA_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define UDMA_CHANNELS_NUM               32
+#define UDMA_MAX_TRANSFER_ITEMS         1024
+
+/* Channel numbers with their default (encoding 0) peripheral */
+#define UDMA_CHANNEL_ADC0_SS0           14
+#define UDMA_CHANNEL_ADC0_SS1           15
+#define UDMA_CHANNEL_ADC0_SS2           16
+#define UDMA_CHANNEL_ADC0_SS3           17
+
+/* Control structure of a channel */
+#define UDMA_PRIMARY                    0
+#define UDMA_ALTERNATE                  1
+
+/* Channel control word fields */
+#define UDMA_CTL_DST_INC_8              0x00000000
+#define UDMA_CTL_DST_INC_16             0x40000000
+#define UDMA_CTL_DST_INC_32             0x80000000
+#define UDMA_CTL_DST_INC_NONE           0xC0000000
+#define UDMA_CTL_DST_SIZE_8             0x00000000
+#define UDMA_CTL_DST_SIZE_16            0x10000000
+#define UDMA_CTL_DST_SIZE_32            0x20000000
+#define UDMA_CTL_SRC_INC_8              0x00000000
+#define UDMA_CTL_SRC_INC_16             0x04000000
+#define UDMA_CTL_SRC_INC_32             0x08000000
+#define UDMA_CTL_SRC_INC_NONE           0x0C000000
+#define UDMA_CTL_SRC_SIZE_8             0x00000000
+#define UDMA_CTL_SRC_SIZE_16            0x01000000
+#define UDMA_CTL_SRC_SIZE_32            0x02000000
+#define UDMA_CTL_ARB_1                  0x00000000
+#define UDMA_CTL_ARB_2                  0x00004000
+#define UDMA_CTL_ARB_4                  0x00008000
+#define UDMA_CTL_ARB_8                  0x0000C000
+#define UDMA_CTL_XFERSIZE_MASK          0x00003FF0
+#define UDMA_CTL_XFERSIZE_BITS_POS      4
+#define UDMA_CTL_MODE_MASK              0x00000007
+
+/* Transfer modes */
+#define UDMA_MODE_STOP                  0x0
+#define UDMA_MODE_BASIC                 0x1
+#define UDMA_MODE_AUTO                  0x2
+#define UDMA_MODE_PINGPONG              0x3
+
+#define UDMA_CFG_MASTEN_MASK            0x00000001
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Enable the controller and point it at the channel control table */
+void UDMA_vInit(void);
+
+/*
+ * Program one control structure of a channel: u16Items items (at most
+ * UDMA_MAX_TRANSFER_ITEMS) from pvSrc to pvDst, with the sizes, increments
+ * and arbitration in u32Control and the transfer mode in u8Mode. The end
+ * pointers the controller works with are derived from the start addresses.
+ */
+void UDMA_vSetTransfer(uint8 u8Channel, uint8 u8Structure, const volatile void *pvSrc,
+                       volatile void *pvDst, uint32 u32Control, uint16 u16Items, uint8 u8Mode);
+
+/* Current transfer mode of a control structure, UDMA_MODE_STOP once its transfer completed */
+uint8 UDMA_u8TransferMode(uint8 u8Channel, uint8 u8Structure);
+
+void UDMA_vChannelEnable(uint8 u8Channel);
+void UDMA_vChannelDisable(uint8 u8Channel);
+
+/* Clear the completion flag of a channel, from the peripheral interrupt handler */
+void UDMA_vClearInterrupt(uint8 u8Channel);
+
+#endif /* UDMA_H_ */
@@ -217,6 +217,13 @@ MPU Registers
 #define MPU_BASE3_REG             (*((volatile uint32 *)0xE000EDB4))
 #define MPU_ATTR3_REG             (*((volatile uint32 *)0xE000EDB8))
 
+/*****************************************************************************
+Data Watchpoint and Trace (DWT) Registers
+*****************************************************************************/
+#define CORE_DEBUG_DEMCR_REG      (*((volatile uint32 *)0xE000EDFC))
+#define DWT_CTRL_REG              (*((volatile uint32 *)0xE0001000))
+#define DWT_CYCCNT_REG            (*((volatile uint32 *)0xE0001004))
+
 /*****************************************************************************
 System Control Registers
 *****************************************************************************/
@@ -438,6 +445,15 @@ Flash Registers
 #define FLASH_FMPPE2_REG          (*((volatile uint32 *)0x400FE408))
 #define FLASH_FMPPE3_REG          (*((volatile uint32 *)0x400FE40C))
 
+/*****************************************************************************
+Timer Registers (TIMER0)
+*****************************************************************************/
+#define TIMER0_CFG_REG            (*((volatile uint32 *)0x40030000))
+#define TIMER0_TAMR_REG           (*((volatile uint32 *)0x40030004))
+#define TIMER0_CTL_REG            (*((volatile uint32 *)0x4003000C))
+#define TIMER0_TAILR_REG          (*((volatile uint32 *)0x40030028))
+#define TIMER0_TAR_REG            (*((volatile uint32 *)0x40030048))
+
 /*****************************************************************************
 Timer Registers (WTIMER0)
 *****************************************************************************/
@@ -452,11 +468,46 @@ Timer Registers (WTIMER0)
 #define WTIMER0_TAR_REG           (*((volatile uint32 *)0x40036048))
 #define WTIMER0_TBR_REG           (*((volatile uint32 *)0x4003604C))
 
+/*****************************************************************************
+PWM Registers (PWM0, generators 0 and 1)
+*****************************************************************************/
+#define PWM0_BASE_ADDRESS          0x40028000
+#define PWM0_CTL_REG              (*((volatile uint32 *)PWM0_BASE_ADDRESS))
+#define PWM0_ENABLE_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x008)))
+#define PWM0_0_CTL_REG            (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x040)))
+#define PWM0_0_LOAD_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x050)))
+#define PWM0_0_CMPA_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x058)))
+#define PWM0_0_CMPB_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x05C)))
+#define PWM0_0_GENA_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x060)))
+#define PWM0_0_GENB_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x064)))
+#define PWM0_1_CTL_REG            (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x080)))
+#define PWM0_1_LOAD_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x090)))
+#define PWM0_1_CMPA_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x098)))
+#define PWM0_1_CMPB_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x09C)))
+#define PWM0_1_GENA_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x0A0)))
+#define PWM0_1_GENB_REG           (*((volatile uint32 *)(PWM0_BASE_ADDRESS + 0x0A4)))
+
+/*****************************************************************************
+EEPROM Registers
+*****************************************************************************/
+#define EEPROM_BASE_ADDRESS        0x400AF000
+#define EEPROM_EESIZE_REG         (*((volatile uint32 *)EEPROM_BASE_ADDRESS))
+#define EEPROM_EEBLOCK_REG        (*((volatile uint32 *)(EEPROM_BASE_ADDRESS + 0x004)))
+#define EEPROM_EEOFFSET_REG       (*((volatile uint32 *)(EEPROM_BASE_ADDRESS + 0x008)))
+#define EEPROM_EERDWR_REG         (*((volatile uint32 *)(EEPROM_BASE_ADDRESS + 0x010)))
+#define EEPROM_EERDWRINC_REG      (*((volatile uint32 *)(EEPROM_BASE_ADDRESS + 0x014)))
+#define EEPROM_EEDONE_REG         (*((volatile uint32 *)(EEPROM_BASE_ADDRESS + 0x018)))
+#define EEPROM_EESUPP_REG         (*((volatile uint32 *)(EEPROM_BASE_ADDRESS + 0x01C)))
+
 #define ADC0_BASE_ADDRESS          0x40038000
 #define ADC0_ACTSS                (*((volatile uint32 *)ADC0_BASE_ADDRESS))
 #define ADC0_RIS                  (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x004)))
 #define ADC0_IM                   (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x008)))
 #define ADC0_EMUX                 (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x014)))
+#define ADC0_SSMUX0               (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x040)))
+#define ADC0_SSCTL0               (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x044)))
+#define ADC0_FIFO0                (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x048)))
+#define ADC0_SSFSTAT0             (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x04C)))
 #define ADC0_SSMUX1               (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x060)))
 #define ADC0_SSMUX3               (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x0A0)))
 #define ADC0_SSCTL1               (*((volatile uint32 *)(ADC0_BASE_ADDRESS + 0x064)))
@@ -0,0 +1,117 @@
+ /******************************************************************************
+ *
+ * Module: Console
+ *
+ * File Name: console.c
+ *
+ * Description: Source file for the command console. The line is split in
+ *              place: the spaces after each word become its terminator.
+ *
+ *******************************************************************************/
+
+#include "console.h"
+#include "uart0.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Console_LineHandler s_pfHandler;
+static char s_acLine[CONSOLE_LINE_MAX_LENGTH + 1];
+static uint8 s_u8Length;
+static boolean s_bOverflow;         /* The line went past its end, drop it */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void Console_vLine(void)
+{
+    const char *apcWords[CONSOLE_WORDS_MAX];
+    uint8 u8Words = 0;
+    uint8 u8Char;
+
+    s_acLine[s_u8Length] = '\0';
+    for(u8Char = 0; u8Char < s_u8Length; u8Char++)
+    {
+        if(s_acLine[u8Char] == ' ')
+        {
+            s_acLine[u8Char] = '\0';
+        }
+        else if(((u8Char == 0) || (s_acLine[u8Char - 1] == '\0')) && (u8Words < CONSOLE_WORDS_MAX))
+        {
+            apcWords[u8Words++] = &s_acLine[u8Char];
+        }
+    }
+    if(u8Words != 0)
+    {
+        s_pfHandler(u8Words, apcWords);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Console_vInit(Console_LineHandler pfHandler)
+{
+    s_pfHandler = pfHandler;
+    s_u8Length = 0;
+    s_bOverflow = FALSE;
+}
+
+void Console_vPoll(void)
+{
+    uint8 u8Char;
+
+    while(UART0_TryReceiveByte(&u8Char))
+    {
+        if((u8Char == '\r') || (u8Char == '\n'))
+        {
+            if(!s_bOverflow)
+            {
+                Console_vLine();
+            }
+            s_u8Length = 0;
+            s_bOverflow = FALSE;
+        }
+        else if(s_u8Length < CONSOLE_LINE_MAX_LENGTH)
+        {
+            s_acLine[s_u8Length++] = (char)u8Char;
+        }
+        else
+        {
+            s_bOverflow = TRUE;
+        }
+    }
+}
+
+boolean Console_bNumber(const char *pcWord, uint32 *pu32Value)
+{
+    uint32 u32Value = 0;
+
+    if(*pcWord == '\0')
+    {
+        return FALSE;
+    }
+    for(; *pcWord != '\0'; pcWord++)
+    {
+        if((*pcWord < '0') || (*pcWord > '9') || (u32Value > 99999999UL))
+        {
+            return FALSE;
+        }
+        u32Value = (u32Value * 10) + (uint32)(*pcWord - '0');
+    }
+    *pu32Value = u32Value;
+    return TRUE;
+}
+
+boolean Console_bIs(const char *pcWord, const char *pcCommand)
+{
+    while((*pcWord != '\0') && (*pcWord == *pcCommand))
+    {
+        pcWord++;
+        pcCommand++;
+    }
+    return (*pcWord == *pcCommand) ? TRUE : FALSE;
+}
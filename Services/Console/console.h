@@ -0,0 +1,54 @@
+ /******************************************************************************
+ *
+ * Module: Console
+ *
+ * File Name: console.h
+ *
+ * Description: Header file for the command console on the UART0 receiver.
+ *              The receive FIFO is polled from a task: each line, ended by
+ *              \r or \n, is split into words at the spaces and handed to the
+ *              handler given to Console_vInit. Replies go out through the log
+ *              service, which owns the transmitter.
+ *
+ *              The FIFO holds 16 characters, 16 ms at UART0_BAUD_RATE: lines
+ *              typed or sent one at a time fit between two polls. A line
+ *              longer than CONSOLE_LINE_MAX_LENGTH is dropped whole, the
+ *              words past CONSOLE_WORDS_MAX are ignored.
+ *
+ *******************************************************************************/
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define CONSOLE_LINE_MAX_LENGTH         32
+#define CONSOLE_WORDS_MAX               4
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Called from the polling task with the words of a line that has at least one */
+typedef void (*Console_LineHandler)(uint8 u8Words, const char *const apcWords[]);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void Console_vInit(Console_LineHandler pfHandler);
+
+/* Take every received character, and handle each line they complete */
+void Console_vPoll(void);
+
+/* TRUE when the word is the decimal number pu32Value is set to */
+boolean Console_bNumber(const char *pcWord, uint32 *pu32Value);
+
+/* TRUE when both words are the same */
+boolean Console_bIs(const char *pcWord, const char *pcCommand);
+
+#endif /* CONSOLE_H_ */
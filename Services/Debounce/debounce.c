@@ -0,0 +1,107 @@
+ /******************************************************************************
+ *
+ * Module: Debounce
+ *
+ * File Name: debounce.c
+ *
+ * Description: Source file for the timer driven button debouncer.
+ *
+ * Each button has a 2-bit counter whose bits are spread over two bytes (one
+ * "vertical" counter per bit position), so all buttons are debounced with a
+ * handful of logic operations per sample. A counter runs while the sampled
+ * level differs from the debounced state and the state toggles when it has
+ * differed for 4 consecutive samples. Any sample equal to the state resets
+ * that button's counter, which is what rejects the contact bounce.
+ *
+ *******************************************************************************/
+
+#include "debounce.h"
+#include "timers.h"
+#include "gpio.h"
+#include "trace.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static TimerHandle_t s_xSampleTimer;
+static StaticTimer_t s_xSampleTimerBuffer;
+static Debounce_PressCallback s_pfPressCallback;
+
+static uint8 s_u8State;      /* Debounced level of each button, 1 = pressed */
+static uint8 s_u8Count0;     /* Bit 0 of the vertical counters */
+static uint8 s_u8Count1;     /* Bit 1 of the vertical counters */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Raw button levels, 1 = pressed (the buttons are active low) */
+static uint8 Debounce_u8ReadButtons(void)
+{
+    uint8 u8Sample = 0;
+
+    if(GPIO_SW1GetState() == PRESSED)
+    {
+        u8Sample |= DEBOUNCE_BUTTON_MASK(DEBOUNCE_SW1);
+    }
+    if(GPIO_SW2GetState() == PRESSED)
+    {
+        u8Sample |= DEBOUNCE_BUTTON_MASK(DEBOUNCE_SW2);
+    }
+    if(GPIO_ExtButtonGetState() == PRESSED)
+    {
+        u8Sample |= DEBOUNCE_BUTTON_MASK(DEBOUNCE_EXT);
+    }
+    return u8Sample;
+}
+
+static void Debounce_vSample(TimerHandle_t xTimer)
+{
+    uint8 u8Delta = Debounce_u8ReadButtons() ^ s_u8State;
+    uint8 u8Toggle;
+
+    /* Count the samples that differ from the state, clear the others */
+    s_u8Count1 = (uint8)((s_u8Count1 ^ s_u8Count0) & u8Delta);
+    s_u8Count0 = (uint8)(~s_u8Count0 & u8Delta);
+    u8Toggle   = (uint8)(u8Delta & ~(s_u8Count0 | s_u8Count1));
+    s_u8State ^= u8Toggle;
+
+    if((u8Toggle & s_u8State) && (s_pfPressCallback != NULL_PTR))
+    {
+        s_pfPressCallback(u8Toggle & s_u8State);
+    }
+
+    /* Everything released and settled: go back to waiting for an edge */
+    if((s_u8State == 0) && (u8Delta == 0))
+    {
+        xTimerStop(xTimer, 0);
+        GPIO_ButtonsEdgeInterruptsEnable();
+
+        /* A press that started before the unmask produced no edge, keep sampling for it */
+        if(Debounce_u8ReadButtons() != 0)
+        {
+            GPIO_ButtonsEdgeInterruptsDisable();
+            xTimerStart(xTimer, 0);
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Debounce_vInit(Debounce_PressCallback pfPressCallback)
+{
+    s_pfPressCallback = pfPressCallback;
+    s_xSampleTimer = xTimerCreateStatic("Debounce", pdMS_TO_TICKS(DEBOUNCE_SAMPLE_PERIOD_MS),
+                                        pdTRUE, NULL, Debounce_vSample, &s_xSampleTimerBuffer);
+    configASSERT(s_xSampleTimer != NULL);
+    Trace_vNameObject((uint8)uxTimerGetTimerNumber(s_xSampleTimer), pcTimerGetName(s_xSampleTimer));
+}
+
+void Debounce_vEdgeFromISR(BaseType_t *pxHigherPriorityTaskWoken)
+{
+    GPIO_ButtonsEdgeInterruptsDisable();
+    xTimerStartFromISR(s_xSampleTimer, pxHigherPriorityTaskWoken);
+}
@@ -0,0 +1,57 @@
+ /******************************************************************************
+ *
+ * Module: Debounce
+ *
+ * File Name: debounce.h
+ *
+ * Description: Header file for the timer driven button debouncer. A button
+ *              edge only wakes the debouncer; the buttons are then sampled
+ *              every DEBOUNCE_SAMPLE_PERIOD_MS and debounced all together with
+ *              vertical counters, so no time is spent waiting inside the GPIO
+ *              interrupts.
+ *
+ *******************************************************************************/
+
+#ifndef DEBOUNCE_H_
+#define DEBOUNCE_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* A press is confirmed after 4 equal samples: 4 * 5ms = 20ms stable level */
+#define DEBOUNCE_SAMPLE_PERIOD_MS       5
+
+/* Button indices, the press mask passed to the callback has bit (1 << index) set */
+#define DEBOUNCE_SW1                    0       /* PF4, driver seat */
+#define DEBOUNCE_SW2                    1       /* PF0, passenger seat */
+#define DEBOUNCE_EXT                    2       /* PA4, external driver seat button */
+#define DEBOUNCE_BUTTONS_NUM            3
+
+#define DEBOUNCE_BUTTON_MASK(BUTTON)    ((uint8)(1U << (BUTTON)))
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Called from the timer service task with the buttons whose press was just confirmed */
+typedef void (*Debounce_PressCallback)(uint8 u8PressedMask);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Create the sampling timer. Call before the scheduler starts. */
+void Debounce_vInit(Debounce_PressCallback pfPressCallback);
+
+/*
+ * Called from the button GPIO interrupts: masks the button edge interrupts and
+ * starts sampling. The edge interrupts are unmasked again once every button is
+ * back to a stable released level.
+ */
+void Debounce_vEdgeFromISR(BaseType_t *pxHigherPriorityTaskWoken);
+
+#endif /* DEBOUNCE_H_ */
@@ -0,0 +1,107 @@
+ /******************************************************************************
+ *
+ * Module: Heater
+ *
+ * File Name: heater.c
+ *
+ * Description: Source file for the seat heater outputs.
+ *
+ * The windows of the software outputs are staggered by an equal share of
+ * HEATER_WINDOW_TICKS per channel, so that the heaters do not all switch on at
+ * the same tick. The tick hook reads a duty cycle the task wrote with a single
+ * 16-bit store, and writes the heater pins of PORTB, and only them, when one
+ * of them changes.
+ *
+ *******************************************************************************/
+
+#include "heater.h"
+#include "FreeRTOS.h"
+#include "gpio.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEATER_PWM_PERIOD_CYCLES        (CLOCK_SYSTEM_HZ / HEATER_PWM_FREQUENCY_HZ)
+
+#if (HEATER_PWM_PERIOD_CYCLES > 0xFFFF) || (HEATER_PWM_PERIOD_CYCLES < PWM_DUTY_FULL)
+#error "The PWM period must fit the 16-bit generators and resolve a permille"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+#if HEATER_SOFTWARE_PWM
+/* PORTB pin of each channel, as routed to PWM0 */
+static const uint8 s_au8Pins[HEATER_CHANNELS_MAX] = { (1<<6), (1<<7), (1<<4), (1<<5) };
+
+static uint8 s_u8Channels;
+static uint8 s_u8Pins;
+static volatile uint16 s_au16OnTicks[HEATER_CHANNELS_MAX];
+static uint8 s_u8Levels;
+static uint16 s_u16Tick;
+#endif
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Heater_vInit(uint8 u8Channels)
+{
+#if HEATER_SOFTWARE_PWM
+    uint8 u8Channel;
+
+    s_u8Channels = (u8Channels < HEATER_CHANNELS_MAX) ? u8Channels : HEATER_CHANNELS_MAX;
+    s_u8Pins = 0;
+    for(u8Channel = 0; u8Channel < s_u8Channels; u8Channel++)
+    {
+        s_u8Pins |= s_au8Pins[u8Channel];
+    }
+    GPIO_PortBOutputsInit(s_u8Pins);
+#else
+    (void)u8Channels;
+    PWM0_vInit(HEATER_PWM_PERIOD_CYCLES);
+#endif
+}
+
+void Heater_vSetDuty(uint8 u8Channel, uint16 u16Permille)
+{
+    if(u16Permille > HEATER_DUTY_FULL)
+    {
+        u16Permille = HEATER_DUTY_FULL;
+    }
+#if HEATER_SOFTWARE_PWM
+    if(u8Channel < s_u8Channels)
+    {
+        s_au16OnTicks[u8Channel] = (uint16)((((uint32)u16Permille * HEATER_WINDOW_TICKS) + (HEATER_DUTY_FULL / 2)) / HEATER_DUTY_FULL);
+    }
+#else
+    PWM0_vSetDuty(u8Channel, u16Permille);
+#endif
+}
+
+void Heater_vTickFromISR(void)
+{
+#if HEATER_SOFTWARE_PWM
+    uint8  u8Channel;
+    uint8  u8Levels = 0;
+    uint16 u16Phase;
+
+    s_u16Tick = (uint16)((s_u16Tick + 1) % HEATER_WINDOW_TICKS);
+    for(u8Channel = 0; u8Channel < s_u8Channels; u8Channel++)
+    {
+        u16Phase = (uint16)((s_u16Tick + ((u8Channel * HEATER_WINDOW_TICKS) / HEATER_CHANNELS_MAX)) % HEATER_WINDOW_TICKS);
+        if(u16Phase < s_au16OnTicks[u8Channel])
+        {
+            u8Levels |= s_au8Pins[u8Channel];
+        }
+    }
+    if(u8Levels != s_u8Levels)
+    {
+        s_u8Levels = u8Levels;
+        GPIO_PortBWrite(s_u8Pins, u8Levels);
+    }
+#endif
+}
@@ -0,0 +1,63 @@
+ /******************************************************************************
+ *
+ * Module: Heater
+ *
+ * File Name: heater.h
+ *
+ * Description: Header file for the seat heater outputs. Channel n drives the
+ *              heater element on PWM0 output n (PB6, PB7, PB4, PB5) at a duty
+ *              cycle in permille.
+ *
+ *              Without HEATER_SOFTWARE_PWM (FreeRTOSConfig.h) the duty cycle is
+ *              the PWM generators' at HEATER_PWM_FREQUENCY_HZ. With it the pins
+ *              are plain GPIO outputs, time proportioned from the tick hook:
+ *              on for the duty cycle of every HEATER_WINDOW_TICKS window, for
+ *              a part or a board without the PWM module. A heater element is
+ *              slow enough for either.
+ *
+ *******************************************************************************/
+
+#ifndef HEATER_H_
+#define HEATER_H_
+
+#include "std_types.h"
+#include "pwm.h"
+#include "pid.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEATER_CHANNELS_MAX             PWM0_OUTPUTS_NUM
+#define HEATER_DUTY_FULL                PWM_DUTY_FULL
+
+#define HEATER_PWM_FREQUENCY_HZ         20000
+
+/* Time proportioning window of the software outputs, the duty resolution is one tick of it */
+#define HEATER_WINDOW_TICKS             100
+
+/*
+ * PI gains of a seat heater loop (pid.h), from the temperature in 0.01 degC to
+ * the duty cycle in permille, run once per sensor sample of 500 ms. Set for
+ * the simulated seat (Simulation/Periph/sim_plant.c) with the SIMC rules and
+ * checked by Simulation/Bench/bench_heater.c: 2.5 permille per 0.01 degC, an
+ * integral time of 34 s, no derivative.
+ */
+#define HEATER_PID_KP                   PID_Q16(2.5)
+#define HEATER_PID_KI                   PID_Q16(2.5 * 0.5 / 34.0)
+#define HEATER_PID_KD                   PID_Q16(0.0)
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Set up channels 0 .. u8Channels - 1, every heater off */
+void Heater_vInit(uint8 u8Channels);
+
+/* Duty cycle of a channel in permille, from its next PWM period or window */
+void Heater_vSetDuty(uint8 u8Channel, uint16 u16Permille);
+
+/* Software outputs: advance the windows by one tick, from vApplicationTickHook() */
+void Heater_vTickFromISR(void);
+
+#endif /* HEATER_H_ */
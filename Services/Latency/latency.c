@@ -0,0 +1,180 @@
+ /******************************************************************************
+ *
+ * Module: Latency
+ *
+ * File Name: latency.c
+ *
+ * Description: Source file for the control path latency histograms.
+ *
+ * A value's bucket is its power of two and the LATENCY_SUB_BUCKET_BITS bits
+ * right below its leading one, as in HDR histograms. The percentile walk and
+ * the summary run in the reporting task, a record only updates one count and
+ * the extremes under a short interrupt mask.
+ *
+ *******************************************************************************/
+
+#include "latency.h"
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint16 au16Counts[LATENCY_BUCKETS];
+    uint32 u32Samples;
+    uint32 u32Min;
+    uint32 u32Max;
+} Latency_Histogram;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Latency_Histogram s_axHistograms[LATENCY_PATHS_NUM][LATENCY_SEATS_MAX];
+static boolean s_abUpdated[LATENCY_PATHS_NUM];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Position of the leading one of a non zero value */
+static uint8 Latency_u8Log2(uint32 u32Value)
+{
+    uint8 u8Log2 = 0;
+
+    while(u32Value > 1)
+    {
+        u32Value >>= 1;
+        u8Log2++;
+    }
+    return u8Log2;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+uint8 Latency_u8Bucket(uint32 u32Cycles)
+{
+    uint8 u8Log2;
+
+    if(u32Cycles < LATENCY_SUB_BUCKETS)
+    {
+        return (uint8)u32Cycles;
+    }
+    u8Log2 = Latency_u8Log2(u32Cycles);
+    return (uint8)(((u8Log2 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS) +
+                   ((u32Cycles >> (u8Log2 - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1)));
+}
+
+uint32 Latency_u32BucketMax(uint8 u8Bucket)
+{
+    uint8 u8Shift;
+
+    if(u8Bucket < LATENCY_SUB_BUCKETS)
+    {
+        return u8Bucket;
+    }
+    /* The power of two of the bucket, less the sub-bucket bits */
+    u8Shift = (uint8)((u8Bucket / LATENCY_SUB_BUCKETS) - 1);
+    return ((uint32)(LATENCY_SUB_BUCKETS + (u8Bucket % LATENCY_SUB_BUCKETS)) << u8Shift) + ((1UL << u8Shift) - 1);
+}
+
+void Latency_vRecord(uint8 u8Path, uint8 u8Seat, uint32 u32Cycles)
+{
+    Latency_Histogram *pxHistogram;
+    uint8  u8Bucket = Latency_u8Bucket(u32Cycles);
+    uint16 u16Index;
+    UBaseType_t uxSavedMask;
+
+    if((u8Path >= LATENCY_PATHS_NUM) || (u8Seat >= LATENCY_SEATS_MAX))
+    {
+        return;
+    }
+    pxHistogram = &s_axHistograms[u8Path][u8Seat];
+
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    if(pxHistogram->au16Counts[u8Bucket] == 0xFFFF)
+    {
+        for(u16Index = 0; u16Index < LATENCY_BUCKETS; u16Index++)
+        {
+            pxHistogram->au16Counts[u16Index] >>= 1;
+        }
+    }
+    pxHistogram->au16Counts[u8Bucket]++;
+    if((pxHistogram->u32Samples == 0) || (u32Cycles < pxHistogram->u32Min))
+    {
+        pxHistogram->u32Min = u32Cycles;
+    }
+    if(u32Cycles > pxHistogram->u32Max)
+    {
+        pxHistogram->u32Max = u32Cycles;
+    }
+    pxHistogram->u32Samples++;
+    s_abUpdated[u8Path] = TRUE;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+}
+
+boolean Latency_bSummary(uint8 u8Path, uint8 u8Seat, Latency_Summary *pxSummary)
+{
+    static uint16 au16Counts[LATENCY_BUCKETS];      /* Not on the caller's stack */
+    const Latency_Histogram *pxHistogram;
+    uint32 u32Total = 0;
+    uint32 u32Rank;
+    uint32 u32Seen = 0;
+    uint16 u16Index;
+    UBaseType_t uxSavedMask;
+
+    if((u8Path >= LATENCY_PATHS_NUM) || (u8Seat >= LATENCY_SEATS_MAX))
+    {
+        return FALSE;
+    }
+    pxHistogram = &s_axHistograms[u8Path][u8Seat];
+
+    /* A consistent copy, the walk runs unmasked */
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    pxSummary->u32Samples = pxHistogram->u32Samples;
+    pxSummary->u32Min = pxHistogram->u32Min;
+    pxSummary->u32Max = pxHistogram->u32Max;
+    for(u16Index = 0; u16Index < LATENCY_BUCKETS; u16Index++)
+    {
+        au16Counts[u16Index] = pxHistogram->au16Counts[u16Index];
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+
+    if(pxSummary->u32Samples == 0)
+    {
+        return FALSE;
+    }
+    for(u16Index = 0; u16Index < LATENCY_BUCKETS; u16Index++)
+    {
+        u32Total += au16Counts[u16Index];
+    }
+
+    /* The smallest value with at least 99% of the samples at or below it */
+    u32Rank = u32Total - (u32Total / 100);
+    for(u16Index = 0; u16Index < LATENCY_BUCKETS; u16Index++)
+    {
+        u32Seen += au16Counts[u16Index];
+        if(u32Seen >= u32Rank)
+        {
+            break;
+        }
+    }
+    pxSummary->u32P99 = Latency_u32BucketMax((uint8)u16Index);
+    if(pxSummary->u32P99 > pxSummary->u32Max)
+    {
+        pxSummary->u32P99 = pxSummary->u32Max;
+    }
+    return TRUE;
+}
+
+boolean Latency_bPathUpdated(uint8 u8Path)
+{
+    boolean bUpdated = s_abUpdated[u8Path];
+
+    s_abUpdated[u8Path] = FALSE;
+    return bUpdated;
+}
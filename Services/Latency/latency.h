@@ -0,0 +1,76 @@
+ /******************************************************************************
+ *
+ * Module: Latency
+ *
+ * File Name: latency.h
+ *
+ * Description: Header file for the control path latency histograms. Each
+ *              path of every seat keeps a log-bucketed histogram of its
+ *              latencies in CPU cycles, measured on the WTimer0 timebase
+ *              from the event starting the path: every power of two is split
+ *              in LATENCY_SUB_BUCKETS buckets, so a bucket is never wider
+ *              than a quarter of the values it holds, from 1 cycle to 2^32.
+ *              The counts are 16-bit; when one would overflow, every count of
+ *              the histogram is halved, which keeps its shape and makes it
+ *              favour the recent samples.
+ *
+ *              Min, max and the 99th percentile (the upper bound of its
+ *              bucket) are reported in TELEMETRY_FRAME_LATENCY frames.
+ *
+ *******************************************************************************/
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Control paths of main.c, each starts from a timestamp taken in an interrupt */
+#define LATENCY_PATH_SENSOR_WAKE        0       /* ADC capture done -> sample record consumed */
+#define LATENCY_PATH_SENSOR_HEATER      1       /* ADC capture done -> heater and LEDs updated (vHeater_Action) */
+#define LATENCY_PATH_BUTTON_CONFIRM     2       /* Button edge -> press confirmed by the debouncer */
+#define LATENCY_PATH_BUTTON_LEVEL       3       /* Button edge -> desired level changed */
+#define LATENCY_PATHS_NUM               4
+
+#define LATENCY_SEATS_MAX               2
+
+/* Buckets per power of two, a power of two itself */
+#define LATENCY_SUB_BUCKET_BITS         2
+#define LATENCY_SUB_BUCKETS             (1U << LATENCY_SUB_BUCKET_BITS)
+
+/* Values below LATENCY_SUB_BUCKETS have a bucket each, then LATENCY_SUB_BUCKETS per power of two up to 2^32 */
+#define LATENCY_BUCKETS                 ((32 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 u32Samples;          /* Since the start, wraps */
+    uint32 u32Min;              /* Cycles */
+    uint32 u32P99;              /* Cycles, upper bound of the bucket */
+    uint32 u32Max;              /* Cycles */
+} Latency_Summary;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Add one latency of a path in CPU cycles, from a task or an interrupt */
+void Latency_vRecord(uint8 u8Path, uint8 u8Seat, uint32 u32Cycles);
+
+/* Summary of a path of a seat. Returns FALSE if it has no sample yet. */
+boolean Latency_bSummary(uint8 u8Path, uint8 u8Seat, Latency_Summary *pxSummary);
+
+/* TRUE once after any seat of the path got a sample */
+boolean Latency_bPathUpdated(uint8 u8Path);
+
+/* Bucket of a value and the highest value of a bucket */
+uint8 Latency_u8Bucket(uint32 u32Cycles);
+uint32 Latency_u32BucketMax(uint8 u8Bucket);
+
+#endif /* LATENCY_H_ */
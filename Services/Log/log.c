@@ -0,0 +1,290 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log.c
+ *
+ * Description: Source file for the UART0 logging gatekeeper.
+ *
+ * Each channel is a message buffer with one writer (its producer task) and one
+ * reader (the gatekeeper), which is the case the kernel supports without any
+ * lock. The send-completed callback of every channel notifies the gatekeeper,
+ * so it sleeps on its notification and then drains the channels in turn, one
+ * line each, into the UART0 transmit ring. Only the gatekeeper waits for room
+ * in the ring; a producer finding its channel full drops the line instead.
+ *
+ * Deferred records go to a word ring written under a short interrupt mask,
+ * which is what lets any task or interrupt log, and read by the gatekeeper
+ * alone. The gatekeeper also wakes every LOG_DEFERRED_DRAIN_MS to pack the
+ * records into telemetry frames; the ring space is released only once a
+ * record has been copied out.
+ *
+ *******************************************************************************/
+
+#include "log.h"
+#include "message_buffer.h"
+#include "uart0.h"
+#include "GPTM.h"
+#include "stack.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define LOG_DEFERRED_RING_MASK          (LOG_DEFERRED_RING_WORDS - 1)
+#define LOG_RECORD_WORDS                2       /* Header and timestamp, without the arguments */
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static MessageBufferHandle_t s_axChannels[LOG_CHANNELS_NUM];
+static volatile uint32 s_au32Dropped[LOG_CHANNELS_NUM];     /* Each written by its producer only */
+static TaskHandle_t s_xLogTask;
+
+/* Static kernel objects; a static buffer holds one byte less than its storage */
+static StaticMessageBuffer_t s_axChannelBuffers[LOG_CHANNELS_NUM];
+static uint8 s_au8ChannelStorage[LOG_CHANNELS_NUM][LOG_CHANNEL_BUFFER_SIZE + 1];
+static StaticTask_t s_xLogTaskBuffer;
+static StackType_t s_axLogTaskStack[STACK_GUARD_WORDS + LOG_TASK_STACK_SIZE];
+
+static uint32 s_au32DeferredRing[LOG_DEFERRED_RING_WORDS];
+static volatile uint32 s_u32DeferredHead;                   /* Written by the producers, under the mask */
+static volatile uint32 s_u32DeferredTail;                   /* Written by the gatekeeper */
+static volatile uint32 s_u32DeferredDropped;
+static uint16 s_u16DeferredSequence;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Send-completed callback of every channel */
+static void Log_vWakeGatekeeper(StreamBufferHandle_t xChannel, BaseType_t xIsInsideISR,
+                                BaseType_t * const pxHigherPriorityTaskWoken)
+{
+    (void)xChannel;
+    if(xIsInsideISR != pdFALSE)
+    {
+        vTaskNotifyGiveFromISR(s_xLogTask, pxHigherPriorityTaskWoken);
+    }
+    else
+    {
+        xTaskNotifyGive(s_xLogTask);
+    }
+}
+
+/* Hand a whole line to UART0, waiting for room in its transmit ring */
+static void Log_vWriteUart(const uint8 *pu8Data, uint16 u16Length)
+{
+    while(UART0_TxSpace() < u16Length)
+    {
+        vTaskDelay(1);
+    }
+    (void)UART0_Write(pu8Data, u16Length);
+}
+
+/* Pack the oldest deferred records into one frame and send it. Returns FALSE if there were none. */
+static boolean Log_bDrainDeferred(void)
+{
+    uint8  au8Payload[LOG_DEFERRED_PAYLOAD_LENGTH + TELEMETRY_CRC_LENGTH];
+    uint8  au8Frame[TELEMETRY_FRAME_LENGTH(LOG_DEFERRED_PAYLOAD_LENGTH + TELEMETRY_CRC_LENGTH)];
+    uint16 u16Length = TELEMETRY_LOG_HEADER_LENGTH;
+    uint32 u32Head = s_u32DeferredHead;
+    uint32 u32Tail = s_u32DeferredTail;
+    uint32 u32Header;
+    uint8  u8Args;
+    uint8  u8Arg;
+
+    if(u32Tail == u32Head)
+    {
+        return FALSE;
+    }
+
+    while(u32Tail != u32Head)
+    {
+        u32Header = s_au32DeferredRing[u32Tail & LOG_DEFERRED_RING_MASK];
+        u8Args = (uint8)(u32Header >> 16);
+        if(u16Length + TELEMETRY_LOG_RECORD_LENGTH + (u8Args * 4) > LOG_DEFERRED_PAYLOAD_LENGTH)
+        {
+            break;
+        }
+        Telemetry_vPut16(&au8Payload[u16Length], (uint16)u32Header);
+        au8Payload[u16Length + 2] = u8Args;
+        Telemetry_vPut32(&au8Payload[u16Length + 3], s_au32DeferredRing[(u32Tail + 1) & LOG_DEFERRED_RING_MASK]);
+        u16Length += TELEMETRY_LOG_RECORD_LENGTH;
+        for(u8Arg = 0; u8Arg < u8Args; u8Arg++)
+        {
+            Telemetry_vPut32(&au8Payload[u16Length], s_au32DeferredRing[(u32Tail + LOG_RECORD_WORDS + u8Arg) & LOG_DEFERRED_RING_MASK]);
+            u16Length += 4;
+        }
+        u32Tail += LOG_RECORD_WORDS + u8Args;
+    }
+    s_u32DeferredTail = u32Tail;
+
+    au8Payload[0] = TELEMETRY_FRAME_LOG;
+    Telemetry_vPut16(&au8Payload[1], s_u16DeferredSequence++);
+    Log_vWriteUart(au8Frame, Telemetry_u16EncodeFrame(au8Payload, u16Length, au8Frame));
+    return TRUE;
+}
+
+static void Log_vTask(void *pvParameters)
+{
+    uint8   au8Line[LOG_MESSAGE_MAX_LENGTH];
+    size_t  xLength;
+    uint8   u8Channel;
+    boolean bMore;
+
+    (void)pvParameters;
+    for(;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_DEFERRED_DRAIN_MS));
+
+        /* One line per channel and one deferred frame per pass, so a busy producer cannot hold the others back */
+        do
+        {
+            bMore = Log_bDrainDeferred();
+            for(u8Channel = 0; u8Channel < LOG_CHANNELS_NUM; u8Channel++)
+            {
+                xLength = xMessageBufferReceive(s_axChannels[u8Channel], au8Line, sizeof(au8Line), 0);
+                if(xLength != 0)
+                {
+                    Log_vWriteUart(au8Line, (uint16)xLength);
+                    bMore = TRUE;
+                }
+            }
+        }
+        while(bMore);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Log_vInit(void)
+{
+    uint8 u8Channel;
+
+    for(u8Channel = 0; u8Channel < LOG_CHANNELS_NUM; u8Channel++)
+    {
+        s_axChannels[u8Channel] = xMessageBufferCreateStaticWithCallback(sizeof(s_au8ChannelStorage[u8Channel]),
+                                                                         s_au8ChannelStorage[u8Channel],
+                                                                         &s_axChannelBuffers[u8Channel],
+                                                                         Log_vWakeGatekeeper, NULL);
+        configASSERT(s_axChannels[u8Channel] != NULL);
+    }
+    s_xLogTask = xTaskCreateStatic(Log_vTask, "Log", LOG_TASK_STACK_SIZE, NULL, LOG_TASK_PRIORITY,
+                                   &s_axLogTaskStack[STACK_GUARD_WORDS], &s_xLogTaskBuffer);
+    configASSERT(s_xLogTask != NULL);
+}
+
+void Log_vStart(Log_Message *pxMessage)
+{
+    pxMessage->u16Length = 0;
+}
+
+void Log_vAppendByte(Log_Message *pxMessage, uint8 u8Byte)
+{
+    if(pxMessage->u16Length < LOG_MESSAGE_MAX_LENGTH)
+    {
+        pxMessage->au8Data[pxMessage->u16Length++] = u8Byte;
+    }
+}
+
+void Log_vAppendString(Log_Message *pxMessage, const uint8 *pu8String)
+{
+    while((*pu8String != '\0') && (pxMessage->u16Length < LOG_MESSAGE_MAX_LENGTH))
+    {
+        pxMessage->au8Data[pxMessage->u16Length++] = *pu8String++;
+    }
+}
+
+void Log_vAppendUnsigned(Log_Message *pxMessage, uint32 u32Number)
+{
+    uint8 au8Digits[10];
+    uint8 u8Count = 0;
+
+    /* The digits come right to left */
+    do
+    {
+        au8Digits[u8Count++] = (uint8)('0' + (u32Number % 10));
+        u32Number /= 10;
+    }
+    while(u32Number != 0);
+
+    while(u8Count != 0)
+    {
+        Log_vAppendByte(pxMessage, au8Digits[--u8Count]);
+    }
+}
+
+boolean Log_bPost(uint8 u8Channel, const Log_Message *pxMessage)
+{
+    return Log_bPostWait(u8Channel, pxMessage, 0);
+}
+
+boolean Log_bPostWait(uint8 u8Channel, const Log_Message *pxMessage, TickType_t xTicksToWait)
+{
+    if((pxMessage->u16Length == 0) ||
+       (xMessageBufferSend(s_axChannels[u8Channel], pxMessage->au8Data, pxMessage->u16Length, xTicksToWait) != 0))
+    {
+        return TRUE;
+    }
+    s_au32Dropped[u8Channel]++;
+    return FALSE;
+}
+
+boolean Log_bPostString(uint8 u8Channel, const uint8 *pu8String)
+{
+    Log_Message xMessage;
+
+    Log_vStart(&xMessage);
+    Log_vAppendString(&xMessage, pu8String);
+    return Log_bPost(u8Channel, &xMessage);
+}
+
+uint32 Log_u32Dropped(uint8 u8Channel)
+{
+    return s_au32Dropped[u8Channel];
+}
+
+void Log_vDefer(uint32 u32Header, uint32 u32Arg0, uint32 u32Arg1, uint32 u32Arg2)
+{
+    uint32 u32Words = LOG_RECORD_WORDS + (u32Header >> 16);
+    uint32 u32Timestamp = (uint32)GPTM_WTimer0ReadUs();   /* The division stays out of the critical section */
+    uint32 u32Head;
+    UBaseType_t uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+
+    u32Head = s_u32DeferredHead;
+    if((LOG_DEFERRED_RING_WORDS - (u32Head - s_u32DeferredTail)) < u32Words)
+    {
+        s_u32DeferredDropped++;
+    }
+    else
+    {
+        s_au32DeferredRing[u32Head & LOG_DEFERRED_RING_MASK] = u32Header;
+        s_au32DeferredRing[(u32Head + 1) & LOG_DEFERRED_RING_MASK] = u32Timestamp;
+        /* Only the words of this record, the ones after it may still be unread */
+        if(u32Words > LOG_RECORD_WORDS)
+        {
+            s_au32DeferredRing[(u32Head + 2) & LOG_DEFERRED_RING_MASK] = u32Arg0;
+        }
+        if(u32Words > LOG_RECORD_WORDS + 1)
+        {
+            s_au32DeferredRing[(u32Head + 3) & LOG_DEFERRED_RING_MASK] = u32Arg1;
+        }
+        if(u32Words > LOG_RECORD_WORDS + 2)
+        {
+            s_au32DeferredRing[(u32Head + 4) & LOG_DEFERRED_RING_MASK] = u32Arg2;
+        }
+        /* The record is complete before the gatekeeper can see it */
+        s_u32DeferredHead = u32Head + u32Words;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+}
+
+uint32 Log_u32DeferredDropped(void)
+{
+    return s_u32DeferredDropped;
+}
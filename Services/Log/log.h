@@ -0,0 +1,116 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log.h
+ *
+ * Description: Header file for the UART0 logging gatekeeper. The gatekeeper
+ *              task is the only writer of UART0; every producer task owns a
+ *              channel (a message buffer) and posts whole lines, text or
+ *              binary frames, to it without blocking and without a critical
+ *              section. A line that does not
+ *              fit in its channel is dropped and counted.
+ *
+ *              Diagnostics use deferred records instead: a format ID from
+ *              log_formats.h and up to three 32-bit arguments, stored in a RAM
+ *              ring in a few cycles from a task or an interrupt. The
+ *              gatekeeper streams them out in telemetry frames and the host
+ *              decoder rebuilds the text, so no formatting runs on the target.
+ *
+ *******************************************************************************/
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+#include "log_formats.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* One channel per producer task: a message buffer has a single writer */
+#define LOG_CHANNEL_TEMPERATURE         0       /* vPrintTemperatureJob */
+#define LOG_CHANNEL_RUNTIME             1       /* vRunTimeMeasurementsJob */
+#define LOG_CHANNEL_CONSOLE             2       /* vConsoleJob */
+#define LOG_CHANNELS_NUM                3
+
+/* Longest line, longer ones are truncated */
+#define LOG_MESSAGE_MAX_LENGTH          96
+
+/* Bytes of each channel's message buffer, each line also takes a size_t for its length */
+#define LOG_CHANNEL_BUFFER_SIZE         384
+
+#define LOG_TASK_STACK_SIZE             192
+#define LOG_TASK_PRIORITY               1
+
+/* Words of the deferred record ring, a power of two. A record takes 2 + arguments words. */
+#define LOG_DEFERRED_RING_WORDS         256
+
+/* The gatekeeper drains the deferred records at least this often */
+#define LOG_DEFERRED_DRAIN_MS           20
+
+/* Payload of a deferred log frame, header included and CRC excluded */
+#define LOG_DEFERRED_PAYLOAD_LENGTH     64
+
+/* First word of a record: format ID and number of arguments */
+#define LOG_RECORD_HEADER(FORMAT, ARGS) (((uint32)(ARGS) << 16) | (uint32)(FORMAT))
+
+/* Deferred log calls, the format is a Log_FormatId */
+#define LOG_DEFER0(FORMAT)              Log_vDefer(LOG_RECORD_HEADER((FORMAT), 0), 0, 0, 0)
+#define LOG_DEFER1(FORMAT, A)           Log_vDefer(LOG_RECORD_HEADER((FORMAT), 1), (uint32)(A), 0, 0)
+#define LOG_DEFER2(FORMAT, A, B)        Log_vDefer(LOG_RECORD_HEADER((FORMAT), 2), (uint32)(A), (uint32)(B), 0)
+#define LOG_DEFER3(FORMAT, A, B, C)     Log_vDefer(LOG_RECORD_HEADER((FORMAT), 3), (uint32)(A), (uint32)(B), (uint32)(C))
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* A line being built by a producer, on the producer's stack */
+typedef struct
+{
+    uint8  au8Data[LOG_MESSAGE_MAX_LENGTH];
+    uint16 u16Length;
+} Log_Message;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Create the channels and the gatekeeper task. Call before the scheduler starts. */
+void Log_vInit(void);
+
+/* Start an empty line */
+void Log_vStart(Log_Message *pxMessage);
+
+/* Append to a line, silently truncated at LOG_MESSAGE_MAX_LENGTH */
+void Log_vAppendByte(Log_Message *pxMessage, uint8 u8Byte);
+void Log_vAppendString(Log_Message *pxMessage, const uint8 *pu8String);
+void Log_vAppendUnsigned(Log_Message *pxMessage, uint32 u32Number);
+
+/* Post a line on a channel; never blocks. Returns FALSE if it was dropped. */
+boolean Log_bPost(uint8 u8Channel, const Log_Message *pxMessage);
+
+/* Post a line, waiting up to xTicksToWait for room in the channel. Returns FALSE if it was dropped. */
+boolean Log_bPostWait(uint8 u8Channel, const Log_Message *pxMessage, TickType_t xTicksToWait);
+
+/* Shortcut to post a constant string as one line */
+boolean Log_bPostString(uint8 u8Channel, const uint8 *pu8String);
+
+/* Lines dropped on a channel because its buffer was full */
+uint32 Log_u32Dropped(uint8 u8Channel);
+
+/*
+ * Store a deferred record, timestamped in usec by WTimer0; use the LOG_DEFERn
+ * macros. Never blocks, callable from interrupts up to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY. A record that does not fit is
+ * dropped and counted.
+ */
+void Log_vDefer(uint32 u32Header, uint32 u32Arg0, uint32 u32Arg1, uint32 u32Arg2);
+
+/* Deferred records dropped because the ring was full */
+uint32 Log_u32DeferredDropped(void);
+
+#endif /* LOG_H_ */
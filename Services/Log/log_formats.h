@@ -0,0 +1,58 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log_formats.h
+ *
+ * Description: Format strings of the deferred log records. The target only
+ *              expands the table into format IDs, so none of the strings is
+ *              linked into the firmware; the host decoder expands it into the
+ *              string table that rebuilds the text. Add new formats at the
+ *              end so the IDs of a running target keep matching.
+ *
+ *              Arguments are 32-bit values, printed with %u, %d or %x.
+ *
+ *******************************************************************************/
+
+#ifndef LOG_FORMATS_H_
+#define LOG_FORMATS_H_
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define LOG_FORMATS(FORMAT) \
+    FORMAT(LOG_FMT_CPU_LOAD,            "CPU load %u permille, peak %u permille") \
+    FORMAT(LOG_FMT_BUTTON_ISR,          "Button ISR time is %u cycles, max %u cycles (%u us)") \
+    FORMAT(LOG_FMT_DROPPED,             "Log dropped: %u telemetry frames, %u text lines, %u deferred records") \
+    FORMAT(LOG_FMT_DRIVER_LEVEL,        "Driver -> desired level %u degC") \
+    FORMAT(LOG_FMT_PASSENGER_LEVEL,     "Passenger -> desired level %u degC") \
+    FORMAT(LOG_FMT_DRIVER_FAILURE,      "Driver sensor failure, level %u degC kept since %u ms") \
+    FORMAT(LOG_FMT_PASSENGER_FAILURE,   "Passenger sensor failure, level %u degC kept since %u ms") \
+    FORMAT(LOG_FMT_TASK_LOAD,           "Task %u load %u permille, peak %u permille") \
+    FORMAT(LOG_FMT_TASK_STACK,          "Task %u stack %u of %u words used") \
+    FORMAT(LOG_FMT_MAIN_STACK,          "Main stack %u of %u words used") \
+    FORMAT(LOG_FMT_SEAT_LEVEL,          "Seat %u -> desired level %u degC") \
+    FORMAT(LOG_FMT_SEAT_FAILURE,        "Seat %u sensor failure, level %u degC kept since %u ms") \
+    FORMAT(LOG_FMT_SAMPLES_DROPPED,     "Sensor samples dropped: %u") \
+    FORMAT(LOG_FMT_TUNE_START,          "Seat %u auto-tuning around %u degC") \
+    FORMAT(LOG_FMT_TUNE_DONE,           "Seat %u tuned: ultimate gain %u/65536 permille per 0.01 degC, period %u ms") \
+    FORMAT(LOG_FMT_TUNE_FAILED,         "Seat %u auto-tuning failed, error %u: gains kept") \
+    FORMAT(LOG_FMT_GAINS_STORED,        "Seat %u gains stored") \
+    FORMAT(LOG_FMT_GAINS_NOT_STORED,    "Seat %u gains not stored, EEPROM error") \
+    FORMAT(LOG_FMT_CONSOLE_UNKNOWN,     "Console: unknown command or seat")
+
+#define LOG_FORMAT_ID(ID, STRING)       ID,
+#define LOG_FORMAT_STRING(ID, STRING)   STRING,
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+    LOG_FORMATS(LOG_FORMAT_ID)
+    LOG_FORMATS_NUM
+} Log_FormatId;
+
+#endif /* LOG_FORMATS_H_ */
@@ -0,0 +1,196 @@
+ /******************************************************************************
+ *
+ * Module: Periodic
+ *
+ * File Name: periodic.c
+ *
+ * Description: Source file for the periodic tasks.
+ *
+ * The kernel wakes a task at its release tick, xTaskDelayUntil keeps the
+ * tick of the next release; the release time on the timebase advances by
+ * the period next to it, so both stay in phase without reading the tick
+ * time. When xTaskDelayUntil finds the release already due, the job runs at
+ * once, late by less than a period. When whole periods have passed since
+ * it, the job before overran: those releases are skipped and counted, and
+ * the job runs for the latest one rather than for each, back to back.
+ *
+ * The tick and the timebase run from the same clock on the target; in the
+ * simulation the tick is a host timer and may run ahead, so a job starting
+ * before its release on the timebase moves the release to its start.
+ *
+ *******************************************************************************/
+
+#include "periodic.h"
+#include "stack.h"
+#include "clock.h"
+#include "GPTM.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Periodic_Task *s_apxTasks[PERIODIC_TASKS_MAX];
+static uint8 s_u8Tasks;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 Periodic_u32Deadline(const Periodic_Task *pxTask)
+{
+    return (pxTask->u32DeadlineMs != 0) ? pxTask->u32DeadlineMs : pxTask->u32PeriodMs;
+}
+
+/* Rate monotonic rank: the number of distinct longer deadlines among the automatic tasks */
+static UBaseType_t Periodic_uxAutoPriority(const Periodic_Task *pxTask)
+{
+    uint32 au32Longer[PERIODIC_TASKS_MAX];
+    uint32 u32Deadline = Periodic_u32Deadline(pxTask);
+    uint32 u32Other;
+    UBaseType_t uxRank = 0;
+    UBaseType_t uxSeen;
+    uint8 u8Index;
+
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        u32Other = Periodic_u32Deadline(s_apxTasks[u8Index]);
+        if((s_apxTasks[u8Index]->uxPriority != PERIODIC_PRIORITY_AUTO) || (u32Other <= u32Deadline))
+        {
+            continue;
+        }
+        for(uxSeen = 0; (uxSeen < uxRank) && (au32Longer[uxSeen] != u32Other); uxSeen++)
+        {
+        }
+        if(uxSeen == uxRank)
+        {
+            au32Longer[uxRank++] = u32Other;
+        }
+    }
+    uxRank += PERIODIC_PRIORITY_LOWEST;
+    return (uxRank > PERIODIC_PRIORITY_HIGHEST) ? PERIODIC_PRIORITY_HIGHEST : uxRank;
+}
+
+static void Periodic_vAccount(Periodic_Task *pxTask, uint32 u32Jitter, uint32 u32Response, uint32 u32Skipped)
+{
+    Periodic_Stats *pxStats = &pxTask->xStats;
+
+    taskENTER_CRITICAL();
+    pxStats->u32Jobs++;
+    pxStats->u32Overruns += u32Skipped;
+    if(u32Response > CLOCK_MS_TO_CYCLES(Periodic_u32Deadline(pxTask)))
+    {
+        pxStats->u32DeadlineMisses++;
+    }
+    if(u32Jitter > pxStats->u32MaxJitter)
+    {
+        pxStats->u32MaxJitter = u32Jitter;
+    }
+    if(u32Response > pxStats->u32MaxResponse)
+    {
+        pxStats->u32MaxResponse = u32Response;
+    }
+    taskEXIT_CRITICAL();
+}
+
+static void Periodic_vTask(void *pvParameters)
+{
+    Periodic_Task *pxTask = (Periodic_Task *)pvParameters;
+    const TickType_t xPeriod = pdMS_TO_TICKS(pxTask->u32PeriodMs);
+    const uint32 u32PeriodCycles = CLOCK_MS_TO_CYCLES(pxTask->u32PeriodMs);
+    TickType_t xRelease = xTaskGetTickCount();
+    uint32 u32Release = GPTM_WTimer0Read32();
+    uint32 u32Start;
+    uint32 u32Skipped = 0;
+
+    for(;;)
+    {
+        u32Start = GPTM_WTimer0Read32();
+        if((sint32)(u32Start - u32Release) < 0)
+        {
+            u32Release = u32Start;
+        }
+        pxTask->pfJob(pxTask->pvParameters);
+        if(pxTask->bDiscardJob)
+        {
+            /* Not a job of the task set: start over from here, as if the task had just been created */
+            pxTask->bDiscardJob = FALSE;
+            xRelease = xTaskGetTickCount();
+            u32Release = GPTM_WTimer0Read32();
+        }
+        else
+        {
+            Periodic_vAccount(pxTask, u32Start - u32Release, GPTM_WTimer0Read32() - u32Release, u32Skipped);
+        }
+
+        u32Skipped = 0;
+        u32Release += u32PeriodCycles;
+        if(xTaskDelayUntil(&xRelease, xPeriod) == pdFALSE)
+        {
+            /* Overrun by whole periods: skip those releases, run for the latest one */
+            u32Skipped = (uint32)((xTaskGetTickCount() - xRelease) / xPeriod);
+            if(u32Skipped != 0)
+            {
+                xRelease += (TickType_t)((u32Skipped - 1) * xPeriod);
+                u32Release += u32Skipped * u32PeriodCycles;
+                (void)xTaskDelayUntil(&xRelease, xPeriod);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Periodic_vCreate(Periodic_Task *pxTask)
+{
+    configASSERT(s_u8Tasks < PERIODIC_TASKS_MAX);
+    configASSERT((pxTask->u32PeriodMs != 0) && (Periodic_u32Deadline(pxTask) <= pxTask->u32PeriodMs));
+    configASSERT((pxTask->uxPriority == PERIODIC_PRIORITY_AUTO) || (pxTask->uxPriority < configMAX_PRIORITIES));
+    s_apxTasks[s_u8Tasks++] = pxTask;
+}
+
+void Periodic_vStart(void)
+{
+    Periodic_Task *pxTask;
+    UBaseType_t axPriorities[PERIODIC_TASKS_MAX];
+    uint8 u8Index;
+
+    /* Rank every automatic task before any of them gets its priority */
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        pxTask = s_apxTasks[u8Index];
+        axPriorities[u8Index] = (pxTask->uxPriority == PERIODIC_PRIORITY_AUTO) ?
+                                Periodic_uxAutoPriority(pxTask) : pxTask->uxPriority;
+    }
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        pxTask = s_apxTasks[u8Index];
+        pxTask->uxPriority = axPriorities[u8Index];
+        pxTask->xHandle = xTaskCreateStatic(Periodic_vTask, pxTask->pcName, pxTask->u16StackDepth, pxTask,
+                                            pxTask->uxPriority, &pxTask->puxStack[STACK_GUARD_WORDS], pxTask->pxTCB);
+        configASSERT(pxTask->xHandle != NULL);
+    }
+}
+
+uint8 Periodic_u8Tasks(void)
+{
+    return s_u8Tasks;
+}
+
+const Periodic_Task *Periodic_pxTask(uint8 u8Index)
+{
+    return s_apxTasks[u8Index];
+}
+
+void Periodic_vStats(uint8 u8Index, Periodic_Stats *pxStats)
+{
+    taskENTER_CRITICAL();
+    *pxStats = s_apxTasks[u8Index]->xStats;
+    taskEXIT_CRITICAL();
+}
+
+void Periodic_vDiscardJob(Periodic_Task *pxTask)
+{
+    pxTask->bDiscardJob = TRUE;
+}
@@ -0,0 +1,123 @@
+ /******************************************************************************
+ *
+ * Module: Periodic
+ *
+ * File Name: periodic.h
+ *
+ * Description: Header file for the periodic tasks. A periodic task declares
+ *              its period, deadline and priority at creation and only gives
+ *              the job run at each release; the task loop around it keeps
+ *              the releases on the period and accounts every job on the
+ *              WTimer0 timebase:
+ *                - jitter: from the release to the start of the job
+ *                - response: from the release to the end of the job, a
+ *                  deadline miss when it is past the deadline
+ *                - overruns: releases skipped because the job before was
+ *                  still running a whole period past them; the task does
+ *                  not catch up on them, the next job runs for the latest
+ *
+ *              A job doing a long piece of work on request, outside of the
+ *              task set (a trace dump), calls Periodic_vDiscardJob(): it is
+ *              not accounted and the releases restart from its end.
+ *
+ *              With PERIODIC_PRIORITY_AUTO the priorities are assigned in
+ *              rate monotonic order (deadline monotonic for a deadline
+ *              shorter than the period) within the periodic band, when the
+ *              tasks are started. The event driven tasks keep their own
+ *              priorities; Simulation/Tools/rta checks the whole set.
+ *
+ *              Every task is static: the descriptor, its stack buffer with
+ *              room for the stack guard (see stack.h) and its TCB.
+ *
+ *                  static StackType_t axStack[STACK_GUARD_WORDS + DEPTH];
+ *                  static StaticTask_t xTCB;
+ *                  static Periodic_Task xTask = { "Name", vJob, NULL, PERIOD_MS, 0,
+ *                                                 PERIODIC_PRIORITY_AUTO, DEPTH, axStack, &xTCB };
+ *                  Periodic_vCreate(&xTask);
+ *                  ...
+ *                  Periodic_vStart();
+ *                  vTaskStartScheduler();
+ *
+ *              The statistics are reported in TELEMETRY_FRAME_PERIODIC frames.
+ *
+ *******************************************************************************/
+
+#ifndef PERIODIC_H_
+#define PERIODIC_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define PERIODIC_TASKS_MAX              3
+
+/* Priority band of the automatically assigned priorities, the shortest deadline on top */
+#define PERIODIC_PRIORITY_LOWEST        1
+#define PERIODIC_PRIORITY_HIGHEST       3
+
+#define PERIODIC_PRIORITY_AUTO          ((UBaseType_t)~0UL)
+
+#if (PERIODIC_PRIORITY_HIGHEST >= configMAX_PRIORITIES) || (PERIODIC_PRIORITY_LOWEST > PERIODIC_PRIORITY_HIGHEST)
+#error "The periodic priority band must be within the kernel priorities"
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef void (*Periodic_Job)(void *pvParameters);
+
+/* Since the start, in CPU cycles of the WTimer0 timebase */
+typedef struct
+{
+    uint32 u32Jobs;
+    uint32 u32DeadlineMisses;
+    uint32 u32Overruns;         /* Releases skipped */
+    uint32 u32MaxJitter;
+    uint32 u32MaxResponse;
+} Periodic_Stats;
+
+typedef struct
+{
+    /* Declared */
+    const char   *pcName;
+    Periodic_Job  pfJob;
+    void         *pvParameters;     /* Of the job */
+    uint32        u32PeriodMs;
+    uint32        u32DeadlineMs;    /* 0 for the period */
+    UBaseType_t   uxPriority;       /* Or PERIODIC_PRIORITY_AUTO */
+    uint16        u16StackDepth;    /* Words, without the guard */
+    StackType_t  *puxStack;         /* STACK_GUARD_WORDS + u16StackDepth words */
+    StaticTask_t *pxTCB;
+
+    /* Set by the service */
+    TaskHandle_t  xHandle;
+    Periodic_Stats xStats;
+    volatile boolean bDiscardJob;
+} Periodic_Task;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Register a periodic task, before Periodic_vStart */
+void Periodic_vCreate(Periodic_Task *pxTask);
+
+/* Assign the automatic priorities and create the tasks, before the scheduler starts */
+void Periodic_vStart(void);
+
+/* Tasks registered, then each one */
+uint8 Periodic_u8Tasks(void);
+const Periodic_Task *Periodic_pxTask(uint8 u8Index);
+
+/* Consistent copy of the statistics of a task */
+void Periodic_vStats(uint8 u8Index, Periodic_Stats *pxStats);
+
+/* From the job of the task: leave the running job out of the statistics */
+void Periodic_vDiscardJob(Periodic_Task *pxTask);
+
+#endif /* PERIODIC_H_ */
@@ -0,0 +1,87 @@
+ /******************************************************************************
+ *
+ * Module: Pid
+ *
+ * File Name: pid.c
+ *
+ * Description: Source file for the fixed point PID controller.
+ *
+ * The products are 64-bit: a Q16 gain times a 0.01 degC error takes more than
+ * 32 bits for the larger gains, and a 32x32->64 multiply is a single
+ * instruction on the M4.
+ *
+ *******************************************************************************/
+
+#include "pid.h"
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static sint64 Pid_s64Clamp(sint64 s64Value, sint64 s64Min, sint64 s64Max)
+{
+    if(s64Value < s64Min)
+    {
+        return s64Min;
+    }
+    if(s64Value > s64Max)
+    {
+        return s64Max;
+    }
+    return s64Value;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Pid_vInit(Pid_Controller *pxPid, const Pid_Gains *pxGains, sint32 s32OutMin, sint32 s32OutMax)
+{
+    pxPid->xGains = *pxGains;
+    pxPid->s32OutMin = s32OutMin;
+    pxPid->s32OutMax = s32OutMax;
+    Pid_vReset(pxPid);
+}
+
+void Pid_vSetGains(Pid_Controller *pxPid, const Pid_Gains *pxGains)
+{
+    pxPid->xGains = *pxGains;
+}
+
+void Pid_vReset(Pid_Controller *pxPid)
+{
+    pxPid->s32Integral = 0;
+    pxPid->s32LastMeasurement = 0;
+    pxPid->bStarted = FALSE;
+}
+
+sint32 Pid_s32Update(Pid_Controller *pxPid, sint32 s32Setpoint, sint32 s32Measurement)
+{
+    const sint64 s64Min = (sint64)pxPid->s32OutMin << 16;
+    const sint64 s64Max = (sint64)pxPid->s32OutMax << 16;
+    sint32 s32Error = s32Setpoint - s32Measurement;
+    sint64 s64Integral;
+    sint64 s64Output;
+
+    /* Proportional and derivative parts, Q16 */
+    s64Output = (sint64)pxPid->xGains.s32Kp * s32Error;
+    if(pxPid->bStarted)
+    {
+        s64Output -= (sint64)pxPid->xGains.s32Kd * (s32Measurement - pxPid->s32LastMeasurement);
+    }
+    pxPid->s32LastMeasurement = s32Measurement;
+    pxPid->bStarted = TRUE;
+
+    /* Integrate unless the output is held at a limit the error pushes towards */
+    s64Integral = Pid_s64Clamp(pxPid->s32Integral + ((sint64)pxPid->xGains.s32Ki * s32Error), s64Min, s64Max);
+    if(!(((s64Output + s64Integral) > s64Max) && (s32Error > 0)) &&
+       !(((s64Output + s64Integral) < s64Min) && (s32Error < 0)))
+    {
+        pxPid->s32Integral = (sint32)s64Integral;
+    }
+
+    s64Output = Pid_s64Clamp(s64Output + pxPid->s32Integral, s64Min, s64Max);
+
+    /* Round to the nearest output unit */
+    return (sint32)((s64Output + 0x8000) >> 16);
+}
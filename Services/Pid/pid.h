@@ -0,0 +1,70 @@
+ /******************************************************************************
+ *
+ * Module: Pid
+ *
+ * File Name: pid.h
+ *
+ * Description: Header file for the fixed point PID controller, run once per
+ *              sample of its measurement.
+ *
+ *              The gains are Q16: output units per input unit for Kp, per
+ *              input unit and sample for Ki, per input unit change over a
+ *              sample for Kd. The derivative acts on the measurement, not on
+ *              the error, so a set point step does not kick the output.
+ *
+ *              Anti-windup: the integral is held while the output is clamped
+ *              and the error would drive it further out, and the integral
+ *              itself stays within the output range. Once the error turns,
+ *              the output leaves the limit on the next sample.
+ *
+ *******************************************************************************/
+
+#ifndef PID_H_
+#define PID_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define PID_Q16(GAIN)                   ((sint32)((GAIN) * 65536.0))
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    sint32 s32Kp;
+    sint32 s32Ki;
+    sint32 s32Kd;
+} Pid_Gains;
+
+typedef struct
+{
+    Pid_Gains xGains;
+    sint32  s32OutMin;
+    sint32  s32OutMax;
+    sint32  s32Integral;            /* Q16 output units */
+    sint32  s32LastMeasurement;
+    boolean bStarted;               /* s32LastMeasurement holds a sample */
+} Pid_Controller;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Gains and output range of a controller, from a reset state */
+void Pid_vInit(Pid_Controller *pxPid, const Pid_Gains *pxGains, sint32 s32OutMin, sint32 s32OutMax);
+
+/* New gains, the integral is kept */
+void Pid_vSetGains(Pid_Controller *pxPid, const Pid_Gains *pxGains);
+
+/* Clear the integral and the derivative history, when the loop is opened */
+void Pid_vReset(Pid_Controller *pxPid);
+
+/* One sample: the output for the set point and the measurement, within the output range */
+sint32 Pid_s32Update(Pid_Controller *pxPid, sint32 s32Setpoint, sint32 s32Measurement);
+
+#endif /* PID_H_ */
@@ -0,0 +1,178 @@
+ /******************************************************************************
+ *
+ * Module: RunTime
+ *
+ * File Name: runtime.c
+ *
+ * Description: Source file for the run time statistics.
+ *
+ * Each followed task keeps its run time counter at the last
+ * RUNTIME_WINDOW_SAMPLES + 1 samples in a small ring, next to the total run
+ * time at the same samples; the load over the window is the ratio of the two
+ * differences between the newest and the oldest sample. The differences fit
+ * in 32 bits as long as the window is shorter than 2^32 cycles, so no 64-bit
+ * division is needed.
+ *
+ * The first sample is only a baseline: the counters before it run from the
+ * timebase start and charge the time before the scheduler started to the first
+ * task switched out. Until the ring is full the window runs from the oldest
+ * sample taken, and the peaks are only those of full windows.
+ *
+ *******************************************************************************/
+
+#include "runtime.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define RUNTIME_RING_LENGTH             (RUNTIME_WINDOW_SAMPLES + 1)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static TaskStatus_t s_axStatus[RUNTIME_TASKS_MAX];
+static RunTime_Task s_axTasks[RUNTIME_TASKS_MAX];
+static uint8  s_u8Tasks;
+
+static uint64 s_au64Total[RUNTIME_RING_LENGTH];
+static uint8  s_u8Slot;             /* Ring slot of the newest sample */
+static uint8  s_u8Samples;          /* Samples taken, up to RUNTIME_RING_LENGTH */
+static uint16 s_u16Load;
+static uint16 s_u16PeakLoad;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Entry of a task, a new one if it was not followed yet. NULL_PTR if the table is full. */
+static RunTime_Task *RunTime_pxFind(const TaskStatus_t *pxStatus)
+{
+    RunTime_Task *pxTask;
+    uint8 u8Index;
+    uint8 u8Slot;
+
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        if(s_axTasks[u8Index].xHandle == pxStatus->xHandle)
+        {
+            return &s_axTasks[u8Index];
+        }
+    }
+    if(s_u8Tasks == RUNTIME_TASKS_MAX)
+    {
+        return NULL_PTR;
+    }
+
+    /* A new task has run for its whole counter within the window so far */
+    pxTask = &s_axTasks[s_u8Tasks++];
+    pxTask->xHandle = pxStatus->xHandle;
+    pxTask->uxNumber = pxStatus->xTaskNumber;
+    for(u8Slot = 0; u8Slot < RUNTIME_RING_LENGTH; u8Slot++)
+    {
+        pxTask->au64Counter[u8Slot] = 0;
+    }
+    pxTask->u16Load = 0;
+    pxTask->u16PeakLoad = 0;
+    pxTask->bNew = TRUE;
+    return pxTask;
+}
+
+static uint16 RunTime_u16Ratio(uint32 u32Part, uint32 u32Scale)
+{
+    uint32 u32Load = (u32Scale != 0) ? (u32Part / u32Scale) : 0;
+
+    return (u32Load > RUNTIME_LOAD_FULL) ? RUNTIME_LOAD_FULL : (uint16)u32Load;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void RunTime_vSample(void)
+{
+    TaskHandle_t xIdle = xTaskGetIdleTaskHandle();
+    configRUN_TIME_COUNTER_TYPE xTotal;
+    RunTime_Task *pxTask;
+    boolean abSeen[RUNTIME_TASKS_MAX] = { FALSE };
+    UBaseType_t uxCount;
+    UBaseType_t uxStatus;
+    uint32 u32Scale;
+    uint8  u8Oldest;
+    uint8  u8Index;
+    boolean bFull;
+    uint8  u8Kept = 0;
+
+    uxCount = uxTaskGetSystemState(s_axStatus, RUNTIME_TASKS_MAX, &xTotal);
+    configASSERT(uxCount != 0);     /* More tasks than RUNTIME_TASKS_MAX */
+
+    s_u8Slot = (uint8)((s_u8Slot + 1) % RUNTIME_RING_LENGTH);
+    if(s_u8Samples < RUNTIME_RING_LENGTH)
+    {
+        s_u8Samples++;
+    }
+    bFull = (s_u8Samples == RUNTIME_RING_LENGTH);
+    u8Oldest = (uint8)((s_u8Slot + RUNTIME_RING_LENGTH + 1 - s_u8Samples) % RUNTIME_RING_LENGTH);
+    s_au64Total[s_u8Slot] = xTotal;
+    u32Scale = (uint32)(s_au64Total[s_u8Slot] - s_au64Total[u8Oldest]) / RUNTIME_LOAD_FULL;
+
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        s_axTasks[u8Index].bNew = FALSE;
+    }
+    for(uxStatus = 0; uxStatus < uxCount; uxStatus++)
+    {
+        pxTask = RunTime_pxFind(&s_axStatus[uxStatus]);
+        if(pxTask == NULL_PTR)
+        {
+            continue;
+        }
+        abSeen[pxTask - s_axTasks] = TRUE;
+        pxTask->pcName = s_axStatus[uxStatus].pcTaskName;
+        pxTask->au64Counter[s_u8Slot] = s_axStatus[uxStatus].ulRunTimeCounter;
+        pxTask->u16Load = RunTime_u16Ratio((uint32)(pxTask->au64Counter[s_u8Slot] - pxTask->au64Counter[u8Oldest]), u32Scale);
+        if(bFull && (pxTask->u16Load > pxTask->u16PeakLoad))
+        {
+            pxTask->u16PeakLoad = pxTask->u16Load;
+        }
+        if(pxTask->xHandle == xIdle)
+        {
+            s_u16Load = (u32Scale != 0) ? (uint16)(RUNTIME_LOAD_FULL - pxTask->u16Load) : 0;
+        }
+    }
+    if(bFull && (s_u16Load > s_u16PeakLoad))
+    {
+        s_u16PeakLoad = s_u16Load;
+    }
+
+    /* Forget the deleted tasks */
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        if(abSeen[u8Index])
+        {
+            s_axTasks[u8Kept++] = s_axTasks[u8Index];
+        }
+    }
+    s_u8Tasks = u8Kept;
+}
+
+uint8 RunTime_u8Tasks(void)
+{
+    return s_u8Tasks;
+}
+
+const RunTime_Task *RunTime_pxTask(uint8 u8Index)
+{
+    return &s_axTasks[u8Index];
+}
+
+uint16 RunTime_u16Load(void)
+{
+    return s_u16Load;
+}
+
+uint16 RunTime_u16PeakLoad(void)
+{
+    return s_u16PeakLoad;
+}
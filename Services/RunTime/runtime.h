@@ -0,0 +1,67 @@
+ /******************************************************************************
+ *
+ * Module: RunTime
+ *
+ * File Name: runtime.h
+ *
+ * Description: Header file for the run time statistics. The kernel keeps a
+ *              64-bit run time counter per task in its TCB, clocked in CPU
+ *              cycles by the WTimer0 timebase (configGENERATE_RUN_TIME_STATS). Sampling
+ *              them periodically gives the CPU load of every task, and of the
+ *              whole CPU, over a sliding window of the last few samples, with
+ *              the peak window seen so far. Tasks are picked up and dropped
+ *              automatically as they are created and deleted.
+ *
+ *******************************************************************************/
+
+#ifndef RUNTIME_H_
+#define RUNTIME_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Tasks followed, idle and timer service tasks included */
+#define RUNTIME_TASKS_MAX               12
+
+/* Samples in the sliding window, the window is RUNTIME_WINDOW_SAMPLES sampling periods long */
+#define RUNTIME_WINDOW_SAMPLES          4
+
+/* Loads are given in 1/1000 of the CPU */
+#define RUNTIME_LOAD_FULL               1000
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    TaskHandle_t xHandle;
+    const char  *pcName;
+    UBaseType_t  uxNumber;                                  /* Kernel task number, unique per task */
+    uint64       au64Counter[RUNTIME_WINDOW_SAMPLES + 1];   /* Run time counter at each sample of the window */
+    uint16       u16Load;                                   /* Over the window, in 1/1000 */
+    uint16       u16PeakLoad;                               /* Highest load over a full window */
+    boolean      bNew;                                      /* First seen at the last sample */
+} RunTime_Task;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Take a sample of every task's run time counter and update the window loads */
+void RunTime_vSample(void);
+
+/* Tasks followed after the last sample */
+uint8 RunTime_u8Tasks(void);
+const RunTime_Task *RunTime_pxTask(uint8 u8Index);
+
+/* Whole CPU load over the window (all but the idle task) and its peak, in 1/1000 */
+uint16 RunTime_u16Load(void);
+uint16 RunTime_u16PeakLoad(void);
+
+#endif /* RUNTIME_H_ */
@@ -0,0 +1,85 @@
+ /******************************************************************************
+ *
+ * Module: Sample
+ *
+ * File Name: sample.c
+ *
+ * Description: Source file for the sensor sample queue.
+ *
+ * The head and the tail count the records published and consumed since the
+ * start and wrap together, so the ring is full when they are
+ * SAMPLE_RING_RECORDS apart. The ring and both indices are volatile: the
+ * compiler keeps the copy of a record on the right side of the index that
+ * hands it over. The atomic.h increments mask the interrupts for their
+ * read-modify-write on this core, a few cycles.
+ *
+ *******************************************************************************/
+
+#include "sample.h"
+
+/* Neither port defines it: inline, the atomic.h functions unused here are not compiled */
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE                inline
+#endif
+
+#include "FreeRTOS.h"
+#include "atomic.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SAMPLE_RING_MASK                (SAMPLE_RING_RECORDS - 1)
+
+#if (SAMPLE_RING_RECORDS & SAMPLE_RING_MASK) != 0
+#error "SAMPLE_RING_RECORDS must be a power of two"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static volatile Sample_Record s_axRing[SAMPLE_RING_RECORDS];
+static volatile uint32_t s_ulHead;      /* Records published, written by the producer only */
+static volatile uint32_t s_ulTail;      /* Records consumed, written by the consumer only */
+static volatile uint32 s_u32Dropped;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+boolean Sample_bPublishFromISR(const Sample_Record *pxRecord)
+{
+    uint32_t ulHead = s_ulHead;
+
+    if((ulHead - s_ulTail) >= SAMPLE_RING_RECORDS)
+    {
+        s_u32Dropped++;
+        return FALSE;
+    }
+    s_axRing[ulHead & SAMPLE_RING_MASK] = *pxRecord;
+
+    /* The record is whole, hand it over */
+    (void)Atomic_Increment_u32(&s_ulHead);
+    return TRUE;
+}
+
+boolean Sample_bConsume(Sample_Record *pxRecord)
+{
+    uint32_t ulTail = s_ulTail;
+
+    if(ulTail == s_ulHead)
+    {
+        return FALSE;
+    }
+    *pxRecord = s_axRing[ulTail & SAMPLE_RING_MASK];
+
+    /* The record is copied, give its slot back */
+    (void)Atomic_Increment_u32(&s_ulTail);
+    return TRUE;
+}
+
+uint32 Sample_u32Dropped(void)
+{
+    return s_u32Dropped;
+}
@@ -0,0 +1,59 @@
+ /******************************************************************************
+ *
+ * Module: Sample
+ *
+ * File Name: sample.h
+ *
+ * Description: Header file for the sensor sample queue. The ADC capture
+ *              interrupt publishes one record per seat sensor and capture:
+ *              the raw value, the converted temperature, the seat and the
+ *              WTimer0 timestamp of the capture. The heater task consumes
+ *              every record in order, and its age is the timebase now less
+ *              its timestamp.
+ *
+ *              The queue is a single producer, single consumer ring: the
+ *              producer only writes the head, the consumer only the tail,
+ *              and each one moves its index past a whole record with an
+ *              atomic.h increment. Neither side ever waits for the other; a
+ *              record published to a full ring is dropped and counted.
+ *
+ *******************************************************************************/
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Records of the ring, a power of two: two captures of 8 seats */
+#define SAMPLE_RING_RECORDS             16
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 u32Timestamp;        /* WTimer0 cycles, low word, at the end of the capture */
+    uint32 u32Temperature;      /* 0.01 degC (see temperature.h) */
+    uint16 u16Raw;              /* ADC value, averaged over the capture */
+    uint8  u8Seat;
+} Sample_Record;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Producer: queue a record, FALSE when the ring is full and it is dropped */
+boolean Sample_bPublishFromISR(const Sample_Record *pxRecord);
+
+/* Consumer: the oldest record not consumed yet, FALSE when there is none */
+boolean Sample_bConsume(Sample_Record *pxRecord);
+
+/* Records dropped on a full ring since the start */
+uint32 Sample_u32Dropped(void);
+
+#endif /* SAMPLE_H_ */
@@ -0,0 +1,176 @@
+ /******************************************************************************
+ *
+ * Module: Stack
+ *
+ * File Name: stack.c
+ *
+ * Description: Source file for the stack monitor.
+ *
+ * The kernel fills every task stack with tskSTACK_FILL_BYTE when the task is
+ * created and uxTaskGetStackHighWaterMark() counts the words still holding
+ * it. The main stack gets the same pattern from Stack_vInit(), above the
+ * frame of main(); the kernel starts it over from __STACK_TOP, so after the
+ * scheduler starts it only holds the interrupt frames.
+ *
+ *******************************************************************************/
+
+#include "stack.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* The kernel stack fill pattern (tskSTACK_FILL_BYTE), four times */
+#define STACK_FILL_WORD                 0xA5A5A5A5UL
+
+/* Words kept under the frame of main() when filling the main stack */
+#define STACK_MAIN_MARGIN_WORDS         16
+
+#define STACK_MAIN_WORDS                (STACK_MAIN_SIZE / sizeof(uint32))
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Main stack placed by the linker (tm4c123gh6pm.cmd) */
+extern uint32 __stack[];
+
+static Stack_Task s_axTasks[STACK_TASKS_MAX];
+static uint8 s_u8Tasks;
+
+static Stack_Task s_xMain;
+static uint32 *s_pu32MainLow;       /* Lowest word of the main stack above its guard */
+
+/* Task running when a guard was hit, for the debugger */
+static volatile TaskHandle_t s_xFaultTask;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* First MPU_GUARD_SIZE aligned block at or above an address */
+static uintptr_t Stack_xGuard(uintptr_t xLow)
+{
+    return (xLow + (MPU_GUARD_SIZE - 1)) & ~(uintptr_t)(MPU_GUARD_SIZE - 1);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Stack_vInit(void)
+{
+    volatile uint32 u32Frame;       /* Its address is in the frame of main() */
+    uint32 *pu32Top = (uint32 *)((uintptr_t)&u32Frame - (STACK_MAIN_MARGIN_WORDS * sizeof(uint32)));
+    uint32 *pu32Word;
+    uintptr_t xGuard = Stack_xGuard((uintptr_t)__stack);
+
+    s_pu32MainLow = (uint32 *)(xGuard + MPU_GUARD_SIZE);
+    if(pu32Top > &__stack[STACK_MAIN_WORDS])
+    {
+        pu32Top = &__stack[STACK_MAIN_WORDS];
+    }
+    for(pu32Word = s_pu32MainLow; pu32Word < pu32Top; pu32Word++)
+    {
+        *pu32Word = STACK_FILL_WORD;
+    }
+    s_xMain.xHandle = NULL;
+    s_xMain.u16Depth = (uint16)(&__stack[STACK_MAIN_WORDS] - s_pu32MainLow);
+
+    /* The task guard waits on the main one until the first task is switched in */
+    MPU_vSetGuard(MPU_REGION_MAIN_STACK_GUARD, (uint32)xGuard);
+    MPU_vSetGuard(MPU_REGION_TASK_STACK_GUARD, (uint32)xGuard);
+    MPU_vInit();
+}
+
+void Stack_vTaskCreated(void *pvTask, void *pvStack, void *pvEndOfStack, uint32 u32Number)
+{
+    Stack_Task *pxTask;
+
+    if(s_u8Tasks == STACK_TASKS_MAX)
+    {
+        return;
+    }
+    pxTask = &s_axTasks[s_u8Tasks++];
+    pxTask->xHandle = (TaskHandle_t)pvTask;
+    pxTask->uxNumber = u32Number;
+    pxTask->u16Depth = (uint16)(((StackType_t *)pvEndOfStack - (StackType_t *)pvStack) + 1);
+    pxTask->u16Used = 0;
+    pxTask->bChanged = FALSE;
+}
+
+void Stack_vTaskDeleted(void *pvTask)
+{
+    uint8 u8Index;
+
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        if(s_axTasks[u8Index].xHandle == (TaskHandle_t)pvTask)
+        {
+            s_axTasks[u8Index] = s_axTasks[--s_u8Tasks];
+            return;
+        }
+    }
+}
+
+void Stack_vTaskSwitchedIn(void *pvStack)
+{
+    MPU_vMoveGuard(MPU_REGION_TASK_STACK_GUARD,
+                   (uint32)Stack_xGuard((uintptr_t)((StackType_t *)pvStack - STACK_GUARD_WORDS)));
+}
+
+void Stack_vSample(void)
+{
+    const uint32 *pu32Word = s_pu32MainLow;
+    Stack_Task *pxTask;
+    uint16 u16Used;
+    uint8  u8Index;
+
+    /* Tasks are only created and deleted by tasks, so the table holds still meanwhile */
+    vTaskSuspendAll();
+    for(u8Index = 0; u8Index < s_u8Tasks; u8Index++)
+    {
+        pxTask = &s_axTasks[u8Index];
+        u16Used = (uint16)(pxTask->u16Depth - uxTaskGetStackHighWaterMark(pxTask->xHandle));
+        pxTask->bChanged = (u16Used > pxTask->u16Used) ? TRUE : FALSE;
+        if(pxTask->bChanged)
+        {
+            pxTask->u16Used = u16Used;
+        }
+    }
+    (void)xTaskResumeAll();
+
+    while((pu32Word < &__stack[STACK_MAIN_WORDS]) && (*pu32Word == STACK_FILL_WORD))
+    {
+        pu32Word++;
+    }
+    u16Used = (uint16)(&__stack[STACK_MAIN_WORDS] - pu32Word);
+    s_xMain.bChanged = (u16Used > s_xMain.u16Used) ? TRUE : FALSE;
+    if(s_xMain.bChanged)
+    {
+        s_xMain.u16Used = u16Used;
+    }
+}
+
+uint8 Stack_u8Tasks(void)
+{
+    return s_u8Tasks;
+}
+
+const Stack_Task *Stack_pxTask(uint8 u8Index)
+{
+    return &s_axTasks[u8Index];
+}
+
+const Stack_Task *Stack_pxMain(void)
+{
+    return &s_xMain;
+}
+
+void MPUFault_Handler(void)
+{
+    /* A stack ran into its guard: stop here, like configASSERT() */
+    s_xFaultTask = xTaskGetCurrentTaskHandle();
+    taskDISABLE_INTERRUPTS();
+    for(;;);
+}
@@ -0,0 +1,91 @@
+ /******************************************************************************
+ *
+ * Module: Stack
+ *
+ * File Name: stack.h
+ *
+ * Description: Header file for the stack monitor. It follows the high
+ *              watermark of every task stack and of the main stack used by
+ *              the interrupts, and guards each of them with a no access MPU
+ *              region right under its lowest word: an overflow faults on its
+ *              first write instead of corrupting the memory below. The task
+ *              guard is moved to the stack of the task switched in, a single
+ *              register write, so there is no pattern check at the switch
+ *              (configCHECK_FOR_STACK_OVERFLOW stays 0).
+ *
+ *              Every task stack buffer holds STACK_GUARD_WORDS below the
+ *              stack given to the kernel, the guard is the MPU_GUARD_SIZE
+ *              aligned block inside them:
+ *
+ *                  static StackType_t axStack[STACK_GUARD_WORDS + DEPTH];
+ *                  xTaskCreateStatic(..., DEPTH, ..., &axStack[STACK_GUARD_WORDS], ...);
+ *
+ *******************************************************************************/
+
+#ifndef STACK_H_
+#define STACK_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mpu.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Tasks followed, idle and timer service tasks included */
+#define STACK_TASKS_MAX                 12
+
+/* Room below each task stack for its guard, wherever the buffer is aligned */
+#define STACK_GUARD_WORDS               ((2 * MPU_GUARD_SIZE) / sizeof(StackType_t))
+
+/*
+ * Main stack in bytes, from __stack: the --stack_size of the CCS project and
+ * __STACK_TOP of tm4c123gh6pm.cmd must match. Its guard takes up to
+ * 2 * MPU_GUARD_SIZE of it.
+ */
+#define STACK_MAIN_SIZE                 576
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    TaskHandle_t xHandle;           /* NULL for the main stack */
+    UBaseType_t  uxNumber;          /* Kernel task number, as in RunTime_Task */
+    uint16       u16Depth;          /* Words */
+    uint16       u16Used;           /* Most words ever used, the high watermark */
+    boolean      bChanged;          /* The high watermark rose at the last sample */
+} Stack_Task;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/*
+ * Fill the free part of the main stack with a known pattern, guard it and
+ * enable the MPU. Call from main() before creating any task.
+ */
+void Stack_vInit(void);
+
+/* Kernel trace hooks (FreeRTOSConfig.h) */
+void Stack_vTaskCreated(void *pvTask, void *pvStack, void *pvEndOfStack, uint32 u32Number);
+void Stack_vTaskDeleted(void *pvTask);
+void Stack_vTaskSwitchedIn(void *pvStack);
+
+/* Update the high watermarks of every stack */
+void Stack_vSample(void);
+
+/* Task stacks followed */
+uint8 Stack_u8Tasks(void);
+const Stack_Task *Stack_pxTask(uint8 u8Index);
+
+/* The main stack, as of the last sample */
+const Stack_Task *Stack_pxMain(void);
+
+/* Fault handler of the guards, in the vector table */
+void MPUFault_Handler(void);
+
+#endif /* STACK_H_ */
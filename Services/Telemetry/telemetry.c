@@ -0,0 +1,322 @@
+ /******************************************************************************
+ *
+ * Module: Telemetry
+ *
+ * File Name: telemetry.c
+ *
+ * Description: Source file for the binary telemetry frames. The same code
+ *              builds the frames on the target and decodes them on the host
+ *              (Simulation/Tools/telemetry_decode.c).
+ *
+ *******************************************************************************/
+
+#include "telemetry.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* CRC of each nibble value, a 16 entry table instead of 256 */
+static const uint16 s_au16CrcNibble[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+static uint16 s_u16Sequence;
+static uint16 s_u16LatencySequence;
+static uint16 s_u16PeriodicSequence;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Telemetry_vPut16(uint8 *pu8Out, uint16 u16Value)
+{
+    pu8Out[0] = (uint8)u16Value;
+    pu8Out[1] = (uint8)(u16Value >> 8);
+}
+
+void Telemetry_vPut32(uint8 *pu8Out, uint32 u32Value)
+{
+    Telemetry_vPut16(pu8Out, (uint16)u32Value);
+    Telemetry_vPut16(pu8Out + 2, (uint16)(u32Value >> 16));
+}
+
+uint16 Telemetry_u16Get16(const uint8 *pu8In)
+{
+    return (uint16)(pu8In[0] | ((uint16)pu8In[1] << 8));
+}
+
+uint32 Telemetry_u32Get32(const uint8 *pu8In)
+{
+    return Telemetry_u16Get16(pu8In) | ((uint32)Telemetry_u16Get16(pu8In + 2) << 16);
+}
+
+uint16 Telemetry_u16Crc16(uint16 u16Crc, const uint8 *pu8Data, uint16 u16Length)
+{
+    while(u16Length-- != 0)
+    {
+        u16Crc = (uint16)(u16Crc << 4) ^ s_au16CrcNibble[(u16Crc >> 12) ^ (*pu8Data >> 4)];
+        u16Crc = (uint16)(u16Crc << 4) ^ s_au16CrcNibble[(u16Crc >> 12) ^ (*pu8Data & 0x0F)];
+        pu8Data++;
+    }
+    return u16Crc;
+}
+
+uint16 Telemetry_u16CobsEncode(const uint8 *pu8In, uint16 u16Length, uint8 *pu8Out)
+{
+    uint16 u16Code = 0;         /* Where the code byte of the current block goes */
+    uint16 u16Out = 1;
+    uint8  u8Code = 1;
+
+    while(u16Length-- != 0)
+    {
+        if(*pu8In != 0)
+        {
+            pu8Out[u16Out++] = *pu8In;
+            u8Code++;
+        }
+        if((*pu8In == 0) || (u8Code == 0xFF))
+        {
+            /* Close the block: a zero, or 254 non-zero bytes in a row */
+            pu8Out[u16Code] = u8Code;
+            u16Code = u16Out++;
+            u8Code = 1;
+        }
+        pu8In++;
+    }
+    pu8Out[u16Code] = u8Code;
+    return u16Out;
+}
+
+uint16 Telemetry_u16CobsDecode(const uint8 *pu8In, uint16 u16Length, uint8 *pu8Out)
+{
+    uint16 u16In = 0;
+    uint16 u16Out = 0;
+    uint8  u8Code;
+    uint8  u8Byte;
+
+    while(u16In < u16Length)
+    {
+        u8Code = pu8In[u16In++];
+        if((u8Code == 0) || ((uint16)(u16In + u8Code - 1) > u16Length))
+        {
+            return 0;
+        }
+        for(u8Byte = 1; u8Byte < u8Code; u8Byte++)
+        {
+            if(pu8In[u16In] == 0)
+            {
+                return 0;
+            }
+            pu8Out[u16Out++] = pu8In[u16In++];
+        }
+        /* A short block stands for a zero, except at the very end */
+        if((u8Code != 0xFF) && (u16In < u16Length))
+        {
+            pu8Out[u16Out++] = 0;
+        }
+    }
+    return u16Out;
+}
+
+uint16 Telemetry_u16EncodeFrame(uint8 *pu8Payload, uint16 u16Length, uint8 *pu8Out)
+{
+    uint16 u16Encoded;
+
+    Telemetry_vPut16(&pu8Payload[u16Length], Telemetry_u16Crc16(TELEMETRY_CRC_INIT, pu8Payload, u16Length));
+    u16Length += TELEMETRY_CRC_LENGTH;
+
+    pu8Out[0] = 0;
+    u16Encoded = Telemetry_u16CobsEncode(pu8Payload, u16Length, &pu8Out[1]);
+    pu8Out[u16Encoded + 1] = 0;
+    return u16Encoded + 2;
+}
+
+uint16 Telemetry_u16DecodeFrame(const uint8 *pu8In, uint16 u16Length, uint8 *pu8Payload)
+{
+    u16Length = Telemetry_u16CobsDecode(pu8In, u16Length, pu8Payload);
+    if((u16Length <= TELEMETRY_CRC_LENGTH) ||
+       (Telemetry_u16Crc16(TELEMETRY_CRC_INIT, pu8Payload, u16Length - TELEMETRY_CRC_LENGTH) !=
+        Telemetry_u16Get16(&pu8Payload[u16Length - TELEMETRY_CRC_LENGTH])))
+    {
+        return 0;
+    }
+    return u16Length - TELEMETRY_CRC_LENGTH;
+}
+
+uint16 Telemetry_u16BuildSeatsFrame(const Telemetry_Seat *pxSeats, uint8 u8Seats,
+                                    uint32 u32Timestamp, uint8 *pu8Out)
+{
+    uint8  au8Payload[TELEMETRY_PAYLOAD_MAX_LENGTH];
+    uint16 u16Length = TELEMETRY_HEADER_LENGTH;
+    uint8  u8Seat;
+
+    if(u8Seats > TELEMETRY_SEATS_MAX)
+    {
+        u8Seats = TELEMETRY_SEATS_MAX;
+    }
+
+    au8Payload[0] = TELEMETRY_FRAME_SEATS;
+    Telemetry_vPut16(&au8Payload[1], s_u16Sequence++);
+    Telemetry_vPut32(&au8Payload[3], u32Timestamp);
+    au8Payload[7] = u8Seats;
+    for(u8Seat = 0; u8Seat < u8Seats; u8Seat++)
+    {
+        Telemetry_vPut16(&au8Payload[u16Length], pxSeats[u8Seat].u16Temperature);
+        au8Payload[u16Length + 2] = pxSeats[u8Seat].u8Level;
+        au8Payload[u16Length + 3] = pxSeats[u8Seat].u8Intensity;
+        au8Payload[u16Length + 4] = pxSeats[u8Seat].u8Flags;
+        u16Length += TELEMETRY_SEAT_LENGTH;
+    }
+    return Telemetry_u16EncodeFrame(au8Payload, u16Length, pu8Out);
+}
+
+boolean Telemetry_bParseSeatsReport(const uint8 *pu8Payload, uint16 u16Length,
+                                    Telemetry_SeatsReport *pxReport)
+{
+    const uint8 *pu8Seat;
+    uint8 u8Seat;
+
+    if((u16Length < TELEMETRY_HEADER_LENGTH) ||
+       (pu8Payload[0] != TELEMETRY_FRAME_SEATS) ||
+       (pu8Payload[7] > TELEMETRY_SEATS_MAX) ||
+       (u16Length != TELEMETRY_HEADER_LENGTH + (pu8Payload[7] * TELEMETRY_SEAT_LENGTH)))
+    {
+        return FALSE;
+    }
+
+    pxReport->u16Sequence = Telemetry_u16Get16(&pu8Payload[1]);
+    pxReport->u32Timestamp = Telemetry_u32Get32(&pu8Payload[3]);
+    pxReport->u8Seats = pu8Payload[7];
+    pu8Seat = &pu8Payload[TELEMETRY_HEADER_LENGTH];
+    for(u8Seat = 0; u8Seat < pxReport->u8Seats; u8Seat++)
+    {
+        pxReport->axSeats[u8Seat].u16Temperature = Telemetry_u16Get16(pu8Seat);
+        pxReport->axSeats[u8Seat].u8Level = pu8Seat[2];
+        pxReport->axSeats[u8Seat].u8Intensity = pu8Seat[3];
+        pxReport->axSeats[u8Seat].u8Flags = pu8Seat[4];
+        pu8Seat += TELEMETRY_SEAT_LENGTH;
+    }
+    return TRUE;
+}
+
+uint16 Telemetry_u16BuildLatencyFrame(uint8 u8Path, const Telemetry_Latency *pxSeats, uint8 u8Seats,
+                                      uint8 *pu8Out)
+{
+    uint8  au8Payload[TELEMETRY_LATENCY_PAYLOAD_MAX_LENGTH];
+    uint16 u16Length = TELEMETRY_LATENCY_HEADER_LENGTH;
+    uint8  u8Seat;
+
+    if(u8Seats > TELEMETRY_LATENCY_SEATS_MAX)
+    {
+        u8Seats = TELEMETRY_LATENCY_SEATS_MAX;
+    }
+
+    au8Payload[0] = TELEMETRY_FRAME_LATENCY;
+    Telemetry_vPut16(&au8Payload[1], s_u16LatencySequence++);
+    au8Payload[3] = u8Path;
+    au8Payload[4] = u8Seats;
+    for(u8Seat = 0; u8Seat < u8Seats; u8Seat++)
+    {
+        Telemetry_vPut32(&au8Payload[u16Length], pxSeats[u8Seat].u32Samples);
+        Telemetry_vPut32(&au8Payload[u16Length + 4], pxSeats[u8Seat].u32Min);
+        Telemetry_vPut32(&au8Payload[u16Length + 8], pxSeats[u8Seat].u32P99);
+        Telemetry_vPut32(&au8Payload[u16Length + 12], pxSeats[u8Seat].u32Max);
+        u16Length += TELEMETRY_LATENCY_SEAT_LENGTH;
+    }
+    return Telemetry_u16EncodeFrame(au8Payload, u16Length, pu8Out);
+}
+
+boolean Telemetry_bParseLatencyReport(const uint8 *pu8Payload, uint16 u16Length,
+                                      Telemetry_LatencyReport *pxReport)
+{
+    const uint8 *pu8Seat;
+    uint8 u8Seat;
+
+    if((u16Length < TELEMETRY_LATENCY_HEADER_LENGTH) ||
+       (pu8Payload[0] != TELEMETRY_FRAME_LATENCY) ||
+       (pu8Payload[4] > TELEMETRY_LATENCY_SEATS_MAX) ||
+       (u16Length != TELEMETRY_LATENCY_HEADER_LENGTH + (pu8Payload[4] * TELEMETRY_LATENCY_SEAT_LENGTH)))
+    {
+        return FALSE;
+    }
+
+    pxReport->u16Sequence = Telemetry_u16Get16(&pu8Payload[1]);
+    pxReport->u8Path = pu8Payload[3];
+    pxReport->u8Seats = pu8Payload[4];
+    pu8Seat = &pu8Payload[TELEMETRY_LATENCY_HEADER_LENGTH];
+    for(u8Seat = 0; u8Seat < pxReport->u8Seats; u8Seat++)
+    {
+        pxReport->axSeats[u8Seat].u32Samples = Telemetry_u32Get32(pu8Seat);
+        pxReport->axSeats[u8Seat].u32Min = Telemetry_u32Get32(pu8Seat + 4);
+        pxReport->axSeats[u8Seat].u32P99 = Telemetry_u32Get32(pu8Seat + 8);
+        pxReport->axSeats[u8Seat].u32Max = Telemetry_u32Get32(pu8Seat + 12);
+        pu8Seat += TELEMETRY_LATENCY_SEAT_LENGTH;
+    }
+    return TRUE;
+}
+
+uint16 Telemetry_u16BuildPeriodicFrame(const Telemetry_Periodic *pxTasks, uint8 u8Tasks, uint8 *pu8Out)
+{
+    uint8  au8Payload[TELEMETRY_PERIODIC_PAYLOAD_MAX_LENGTH];
+    uint16 u16Length = TELEMETRY_PERIODIC_HEADER_LENGTH;
+    uint8  u8Task;
+
+    if(u8Tasks > TELEMETRY_PERIODIC_TASKS_MAX)
+    {
+        u8Tasks = TELEMETRY_PERIODIC_TASKS_MAX;
+    }
+
+    au8Payload[0] = TELEMETRY_FRAME_PERIODIC;
+    Telemetry_vPut16(&au8Payload[1], s_u16PeriodicSequence++);
+    au8Payload[3] = u8Tasks;
+    for(u8Task = 0; u8Task < u8Tasks; u8Task++)
+    {
+        au8Payload[u16Length] = pxTasks[u8Task].u8Task;
+        au8Payload[u16Length + 1] = pxTasks[u8Task].u8Priority;
+        Telemetry_vPut16(&au8Payload[u16Length + 2], pxTasks[u8Task].u16PeriodMs);
+        Telemetry_vPut16(&au8Payload[u16Length + 4], pxTasks[u8Task].u16DeadlineMs);
+        Telemetry_vPut32(&au8Payload[u16Length + 6], pxTasks[u8Task].u32Jobs);
+        Telemetry_vPut32(&au8Payload[u16Length + 10], pxTasks[u8Task].u32DeadlineMisses);
+        Telemetry_vPut32(&au8Payload[u16Length + 14], pxTasks[u8Task].u32Overruns);
+        Telemetry_vPut32(&au8Payload[u16Length + 18], pxTasks[u8Task].u32MaxJitter);
+        Telemetry_vPut32(&au8Payload[u16Length + 22], pxTasks[u8Task].u32MaxResponse);
+        u16Length += TELEMETRY_PERIODIC_TASK_LENGTH;
+    }
+    return Telemetry_u16EncodeFrame(au8Payload, u16Length, pu8Out);
+}
+
+boolean Telemetry_bParsePeriodicReport(const uint8 *pu8Payload, uint16 u16Length,
+                                       Telemetry_PeriodicReport *pxReport)
+{
+    const uint8 *pu8Task;
+    uint8 u8Task;
+
+    if((u16Length < TELEMETRY_PERIODIC_HEADER_LENGTH) ||
+       (pu8Payload[0] != TELEMETRY_FRAME_PERIODIC) ||
+       (pu8Payload[3] > TELEMETRY_PERIODIC_TASKS_MAX) ||
+       (u16Length != TELEMETRY_PERIODIC_HEADER_LENGTH + (pu8Payload[3] * TELEMETRY_PERIODIC_TASK_LENGTH)))
+    {
+        return FALSE;
+    }
+
+    pxReport->u16Sequence = Telemetry_u16Get16(&pu8Payload[1]);
+    pxReport->u8Tasks = pu8Payload[3];
+    pu8Task = &pu8Payload[TELEMETRY_PERIODIC_HEADER_LENGTH];
+    for(u8Task = 0; u8Task < pxReport->u8Tasks; u8Task++)
+    {
+        pxReport->axTasks[u8Task].u8Task = pu8Task[0];
+        pxReport->axTasks[u8Task].u8Priority = pu8Task[1];
+        pxReport->axTasks[u8Task].u16PeriodMs = Telemetry_u16Get16(pu8Task + 2);
+        pxReport->axTasks[u8Task].u16DeadlineMs = Telemetry_u16Get16(pu8Task + 4);
+        pxReport->axTasks[u8Task].u32Jobs = Telemetry_u32Get32(pu8Task + 6);
+        pxReport->axTasks[u8Task].u32DeadlineMisses = Telemetry_u32Get32(pu8Task + 10);
+        pxReport->axTasks[u8Task].u32Overruns = Telemetry_u32Get32(pu8Task + 14);
+        pxReport->axTasks[u8Task].u32MaxJitter = Telemetry_u32Get32(pu8Task + 18);
+        pxReport->axTasks[u8Task].u32MaxResponse = Telemetry_u32Get32(pu8Task + 22);
+        pu8Task += TELEMETRY_PERIODIC_TASK_LENGTH;
+    }
+    return TRUE;
+}
@@ -0,0 +1,243 @@
+ /******************************************************************************
+ *
+ * Module: Telemetry
+ *
+ * File Name: telemetry.h
+ *
+ * Description: Header file for the binary telemetry frames. A frame is a
+ *              little-endian payload starting with the frame type, followed
+ *              by its CRC-16, COBS encoded so it holds no zero byte, with a
+ *              zero delimiter on both sides. A reader resynchronises on the
+ *              next zero after any error, and text sharing the line falls
+ *              between frames and fails the CRC.
+ *
+ *              Seats report payload:
+ *                0      frame type (TELEMETRY_FRAME_SEATS)
+ *                1..2   sequence number, wraps at 65535
+ *                3..6   timestamp in usec, low 32 bits of the WTimer0 timebase
+ *                7      number of seats N
+ *                8..    N x { temperature in 0.01 degC (2 bytes), desired
+ *                             level in degC, heater intensity, flags }
+ *                last 2 CRC-16/CCITT-FALSE of all the bytes above
+ *
+ *              Deferred log payload (see log.h):
+ *                0      frame type (TELEMETRY_FRAME_LOG)
+ *                1..2   sequence number, wraps at 65535
+ *                3..    log records, each { format ID (2 bytes), number of
+ *                       arguments A, timestamp in usec (4 bytes),
+ *                       A arguments (4 bytes each) }
+ *                last 2 CRC-16/CCITT-FALSE of all the bytes above
+ *
+ *              Latency report payload (see latency.h), one control path:
+ *                0      frame type (TELEMETRY_FRAME_LATENCY)
+ *                1..2   sequence number, wraps at 65535
+ *                3      path
+ *                4      number of seats N
+ *                5..    N x { samples, min, 99th percentile, max, each 4
+ *                             bytes, latencies in CPU cycles }
+ *                last 2 CRC-16/CCITT-FALSE of all the bytes above
+ *
+ *              Periodic task report payload (see periodic.h):
+ *                0      frame type (TELEMETRY_FRAME_PERIODIC)
+ *                1..2   sequence number, wraps at 65535
+ *                3      number of tasks N
+ *                4..    N x { task number, priority, period in msec (2 bytes),
+ *                             deadline in msec (2 bytes), jobs, deadline
+ *                             misses, skipped releases, max jitter, max
+ *                             response, each 4 bytes, times in CPU cycles }
+ *                last 2 CRC-16/CCITT-FALSE of all the bytes above
+ *
+ *              Kernel trace payload (see trace.h):
+ *                0      frame type (TELEMETRY_FRAME_TRACE)
+ *                1..2   frame index within the dump, 0 starts a new dump
+ *                3..    trace records, each { time in CPU cycles, low 32 bits
+ *                       of the WTimer0 timebase (4 bytes), event, task
+ *                       number, object number, parameter }
+ *                last 2 CRC-16/CCITT-FALSE of all the bytes above
+ *
+ *******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define TELEMETRY_FRAME_SEATS           0x01
+#define TELEMETRY_FRAME_LOG             0x02
+#define TELEMETRY_FRAME_TRACE           0x03
+#define TELEMETRY_FRAME_LATENCY         0x04
+#define TELEMETRY_FRAME_PERIODIC        0x05
+
+#define TELEMETRY_SEATS_MAX             8
+
+/* Seat flags */
+#define TELEMETRY_FLAG_SENSOR_FAILURE   0x01
+
+#define TELEMETRY_HEADER_LENGTH         8
+#define TELEMETRY_SEAT_LENGTH           5
+#define TELEMETRY_CRC_LENGTH            2
+
+#define TELEMETRY_LOG_HEADER_LENGTH     3
+#define TELEMETRY_LOG_RECORD_LENGTH     7       /* Without its arguments */
+#define TELEMETRY_LOG_ARGS_MAX          3
+
+#define TELEMETRY_LATENCY_HEADER_LENGTH 5
+#define TELEMETRY_LATENCY_SEAT_LENGTH   16
+#define TELEMETRY_LATENCY_SEATS_MAX     4
+
+#define TELEMETRY_PERIODIC_HEADER_LENGTH 4
+#define TELEMETRY_PERIODIC_TASK_LENGTH  26
+#define TELEMETRY_PERIODIC_TASKS_MAX    3
+
+#define TELEMETRY_TRACE_HEADER_LENGTH   3
+#define TELEMETRY_TRACE_RECORD_LENGTH   8
+
+/* Payload of the largest frame, before COBS */
+#define TELEMETRY_PAYLOAD_MAX_LENGTH    (TELEMETRY_HEADER_LENGTH + (TELEMETRY_SEATS_MAX * TELEMETRY_SEAT_LENGTH) + TELEMETRY_CRC_LENGTH)
+
+/* Encoded frame of a payload, CRC included: COBS adds one byte per 254 bytes, plus the two delimiters */
+#define TELEMETRY_FRAME_LENGTH(PAYLOAD) ((PAYLOAD) + ((PAYLOAD) / 254) + 1 + 2)
+
+#define TELEMETRY_FRAME_MAX_LENGTH      TELEMETRY_FRAME_LENGTH(TELEMETRY_PAYLOAD_MAX_LENGTH)
+
+/* Largest latency report, CRC included */
+#define TELEMETRY_LATENCY_PAYLOAD_MAX_LENGTH (TELEMETRY_LATENCY_HEADER_LENGTH + (TELEMETRY_LATENCY_SEATS_MAX * TELEMETRY_LATENCY_SEAT_LENGTH) + TELEMETRY_CRC_LENGTH)
+#define TELEMETRY_LATENCY_FRAME_MAX_LENGTH TELEMETRY_FRAME_LENGTH(TELEMETRY_LATENCY_PAYLOAD_MAX_LENGTH)
+
+/* Largest periodic task report, CRC included */
+#define TELEMETRY_PERIODIC_PAYLOAD_MAX_LENGTH (TELEMETRY_PERIODIC_HEADER_LENGTH + (TELEMETRY_PERIODIC_TASKS_MAX * TELEMETRY_PERIODIC_TASK_LENGTH) + TELEMETRY_CRC_LENGTH)
+#define TELEMETRY_PERIODIC_FRAME_MAX_LENGTH TELEMETRY_FRAME_LENGTH(TELEMETRY_PERIODIC_PAYLOAD_MAX_LENGTH)
+
+#define TELEMETRY_CRC_INIT              0xFFFF
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint16 u16Temperature;      /* 0.01 degC */
+    uint8  u8Level;             /* Desired temperature in degC, 0 when off */
+    uint8  u8Intensity;
+    uint8  u8Flags;
+} Telemetry_Seat;
+
+typedef struct
+{
+    uint16 u16Sequence;
+    uint32 u32Timestamp;
+    uint8  u8Seats;
+    Telemetry_Seat axSeats[TELEMETRY_SEATS_MAX];
+} Telemetry_SeatsReport;
+
+/* Latencies of one control path for one seat, in CPU cycles */
+typedef struct
+{
+    uint32 u32Samples;
+    uint32 u32Min;
+    uint32 u32P99;
+    uint32 u32Max;
+} Telemetry_Latency;
+
+typedef struct
+{
+    uint16 u16Sequence;
+    uint8  u8Path;
+    uint8  u8Seats;
+    Telemetry_Latency axSeats[TELEMETRY_LATENCY_SEATS_MAX];
+} Telemetry_LatencyReport;
+
+/* Scheduling statistics of one periodic task since the start */
+typedef struct
+{
+    uint8  u8Task;              /* Kernel task number */
+    uint8  u8Priority;
+    uint16 u16PeriodMs;
+    uint16 u16DeadlineMs;
+    uint32 u32Jobs;
+    uint32 u32DeadlineMisses;
+    uint32 u32Overruns;         /* Releases skipped */
+    uint32 u32MaxJitter;        /* Cycles */
+    uint32 u32MaxResponse;      /* Cycles */
+} Telemetry_Periodic;
+
+typedef struct
+{
+    uint16 u16Sequence;
+    uint8  u8Tasks;
+    Telemetry_Periodic axTasks[TELEMETRY_PERIODIC_TASKS_MAX];
+} Telemetry_PeriodicReport;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Little-endian fields of a payload */
+void Telemetry_vPut16(uint8 *pu8Out, uint16 u16Value);
+void Telemetry_vPut32(uint8 *pu8Out, uint32 u32Value);
+uint16 Telemetry_u16Get16(const uint8 *pu8In);
+uint32 Telemetry_u32Get32(const uint8 *pu8In);
+
+/* CRC-16/CCITT-FALSE (poly 0x1021), start from TELEMETRY_CRC_INIT */
+uint16 Telemetry_u16Crc16(uint16 u16Crc, const uint8 *pu8Data, uint16 u16Length);
+
+/* COBS encode, the output needs u16Length + u16Length / 254 + 1 bytes. Returns the encoded length. */
+uint16 Telemetry_u16CobsEncode(const uint8 *pu8In, uint16 u16Length, uint8 *pu8Out);
+
+/* COBS decode one frame without its delimiters. Returns the decoded length, 0 if malformed. */
+uint16 Telemetry_u16CobsDecode(const uint8 *pu8In, uint16 u16Length, uint8 *pu8Out);
+
+/*
+ * Append the CRC to a payload of u16Length bytes, which must have room for
+ * TELEMETRY_CRC_LENGTH more, and encode it with its delimiters in pu8Out
+ * (TELEMETRY_FRAME_LENGTH(u16Length + TELEMETRY_CRC_LENGTH) bytes).
+ * Returns the frame length.
+ */
+uint16 Telemetry_u16EncodeFrame(uint8 *pu8Payload, uint16 u16Length, uint8 *pu8Out);
+
+/*
+ * Decode one frame without its delimiters and check its CRC. Returns the
+ * payload length without the CRC, 0 if the frame is malformed.
+ */
+uint16 Telemetry_u16DecodeFrame(const uint8 *pu8In, uint16 u16Length, uint8 *pu8Payload);
+
+/*
+ * Build a complete seats report frame, delimiters included, in pu8Out
+ * (TELEMETRY_FRAME_MAX_LENGTH bytes). Each call takes the next sequence
+ * number. Returns the frame length.
+ */
+uint16 Telemetry_u16BuildSeatsFrame(const Telemetry_Seat *pxSeats, uint8 u8Seats,
+                                    uint32 u32Timestamp, uint8 *pu8Out);
+
+/* Unpack a decoded seats report payload. Returns FALSE on a bad type or length. */
+boolean Telemetry_bParseSeatsReport(const uint8 *pu8Payload, uint16 u16Length,
+                                    Telemetry_SeatsReport *pxReport);
+
+/*
+ * Build a complete latency report frame of one path, delimiters included, in
+ * pu8Out (TELEMETRY_LATENCY_FRAME_MAX_LENGTH bytes). Each call takes the next
+ * latency sequence number. Returns the frame length.
+ */
+uint16 Telemetry_u16BuildLatencyFrame(uint8 u8Path, const Telemetry_Latency *pxSeats, uint8 u8Seats,
+                                      uint8 *pu8Out);
+
+/* Unpack a decoded latency report payload. Returns FALSE on a bad type or length. */
+boolean Telemetry_bParseLatencyReport(const uint8 *pu8Payload, uint16 u16Length,
+                                      Telemetry_LatencyReport *pxReport);
+
+/*
+ * Build a complete periodic task report frame, delimiters included, in pu8Out
+ * (TELEMETRY_PERIODIC_FRAME_MAX_LENGTH bytes). Each call takes the next
+ * periodic sequence number. Returns the frame length.
+ */
+uint16 Telemetry_u16BuildPeriodicFrame(const Telemetry_Periodic *pxTasks, uint8 u8Tasks, uint8 *pu8Out);
+
+/* Unpack a decoded periodic task report payload. Returns FALSE on a bad type or length. */
+boolean Telemetry_bParsePeriodicReport(const uint8 *pu8Payload, uint16 u16Length,
+                                       Telemetry_PeriodicReport *pxReport);
+
+#endif /* TELEMETRY_H_ */
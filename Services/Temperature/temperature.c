@@ -0,0 +1,25 @@
+ /******************************************************************************
+ *
+ * Module: Temperature
+ *
+ * File Name: temperature.c
+ *
+ * Description: Source file for the seat temperature sensor conversion
+ *
+ *******************************************************************************/
+
+#include "temperature.h"
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+uint32 Temperature_u32FromRaw(uint32 u32Raw)
+{
+    /* Out of range codes are clamped so the product can never overflow */
+    if(u32Raw > TEMPERATURE_ADC_FULL_SCALE)
+    {
+        u32Raw = TEMPERATURE_ADC_FULL_SCALE;
+    }
+    return ((u32Raw * TEMPERATURE_RAW_TO_CENTI_Q18) + TEMPERATURE_Q18_HALF) >> TEMPERATURE_Q18_SHIFT;
+}
@@ -0,0 +1,47 @@
+ /******************************************************************************
+ *
+ * Module: Temperature
+ *
+ * File Name: temperature.h
+ *
+ * Description: Header file for the seat temperature sensor conversion. Raw
+ *              12-bit ADC codes are converted to 0.01 degC steps with integer
+ *              arithmetic only, so the conversion is safe in interrupt context
+ *              and needs no floating point support.
+ *
+ *******************************************************************************/
+
+#ifndef TEMPERATURE_H_
+#define TEMPERATURE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Temperatures are handled in 0.01 degC, e.g. 2197 = 21.97 degC */
+#define TEMPERATURE_SCALE               100
+
+/* Sensor range: ADC code 0 .. 4095 maps linearly to 0 .. 45 degC */
+#define TEMPERATURE_ADC_FULL_SCALE      4095
+#define TEMPERATURE_SENSOR_RANGE        45
+
+/*
+ * 4500 / 4095 in Q18, rounded. Q18 rounds every one of the 4096 codes to
+ * the nearest 0.01 degC exactly like the real division would, which is all
+ * the precision needed; 4095 * factor plus the rounding half stays within
+ * 32 bits up to Q19.
+ */
+#define TEMPERATURE_RAW_TO_CENTI_Q18    288070UL
+#define TEMPERATURE_Q18_SHIFT           18
+#define TEMPERATURE_Q18_HALF            (1UL << (TEMPERATURE_Q18_SHIFT - 1))
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Raw ADC code to temperature in 0.01 degC: one multiply, one add and one shift */
+uint32 Temperature_u32FromRaw(uint32 u32Raw);
+
+#endif /* TEMPERATURE_H_ */
@@ -0,0 +1,200 @@
+ /******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: trace.c
+ *
+ * Description: Source file for the kernel event trace recorder.
+ *
+ * The ring is written under a short interrupt mask by every context, like the
+ * deferred log ring, but it is never drained while recording: the head only
+ * grows and a new record overwrites the oldest one, so the ring always holds
+ * the last TRACE_RING_RECORDS events. Trace_vTrigger() stops the recording;
+ * from then on the ring is only read, by Trace_vDump(), which restarts it
+ * once every record is posted. The dump frames are laid out in telemetry.h.
+ *
+ *******************************************************************************/
+
+#include "trace.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "log.h"
+#include "telemetry.h"
+#include "GPTM.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define TRACE_RING_MASK                 (TRACE_RING_RECORDS - 1)
+
+#define TRACE_FRAME_PAYLOAD_LENGTH      (TELEMETRY_TRACE_HEADER_LENGTH + (TRACE_RECORDS_PER_FRAME * TELEMETRY_TRACE_RECORD_LENGTH))
+
+#if ((TRACE_RING_RECORDS & TRACE_RING_MASK) != 0)
+#error "TRACE_RING_RECORDS must be a power of two"
+#endif
+
+#if (TELEMETRY_FRAME_LENGTH(TRACE_FRAME_PAYLOAD_LENGTH + TELEMETRY_CRC_LENGTH) > LOG_MESSAGE_MAX_LENGTH)
+#error "A trace frame must fit in one log message"
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 u32Time;             /* Low word of the WTimer0 timebase, CPU cycles */
+    uint8  u8Event;
+    uint8  u8Task;              /* Kernel number of the running (or interrupted) task */
+    uint8  u8Object;
+    uint8  u8Param;
+} Trace_Record;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Trace_Record s_axRing[TRACE_RING_RECORDS];
+static uint32 s_u32Head;                                    /* Records written since the last restart */
+static volatile boolean s_bStopped;
+static uint8  s_u8Task;
+
+static uint8  s_u8Objects;                                  /* Last object number given */
+static uint8  s_au8ObjectTypes[TRACE_OBJECTS_MAX + 1];      /* By object number */
+static const char *s_apcObjectNames[TRACE_OBJECTS_MAX + 1];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Tell the host the type and name of every object numbered so far */
+static void Trace_vPostObjects(uint8 u8Channel)
+{
+    Log_Message xLine;
+    uint8 u8Object;
+
+    for(u8Object = 1; (u8Object <= s_u8Objects) && (u8Object <= TRACE_OBJECTS_MAX); u8Object++)
+    {
+        Log_vStart(&xLine);
+        Log_vAppendString(&xLine, "Object ");
+        Log_vAppendUnsigned(&xLine, u8Object);
+        Log_vAppendString(&xLine, " type ");
+        Log_vAppendUnsigned(&xLine, s_au8ObjectTypes[u8Object]);
+        Log_vAppendString(&xLine, ": ");
+        if(s_apcObjectNames[u8Object] != NULL_PTR)
+        {
+            Log_vAppendString(&xLine, (const uint8 *)s_apcObjectNames[u8Object]);
+        }
+        Log_vAppendString(&xLine, "\r\n");
+        (void)Log_bPostWait(u8Channel, &xLine, portMAX_DELAY);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Trace_vRecord(uint8 u8Event, uint8 u8Object, uint8 u8Param)
+{
+    Trace_Record *pxRecord;
+    UBaseType_t uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    if(!s_bStopped)
+    {
+        pxRecord = &s_axRing[s_u32Head++ & TRACE_RING_MASK];
+        pxRecord->u32Time = GPTM_WTimer0Read32();
+        pxRecord->u8Event = u8Event;
+        pxRecord->u8Task = s_u8Task;
+        pxRecord->u8Object = u8Object;
+        pxRecord->u8Param = u8Param;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+}
+
+void Trace_vTaskSwitchedIn(uint32 u32Task)
+{
+    s_u8Task = (uint8)u32Task;
+    Trace_vRecord(TRACE_EVENT_SWITCH_IN, 0, 0);
+}
+
+uint8 Trace_u8NewObject(uint8 u8Type)
+{
+    UBaseType_t uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint8 u8Object = ++s_u8Objects;
+
+    if(u8Object <= TRACE_OBJECTS_MAX)
+    {
+        s_au8ObjectTypes[u8Object] = u8Type;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+    return u8Object;
+}
+
+void Trace_vIsrEnter(uint8 u8Irq)
+{
+    Trace_vRecord(TRACE_EVENT_ISR_ENTER, 0, u8Irq);
+}
+
+void Trace_vIsrExit(uint8 u8Irq)
+{
+    Trace_vRecord(TRACE_EVENT_ISR_EXIT, 0, u8Irq);
+}
+
+void Trace_vNameObject(uint8 u8Object, const char *pcName)
+{
+    if((u8Object != 0) && (u8Object <= TRACE_OBJECTS_MAX))
+    {
+        s_apcObjectNames[u8Object] = pcName;
+    }
+}
+
+void Trace_vTrigger(void)
+{
+    s_bStopped = TRUE;
+}
+
+boolean Trace_bTriggered(void)
+{
+    return s_bStopped;
+}
+
+void Trace_vDump(uint8 u8Channel)
+{
+    uint8  au8Payload[TRACE_FRAME_PAYLOAD_LENGTH + TELEMETRY_CRC_LENGTH];
+    Log_Message xFrame;
+    const Trace_Record *pxRecord;
+    uint32 u32Record;
+    uint32 u32Records;
+    uint16 u16Length = TELEMETRY_TRACE_HEADER_LENGTH;
+    uint16 u16Index = 0;
+
+    Trace_vPostObjects(u8Channel);
+
+    /* Stopped: nothing writes the ring or the head until the restart below */
+    u32Records = (s_u32Head < TRACE_RING_RECORDS) ? s_u32Head : TRACE_RING_RECORDS;
+    for(u32Record = s_u32Head - u32Records; u32Record != s_u32Head; u32Record++)
+    {
+        pxRecord = &s_axRing[u32Record & TRACE_RING_MASK];
+        Telemetry_vPut32(&au8Payload[u16Length], pxRecord->u32Time);
+        au8Payload[u16Length + 4] = pxRecord->u8Event;
+        au8Payload[u16Length + 5] = pxRecord->u8Task;
+        au8Payload[u16Length + 6] = pxRecord->u8Object;
+        au8Payload[u16Length + 7] = pxRecord->u8Param;
+        u16Length += TELEMETRY_TRACE_RECORD_LENGTH;
+
+        if((u16Length == TRACE_FRAME_PAYLOAD_LENGTH) || (u32Record + 1 == s_u32Head))
+        {
+            au8Payload[0] = TELEMETRY_FRAME_TRACE;
+            Telemetry_vPut16(&au8Payload[1], u16Index++);
+            xFrame.u16Length = Telemetry_u16EncodeFrame(au8Payload, u16Length, xFrame.au8Data);
+            (void)Log_bPostWait(u8Channel, &xFrame, portMAX_DELAY);
+            u16Length = TELEMETRY_TRACE_HEADER_LENGTH;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    s_u32Head = 0;
+    s_bStopped = FALSE;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,107 @@
+ /******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: trace.h
+ *
+ * Description: Header file for the kernel event trace recorder. The kernel
+ *              trace macros (FreeRTOSConfig.h) and the application interrupt
+ *              handlers store 8-byte records in a RAM ring: the low word of
+ *              the WTimer0 timebase in CPU cycles, the event, the running
+ *              task number, the kernel object and one parameter byte.
+ *              Recording stops at a trigger, so the ring keeps the events
+ *              that led to it, and Trace_vDump() sends the ring as
+ *              TELEMETRY_FRAME_TRACE frames. The host tool
+ *              Simulation/Tools/trace_export.c turns a UART capture into
+ *              Chrome trace JSON, which Perfetto and chrome://tracing open.
+ *
+ *              Kernel objects (queues and semaphores, event groups, timers)
+ *              are numbered from 1 as they are created, in one sequence; the
+ *              dump names them in text lines "Object N type T: name".
+ *
+ *              Only std_types.h is included: FreeRTOSConfig.h includes this
+ *              header for the hooks.
+ *
+ *******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Records of the ring, a power of two. With the ticks recorded 256 records
+ * hold about the last 200 msec, and a dump takes 2.5 sec of UART0 at 9600 baud. */
+#define TRACE_RING_RECORDS              256
+
+/* Record the tick interrupt, 1 record per msec */
+#define TRACE_TICKS                     1
+
+/* Objects that can be named */
+#define TRACE_OBJECTS_MAX               16
+
+/* Records per dump frame, so a frame fits in a log message */
+#define TRACE_RECORDS_PER_FRAME         10
+
+/* Events; the object and the parameter of each */
+#define TRACE_EVENT_SWITCH_IN           0x01    /* -, - */
+#define TRACE_EVENT_TICK                0x02    /* -, tick count low byte */
+#define TRACE_EVENT_ISR_ENTER           0x03    /* -, interrupt number */
+#define TRACE_EVENT_ISR_EXIT            0x04    /* -, interrupt number */
+#define TRACE_EVENT_QUEUE_SEND          0x10    /* queue, - (semaphore give) */
+#define TRACE_EVENT_QUEUE_SEND_FROM_ISR 0x11    /* queue, - */
+#define TRACE_EVENT_QUEUE_RECEIVE       0x12    /* queue, - (semaphore take) */
+#define TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR 0x13 /* queue, - */
+#define TRACE_EVENT_QUEUE_BLOCK         0x14    /* queue, - (blocks to receive) */
+#define TRACE_EVENT_GROUP_SET           0x20    /* event group, bits */
+#define TRACE_EVENT_GROUP_SET_FROM_ISR  0x21    /* event group, bits */
+#define TRACE_EVENT_GROUP_WAIT_BLOCK    0x22    /* event group, bits waited for */
+#define TRACE_EVENT_GROUP_WAIT_END      0x23    /* event group, bits waited for */
+#define TRACE_EVENT_NOTIFY              0x30    /* -, task notified */
+#define TRACE_EVENT_NOTIFY_FROM_ISR     0x31    /* -, task notified */
+#define TRACE_EVENT_NOTIFY_TAKE         0x32    /* -, - (also wait) */
+#define TRACE_EVENT_TIMER_COMMAND       0x40    /* timer, command */
+#define TRACE_EVENT_TIMER_EXPIRED       0x41    /* timer, - */
+
+/* Object types: the kernel queue types (queueQUEUE_TYPE_*), then the others */
+#define TRACE_OBJECT_QUEUE              0
+#define TRACE_OBJECT_MUTEX              1
+#define TRACE_OBJECT_COUNTING_SEMAPHORE 2
+#define TRACE_OBJECT_BINARY_SEMAPHORE   3
+#define TRACE_OBJECT_RECURSIVE_MUTEX    4
+#define TRACE_OBJECT_EVENT_GROUP        0x10
+#define TRACE_OBJECT_TIMER              0x11
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Store one record. Callable from any context, does nothing once stopped. */
+void Trace_vRecord(uint8 u8Event, uint8 u8Object, uint8 u8Param);
+
+/* Kernel hooks: task switch, and the number of each new object */
+void Trace_vTaskSwitchedIn(uint32 u32Task);
+uint8 Trace_u8NewObject(uint8 u8Type);
+
+/* First and last statement of a traced interrupt handler */
+void Trace_vIsrEnter(uint8 u8Irq);
+void Trace_vIsrExit(uint8 u8Irq);
+
+/* Name an object in the dumps, the string must stay valid */
+void Trace_vNameObject(uint8 u8Object, const char *pcName);
+
+/* Stop recording, the ring keeps what led to this point until it is dumped */
+void Trace_vTrigger(void);
+boolean Trace_bTriggered(void);
+
+/*
+ * Send the object names and the ring on a log channel, oldest record first,
+ * then start recording again. Blocks the calling task, which must be the
+ * single producer of the channel, until all of it is posted.
+ */
+void Trace_vDump(uint8 u8Channel);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,268 @@
+ /******************************************************************************
+ *
+ * Module: Tune
+ *
+ * File Name: tune.c
+ *
+ * Description: Source file for the relay feedback auto-tuner.
+ *
+ * Integer arithmetic only. The amplitude and the hysteresis are both taken
+ * 2 * TUNE_MEASURED_CYCLES times, as the sum of the peak to peak swings is, so
+ * the square root needs no division before it; pi is 355/113.
+ *
+ * A stored record is its gains, then a check word and the magic word. A write
+ * cut short leaves a record that fails its check, and the seat falls back to
+ * the gains of heater.h.
+ *
+ *******************************************************************************/
+
+#include "tune.h"
+#include "heater.h"
+#include "eeprom.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define TUNE_PI_NUMERATOR               355
+#define TUNE_PI_DENOMINATOR             113
+
+/* Gains record of a seat: its EEPROM block and layout */
+#define TUNE_GAINS_FIRST_BLOCK          0
+#define TUNE_GAINS_MAGIC                0x54554E31UL        /* "TUN1" */
+#define TUNE_GAINS_WORDS                5
+#define TUNE_GAINS_WORD_KP              0
+#define TUNE_GAINS_WORD_KI              1
+#define TUNE_GAINS_WORD_KD              2
+#define TUNE_GAINS_WORD_CHECK           3
+#define TUNE_GAINS_WORD_MAGIC           4
+
+#if ((TUNE_GAINS_FIRST_BLOCK + TUNE_SEATS_MAX) > EEPROM_BLOCKS_NUM) || (TUNE_GAINS_WORDS > EEPROM_BLOCK_WORDS)
+#error "The gains of every seat must fit a block of the EEPROM"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static boolean s_bEeprom;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 Tune_u32Sqrt(uint64 u64Value)
+{
+    uint64 u64Root = 0;
+    uint64 u64Bit = 1ULL << 62;
+
+    while(u64Bit > u64Value)
+    {
+        u64Bit >>= 2;
+    }
+    while(u64Bit != 0)
+    {
+        if(u64Value >= (u64Root + u64Bit))
+        {
+            u64Value -= u64Root + u64Bit;
+            u64Root = (u64Root >> 1) + u64Bit;
+        }
+        else
+        {
+            u64Root >>= 1;
+        }
+        u64Bit >>= 2;
+    }
+    return (uint32)u64Root;
+}
+
+static void Tune_vFail(Tune_Relay *pxTune, uint8 u8Error)
+{
+    pxTune->u8State = TUNE_STATE_FAILED;
+    pxTune->u8Error = u8Error;
+}
+
+/* Ultimate gain and period of the measured cycles, then the gains */
+static void Tune_vFinish(Tune_Relay *pxTune)
+{
+    const uint32 u32Halves = 2 * TUNE_MEASURED_CYCLES;
+    uint32 u32Swing = pxTune->u32SwingSum;
+    uint32 u32Band = TUNE_HYSTERESIS * u32Halves;
+    uint32 u32Root;
+    sint64 s64Ku;
+    sint64 s64Kp;
+    sint64 s64Ki;
+    sint64 s64Kd;
+
+    if(u32Swing <= u32Band)
+    {
+        Tune_vFail(pxTune, TUNE_ERROR_AMPLITUDE);
+        return;
+    }
+    u32Root = Tune_u32Sqrt(((uint64)u32Swing * u32Swing) - ((uint64)u32Band * u32Band));
+
+    /* Ku = 4 d / (pi a), with 2 * cycles * a the root */
+    s64Ku = ((sint64)4 * pxTune->u16Amplitude * u32Halves * TUNE_PI_DENOMINATOR * 65536) /
+            ((sint64)TUNE_PI_NUMERATOR * u32Root);
+
+    /* Kp = Ku / 2.2, Ki = Kp Ts / (2.2 Pu), Kd = Kp Pu / (4 Ts) */
+    s64Kp = (s64Ku * 5) / 11;
+    s64Ki = (s64Kp * 5 * TUNE_MEASURED_CYCLES) / (11 * (sint64)pxTune->u32PeriodSum);
+    s64Kd = (s64Kp * pxTune->u32PeriodSum) / (4 * TUNE_MEASURED_CYCLES);
+    if((s64Ku > 0x7FFFFFFF) || (s64Kd > 0x7FFFFFFF) || (s64Ki == 0))
+    {
+        Tune_vFail(pxTune, TUNE_ERROR_RANGE);
+        return;
+    }
+
+    pxTune->s32UltimateGain = (sint32)s64Ku;
+    pxTune->u32UltimatePeriodMs = (pxTune->u32PeriodSum * pxTune->u32SamplePeriodMs) / TUNE_MEASURED_CYCLES;
+    pxTune->xGains.s32Kp = (sint32)s64Kp;
+    pxTune->xGains.s32Ki = (sint32)s64Ki;
+    pxTune->xGains.s32Kd = (sint32)s64Kd;
+    pxTune->u8State = TUNE_STATE_DONE;
+}
+
+/* The relay switched on: the end of a cycle and the start of the next one */
+static void Tune_vCycleEnd(Tune_Relay *pxTune, sint32 s32Measurement)
+{
+    uint32 u32Period = pxTune->u32Samples - pxTune->u32CycleStart;
+
+    if(pxTune->u8Cycles == 1)
+    {
+        /* Off and full power: the share of time on holds the set point */
+        pxTune->u16Bias = (uint16)((pxTune->u32OnSamples * HEATER_DUTY_FULL) / u32Period);
+        pxTune->u16Amplitude = (pxTune->u16Bias < (HEATER_DUTY_FULL - pxTune->u16Bias)) ?
+                               pxTune->u16Bias : (uint16)(HEATER_DUTY_FULL - pxTune->u16Bias);
+        if(pxTune->u16Amplitude < TUNE_AMPLITUDE_MIN)
+        {
+            Tune_vFail(pxTune, TUNE_ERROR_RANGE);
+            return;
+        }
+    }
+    else if(pxTune->u8Cycles > (1 + TUNE_SETTLE_CYCLES))
+    {
+        pxTune->u32PeriodSum += u32Period;
+        pxTune->u32SwingSum += (uint32)(pxTune->s32Max - pxTune->s32Min);
+        if(pxTune->u8Cycles == (1 + TUNE_SETTLE_CYCLES + TUNE_MEASURED_CYCLES))
+        {
+            Tune_vFinish(pxTune);
+            return;
+        }
+    }
+
+    pxTune->u8Cycles++;
+    pxTune->u32CycleStart = pxTune->u32Samples;
+    pxTune->u32OnSamples = 0;
+    pxTune->s32Max = s32Measurement;
+    pxTune->s32Min = s32Measurement;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Tune_vStart(Tune_Relay *pxTune, sint32 s32Setpoint, uint32 u32SamplePeriodMs)
+{
+    pxTune->s32Setpoint = s32Setpoint;
+    pxTune->u32SamplePeriodMs = u32SamplePeriodMs;
+    pxTune->u16Bias = HEATER_DUTY_FULL / 2;
+    pxTune->u16Amplitude = HEATER_DUTY_FULL / 2;
+    pxTune->bHigh = TRUE;
+    pxTune->u8State = TUNE_STATE_RELAY;
+    pxTune->u8Error = TUNE_ERROR_NONE;
+    pxTune->u8Cycles = 0;
+    pxTune->u32Samples = 0;
+    pxTune->u32CycleStart = 0;
+    pxTune->u32OnSamples = 0;
+    pxTune->u32PeriodSum = 0;
+    pxTune->u32SwingSum = 0;
+}
+
+uint16 Tune_u16Update(Tune_Relay *pxTune, sint32 s32Measurement)
+{
+    if(pxTune->u8State != TUNE_STATE_RELAY)
+    {
+        return 0;
+    }
+    if(++pxTune->u32Samples > TUNE_TIMEOUT_SAMPLES)
+    {
+        Tune_vFail(pxTune, TUNE_ERROR_TIMEOUT);
+        return 0;
+    }
+
+    if(pxTune->bHigh && (s32Measurement > (pxTune->s32Setpoint + TUNE_HYSTERESIS)))
+    {
+        pxTune->bHigh = FALSE;
+    }
+    else if(!pxTune->bHigh && (s32Measurement < (pxTune->s32Setpoint - TUNE_HYSTERESIS)))
+    {
+        pxTune->bHigh = TRUE;
+        Tune_vCycleEnd(pxTune, s32Measurement);
+        if(pxTune->u8State != TUNE_STATE_RELAY)
+        {
+            return 0;
+        }
+    }
+
+    /* The heat up to the first switch off is not part of any cycle */
+    if(pxTune->u8Cycles != 0)
+    {
+        pxTune->u32OnSamples += pxTune->bHigh ? 1 : 0;
+        pxTune->s32Max = (s32Measurement > pxTune->s32Max) ? s32Measurement : pxTune->s32Max;
+        pxTune->s32Min = (s32Measurement < pxTune->s32Min) ? s32Measurement : pxTune->s32Min;
+    }
+    return pxTune->bHigh ? (uint16)(pxTune->u16Bias + pxTune->u16Amplitude) : (uint16)(pxTune->u16Bias - pxTune->u16Amplitude);
+}
+
+void Tune_vAbort(Tune_Relay *pxTune)
+{
+    if(pxTune->u8State == TUNE_STATE_RELAY)
+    {
+        Tune_vFail(pxTune, TUNE_ERROR_ABORTED);
+    }
+}
+
+boolean Tune_bInit(void)
+{
+    s_bEeprom = EEPROM_bInit();
+    return s_bEeprom;
+}
+
+boolean Tune_bLoadGains(uint8 u8Seat, Pid_Gains *pxGains)
+{
+    uint32 au32Record[TUNE_GAINS_WORDS];
+
+    if(!s_bEeprom || (u8Seat >= TUNE_SEATS_MAX) ||
+       !EEPROM_bRead(TUNE_GAINS_FIRST_BLOCK + u8Seat, 0, au32Record, TUNE_GAINS_WORDS))
+    {
+        return FALSE;
+    }
+    if((au32Record[TUNE_GAINS_WORD_MAGIC] != TUNE_GAINS_MAGIC) ||
+       (au32Record[TUNE_GAINS_WORD_CHECK] != ~(au32Record[TUNE_GAINS_WORD_KP] + au32Record[TUNE_GAINS_WORD_KI] +
+                                               au32Record[TUNE_GAINS_WORD_KD])))
+    {
+        return FALSE;
+    }
+    pxGains->s32Kp = (sint32)au32Record[TUNE_GAINS_WORD_KP];
+    pxGains->s32Ki = (sint32)au32Record[TUNE_GAINS_WORD_KI];
+    pxGains->s32Kd = (sint32)au32Record[TUNE_GAINS_WORD_KD];
+    return TRUE;
+}
+
+boolean Tune_bStoreGains(uint8 u8Seat, const Pid_Gains *pxGains)
+{
+    uint32 au32Record[TUNE_GAINS_WORDS];
+
+    if(!s_bEeprom || (u8Seat >= TUNE_SEATS_MAX))
+    {
+        return FALSE;
+    }
+    au32Record[TUNE_GAINS_WORD_KP] = (uint32)pxGains->s32Kp;
+    au32Record[TUNE_GAINS_WORD_KI] = (uint32)pxGains->s32Ki;
+    au32Record[TUNE_GAINS_WORD_KD] = (uint32)pxGains->s32Kd;
+    au32Record[TUNE_GAINS_WORD_CHECK] = ~(au32Record[TUNE_GAINS_WORD_KP] + au32Record[TUNE_GAINS_WORD_KI] +
+                                          au32Record[TUNE_GAINS_WORD_KD]);
+    au32Record[TUNE_GAINS_WORD_MAGIC] = TUNE_GAINS_MAGIC;
+    return EEPROM_bWrite(TUNE_GAINS_FIRST_BLOCK + u8Seat, 0, au32Record, TUNE_GAINS_WORDS);
+}
@@ -0,0 +1,128 @@
+ /******************************************************************************
+ *
+ * Module: Tune
+ *
+ * File Name: tune.h
+ *
+ * Description: Header file for the relay feedback auto-tuner of the seat
+ *              heater loops, and for the tuned gains kept per seat in the
+ *              EEPROM.
+ *
+ *              While a seat is tuned its heater is a relay instead of its PI
+ *              loop: on above the set point less TUNE_HYSTERESIS, off below
+ *              it plus TUNE_HYSTERESIS, so the seat oscillates around the set
+ *              point at the ultimate period Pu of its loop. The first cycle
+ *              switches between off and full power; its share of time on is
+ *              the duty cycle that holds the set point, and the relay then
+ *              switches around it, as far as the nearer end allows, so the
+ *              oscillation is symmetric. After TUNE_SETTLE_CYCLES more cycles,
+ *              TUNE_MEASURED_CYCLES cycles give Pu and the amplitude a, and
+ *              the ultimate gain is the describing function of the relay of
+ *              amplitude d: Ku = 4 d / (pi sqrt(a^2 - hysteresis^2)).
+ *
+ *              The gains are the Tyreus-Luyben PID rule with a longer
+ *              derivative time, Kp = Ku / 2.2, Ti = 2.2 Pu and Td = Pu / 4:
+ *              over the thermal plants of Simulation/Bench/bench_tune.c it
+ *              gives the fastest cold start to each level that stays within
+ *              0.3 degC of it, inside the band a seat counts as settled.
+ *
+ *              Measurements and set points are in 0.01 degC, the relay output
+ *              in permille of HEATER_DUTY_FULL.
+ *
+ *******************************************************************************/
+
+#ifndef TUNE_H_
+#define TUNE_H_
+
+#include "std_types.h"
+#include "pid.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Relay switching band, +/- 0.05 degC: above the noise of a converted sample */
+#define TUNE_HYSTERESIS                 5
+
+#define TUNE_SETTLE_CYCLES              1
+#define TUNE_MEASURED_CYCLES            3
+
+/* Samples a tuning may take, the heat up from cold included */
+#define TUNE_TIMEOUT_SAMPLES            2400
+
+/* Smallest relay amplitude d, permille: a holding duty cycle nearer an end cannot be tuned around */
+#define TUNE_AMPLITUDE_MIN              50
+
+/* Tuner states */
+#define TUNE_STATE_IDLE                 0
+#define TUNE_STATE_RELAY                1       /* The relay drives the heater */
+#define TUNE_STATE_DONE                 2       /* xGains hold the tuned gains */
+#define TUNE_STATE_FAILED               3       /* u8Error tells why */
+
+/* Errors of a failed tuning */
+#define TUNE_ERROR_NONE                 0
+#define TUNE_ERROR_TIMEOUT              1       /* No oscillation in TUNE_TIMEOUT_SAMPLES */
+#define TUNE_ERROR_RANGE                2       /* The set point needs a duty cycle near 0 or full, or the gains overflow */
+#define TUNE_ERROR_AMPLITUDE            3       /* The oscillation did not leave the hysteresis */
+#define TUNE_ERROR_ABORTED              4
+
+/* Seats whose gains the EEPROM holds, one block each */
+#define TUNE_SEATS_MAX                  8
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    /* Result, valid in TUNE_STATE_DONE */
+    Pid_Gains xGains;
+    sint32 s32UltimateGain;         /* Q16 permille per 0.01 degC */
+    uint32 u32UltimatePeriodMs;
+
+    /* Relay */
+    sint32 s32Setpoint;
+    uint32 u32SamplePeriodMs;
+    uint16 u16Bias;
+    uint16 u16Amplitude;
+    boolean bHigh;
+    uint8  u8State;
+    uint8  u8Error;
+
+    /* Cycle from one switch on to the next */
+    uint8  u8Cycles;                /* Switches on so far, the first one starts cycle 1 */
+    uint32 u32Samples;              /* Since the start */
+    uint32 u32CycleStart;
+    uint32 u32OnSamples;
+    sint32 s32Max;
+    sint32 s32Min;
+    uint32 u32PeriodSum;            /* Samples, over the measured cycles */
+    uint32 u32SwingSum;             /* Peak to peak, over the measured cycles */
+} Tune_Relay;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Start a tuning around s32Setpoint, sampled every u32SamplePeriodMs */
+void Tune_vStart(Tune_Relay *pxTune, sint32 s32Setpoint, uint32 u32SamplePeriodMs);
+
+/*
+ * One sample: the relay output for it, 0 once the tuning is over. The tuning
+ * ends in TUNE_STATE_DONE or TUNE_STATE_FAILED on the sample that completes it.
+ */
+uint16 Tune_u16Update(Tune_Relay *pxTune, sint32 s32Measurement);
+
+/* Stop a running tuning, it fails with TUNE_ERROR_ABORTED */
+void Tune_vAbort(Tune_Relay *pxTune);
+
+/* Bring up the EEPROM of the tuned gains, FALSE when it cannot be used */
+boolean Tune_bInit(void);
+
+/* Tuned gains stored for a seat, FALSE when there are none or they are damaged */
+boolean Tune_bLoadGains(uint8 u8Seat, Pid_Gains *pxGains);
+
+/* Store the tuned gains of a seat, FALSE on an EEPROM error. Waits for the EEPROM: from a task only. */
+boolean Tune_bStoreGains(uint8 u8Seat, const Pid_Gains *pxGains);
+
+#endif /* TUNE_H_ */
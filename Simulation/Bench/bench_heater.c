@@ -0,0 +1,198 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Benchmarks
+ *
+ * File Name: bench_heater.c
+ *
+ * Description: Settling time and overshoot of the seat heater loop on the
+ *              thermal plant of the simulation (sim_plant.c), for a cold start
+ *              to each heater level. Compares the three step intensity
+ *              control vHeater_Action used to do, taken as 1/3, 2/3 and full
+ *              heater power, with the PI controller and the gains of heater.h.
+ *              Both run on the converted sensor samples, every 500 ms.
+ *
+ *              Settled is within BENCH_BAND_CENTI of the level for good; the
+ *              error and the ripple are taken over the last BENCH_TAIL_S. The
+ *              benchmark fails if the PI loop does not settle in the run, or
+ *              overshoots by more than BENCH_MAX_OVERSHOOT_CENTI.
+ *
+ *              Plant parameters are taken from SIM_PLANT_xxx as in the
+ *              simulation. Simulated time only, the benchmark runs in well
+ *              under a second.
+ *
+ *              make -C Simulation bench
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim_periph.h"
+#include "temperature.h"
+#include "heater.h"
+#include "pid.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_PERIOD_MS              500
+#define BENCH_RUN_S                  1200
+#define BENCH_TAIL_S                 120
+#define BENCH_BAND_CENTI             50          /* +/- 0.5 degC */
+#define BENCH_MAX_OVERSHOOT_CENTI    100
+#define BENCH_SAMPLES                ((BENCH_RUN_S * 1000) / BENCH_PERIOD_MS)
+#define BENCH_TAIL_SAMPLES           ((BENCH_TAIL_S * 1000) / BENCH_PERIOD_MS)
+
+/* Intensities of the three step control and their heater power */
+#define BENCH_OFF                    0
+#define BENCH_LOW                    333
+#define BENCH_MEDIUM                 667
+#define BENCH_HIGH                   1000
+
+typedef uint16 (*Bench_Controller)(uint32 u32Level, uint32 u32Temperature);
+
+typedef struct
+{
+    sint32 s32Overshoot;        /* 0.01 degC above the level, at the worst */
+    sint32 s32SettledAt;        /* Samples, -1 when not settled */
+    sint32 s32MeanError;        /* Mean absolute error over the tail, 0.01 degC */
+    sint32 s32Ripple;           /* Peak to peak over the tail, 0.01 degC */
+} Bench_Result;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const uint8 s_au8Levels[] = { 25, 30, 35 };
+
+static uint16 s_u16StepDuty;
+static Pid_Controller s_xPid;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* The intensity bands of vHeater_Action: off above the level, the last
+ * intensity kept within 2 degC below it */
+static uint16 Bench_u16Steps(uint32 u32Level, uint32 u32Temperature)
+{
+    sint32 s32Difference = (sint32)(u32Level * TEMPERATURE_SCALE) - (sint32)u32Temperature;
+
+    if(u32Temperature > (u32Level * TEMPERATURE_SCALE))
+    {
+        s_u16StepDuty = BENCH_OFF;
+    }
+    else if(s32Difference >= (10 * TEMPERATURE_SCALE))
+    {
+        s_u16StepDuty = BENCH_HIGH;
+    }
+    else if(s32Difference >= (5 * TEMPERATURE_SCALE))
+    {
+        s_u16StepDuty = BENCH_MEDIUM;
+    }
+    else if(s32Difference >= (2 * TEMPERATURE_SCALE))
+    {
+        s_u16StepDuty = BENCH_LOW;
+    }
+    return s_u16StepDuty;
+}
+
+static uint16 Bench_u16Pi(uint32 u32Level, uint32 u32Temperature)
+{
+    return (uint16)Pid_s32Update(&s_xPid, (sint32)(u32Level * TEMPERATURE_SCALE), (sint32)u32Temperature);
+}
+
+static void Bench_vRun(Bench_Controller pfController, uint32 u32Level, Bench_Result *pxResult)
+{
+    const Pid_Gains xGains = { HEATER_PID_KP, HEATER_PID_KI, HEATER_PID_KD };
+    sint32 s32Setpoint = (sint32)(u32Level * TEMPERATURE_SCALE);
+    sint32 s32Error;
+    sint32 s32Min = 0x7FFFFFFF;
+    sint32 s32Max = 0;
+    sint64 s64ErrorSum = 0;
+    uint32 u32Temperature;
+    uint32 u32Sample;
+
+    SimPlant_vInit();
+    Pid_vInit(&s_xPid, &xGains, 0, HEATER_DUTY_FULL);
+    s_u16StepDuty = BENCH_OFF;
+    pxResult->s32Overshoot = 0;
+    pxResult->s32SettledAt = 0;
+
+    for(u32Sample = 0; u32Sample < BENCH_SAMPLES; u32Sample++)
+    {
+        u32Temperature = Temperature_u32FromRaw(SimPlant_u32SensorRaw(0));
+        SimPlant_vDrive(0, pfController(u32Level, u32Temperature));
+        SimPlant_vAdvance((uint64)BENCH_PERIOD_MS * 1000000ULL);
+
+        s32Error = (sint32)u32Temperature - s32Setpoint;
+        if(s32Error > pxResult->s32Overshoot)
+        {
+            pxResult->s32Overshoot = s32Error;
+        }
+        if((s32Error > BENCH_BAND_CENTI) || (s32Error < -BENCH_BAND_CENTI))
+        {
+            pxResult->s32SettledAt = (sint32)u32Sample + 1;
+        }
+        if(u32Sample >= (BENCH_SAMPLES - BENCH_TAIL_SAMPLES))
+        {
+            s64ErrorSum += (s32Error < 0) ? -s32Error : s32Error;
+            s32Min = ((sint32)u32Temperature < s32Min) ? (sint32)u32Temperature : s32Min;
+            s32Max = ((sint32)u32Temperature > s32Max) ? (sint32)u32Temperature : s32Max;
+        }
+    }
+    if(pxResult->s32SettledAt >= (sint32)BENCH_SAMPLES)
+    {
+        pxResult->s32SettledAt = -1;
+    }
+    pxResult->s32MeanError = (sint32)(s64ErrorSum / BENCH_TAIL_SAMPLES);
+    pxResult->s32Ripple = s32Max - s32Min;
+}
+
+static void Bench_vPrint(const char *pcName, const Bench_Result *pxResult)
+{
+    printf("  %-6s", pcName);
+    if(pxResult->s32SettledAt < 0)
+    {
+        printf("  settled      never");
+    }
+    else
+    {
+        printf("  settled %7.1f s", (pxResult->s32SettledAt * BENCH_PERIOD_MS) / 1000.0);
+    }
+    printf("  overshoot %5.2f degC  error %5.2f degC  ripple %5.2f degC\n",
+           pxResult->s32Overshoot / (double)TEMPERATURE_SCALE, pxResult->s32MeanError / (double)TEMPERATURE_SCALE,
+           pxResult->s32Ripple / (double)TEMPERATURE_SCALE);
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(void)
+{
+    Bench_Result xSteps;
+    Bench_Result xPi;
+    uint8  u8Level;
+    boolean bPass = TRUE;
+
+    printf("heater loop, cold start to each level, %u ms samples, settled within %.1f degC\n",
+           BENCH_PERIOD_MS, BENCH_BAND_CENTI / (double)TEMPERATURE_SCALE);
+    for(u8Level = 0; u8Level < sizeof(s_au8Levels); u8Level++)
+    {
+        Bench_vRun(Bench_u16Steps, s_au8Levels[u8Level], &xSteps);
+        Bench_vRun(Bench_u16Pi, s_au8Levels[u8Level], &xPi);
+
+        printf(" level %u degC\n", s_au8Levels[u8Level]);
+        Bench_vPrint("steps", &xSteps);
+        Bench_vPrint("PI", &xPi);
+
+        if((xPi.s32SettledAt < 0) || (xPi.s32Overshoot > BENCH_MAX_OVERSHOOT_CENTI))
+        {
+            bPass = FALSE;
+        }
+    }
+
+    return bPass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
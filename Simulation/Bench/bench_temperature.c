@@ -0,0 +1,74 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Benchmarks
+ *
+ * File Name: bench_temperature.c
+ *
+ * Description: ADC code to temperature conversion: the floating point
+ *              scaling the ADC ISRs used to do against the fixed point
+ *              Temperature_u32FromRaw. Checks that both agree to within the
+ *              0.01 degC resolution over the whole ADC range.
+ *
+ *              The cost is not timed here: the virtual cycle counter is host
+ *              time scaled to the system clock, and the host has a double
+ *              precision FPU. It is counted on a Cortex-M4F build of both
+ *              conversions (GNU Arm toolchain, hard float, -O2) instead:
+ *
+ *              make -C Simulation m4count
+ *
+ *              prints the instructions of Temperature_u32FromRaw, which calls
+ *              nothing, and of Bench_u32FloatFromRaw with the software double
+ *              routines it calls, as the M4F FPU is single precision only.
+ *              These are instructions in the code and not cycles of a run
+ *              (see Tools/insn_count.c).
+ *
+ *              make -C Simulation bench
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "temperature.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_CODES          (TEMPERATURE_ADC_FULL_SCALE + 1)
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* The conversion as it was done in ADC0Seq3_Handler/ADC1Seq3_Handler, in centi degrees */
+static uint32 Bench_u32FloatFromRaw(uint32 u32Raw)
+{
+    u32Raw *= TEMPERATURE_SCALE * 45.0 / 4095;
+    return u32Raw;
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(void)
+{
+    uint32 u32Raw;
+    uint32 u32Mismatch = 0;
+
+    /* Truncating float result vs rounded fixed point result: at most 1 apart */
+    for(u32Raw = 0; u32Raw < BENCH_CODES; u32Raw++)
+    {
+        if((Temperature_u32FromRaw(u32Raw) - Bench_u32FloatFromRaw(u32Raw)) > 1)
+        {
+            u32Mismatch++;
+        }
+    }
+
+    printf("temperature conversion, %u codes\n", BENCH_CODES);
+    printf("  float  (u32 *= 45.0/4095)  vs  fixed  (Q18, 0.01 degC)\n");
+    printf("  codes off by more than 0.01   %u\n", u32Mismatch);
+
+    return (u32Mismatch == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,207 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Benchmarks
+ *
+ * File Name: bench_tune.c
+ *
+ * Description: Relay auto-tuning of the seat heater loop (tune.h) on thermal
+ *              plants of the simulation (sim_plant.c) faster, slower and with
+ *              more sensor lag than the seat heater.h was set for. Each plant
+ *              is tuned around MAKE_HEATER_MEDIUM_LEVEL, 30 degC, then makes a
+ *              cold start to each heater level with the tuned gains and with
+ *              the fixed gains of heater.h, sampled every 500 ms.
+ *
+ *              Settled is within BENCH_BAND_CENTI of the level for good. The
+ *              benchmark fails if a tuning fails, or if the tuned loop does not
+ *              settle or overshoots out of the band on the way.
+ *
+ *              Simulated time only, the benchmark runs in about a second.
+ *
+ *              make -C Simulation bench
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim_periph.h"
+#include "temperature.h"
+#include "heater.h"
+#include "pid.h"
+#include "tune.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_PERIOD_MS              500
+#define BENCH_RUN_S                  1200
+#define BENCH_BAND_CENTI             50          /* +/- 0.5 degC */
+#define BENCH_MAX_OVERSHOOT_CENTI    BENCH_BAND_CENTI
+#define BENCH_TUNE_LEVEL             30
+#define BENCH_SAMPLES                ((BENCH_RUN_S * 1000) / BENCH_PERIOD_MS)
+
+typedef struct
+{
+    const char *pcName;
+    const char *pcRise;         /* SIM_PLANT_xxx */
+    const char *pcTauMs;
+    const char *pcLagMs;
+} Bench_Plant;
+
+typedef struct
+{
+    sint32 s32Overshoot;        /* 0.01 degC above the level, at the worst */
+    sint32 s32SettledAt;        /* Samples, -1 when not settled */
+} Bench_Result;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const Bench_Plant s_axPlants[] =
+{
+    { "heater.h seat",  "30", "60000",  "8000"  },
+    { "sensor lag x2",  "30", "60000",  "16000" },
+    { "light seat",     "30", "30000",  "4000"  },
+    { "heavy seat",     "30", "120000", "8000"  },
+    { "weak heater",    "20", "60000",  "8000"  },
+    { "simulation x10", "30", "6000",   "800"   },
+};
+
+static const uint8 s_au8Levels[] = { 25, 30, 35 };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void Bench_vPlant(const Bench_Plant *pxPlant)
+{
+    setenv("SIM_PLANT_RISE_C", pxPlant->pcRise, 1);
+    setenv("SIM_PLANT_TAU_MS", pxPlant->pcTauMs, 1);
+    setenv("SIM_PLANT_LAG_MS", pxPlant->pcLagMs, 1);
+    SimPlant_vInit();
+}
+
+static sint32 Bench_s32Sample(void)
+{
+    return (sint32)Temperature_u32FromRaw(SimPlant_u32SensorRaw(0));
+}
+
+/* Tune from cold, FALSE when the tuner fails */
+static boolean Bench_bTune(Tune_Relay *pxTune, uint32 *pu32Samples)
+{
+    uint32 u32Sample;
+
+    Tune_vStart(pxTune, BENCH_TUNE_LEVEL * TEMPERATURE_SCALE, BENCH_PERIOD_MS);
+    for(u32Sample = 0; pxTune->u8State == TUNE_STATE_RELAY; u32Sample++)
+    {
+        SimPlant_vDrive(0, Tune_u16Update(pxTune, Bench_s32Sample()));
+        SimPlant_vAdvance((uint64)BENCH_PERIOD_MS * 1000000ULL);
+    }
+    *pu32Samples = u32Sample;
+    return (pxTune->u8State == TUNE_STATE_DONE) ? TRUE : FALSE;
+}
+
+static void Bench_vRun(const Pid_Gains *pxGains, uint32 u32Level, Bench_Result *pxResult)
+{
+    sint32 s32Setpoint = (sint32)(u32Level * TEMPERATURE_SCALE);
+    Pid_Controller xPid;
+    sint32 s32Temperature;
+    sint32 s32Error;
+    uint32 u32Sample;
+
+    SimPlant_vInit();
+    Pid_vInit(&xPid, pxGains, 0, HEATER_DUTY_FULL);
+    pxResult->s32Overshoot = 0;
+    pxResult->s32SettledAt = 0;
+
+    for(u32Sample = 0; u32Sample < BENCH_SAMPLES; u32Sample++)
+    {
+        s32Temperature = Bench_s32Sample();
+        SimPlant_vDrive(0, (uint16)Pid_s32Update(&xPid, s32Setpoint, s32Temperature));
+        SimPlant_vAdvance((uint64)BENCH_PERIOD_MS * 1000000ULL);
+
+        s32Error = s32Temperature - s32Setpoint;
+        if(s32Error > pxResult->s32Overshoot)
+        {
+            pxResult->s32Overshoot = s32Error;
+        }
+        if((s32Error > BENCH_BAND_CENTI) || (s32Error < -BENCH_BAND_CENTI))
+        {
+            pxResult->s32SettledAt = (sint32)u32Sample + 1;
+        }
+    }
+    if(pxResult->s32SettledAt >= (sint32)BENCH_SAMPLES)
+    {
+        pxResult->s32SettledAt = -1;
+    }
+}
+
+static void Bench_vPrint(const char *pcName, const Bench_Result *pxResult)
+{
+    printf("    %-8s", pcName);
+    if(pxResult->s32SettledAt < 0)
+    {
+        printf("  settled      never");
+    }
+    else
+    {
+        printf("  settled %7.1f s", (pxResult->s32SettledAt * BENCH_PERIOD_MS) / 1000.0);
+    }
+    printf("  overshoot %5.2f degC\n", pxResult->s32Overshoot / (double)TEMPERATURE_SCALE);
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(void)
+{
+    const Pid_Gains xFixed = { HEATER_PID_KP, HEATER_PID_KI, HEATER_PID_KD };
+    const Bench_Plant *pxPlant;
+    Tune_Relay xTune;
+    Bench_Result xTuned;
+    Bench_Result xDefault;
+    uint32 u32Samples;
+    uint8  u8Plant;
+    uint8  u8Level;
+    boolean bPass = TRUE;
+
+    printf("relay auto-tuning around %u degC, cold start to each level, %u ms samples, settled within %.1f degC\n",
+           BENCH_TUNE_LEVEL, BENCH_PERIOD_MS, BENCH_BAND_CENTI / (double)TEMPERATURE_SCALE);
+    for(u8Plant = 0; u8Plant < (sizeof(s_axPlants) / sizeof(s_axPlants[0])); u8Plant++)
+    {
+        pxPlant = &s_axPlants[u8Plant];
+        Bench_vPlant(pxPlant);
+        printf(" %s: rise %s degC, tau %s ms, lag %s ms\n", pxPlant->pcName, pxPlant->pcRise, pxPlant->pcTauMs,
+               pxPlant->pcLagMs);
+        if(!Bench_bTune(&xTune, &u32Samples))
+        {
+            printf("  tuning failed, error %u\n", (unsigned)xTune.u8Error);
+            bPass = FALSE;
+            continue;
+        }
+        printf("  tuned in %.1f s: Ku %.2f permille per 0.01 degC, Pu %.1f s -> Kp %.2f Ki %.4f Kd %.2f\n",
+               (u32Samples * BENCH_PERIOD_MS) / 1000.0, xTune.s32UltimateGain / 65536.0,
+               xTune.u32UltimatePeriodMs / 1000.0, xTune.xGains.s32Kp / 65536.0, xTune.xGains.s32Ki / 65536.0,
+               xTune.xGains.s32Kd / 65536.0);
+
+        for(u8Level = 0; u8Level < sizeof(s_au8Levels); u8Level++)
+        {
+            Bench_vRun(&xTune.xGains, s_au8Levels[u8Level], &xTuned);
+            Bench_vRun(&xFixed, s_au8Levels[u8Level], &xDefault);
+
+            printf("   level %u degC\n", s_au8Levels[u8Level]);
+            Bench_vPrint("tuned", &xTuned);
+            Bench_vPrint("heater.h", &xDefault);
+
+            if((xTuned.s32SettledAt < 0) || (xTuned.s32Overshoot > BENCH_MAX_OVERSHOOT_CENTI))
+            {
+                bPass = FALSE;
+            }
+        }
+    }
+
+    return bPass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Benchmarks
+ *
+ * File Name: bench_uart0.c
+ *
+ * Description: CPU cycles spent per byte sent on UART0 in each transmit mode
+ *              of the driver, measured with the DWT cycle counter of the
+ *              virtual target under the kernel. The cycles are those spent in
+ *              UART0_Write plus those spent in UART0_Handler; the time the
+ *              sending task sleeps while the interrupt or the uDMA drains the
+ *              ring is free for the other tasks and is not counted.
+ *
+ *              The virtual cycle counter is host time scaled to the system
+ *              clock and every register access traps into the peripheral
+ *              models, so every figure is host time, and the interrupt and
+ *              DMA ones are inflated by the trap cost. The polling figure is
+ *              the time UART0_Write busy waits for room in the TX FIFO of the
+ *              model: below the wire time of a byte at 9600 baud (83333
+ *              cycles), about half of it here, as the FIFO takes in the first
+ *              16 bytes of each message without waiting.
+ *
+ *              make -C Simulation bench
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "dwt.h"
+#include "clock.h"
+#include "udma.h"
+#include "uart0.h"
+#include "stack.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_MESSAGE_LENGTH     32
+#define BENCH_MESSAGES           16
+#define BENCH_BYTES              (BENCH_MESSAGE_LENGTH * BENCH_MESSAGES)
+
+#define BENCH_TASK_STACK_SIZE    256
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const char *const s_apcModeNames[] = { "polling", "interrupt", "dma" };
+
+static volatile uint32 s_u32IsrCycles;
+static volatile uint32 s_u32IsrCalls;
+
+/* The kernel is built without dynamic allocation (FreeRTOSConfig.h) */
+static StackType_t s_axBenchStack[STACK_GUARD_WORDS + BENCH_TASK_STACK_SIZE];
+static StackType_t s_axIdleStack[STACK_GUARD_WORDS + configMINIMAL_STACK_SIZE];
+static StackType_t s_axTimerStack[STACK_GUARD_WORDS + configTIMER_TASK_STACK_DEPTH];
+static StaticTask_t s_xBenchTCB;
+static StaticTask_t s_xIdleTCB;
+static StaticTask_t s_xTimerTCB;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void Bench_vUart0Isr(void)
+{
+    uint32 u32Start = DWT_CycleCounterRead();
+
+    UART0_Handler();
+    s_u32IsrCycles += DWT_CycleCounterRead() - u32Start;
+    s_u32IsrCalls++;
+}
+
+static void Bench_vRun(uint8 u8Mode)
+{
+    uint8  au8Message[BENCH_MESSAGE_LENGTH];
+    uint32 u32WriteCycles = 0;
+    uint32 u32Start;
+    uint8  u8Message;
+    uint8  u8Byte;
+
+    for(u8Byte = 0; u8Byte < BENCH_MESSAGE_LENGTH; u8Byte++)
+    {
+        au8Message[u8Byte] = (uint8)('a' + (u8Byte % 26));
+    }
+
+    UART0_SetTxMode(u8Mode);
+    s_u32IsrCycles = 0;
+    s_u32IsrCalls = 0;
+
+    for(u8Message = 0; u8Message < BENCH_MESSAGES; u8Message++)
+    {
+        u32Start = DWT_CycleCounterRead();
+        (void)UART0_Write(au8Message, BENCH_MESSAGE_LENGTH);
+        u32WriteCycles += DWT_CycleCounterRead() - u32Start;
+
+        /* One message at a time, so the ring never overflows and each write starts the transmitter */
+        while(UART0_TxIdle() == FALSE)
+        {
+            vTaskDelay(1);
+        }
+    }
+
+    printf("  %-9s  write %9.1f  isr %7.1f (%3u calls)  total %9.1f cycles/byte\n",
+           s_apcModeNames[u8Mode], (double)u32WriteCycles / BENCH_BYTES,
+           (double)s_u32IsrCycles / BENCH_BYTES, (unsigned)s_u32IsrCalls,
+           (double)(u32WriteCycles + s_u32IsrCycles) / BENCH_BYTES);
+}
+
+static void Bench_vTask(void *pvParameters)
+{
+    uint8 u8Mode;
+
+    (void)pvParameters;
+    printf("uart0 transmit, %u bytes in %u byte messages at %u baud\n", BENCH_BYTES, BENCH_MESSAGE_LENGTH, UART0_BAUD_RATE);
+    for(u8Mode = UART0_TX_MODE_POLLING; u8Mode <= UART0_TX_MODE_DMA; u8Mode++)
+    {
+        Bench_vRun(u8Mode);
+    }
+    printf("  dropped bytes %u\n", (unsigned)UART0_TxDroppedBytes());
+    fflush(stdout);
+
+    exit((UART0_TxDroppedBytes() == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &s_xIdleTCB;
+    *ppxIdleTaskStackBuffer = &s_axIdleStack[STACK_GUARD_WORDS];
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &s_xTimerTCB;
+    *ppxTimerTaskStackBuffer = &s_axTimerStack[STACK_GUARD_WORDS];
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(void)
+{
+    SimPeriph_vInit();
+    CLOCK_vInit();
+    DWT_CycleCounterInit();
+    UDMA_vInit();
+    UART0_Init();
+    vPortSetInterruptHandler(SIM_IRQ_UART0, Bench_vUart0Isr);
+
+    xTaskCreateStatic(Bench_vTask, "Bench", BENCH_TASK_STACK_SIZE, NULL, 1, &s_axBenchStack[STACK_GUARD_WORDS], &s_xBenchTCB);
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
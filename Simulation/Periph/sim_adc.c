@@ -0,0 +1,402 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - ADC
+ *
+ * File Name: sim_adc.c
+ *
+ * Description: Virtual ADC0/ADC1 with the four sample sequencers, their FIFOs
+ *              and interrupts. Sequences run on a processor trigger (PSSI) or
+ *              on a GPTM timeout (EMUX timer trigger) and complete after the
+ *              conversion time of their samples. The FIFO of a sequencer is
+ *              drained by its uDMA channel when the channel is enabled.
+ *
+ *              Analog input n is fed from SIM_ADC_AIN<n>:
+ *                SIM_ADC_AIN0=2048              constant raw value
+ *                SIM_ADC_AIN0=/path/to/file     one raw value per line, one line
+ *                                               per conversion, wraps at the end
+ *                SIM_ADC_AIN0=plant             sensor of the seat heater 0 warms
+ *                                               (sim_plant.c)
+ *              Unset inputs read SIM_ADC_DEFAULT_RAW.
+ *
+ *******************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_ADC_MODULES              2
+#define SIM_ADC_SEQUENCERS           4
+#define SIM_ADC_DEFAULT_RAW          2000
+#define SIM_ADC_MAX_RAW              4095
+#define SIM_ADC_SAMPLE_NS            1000ULL    /* 1 Msps */
+
+#define SIM_ADC_ACTSS                0x000
+#define SIM_ADC_RIS                  0x004
+#define SIM_ADC_IM                   0x008
+#define SIM_ADC_ISC                  0x00C
+#define SIM_ADC_EMUX                 0x014
+#define SIM_ADC_PSSI                 0x028
+#define SIM_ADC_SS_FIRST             0x040
+#define SIM_ADC_SS_STRIDE            0x020
+#define SIM_ADC_SSMUX                0x000
+#define SIM_ADC_SSCTL                0x004
+#define SIM_ADC_SSFIFO               0x008
+#define SIM_ADC_SSFSTAT              0x00C
+
+#define SIM_ADC_EMUX_TIMER           0x5
+
+#define SIM_ADC_SSCTL_END            0x2
+#define SIM_ADC_SSCTL_IE             0x4
+#define SIM_ADC_SSCTL_TS             0x8
+
+#define SIM_ADC_FSTAT_EMPTY          (1UL << 8)
+#define SIM_ADC_FSTAT_FULL           (1UL << 12)
+
+typedef struct
+{
+    uint16 au16Data[8];
+    uint8  u8Head;
+    uint8  u8Count;
+    uint64 u64DoneAtNs;      /* Non zero while a sequence is converting */
+} SimAdc_Sequencer;
+
+typedef struct
+{
+    uint32 u32Base;
+    uint32 u32FirstIrq;
+    uint8  u8FirstDmaChannel;
+    SimAdc_Sequencer axSeq[SIM_ADC_SEQUENCERS];
+} SimAdc_Module;
+
+typedef struct
+{
+    FILE  *pxFile;
+    uint32 u32Constant;
+    boolean bPlant;
+} SimAdc_Source;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const uint8 s_au8Depth[SIM_ADC_SEQUENCERS] = { 8, 4, 4, 1 };
+
+static SimAdc_Module s_axModules[SIM_ADC_MODULES] =
+{
+    { 0x40038000UL, SIM_IRQ_ADC0_SEQ0, 14, { { { 0 } } } },
+    { 0x40039000UL, SIM_IRQ_ADC1_SEQ0, 24, { { { 0 } } } },
+};
+
+static SimAdc_Source s_axSources[SIM_ADC_CHANNELS + 1];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static volatile uint32 *SimAdc_pu32Reg(const SimAdc_Module *pxModule, uint32 u32Offset)
+{
+    return SimRegs_pu32Alias(pxModule->u32Base + u32Offset);
+}
+
+static uint32 SimAdc_u32SsOffset(uint8 u8Seq, uint32 u32Register)
+{
+    return SIM_ADC_SS_FIRST + ((uint32)u8Seq * SIM_ADC_SS_STRIDE) + u32Register;
+}
+
+static SimAdc_Module *SimAdc_pxModuleOf(uint32 u32Address)
+{
+    return ((u32Address & ~0xFFFUL) == s_axModules[0].u32Base) ? &s_axModules[0] : &s_axModules[1];
+}
+
+/* Sequencer owning a SSMUX..SSFSTAT offset, or SIM_ADC_SEQUENCERS if it is a common register */
+static uint8 SimAdc_u8SeqOf(uint32 u32Offset)
+{
+    if((u32Offset < SIM_ADC_SS_FIRST) || (u32Offset >= SimAdc_u32SsOffset(SIM_ADC_SEQUENCERS, 0)))
+    {
+        return SIM_ADC_SEQUENCERS;
+    }
+    return (uint8)((u32Offset - SIM_ADC_SS_FIRST) / SIM_ADC_SS_STRIDE);
+}
+
+static void SimAdc_vUpdateFstat(SimAdc_Module *pxModule, uint8 u8Seq)
+{
+    SimAdc_Sequencer *pxSeq = &pxModule->axSeq[u8Seq];
+    uint8  u8Depth = s_au8Depth[u8Seq];
+    uint32 u32Fstat = ((uint32)((pxSeq->u8Head + pxSeq->u8Count) % u8Depth) << 4) | pxSeq->u8Head;
+
+    u32Fstat |= (pxSeq->u8Count == 0) ? SIM_ADC_FSTAT_EMPTY : 0;
+    u32Fstat |= (pxSeq->u8Count == u8Depth) ? SIM_ADC_FSTAT_FULL : 0;
+    *SimAdc_pu32Reg(pxModule, SimAdc_u32SsOffset(u8Seq, SIM_ADC_SSFSTAT)) = u32Fstat;
+    *SimAdc_pu32Reg(pxModule, SimAdc_u32SsOffset(u8Seq, SIM_ADC_SSFIFO)) =
+        (pxSeq->u8Count != 0) ? pxSeq->au16Data[pxSeq->u8Head] : 0;
+}
+
+static void SimAdc_vOpenSource(uint8 u8Channel, const char *pcName)
+{
+    const char *pcValue = getenv(pcName);
+    SimAdc_Source *pxSource = &s_axSources[u8Channel];
+
+    pxSource->u32Constant = SIM_ADC_DEFAULT_RAW;
+    if(pcValue == NULL)
+    {
+        return;
+    }
+    if(strcmp(pcValue, "plant") == 0)
+    {
+        pxSource->bPlant = TRUE;
+        SimPeriph_vLog("%s fed from the thermal plant\n", pcName);
+        return;
+    }
+    if(isdigit((unsigned char)pcValue[0]))
+    {
+        pxSource->u32Constant = (uint32)strtoul(pcValue, NULL, 0);
+        return;
+    }
+    pxSource->pxFile = fopen(pcValue, "r");
+    if(pxSource->pxFile == NULL)
+    {
+        SimPeriph_vLog("%s: cannot open %s, using %u\n", pcName, pcValue, SIM_ADC_DEFAULT_RAW);
+    }
+    else
+    {
+        SimPeriph_vLog("%s fed from %s\n", pcName, pcValue);
+    }
+}
+
+/* Hand the FIFO to the uDMA channel of the sequencer for as long as it takes requests */
+static void SimAdc_vDmaRequest(SimAdc_Module *pxModule, uint8 u8Seq)
+{
+    SimAdc_Sequencer *pxSeq = &pxModule->axSeq[u8Seq];
+    uint8 u8Result;
+
+    while(pxSeq->u8Count != 0)
+    {
+        u8Result = SimUdma_u8PeripheralRequest(pxModule->u8FirstDmaChannel + u8Seq, pxSeq->au16Data[pxSeq->u8Head]);
+        if(u8Result == SIM_UDMA_IGNORED)
+        {
+            break;
+        }
+        pxSeq->u8Head = (uint8)((pxSeq->u8Head + 1) % s_au8Depth[u8Seq]);
+        pxSeq->u8Count--;
+
+        /* The uDMA completion is signalled on the sequencer interrupt */
+        if(u8Result == SIM_UDMA_DONE)
+        {
+            SimRegs_vRaiseInterrupt(pxModule->u32FirstIrq + u8Seq);
+        }
+    }
+}
+
+/* Run every sample of a sequence into its FIFO */
+static void SimAdc_vConvert(SimAdc_Module *pxModule, uint8 u8Seq)
+{
+    SimAdc_Sequencer *pxSeq = &pxModule->axSeq[u8Seq];
+    uint32 u32Mux = *SimAdc_pu32Reg(pxModule, SimAdc_u32SsOffset(u8Seq, SIM_ADC_SSMUX));
+    uint32 u32Ctl = *SimAdc_pu32Reg(pxModule, SimAdc_u32SsOffset(u8Seq, SIM_ADC_SSCTL));
+    boolean bInterrupt = FALSE;
+    uint8  u8Step;
+    uint8  u8Nibble;
+    uint8  u8Channel;
+
+    for(u8Step = 0; u8Step < s_au8Depth[u8Seq]; u8Step++)
+    {
+        u8Nibble = (uint8)((u32Ctl >> (u8Step * 4)) & 0xF);
+        u8Channel = (u8Nibble & SIM_ADC_SSCTL_TS) ? SIM_ADC_CHANNEL_TS : (uint8)((u32Mux >> (u8Step * 4)) & 0xF);
+
+        if(pxSeq->u8Count < s_au8Depth[u8Seq])
+        {
+            pxSeq->au16Data[(pxSeq->u8Head + pxSeq->u8Count) % s_au8Depth[u8Seq]] = (uint16)SimAdc_u32Sample(u8Channel);
+            pxSeq->u8Count++;
+        }
+        if(u8Nibble & SIM_ADC_SSCTL_IE)
+        {
+            bInterrupt = TRUE;
+        }
+        if(u8Nibble & SIM_ADC_SSCTL_END)
+        {
+            break;
+        }
+    }
+    SimAdc_vDmaRequest(pxModule, u8Seq);
+    SimAdc_vUpdateFstat(pxModule, u8Seq);
+
+    if(bInterrupt)
+    {
+        *SimAdc_pu32Reg(pxModule, SIM_ADC_RIS) |= (1UL << u8Seq);
+        if(*SimAdc_pu32Reg(pxModule, SIM_ADC_IM) & (1UL << u8Seq))
+        {
+            *SimAdc_pu32Reg(pxModule, SIM_ADC_ISC) |= (1UL << u8Seq);
+            SimRegs_vRaiseInterrupt(pxModule->u32FirstIrq + u8Seq);
+        }
+    }
+}
+
+static void SimAdc_vTrigger(SimAdc_Module *pxModule, uint8 u8Seq)
+{
+    SimAdc_Sequencer *pxSeq = &pxModule->axSeq[u8Seq];
+    uint32 u32Ctl = *SimAdc_pu32Reg(pxModule, SimAdc_u32SsOffset(u8Seq, SIM_ADC_SSCTL));
+    uint8  u8Samples = 1;
+
+    if(!(*SimAdc_pu32Reg(pxModule, SIM_ADC_ACTSS) & (1UL << u8Seq)) || (pxSeq->u64DoneAtNs != 0))
+    {
+        return;
+    }
+    while((u8Samples < s_au8Depth[u8Seq]) && !((u32Ctl >> ((u8Samples - 1) * 4)) & SIM_ADC_SSCTL_END))
+    {
+        u8Samples++;
+    }
+    pxSeq->u64DoneAtNs = SimSysCtl_u64NowNs() + (u8Samples * SIM_ADC_SAMPLE_NS);
+}
+
+static void SimAdc_vReadDone(uint32 u32Address)
+{
+    SimAdc_Module *pxModule = SimAdc_pxModuleOf(u32Address);
+    uint32 u32Offset = u32Address & 0xFFC;
+    uint8  u8Seq = SimAdc_u8SeqOf(u32Offset);
+    SimAdc_Sequencer *pxSeq;
+
+    if((u8Seq < SIM_ADC_SEQUENCERS) && (u32Offset == SimAdc_u32SsOffset(u8Seq, SIM_ADC_SSFIFO)))
+    {
+        pxSeq = &pxModule->axSeq[u8Seq];
+        if(pxSeq->u8Count != 0)
+        {
+            pxSeq->u8Head = (uint8)((pxSeq->u8Head + 1) % s_au8Depth[u8Seq]);
+            pxSeq->u8Count--;
+        }
+        SimAdc_vUpdateFstat(pxModule, u8Seq);
+    }
+}
+
+static void SimAdc_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    SimAdc_Module *pxModule = SimAdc_pxModuleOf(u32Address);
+    uint32 u32Offset = u32Address & 0xFFC;
+    uint8  u8Seq;
+
+    if(u32Offset == SIM_ADC_PSSI)
+    {
+        for(u8Seq = 0; u8Seq < SIM_ADC_SEQUENCERS; u8Seq++)
+        {
+            if(u32Value & (1UL << u8Seq))
+            {
+                SimAdc_vTrigger(pxModule, u8Seq);
+            }
+        }
+        *SimAdc_pu32Reg(pxModule, SIM_ADC_PSSI) = 0;
+    }
+    else if(u32Offset == SIM_ADC_ISC)
+    {
+        /* Write 1 to clear the raw and masked status */
+        u32Value &= 0xF;
+        *SimAdc_pu32Reg(pxModule, SIM_ADC_RIS) &= ~u32Value;
+        *SimAdc_pu32Reg(pxModule, SIM_ADC_ISC) =
+            *SimAdc_pu32Reg(pxModule, SIM_ADC_RIS) & *SimAdc_pu32Reg(pxModule, SIM_ADC_IM);
+    }
+    else if(u32Offset == SIM_ADC_IM)
+    {
+        *SimAdc_pu32Reg(pxModule, SIM_ADC_ISC) =
+            *SimAdc_pu32Reg(pxModule, SIM_ADC_RIS) & *SimAdc_pu32Reg(pxModule, SIM_ADC_IM);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimAdc_vInit(void)
+{
+    char   acName[16];
+    uint8  u8Module;
+    uint8  u8Seq;
+    uint8  u8Channel;
+
+    for(u8Channel = 0; u8Channel < SIM_ADC_CHANNELS; u8Channel++)
+    {
+        snprintf(acName, sizeof(acName), "SIM_ADC_AIN%u", u8Channel);
+        SimAdc_vOpenSource(u8Channel, acName);
+    }
+    SimAdc_vOpenSource(SIM_ADC_CHANNEL_TS, "SIM_ADC_TS");
+
+    for(u8Module = 0; u8Module < SIM_ADC_MODULES; u8Module++)
+    {
+        for(u8Seq = 0; u8Seq < SIM_ADC_SEQUENCERS; u8Seq++)
+        {
+            SimAdc_vUpdateFstat(&s_axModules[u8Module], u8Seq);
+        }
+        SimRegs_vTrapPage(s_axModules[u8Module].u32Base, NULL_PTR, SimAdc_vReadDone, SimAdc_vWrite);
+    }
+}
+
+uint32 SimAdc_u32Sample(uint8 u8Channel)
+{
+    SimAdc_Source *pxSource = &s_axSources[u8Channel];
+    char   acLine[32];
+    uint32 u32Raw;
+
+    if(pxSource->bPlant)
+    {
+        return SimPlant_u32SensorRaw(u8Channel);
+    }
+    if(pxSource->pxFile == NULL)
+    {
+        return pxSource->u32Constant;
+    }
+    if(fgets(acLine, sizeof(acLine), pxSource->pxFile) == NULL)
+    {
+        rewind(pxSource->pxFile);
+        if(fgets(acLine, sizeof(acLine), pxSource->pxFile) == NULL)
+        {
+            return pxSource->u32Constant;
+        }
+    }
+    u32Raw = (uint32)strtoul(acLine, NULL, 0);
+    return (u32Raw > SIM_ADC_MAX_RAW) ? SIM_ADC_MAX_RAW : u32Raw;
+}
+
+void SimAdc_vTimerTrigger(void)
+{
+    uint8 u8Module;
+    uint8 u8Seq;
+
+    for(u8Module = 0; u8Module < SIM_ADC_MODULES; u8Module++)
+    {
+        uint32 u32Emux = *SimAdc_pu32Reg(&s_axModules[u8Module], SIM_ADC_EMUX);
+
+        for(u8Seq = 0; u8Seq < SIM_ADC_SEQUENCERS; u8Seq++)
+        {
+            if(((u32Emux >> (u8Seq * 4)) & 0xF) == SIM_ADC_EMUX_TIMER)
+            {
+                SimAdc_vTrigger(&s_axModules[u8Module], u8Seq);
+            }
+        }
+    }
+}
+
+void SimAdc_vService(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+    uint8  u8Module;
+    uint8  u8Seq;
+
+    for(u8Module = 0; u8Module < SIM_ADC_MODULES; u8Module++)
+    {
+        for(u8Seq = 0; u8Seq < SIM_ADC_SEQUENCERS; u8Seq++)
+        {
+            SimAdc_Sequencer *pxSeq = &s_axModules[u8Module].axSeq[u8Seq];
+
+            if((pxSeq->u64DoneAtNs != 0) && (u64Now >= pxSeq->u64DoneAtNs))
+            {
+                pxSeq->u64DoneAtNs = 0;
+                SimAdc_vConvert(&s_axModules[u8Module], u8Seq);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - DWT
+ *
+ * File Name: sim_dwt.c
+ *
+ * Description: Virtual Cortex-M4 DWT cycle counter. CYCCNT follows the
+ *              simulated system clock, so cycle measurements taken by the
+ *              firmware are host time expressed in target clock cycles.
+ *
+ *******************************************************************************/
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_DWT_BASE                 0xE0001000UL
+#define SIM_DWT_CTRL                 0x000
+#define SIM_DWT_CYCCNT               0x004
+
+#define SIM_DWT_CTRL_CYCCNTENA       0x00000001UL
+#define SIM_DWT_DEMCR_TRCENA         0x01000000UL
+
+/* DWT_CTRL reset value: 4 comparators, no cycle counter running */
+#define SIM_DWT_CTRL_RESET           0x40000000UL
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static boolean s_bRunning;
+static uint64  s_u64Origin;      /* System clock count at which CYCCNT was 0 */
+static uint32  s_u32Stopped;     /* CYCCNT while the counter is disabled */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 SimDwt_u32Count(void)
+{
+    return s_bRunning ? (uint32)(SimSysCtl_u64Cycles() - s_u64Origin) : s_u32Stopped;
+}
+
+static void SimDwt_vRead(uint32 u32Address)
+{
+    if((u32Address & 0xFFC) == SIM_DWT_CYCCNT)
+    {
+        SIM_REG(DWT_CYCCNT_REG) = SimDwt_u32Count();
+    }
+}
+
+static void SimDwt_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    boolean bEnable = ((SIM_REG(DWT_CTRL_REG) & SIM_DWT_CTRL_CYCCNTENA) &&
+                       (SIM_REG(CORE_DEBUG_DEMCR_REG) & SIM_DWT_DEMCR_TRCENA)) ? TRUE : FALSE;
+
+    if((u32Address & 0xFFC) == SIM_DWT_CYCCNT)
+    {
+        s_u32Stopped = u32Value;
+        s_u64Origin = SimSysCtl_u64Cycles() - u32Value;
+    }
+    else if(bEnable && !s_bRunning)
+    {
+        s_u64Origin = SimSysCtl_u64Cycles() - s_u32Stopped;
+    }
+    else if(!bEnable && s_bRunning)
+    {
+        s_u32Stopped = SimDwt_u32Count();
+    }
+    s_bRunning = bEnable;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimDwt_vInit(void)
+{
+    SIM_REG(DWT_CTRL_REG) = SIM_DWT_CTRL_RESET;
+    SimRegs_vTrapPage(SIM_DWT_BASE, SimDwt_vRead, NULL_PTR, SimDwt_vWrite);
+}
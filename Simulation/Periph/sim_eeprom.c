@@ -0,0 +1,148 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - EEPROM
+ *
+ * File Name: sim_eeprom.c
+ *
+ * Description: Virtual 2 KB EEPROM, 32 blocks of 16 words, read and written
+ *              through EEBLOCK, EEOFFSET and EERDWR/EERDWRINC. Writes finish at
+ *              once: EEDONE never shows the EEPROM working. The contents start
+ *              erased, every word 0xFFFFFFFF.
+ *
+ *              SIM_EEPROM=path      keep the contents in a file across runs,
+ *                                   read at start and written on every write
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_EEPROM_BASE              0x400AF000UL
+#define SIM_EEPROM_EESIZE            0x000
+#define SIM_EEPROM_EEBLOCK           0x004
+#define SIM_EEPROM_EEOFFSET          0x008
+#define SIM_EEPROM_EERDWR            0x010
+#define SIM_EEPROM_EERDWRINC         0x014
+
+#define SIM_EEPROM_BLOCKS            32
+#define SIM_EEPROM_BLOCK_WORDS       16
+#define SIM_EEPROM_WORDS             (SIM_EEPROM_BLOCKS * SIM_EEPROM_BLOCK_WORDS)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 s_au32Words[SIM_EEPROM_WORDS];
+static const char *s_pcFile;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static volatile uint32 *SimEeprom_pu32Reg(uint32 u32Offset)
+{
+    return SimRegs_pu32Alias(SIM_EEPROM_BASE + u32Offset);
+}
+
+/* Word addressed by EEBLOCK and EEOFFSET */
+static uint32 *SimEeprom_pu32Word(void)
+{
+    uint32 u32Block = *SimEeprom_pu32Reg(SIM_EEPROM_EEBLOCK) % SIM_EEPROM_BLOCKS;
+    uint32 u32Offset = *SimEeprom_pu32Reg(SIM_EEPROM_EEOFFSET) % SIM_EEPROM_BLOCK_WORDS;
+
+    return &s_au32Words[(u32Block * SIM_EEPROM_BLOCK_WORDS) + u32Offset];
+}
+
+/* EERDWRINC moves to the next word, wrapping within the block */
+static void SimEeprom_vIncrement(void)
+{
+    *SimEeprom_pu32Reg(SIM_EEPROM_EEOFFSET) = (*SimEeprom_pu32Reg(SIM_EEPROM_EEOFFSET) + 1) % SIM_EEPROM_BLOCK_WORDS;
+}
+
+static void SimEeprom_vSave(void)
+{
+    FILE *pxFile;
+
+    if(s_pcFile == NULL)
+    {
+        return;
+    }
+    pxFile = fopen(s_pcFile, "wb");
+    if((pxFile == NULL) || (fwrite(s_au32Words, sizeof(s_au32Words), 1, pxFile) != 1))
+    {
+        SimPeriph_vLog("SIM_EEPROM: cannot write %s\n", s_pcFile);
+    }
+    if(pxFile != NULL)
+    {
+        fclose(pxFile);
+    }
+}
+
+static void SimEeprom_vRead(uint32 u32Address)
+{
+    uint32 u32Offset = u32Address & 0xFFC;
+
+    if((u32Offset == SIM_EEPROM_EERDWR) || (u32Offset == SIM_EEPROM_EERDWRINC))
+    {
+        *SimEeprom_pu32Reg(u32Offset) = *SimEeprom_pu32Word();
+    }
+}
+
+static void SimEeprom_vReadDone(uint32 u32Address)
+{
+    if((u32Address & 0xFFC) == SIM_EEPROM_EERDWRINC)
+    {
+        SimEeprom_vIncrement();
+    }
+}
+
+static void SimEeprom_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    uint32 u32Offset = u32Address & 0xFFC;
+
+    if((u32Offset == SIM_EEPROM_EERDWR) || (u32Offset == SIM_EEPROM_EERDWRINC))
+    {
+        *SimEeprom_pu32Word() = u32Value;
+        if(u32Offset == SIM_EEPROM_EERDWRINC)
+        {
+            SimEeprom_vIncrement();
+        }
+        SimEeprom_vSave();
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimEeprom_vInit(void)
+{
+    FILE *pxFile;
+
+    memset(s_au32Words, 0xFF, sizeof(s_au32Words));
+    s_pcFile = getenv("SIM_EEPROM");
+    if(s_pcFile != NULL)
+    {
+        pxFile = fopen(s_pcFile, "rb");
+        if(pxFile != NULL)
+        {
+            if(fread(s_au32Words, sizeof(s_au32Words), 1, pxFile) != 1)
+            {
+                SimPeriph_vLog("SIM_EEPROM: %s is short, the rest reads erased\n", s_pcFile);
+            }
+            fclose(pxFile);
+        }
+    }
+
+    /* EESIZE: BLKCNT in the upper half, WORDCNT in the lower one */
+    *SimEeprom_pu32Reg(SIM_EEPROM_EESIZE) = ((uint32)SIM_EEPROM_BLOCKS << 16) | SIM_EEPROM_WORDS;
+    SimRegs_vTrapPage(SIM_EEPROM_BASE, SimEeprom_vRead, SimEeprom_vReadDone, SimEeprom_vWrite);
+}
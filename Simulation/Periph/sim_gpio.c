@@ -0,0 +1,274 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - GPIO
+ *
+ * File Name: sim_gpio.c
+ *
+ * Description: Virtual GPIO ports A..F: masked DATA accesses, input pins
+ *              driven by the simulation (buttons), edge/level interrupt
+ *              detection, a console trace of the LaunchPad RGB LED and the
+ *              heater pins of PORTB driving the thermal plant.
+ *
+ *******************************************************************************/
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_GPIO_DATA_END            0x400
+#define SIM_GPIO_DIR                 0x400
+#define SIM_GPIO_IS                  0x404
+#define SIM_GPIO_IBE                 0x408
+#define SIM_GPIO_IEV                 0x40C
+#define SIM_GPIO_IM                  0x410
+#define SIM_GPIO_RIS                 0x414
+#define SIM_GPIO_MIS                 0x418
+#define SIM_GPIO_ICR                 0x41C
+#define SIM_GPIO_AFSEL               0x420
+#define SIM_GPIO_DATA_ALL            0x3FC
+
+#define SIM_GPIO_LED_MASK            0x0E   /* PF1 red, PF2 blue, PF3 green */
+#define SIM_GPIO_HEATERS             4      /* PB6, PB7, PB4, PB5, the pins of PWM0 outputs 0..3 */
+
+#define SIM_GPIO_MAX_RELEASES        8
+
+typedef struct
+{
+    uint32 u32Base;
+    uint32 u32Irq;
+    uint8  u8Out;       /* Value last written to the output latches */
+    uint8  u8In;        /* Level driven on the pins from outside */
+} SimGpio_Port;
+
+typedef struct
+{
+    uint64 u64AtNs;
+    uint8  u8Port;
+    uint8  u8Pin;
+} SimGpio_Release;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimGpio_Port s_axPorts[SIM_GPIO_PORTS] =
+{
+    { 0x40004000UL, SIM_IRQ_GPIOA, 0x00, 0xFF },
+    { 0x40005000UL, 1,             0x00, 0xFF },
+    { 0x40006000UL, 2,             0x00, 0xFF },
+    { 0x40007000UL, 3,             0x00, 0xFF },
+    { 0x40024000UL, 4,             0x00, 0xFF },
+    { 0x40025000UL, SIM_IRQ_GPIOF, 0x00, 0xFF },
+};
+
+static SimGpio_Release s_axReleases[SIM_GPIO_MAX_RELEASES];
+
+static const uint8 s_au8HeaterPins[SIM_GPIO_HEATERS] = { 6, 7, 4, 5 };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static volatile uint32 *SimGpio_pu32Reg(const SimGpio_Port *pxPort, uint32 u32Offset)
+{
+    return SimRegs_pu32Alias(pxPort->u32Base + u32Offset);
+}
+
+static SimGpio_Port *SimGpio_pxPortOf(uint32 u32Address)
+{
+    uint8 u8Port;
+
+    for(u8Port = 0; u8Port < SIM_GPIO_PORTS; u8Port++)
+    {
+        if((u32Address & ~0xFFFUL) == s_axPorts[u8Port].u32Base)
+        {
+            return &s_axPorts[u8Port];
+        }
+    }
+    return NULL_PTR;
+}
+
+static uint8 SimGpio_u8PinLevels(const SimGpio_Port *pxPort)
+{
+    uint8 u8Dir = (uint8)*SimGpio_pu32Reg(pxPort, SIM_GPIO_DIR);
+
+    return (uint8)((pxPort->u8Out & u8Dir) | (pxPort->u8In & ~u8Dir));
+}
+
+static void SimGpio_vUpdateInterrupt(const SimGpio_Port *pxPort)
+{
+    uint32 u32Mis = *SimGpio_pu32Reg(pxPort, SIM_GPIO_RIS) & *SimGpio_pu32Reg(pxPort, SIM_GPIO_IM);
+
+    *SimGpio_pu32Reg(pxPort, SIM_GPIO_MIS) = u32Mis;
+    if(u32Mis != 0)
+    {
+        SimRegs_vRaiseInterrupt(pxPort->u32Irq);
+    }
+}
+
+static void SimGpio_vTraceLeds(const SimGpio_Port *pxPort, uint8 u8Before)
+{
+    uint8 u8After = SimGpio_u8PinLevels(pxPort);
+
+    if((pxPort == &s_axPorts[SIM_GPIO_PORTF]) && ((u8Before ^ u8After) & SIM_GPIO_LED_MASK))
+    {
+        SimPeriph_vLog("LED red=%u green=%u blue=%u\n",
+                       (u8After >> 1) & 1U, (u8After >> 3) & 1U, (u8After >> 2) & 1U);
+    }
+}
+
+/* Heater pins used as plain outputs (software PWM) heat the plant at their level */
+static void SimGpio_vDriveHeaters(const SimGpio_Port *pxPort)
+{
+    uint8 u8Plain = (uint8)(*SimGpio_pu32Reg(pxPort, SIM_GPIO_DIR) & ~*SimGpio_pu32Reg(pxPort, SIM_GPIO_AFSEL));
+    uint8 u8Levels = SimGpio_u8PinLevels(pxPort);
+    uint8 u8Heater;
+    uint8 u8Bit;
+
+    for(u8Heater = 0; u8Heater < SIM_GPIO_HEATERS; u8Heater++)
+    {
+        u8Bit = (uint8)(1U << s_au8HeaterPins[u8Heater]);
+        if(u8Plain & u8Bit)
+        {
+            SimPlant_vDrive(u8Heater, (u8Levels & u8Bit) ? 1000 : 0);
+        }
+    }
+}
+
+static void SimGpio_vRead(uint32 u32Address)
+{
+    SimGpio_Port *pxPort = SimGpio_pxPortOf(u32Address);
+    uint32 u32Offset = u32Address & 0xFFC;
+
+    if(u32Offset < SIM_GPIO_DATA_END)
+    {
+        /* Address bits [9:2] mask the DATA bits that are visible */
+        *SimGpio_pu32Reg(pxPort, u32Offset) = SimGpio_u8PinLevels(pxPort) & (u32Offset >> 2);
+    }
+    else if(u32Offset == SIM_GPIO_MIS)
+    {
+        *SimGpio_pu32Reg(pxPort, SIM_GPIO_MIS) = *SimGpio_pu32Reg(pxPort, SIM_GPIO_RIS) & *SimGpio_pu32Reg(pxPort, SIM_GPIO_IM);
+    }
+}
+
+static void SimGpio_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    SimGpio_Port *pxPort = SimGpio_pxPortOf(u32Address);
+    uint32 u32Offset = u32Address & 0xFFC;
+    uint8  u8Mask = (uint8)(u32Offset >> 2);
+    uint8  u8Before = SimGpio_u8PinLevels(pxPort);
+
+    if(u32Offset < SIM_GPIO_DATA_END)
+    {
+        pxPort->u8Out = (uint8)((pxPort->u8Out & ~u8Mask) | (u32Value & u8Mask));
+        *SimGpio_pu32Reg(pxPort, SIM_GPIO_DATA_ALL) = SimGpio_u8PinLevels(pxPort);
+        SimGpio_vTraceLeds(pxPort, u8Before);
+        if(pxPort == &s_axPorts[SIM_GPIO_PORTB])
+        {
+            SimGpio_vDriveHeaters(pxPort);
+        }
+    }
+    else if(u32Offset == SIM_GPIO_ICR)
+    {
+        /* Write 1 to clear, reads back as 0 */
+        *SimGpio_pu32Reg(pxPort, SIM_GPIO_RIS) &= ~u32Value;
+        *SimGpio_pu32Reg(pxPort, SIM_GPIO_ICR) = 0;
+        SimGpio_vUpdateInterrupt(pxPort);
+    }
+    else if(u32Offset == SIM_GPIO_IM)
+    {
+        SimGpio_vUpdateInterrupt(pxPort);
+    }
+    else if(u32Offset == SIM_GPIO_DIR)
+    {
+        SimGpio_vTraceLeds(pxPort, u8Before);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimGpio_vInit(void)
+{
+    uint8 u8Port;
+
+    for(u8Port = 0; u8Port < SIM_GPIO_PORTS; u8Port++)
+    {
+        SimRegs_vTrapPage(s_axPorts[u8Port].u32Base, SimGpio_vRead, NULL_PTR, SimGpio_vWrite);
+    }
+}
+
+void SimGpio_vDrivePin(uint8 u8Port, uint8 u8Pin, uint8 u8Level)
+{
+    SimGpio_Port *pxPort = &s_axPorts[u8Port];
+    uint8  u8Bit = (uint8)(1U << u8Pin);
+    uint8  u8Old = (pxPort->u8In & u8Bit) ? 1U : 0U;
+    uint32 u32Is  = *SimGpio_pu32Reg(pxPort, SIM_GPIO_IS);
+    uint32 u32Ibe = *SimGpio_pu32Reg(pxPort, SIM_GPIO_IBE);
+    uint32 u32Iev = *SimGpio_pu32Reg(pxPort, SIM_GPIO_IEV);
+    boolean bEvent = FALSE;
+
+    if(u8Level)
+    {
+        pxPort->u8In |= u8Bit;
+    }
+    else
+    {
+        pxPort->u8In &= (uint8)~u8Bit;
+    }
+
+    if(u32Is & u8Bit)
+    {
+        /* Level sensitive: high or low level selected by IEV */
+        bEvent = (((u32Iev & u8Bit) ? 1U : 0U) == u8Level) ? TRUE : FALSE;
+    }
+    else if(u8Old != u8Level)
+    {
+        /* Edge sensitive: both edges (IBE) or rising/falling selected by IEV */
+        bEvent = ((u32Ibe & u8Bit) || ((((u32Iev & u8Bit) ? 1U : 0U) == u8Level))) ? TRUE : FALSE;
+    }
+
+    if(bEvent)
+    {
+        *SimGpio_pu32Reg(pxPort, SIM_GPIO_RIS) |= u8Bit;
+        SimGpio_vUpdateInterrupt(pxPort);
+    }
+}
+
+void SimGpio_vPressButton(uint8 u8Port, uint8 u8Pin, uint32 u32HoldMs)
+{
+    uint8 u8Slot;
+
+    /* Buttons are active low, released again by SimGpio_vService */
+    SimGpio_vDrivePin(u8Port, u8Pin, 0);
+
+    for(u8Slot = 0; u8Slot < SIM_GPIO_MAX_RELEASES; u8Slot++)
+    {
+        if(s_axReleases[u8Slot].u64AtNs == 0)
+        {
+            s_axReleases[u8Slot].u64AtNs = SimSysCtl_u64NowNs() + ((uint64)u32HoldMs * 1000000ULL);
+            s_axReleases[u8Slot].u8Port = u8Port;
+            s_axReleases[u8Slot].u8Pin = u8Pin;
+            break;
+        }
+    }
+}
+
+void SimGpio_vService(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+    uint8  u8Slot;
+
+    for(u8Slot = 0; u8Slot < SIM_GPIO_MAX_RELEASES; u8Slot++)
+    {
+        if((s_axReleases[u8Slot].u64AtNs != 0) && (u64Now >= s_axReleases[u8Slot].u64AtNs))
+        {
+            s_axReleases[u8Slot].u64AtNs = 0;
+            SimGpio_vDrivePin(s_axReleases[u8Slot].u8Port, s_axReleases[u8Slot].u8Pin, 1);
+        }
+    }
+}
@@ -0,0 +1,362 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - GPTM
+ *
+ * File Name: sim_gptm.c
+ *
+ * Description: Virtual 16/32-bit (TIMER0..5) and 32/64-bit (WTIMER0..5)
+ *              general purpose timers in one-shot and periodic modes, counting
+ *              up or down, with the ADC trigger output. The counters are derived from the simulated clock
+ *              when they are read, so they advance with system clock accuracy.
+ *
+ *******************************************************************************/
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_GPTM_TIMERS              12
+
+#define SIM_GPTM_CFG                 0x000
+#define SIM_GPTM_TAMR                0x004
+#define SIM_GPTM_TBMR                0x008
+#define SIM_GPTM_CTL                 0x00C
+#define SIM_GPTM_IMR                 0x018
+#define SIM_GPTM_RIS                 0x01C
+#define SIM_GPTM_MIS                 0x020
+#define SIM_GPTM_ICR                 0x024
+#define SIM_GPTM_TAILR               0x028
+#define SIM_GPTM_TBILR               0x02C
+#define SIM_GPTM_TAPR                0x038
+#define SIM_GPTM_TBPR                0x03C
+#define SIM_GPTM_TAR                 0x048
+#define SIM_GPTM_TBR                 0x04C
+#define SIM_GPTM_TAV                 0x050
+#define SIM_GPTM_TBV                 0x054
+
+#define SIM_GPTM_CFG_SPLIT           0x4         /* Two individual timers A and B */
+#define SIM_GPTM_MR_MODE_MASK        0x3
+#define SIM_GPTM_MR_ONE_SHOT         0x1
+#define SIM_GPTM_MR_CDIR_UP          0x10
+#define SIM_GPTM_CTL_TAEN            0x001
+#define SIM_GPTM_CTL_TAOTE           0x020
+#define SIM_GPTM_CTL_TBEN            0x100
+#define SIM_GPTM_CTL_TBOTE           0x2000
+#define SIM_GPTM_RIS_TATO            0x001
+#define SIM_GPTM_RIS_TBTO            0x100
+
+#define SIM_GPTM_HALF_A              0
+#define SIM_GPTM_HALF_B              1
+
+typedef struct
+{
+    boolean bRunning;
+    uint64  u64StartCycles;     /* System clock count when the half was enabled */
+    uint64  u64Timeouts;        /* Timeouts already reported in RIS */
+    uint64  u64Stopped;         /* Counter value while disabled */
+} SimGptm_Half;
+
+typedef struct
+{
+    uint32 u32Base;
+    uint32 u32IrqA;
+    boolean bWide;
+    SimGptm_Half axHalf[2];
+} SimGptm_Timer;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimGptm_Timer s_axTimers[SIM_GPTM_TIMERS] =
+{
+    { 0x40030000UL, 19, FALSE, { { 0 } } },
+    { 0x40031000UL, 21, FALSE, { { 0 } } },
+    { 0x40032000UL, 23, FALSE, { { 0 } } },
+    { 0x40033000UL, 35, FALSE, { { 0 } } },
+    { 0x40034000UL, 70, FALSE, { { 0 } } },
+    { 0x40035000UL, 92, FALSE, { { 0 } } },
+    { 0x40036000UL, SIM_IRQ_WTIMER0A, TRUE, { { 0 } } },
+    { 0x40037000UL, 96,  TRUE, { { 0 } } },
+    { 0x4004C000UL, 98,  TRUE, { { 0 } } },
+    { 0x4004D000UL, 100, TRUE, { { 0 } } },
+    { 0x4004E000UL, 102, TRUE, { { 0 } } },
+    { 0x4004F000UL, 104, TRUE, { { 0 } } },
+};
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static volatile uint32 *SimGptm_pu32Reg(const SimGptm_Timer *pxTimer, uint32 u32Offset)
+{
+    return SimRegs_pu32Alias(pxTimer->u32Base + u32Offset);
+}
+
+static SimGptm_Timer *SimGptm_pxTimerOf(uint32 u32Address)
+{
+    uint8 u8Timer;
+
+    for(u8Timer = 0; u8Timer < SIM_GPTM_TIMERS; u8Timer++)
+    {
+        if((u32Address & ~0xFFFUL) == s_axTimers[u8Timer].u32Base)
+        {
+            return &s_axTimers[u8Timer];
+        }
+    }
+    return NULL_PTR;
+}
+
+static boolean SimGptm_bSplit(const SimGptm_Timer *pxTimer)
+{
+    return (*SimGptm_pu32Reg(pxTimer, SIM_GPTM_CFG) & SIM_GPTM_CFG_SPLIT) ? TRUE : FALSE;
+}
+
+static uint32 SimGptm_u32ModeOf(const SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    return *SimGptm_pu32Reg(pxTimer, (u8Half == SIM_GPTM_HALF_A) ? SIM_GPTM_TAMR : SIM_GPTM_TBMR);
+}
+
+/* Interval load value; A and B form one 32-bit (TIMER) or 64-bit (WTIMER) counter when not split */
+static uint64 SimGptm_u64Load(const SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    uint64 u64A = *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TAILR);
+    uint64 u64B = *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TBILR);
+
+    if(SimGptm_bSplit(pxTimer))
+    {
+        return pxTimer->bWide ? ((u8Half == SIM_GPTM_HALF_A) ? u64A : u64B)
+                              : (((u8Half == SIM_GPTM_HALF_A) ? u64A : u64B) & 0xFFFF);
+    }
+    return pxTimer->bWide ? ((u64B << 32) | u64A) : (u64A & 0xFFFFFFFFULL);
+}
+
+/* Prescaler only divides the clock of individual timers */
+static uint64 SimGptm_u64Prescale(const SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    uint32 u32Pr = *SimGptm_pu32Reg(pxTimer, (u8Half == SIM_GPTM_HALF_A) ? SIM_GPTM_TAPR : SIM_GPTM_TBPR);
+
+    if(!SimGptm_bSplit(pxTimer))
+    {
+        return 1;
+    }
+    return (uint64)(u32Pr & (pxTimer->bWide ? 0xFFFF : 0xFF)) + 1;
+}
+
+static uint64 SimGptm_u64Ticks(const SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    return (SimSysCtl_u64Cycles() - pxTimer->axHalf[u8Half].u64StartCycles) / SimGptm_u64Prescale(pxTimer, u8Half);
+}
+
+static uint64 SimGptm_u64Timeouts(const SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    uint64 u64Ticks = SimGptm_u64Ticks(pxTimer, u8Half);
+    uint64 u64Load = SimGptm_u64Load(pxTimer, u8Half);
+    uint64 u64Timeouts;
+
+    /* Timeout on the tick that would reload the counter (0 counting down, ILR counting up) */
+    u64Timeouts = (u64Load == 0xFFFFFFFFFFFFFFFFULL) ? 0 : ((u64Ticks + 1) / (u64Load + 1));
+    if(((SimGptm_u32ModeOf(pxTimer, u8Half) & SIM_GPTM_MR_MODE_MASK) == SIM_GPTM_MR_ONE_SHOT) && (u64Timeouts > 1))
+    {
+        u64Timeouts = 1;
+    }
+    return u64Timeouts;
+}
+
+static uint64 SimGptm_u64Counter(const SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    const SimGptm_Half *pxHalf = &pxTimer->axHalf[u8Half];
+    uint32 u32Mode = SimGptm_u32ModeOf(pxTimer, u8Half);
+    uint64 u64Load = SimGptm_u64Load(pxTimer, u8Half);
+    uint64 u64Ticks;
+
+    if(!pxHalf->bRunning)
+    {
+        return pxHalf->u64Stopped;
+    }
+
+    u64Ticks = SimGptm_u64Ticks(pxTimer, u8Half);
+    if((u32Mode & SIM_GPTM_MR_MODE_MASK) == SIM_GPTM_MR_ONE_SHOT)
+    {
+        if(u64Ticks > u64Load)
+        {
+            u64Ticks = u64Load;
+        }
+    }
+    else if(u64Load != 0xFFFFFFFFFFFFFFFFULL)
+    {
+        u64Ticks %= (u64Load + 1);
+    }
+    return (u32Mode & SIM_GPTM_MR_CDIR_UP) ? u64Ticks : (u64Load - u64Ticks);
+}
+
+static void SimGptm_vStart(SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    SimGptm_Half *pxHalf = &pxTimer->axHalf[u8Half];
+
+    pxHalf->bRunning = TRUE;
+    pxHalf->u64StartCycles = SimSysCtl_u64Cycles();
+    pxHalf->u64Timeouts = 0;
+}
+
+static void SimGptm_vStop(SimGptm_Timer *pxTimer, uint8 u8Half)
+{
+    SimGptm_Half *pxHalf = &pxTimer->axHalf[u8Half];
+
+    pxHalf->u64Stopped = SimGptm_u64Counter(pxTimer, u8Half);
+    pxHalf->bRunning = FALSE;
+}
+
+static void SimGptm_vRefreshCounters(const SimGptm_Timer *pxTimer)
+{
+    uint64 u64A = SimGptm_u64Counter(pxTimer, SIM_GPTM_HALF_A);
+    uint64 u64B = SimGptm_u64Counter(pxTimer, SIM_GPTM_HALF_B);
+
+    if(!SimGptm_bSplit(pxTimer))
+    {
+        /* Concatenated: A holds the low word, B the high word of the 64-bit counter */
+        u64B = u64A >> 32;
+    }
+    *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TAR) = (uint32)u64A;
+    *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TAV) = (uint32)u64A;
+    *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TBR) = (uint32)u64B;
+    *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TBV) = (uint32)u64B;
+}
+
+static void SimGptm_vUpdateInterrupts(SimGptm_Timer *pxTimer)
+{
+    static const uint32 au32Flag[2] = { SIM_GPTM_RIS_TATO, SIM_GPTM_RIS_TBTO };
+    static const uint32 au32Trigger[2] = { SIM_GPTM_CTL_TAOTE, SIM_GPTM_CTL_TBOTE };
+    uint32 u32Ctl = *SimGptm_pu32Reg(pxTimer, SIM_GPTM_CTL);
+    uint32 u32MisBefore = *SimGptm_pu32Reg(pxTimer, SIM_GPTM_MIS);
+    uint32 u32Mis;
+    uint64 u64Timeouts;
+    uint8  u8Half;
+
+    for(u8Half = SIM_GPTM_HALF_A; u8Half <= SIM_GPTM_HALF_B; u8Half++)
+    {
+        if(!pxTimer->axHalf[u8Half].bRunning || ((u8Half == SIM_GPTM_HALF_B) && !SimGptm_bSplit(pxTimer)))
+        {
+            continue;
+        }
+        u64Timeouts = SimGptm_u64Timeouts(pxTimer, u8Half);
+        if(u64Timeouts != pxTimer->axHalf[u8Half].u64Timeouts)
+        {
+            pxTimer->axHalf[u8Half].u64Timeouts = u64Timeouts;
+            *SimGptm_pu32Reg(pxTimer, SIM_GPTM_RIS) |= au32Flag[u8Half];
+            if(u32Ctl & au32Trigger[u8Half])
+            {
+                SimAdc_vTimerTrigger();
+            }
+
+            /* A one-shot timer clears its enable bit when it times out */
+            if((SimGptm_u32ModeOf(pxTimer, u8Half) & SIM_GPTM_MR_MODE_MASK) == SIM_GPTM_MR_ONE_SHOT)
+            {
+                SimGptm_vStop(pxTimer, u8Half);
+                u32Ctl &= ~((u8Half == SIM_GPTM_HALF_A) ? SIM_GPTM_CTL_TAEN : SIM_GPTM_CTL_TBEN);
+                *SimGptm_pu32Reg(pxTimer, SIM_GPTM_CTL) = u32Ctl;
+            }
+        }
+    }
+
+    u32Mis = *SimGptm_pu32Reg(pxTimer, SIM_GPTM_RIS) & *SimGptm_pu32Reg(pxTimer, SIM_GPTM_IMR);
+    *SimGptm_pu32Reg(pxTimer, SIM_GPTM_MIS) = u32Mis;
+    if((u32Mis & ~u32MisBefore) & SIM_GPTM_RIS_TATO)
+    {
+        SimRegs_vRaiseInterrupt(pxTimer->u32IrqA);
+    }
+    if((u32Mis & ~u32MisBefore) & SIM_GPTM_RIS_TBTO)
+    {
+        SimRegs_vRaiseInterrupt(pxTimer->u32IrqA + 1);
+    }
+}
+
+static void SimGptm_vRead(uint32 u32Address)
+{
+    SimGptm_Timer *pxTimer = SimGptm_pxTimerOf(u32Address);
+
+    SimGptm_vUpdateInterrupts(pxTimer);
+    SimGptm_vRefreshCounters(pxTimer);
+}
+
+static void SimGptm_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    SimGptm_Timer *pxTimer = SimGptm_pxTimerOf(u32Address);
+    uint32 u32Offset = u32Address & 0xFFC;
+    uint8  u8Half;
+
+    if(u32Offset == SIM_GPTM_CTL)
+    {
+        for(u8Half = SIM_GPTM_HALF_A; u8Half <= SIM_GPTM_HALF_B; u8Half++)
+        {
+            boolean bEnable = (u32Value & ((u8Half == SIM_GPTM_HALF_A) ? SIM_GPTM_CTL_TAEN : SIM_GPTM_CTL_TBEN)) ? TRUE : FALSE;
+
+            if(bEnable && !pxTimer->axHalf[u8Half].bRunning)
+            {
+                SimGptm_vStart(pxTimer, u8Half);
+            }
+            else if(!bEnable && pxTimer->axHalf[u8Half].bRunning)
+            {
+                SimGptm_vStop(pxTimer, u8Half);
+            }
+        }
+    }
+    else if((u32Offset == SIM_GPTM_TAILR) || (u32Offset == SIM_GPTM_TBILR))
+    {
+        /* The counter loads the new interval while the timer is disabled */
+        for(u8Half = SIM_GPTM_HALF_A; u8Half <= SIM_GPTM_HALF_B; u8Half++)
+        {
+            if(!pxTimer->axHalf[u8Half].bRunning)
+            {
+                pxTimer->axHalf[u8Half].u64Stopped =
+                    (SimGptm_u32ModeOf(pxTimer, u8Half) & SIM_GPTM_MR_CDIR_UP) ? 0 : SimGptm_u64Load(pxTimer, u8Half);
+            }
+        }
+    }
+    else if(u32Offset == SIM_GPTM_ICR)
+    {
+        *SimGptm_pu32Reg(pxTimer, SIM_GPTM_RIS) &= ~u32Value;
+        *SimGptm_pu32Reg(pxTimer, SIM_GPTM_ICR) = 0;
+    }
+
+    SimGptm_vUpdateInterrupts(pxTimer);
+    SimGptm_vRefreshCounters(pxTimer);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimGptm_vInit(void)
+{
+    uint8 u8Timer;
+
+    for(u8Timer = 0; u8Timer < SIM_GPTM_TIMERS; u8Timer++)
+    {
+        SimGptm_Timer *pxTimer = &s_axTimers[u8Timer];
+
+        /* Reset values: interval loads and counters all ones */
+        *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TAILR) = 0xFFFFFFFFUL;
+        *SimGptm_pu32Reg(pxTimer, SIM_GPTM_TBILR) = pxTimer->bWide ? 0xFFFFFFFFUL : 0x0000FFFFUL;
+        pxTimer->axHalf[SIM_GPTM_HALF_A].u64Stopped = SimGptm_u64Load(pxTimer, SIM_GPTM_HALF_A);
+        pxTimer->axHalf[SIM_GPTM_HALF_B].u64Stopped = SimGptm_u64Load(pxTimer, SIM_GPTM_HALF_B);
+        SimGptm_vRefreshCounters(pxTimer);
+        SimRegs_vTrapPage(pxTimer->u32Base, SimGptm_vRead, NULL_PTR, SimGptm_vWrite);
+    }
+}
+
+void SimGptm_vService(void)
+{
+    uint8 u8Timer;
+
+    for(u8Timer = 0; u8Timer < SIM_GPTM_TIMERS; u8Timer++)
+    {
+        if(s_axTimers[u8Timer].axHalf[SIM_GPTM_HALF_A].bRunning || s_axTimers[u8Timer].axHalf[SIM_GPTM_HALF_B].bRunning)
+        {
+            SimGptm_vUpdateInterrupts(&s_axTimers[u8Timer]);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - NVIC
+ *
+ * File Name: sim_nvic.c
+ *
+ * Description: Interrupt enable and pending state of the virtual NVIC. The
+ *              set-enable/clear-enable and set-pending/clear-pending register
+ *              pairs act on one state each, and an interrupt raised while it
+ *              is disabled stays pending until it is enabled again, as on the
+ *              target. Delivery goes through the FreeRTOS POSIX port.
+ *
+ *******************************************************************************/
+
+#include <stddef.h>
+
+#include "FreeRTOS.h"
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_NVIC_BASE                0xE000E000UL
+#define SIM_NVIC_EN                  0x100
+#define SIM_NVIC_DIS                 0x180
+#define SIM_NVIC_PEND                0x200
+#define SIM_NVIC_UNPEND              0x280
+#define SIM_NVIC_WORDS               5          /* 139 interrupts */
+
+/* Weak so the benchmarks can link the models without the POSIX port */
+#pragma weak vPortGenerateSimulatedInterrupt
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 s_au32Enabled[SIM_NVIC_WORDS];
+static uint32 s_au32Pending[SIM_NVIC_WORDS];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SimNvic_vPublish(uint8 u8Word)
+{
+    *SimRegs_pu32Alias(SIM_NVIC_BASE + SIM_NVIC_EN + (u8Word * 4UL)) = s_au32Enabled[u8Word];
+    *SimRegs_pu32Alias(SIM_NVIC_BASE + SIM_NVIC_DIS + (u8Word * 4UL)) = s_au32Enabled[u8Word];
+    *SimRegs_pu32Alias(SIM_NVIC_BASE + SIM_NVIC_PEND + (u8Word * 4UL)) = s_au32Pending[u8Word];
+    *SimRegs_pu32Alias(SIM_NVIC_BASE + SIM_NVIC_UNPEND + (u8Word * 4UL)) = s_au32Pending[u8Word];
+}
+
+/* Take every interrupt of a word that is both pending and enabled */
+static void SimNvic_vDeliver(uint8 u8Word)
+{
+    uint32 u32Ready = s_au32Pending[u8Word] & s_au32Enabled[u8Word];
+    uint8  u8Bit;
+
+    s_au32Pending[u8Word] &= ~u32Ready;
+    SimNvic_vPublish(u8Word);
+    for(u8Bit = 0; (u32Ready != 0) && (u8Bit < 32); u8Bit++)
+    {
+        if((u32Ready & (1UL << u8Bit)) && (vPortGenerateSimulatedInterrupt != NULL))
+        {
+            vPortGenerateSimulatedInterrupt(((uint32)u8Word * 32) + u8Bit);
+        }
+    }
+}
+
+static void SimNvic_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    uint32 u32Offset = u32Address & 0xFFC;
+    uint8  u8Word = (uint8)((u32Offset & 0x7F) / 4);
+
+    if(u8Word >= SIM_NVIC_WORDS)
+    {
+        return;
+    }
+    switch(u32Offset & ~0x7FUL)
+    {
+    case SIM_NVIC_EN:     s_au32Enabled[u8Word] |= u32Value;  break;
+    case SIM_NVIC_DIS:    s_au32Enabled[u8Word] &= ~u32Value; break;
+    case SIM_NVIC_PEND:   s_au32Pending[u8Word] |= u32Value;  break;
+    case SIM_NVIC_UNPEND: s_au32Pending[u8Word] &= ~u32Value; break;
+    default:              return;
+    }
+    SimNvic_vDeliver(u8Word);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimNvic_vInit(void)
+{
+    SimRegs_vTrapPage(SIM_NVIC_BASE, NULL_PTR, NULL_PTR, SimNvic_vWrite);
+}
+
+void SimNvic_vRaise(uint32 u32IrqNumber)
+{
+    uint8 u8Word = (uint8)(u32IrqNumber / 32);
+
+    if(u8Word < SIM_NVIC_WORDS)
+    {
+        s_au32Pending[u8Word] |= (1UL << (u32IrqNumber % 32));
+        SimNvic_vDeliver(u8Word);
+    }
+}
@@ -0,0 +1,252 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Virtual Peripherals
+ *
+ * File Name: sim_periph.c
+ *
+ * Description: Brings up the virtual TM4C123GH6PM and runs the peripheral
+ *              service thread that advances the models which change on their
+ *              own (UART line, ADC conversions, timer timeouts, buttons).
+ *
+ *              SIM_BUTTONS="500:SW1,2500:SW2,4000:EXT"  press buttons at the
+ *                                    given ms after start (held 100 ms)
+ *              stdin keys 1, 2, 3     press SW1, SW2, EXT
+ *              SIM_DURATION_MS=n      exit after n ms of simulated run time
+ *
+ *******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "stack.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_PERIPH_SERVICE_NS        50000L      /* 50 us service period */
+#define SIM_PERIPH_BUTTON_HOLD_MS    100
+#define SIM_PERIPH_MAX_EVENTS        32
+
+typedef struct
+{
+    const char *pcName;
+    uint8 u8Port;
+    uint8 u8Pin;
+    char  cKey;
+} SimPeriph_Button;
+
+typedef struct
+{
+    uint64 u64AtNs;
+    uint8  u8Button;
+} SimPeriph_Event;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* SW1 (driver) PF4, SW2 (passenger) PF0, external driver button PA4 */
+static const SimPeriph_Button s_axButtons[] =
+{
+    { "SW1", SIM_GPIO_PORTF, 4, '1' },
+    { "SW2", SIM_GPIO_PORTF, 0, '2' },
+    { "EXT", SIM_GPIO_PORTA, 4, '3' },
+};
+
+#define SIM_PERIPH_BUTTONS           (sizeof(s_axButtons) / sizeof(s_axButtons[0]))
+
+static SimPeriph_Event s_axEvents[SIM_PERIPH_MAX_EVENTS];
+static uint8  s_u8Events;
+static uint64 s_u64DurationNs;
+static boolean s_bStdinKeys;
+
+/*******************************************************************************
+ *                              Public Variables                               *
+ *******************************************************************************/
+
+/* Main stack the target linker places at __stack (tm4c123gh6pm.cmd). The
+ * interrupts run on the task threads here, so it only gives the stack monitor
+ * the same layout and stays unused. */
+uint32 __stack[STACK_MAIN_SIZE / sizeof(uint32)];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void SimPeriph_vPress(uint8 u8Button)
+{
+    SimPeriph_vLog("%s pressed\n", s_axButtons[u8Button].pcName);
+    SimGpio_vPressButton(s_axButtons[u8Button].u8Port, s_axButtons[u8Button].u8Pin, SIM_PERIPH_BUTTON_HOLD_MS);
+}
+
+static void SimPeriph_vParseButtons(const char *pcScript)
+{
+    char  acName[8];
+    unsigned long ulMs;
+    int   s32Used;
+    uint8 u8Button;
+
+    while((pcScript != NULL) && (s_u8Events < SIM_PERIPH_MAX_EVENTS) &&
+          (sscanf(pcScript, "%lu:%7[A-Za-z0-9]%n", &ulMs, acName, &s32Used) == 2))
+    {
+        for(u8Button = 0; u8Button < SIM_PERIPH_BUTTONS; u8Button++)
+        {
+            if(strcasecmp(acName, s_axButtons[u8Button].pcName) == 0)
+            {
+                s_axEvents[s_u8Events].u64AtNs = (uint64)ulMs * 1000000ULL;
+                s_axEvents[s_u8Events].u8Button = u8Button;
+                s_u8Events++;
+                break;
+            }
+        }
+        if(u8Button == SIM_PERIPH_BUTTONS)
+        {
+            SimPeriph_vLog("SIM_BUTTONS: unknown button %s\n", acName);
+        }
+        pcScript = strchr(pcScript + s32Used, ',');
+        pcScript = (pcScript != NULL) ? (pcScript + 1) : NULL;
+    }
+}
+
+static void SimPeriph_vServiceInputs(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+    uint8  u8Event;
+    uint8  u8Button;
+    char   cKey;
+
+    for(u8Event = 0; u8Event < s_u8Events; u8Event++)
+    {
+        if((s_axEvents[u8Event].u64AtNs != 0) && (u64Now >= s_axEvents[u8Event].u64AtNs))
+        {
+            s_axEvents[u8Event].u64AtNs = 0;
+            SimPeriph_vPress(s_axEvents[u8Event].u8Button);
+        }
+    }
+
+    while(s_bStdinKeys && (read(STDIN_FILENO, &cKey, 1) == 1))
+    {
+        for(u8Button = 0; u8Button < SIM_PERIPH_BUTTONS; u8Button++)
+        {
+            if(cKey == s_axButtons[u8Button].cKey)
+            {
+                SimPeriph_vPress(u8Button);
+            }
+        }
+    }
+}
+
+static void *SimPeriph_pvServiceThread(void *pvParams)
+{
+    struct timespec xNext;
+
+    (void)pvParams;
+    clock_gettime(CLOCK_MONOTONIC, &xNext);
+
+    for(;;)
+    {
+        xNext.tv_nsec += SIM_PERIPH_SERVICE_NS;
+        if(xNext.tv_nsec >= 1000000000L)
+        {
+            xNext.tv_nsec -= 1000000000L;
+            xNext.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &xNext, NULL);
+
+        SimRegs_vLock();
+        SimPeriph_vServiceInputs();
+        SimGpio_vService();
+        SimUart0_vService();
+        SimAdc_vService();
+        SimGptm_vService();
+        SimPlant_vService();
+        SimRegs_vUnlock();
+
+        if((s_u64DurationNs != 0) && (SimSysCtl_u64NowNs() >= s_u64DurationNs))
+        {
+            SimPeriph_vLog("simulated %llu ms, exiting\n", (unsigned long long)(s_u64DurationNs / 1000000ULL));
+            _exit(EXIT_SUCCESS);
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimPeriph_vInit(void)
+{
+    pthread_attr_t xAttr;
+    pthread_t xThread;
+    sigset_t xSignals;
+    sigset_t xSaved;
+    const char *pcDuration = getenv("SIM_DURATION_MS");
+
+    SimRegs_vInit();
+    SimNvic_vInit();
+    SimSysCtl_vInit();
+    SimGpio_vInit();
+    SimUart0_vInit();
+    SimAdc_vInit();
+    SimGptm_vInit();
+    SimUdma_vInit();
+    SimPwm_vInit();
+    SimEeprom_vInit();
+    SimPlant_vInit();
+    SimDwt_vInit();
+
+    SimPeriph_vParseButtons(getenv("SIM_BUTTONS"));
+    if(pcDuration != NULL)
+    {
+        s_u64DurationNs = (uint64)strtoull(pcDuration, NULL, 0) * 1000000ULL;
+    }
+    if(isatty(STDIN_FILENO))
+    {
+        fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+        s_bStdinKeys = TRUE;
+    }
+
+    /* The service thread must never take the simulated interrupts */
+    sigemptyset(&xSignals);
+    sigaddset(&xSignals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &xSignals, &xSaved);
+    pthread_attr_init(&xAttr);
+    pthread_attr_setdetachstate(&xAttr, PTHREAD_CREATE_DETACHED);
+    if(pthread_create(&xThread, &xAttr, SimPeriph_pvServiceThread, NULL) != 0)
+    {
+        perror("[sim] peripheral service thread");
+        exit(EXIT_FAILURE);
+    }
+    pthread_attr_destroy(&xAttr);
+    pthread_sigmask(SIG_SETMASK, &xSaved, NULL);
+}
+
+void SimPeriph_vLog(const char *pcFormat, ...)
+{
+    char acBuffer[256];
+    int  s32Length = snprintf(acBuffer, sizeof(acBuffer), "[sim %8.3f] ", (double)SimSysCtl_u64NowNs() / 1e9);
+    va_list xArgs;
+
+    va_start(xArgs, pcFormat);
+    s32Length += vsnprintf(acBuffer + s32Length, sizeof(acBuffer) - (size_t)s32Length, pcFormat, xArgs);
+    va_end(xArgs);
+
+    if(s32Length > (int)sizeof(acBuffer) - 1)
+    {
+        s32Length = (int)sizeof(acBuffer) - 1;
+    }
+    (void)!write(STDERR_FILENO, acBuffer, (size_t)s32Length);
+}
@@ -0,0 +1,105 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Virtual Peripherals
+ *
+ * File Name: sim_periph.h
+ *
+ * Description: Header file for the virtual TM4C123GH6PM peripheral models
+ *              (SYSCTL, GPIO, UART0, ADC, GPTM, uDMA, PWM, EEPROM, NVIC, DWT)
+ *              and the thermal plant of the seats used by the simulation
+ *              build. The models sit behind the trapped register pages of
+ *              sim_regs.c and behave like the silicon as seen by the MCAL
+ *              drivers.
+ *
+ *******************************************************************************/
+
+#ifndef SIM_PERIPH_H_
+#define SIM_PERIPH_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_GPIO_PORTA               0
+#define SIM_GPIO_PORTB               1
+#define SIM_GPIO_PORTC               2
+#define SIM_GPIO_PORTD               3
+#define SIM_GPIO_PORTE               4
+#define SIM_GPIO_PORTF               5
+#define SIM_GPIO_PORTS               6
+
+#define SIM_ADC_CHANNELS             12
+#define SIM_ADC_CHANNEL_TS           SIM_ADC_CHANNELS     /* Internal temperature sensor */
+
+/* SimUdma_u8PeripheralRequest/SimUdma_u8PeripheralFetch results */
+#define SIM_UDMA_IGNORED             0      /* Channel off or masked, the peripheral keeps the item */
+#define SIM_UDMA_MOVED               1
+#define SIM_UDMA_DONE                2      /* Moved, and it completed a control structure */
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Bring up the register file, every model and the peripheral service thread */
+void SimPeriph_vInit(void);
+
+/* Printf style logging that is safe from the register trap handlers */
+void SimPeriph_vLog(const char *pcFormat, ...) __attribute__((format(printf, 1, 2)));
+
+/* System control: reset values, clock tree and simulated time */
+void   SimSysCtl_vInit(void);
+uint32 SimSysCtl_u32ClockHz(void);
+uint64 SimSysCtl_u64NowNs(void);
+uint64 SimSysCtl_u64Cycles(void);
+
+/* GPIO ports A..F */
+void SimGpio_vInit(void);
+void SimGpio_vDrivePin(uint8 u8Port, uint8 u8Pin, uint8 u8Level);
+void SimGpio_vPressButton(uint8 u8Port, uint8 u8Pin, uint32 u32HoldMs);
+void SimGpio_vService(void);
+
+/* UART0 on a pseudo terminal */
+void SimUart0_vInit(void);
+void SimUart0_vService(void);
+
+/* ADC0/ADC1 with file or constant fed analog inputs */
+void   SimAdc_vInit(void);
+uint32 SimAdc_u32Sample(uint8 u8Channel);
+void   SimAdc_vService(void);
+/* A GPTM with its ADC trigger output enabled timed out */
+void   SimAdc_vTimerTrigger(void);
+
+/* General purpose timers TIMER0..5 and WTIMER0..5 */
+void SimGptm_vInit(void);
+void SimGptm_vService(void);
+
+/* Micro DMA controller: peripheral to memory (Request) and memory to peripheral (Fetch) */
+void  SimUdma_vInit(void);
+uint8 SimUdma_u8PeripheralRequest(uint8 u8Channel, uint32 u32Data);
+uint8 SimUdma_u8PeripheralFetch(uint8 u8Channel, uint32 *pu32Data);
+
+/* NVIC enable and pending state */
+void SimNvic_vInit(void);
+void SimNvic_vRaise(uint32 u32IrqNumber);
+
+/* PWM0 generators 0 and 1, their outputs drive the thermal plant */
+void SimPwm_vInit(void);
+
+/* EEPROM, optionally kept in a file (SIM_EEPROM) */
+void SimEeprom_vInit(void);
+
+/* Thermal plant of the seats: heater n warms the seat read on AIN n (see sim_plant.c) */
+void   SimPlant_vInit(void);
+void   SimPlant_vDrive(uint8 u8Heater, uint16 u16Permille);
+/* Advance every seat by u64Ns at its present drive; vService advances to the simulated time */
+void   SimPlant_vAdvance(uint64 u64Ns);
+void   SimPlant_vService(void);
+double SimPlant_dSensorC(uint8 u8Heater);
+uint32 SimPlant_u32SensorRaw(uint8 u8Heater);
+
+/* Cortex-M4 DWT cycle counter */
+void SimDwt_vInit(void);
+
+#endif /* SIM_PERIPH_H_ */
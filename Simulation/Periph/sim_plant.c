@@ -0,0 +1,163 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Thermal Plant
+ *
+ * File Name: sim_plant.c
+ *
+ * Description: Thermal model of the seats. Heater n warms the seat whose
+ *              sensor is on AIN n (SIM_ADC_AIN<n>=plant), at the duty cycle of
+ *              PWM0 output n or of its PORTB pin (see heater.h).
+ *
+ *              The seat body settles at the ambient temperature plus the duty
+ *              cycle times the full power rise, with a first order time
+ *              constant; the sensor follows the body through a second, shorter
+ *              lag, the delay a controller has to cope with:
+ *
+ *                dBody/dt   = (Ambient + Rise * Duty - Body) / Tau
+ *                dSensor/dt = (Body - Sensor) / Lag
+ *
+ *              SIM_PLANT_AMBIENT_C=20   start and ambient temperature (degC)
+ *              SIM_PLANT_RISE_C=30      rise at full power (degC)
+ *              SIM_PLANT_TAU_MS=60000   body time constant
+ *              SIM_PLANT_LAG_MS=8000    sensor time constant
+ *
+ *              SIM_PLANT<n>_RISE_C, _TAU_MS and _LAG_MS set them for the seat of
+ *              heater n alone, e.g. SIM_PLANT1_TAU_MS=90000 for a passenger
+ *              seat slower than the driver's.
+ *
+ *              The sensor reads 0..45 degC over the 12-bit ADC range, as the
+ *              firmware converts it (temperature.h).
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim_periph.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_PLANT_HEATERS            4
+#define SIM_PLANT_STEP_NS            10000000ULL    /* 10 ms integration step */
+#define SIM_PLANT_ADC_FULL_SCALE     4095
+#define SIM_PLANT_SENSOR_SPAN_C      45.0
+
+typedef struct
+{
+    double dBody;
+    double dSensor;
+    double dDuty;
+    double dRise;
+    double dTauS;
+    double dLagS;
+} SimPlant_Seat;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static double s_dAmbient;
+
+static SimPlant_Seat s_axSeats[SIM_PLANT_HEATERS];
+static uint64 s_u64LastNs;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static double SimPlant_dParameter(const char *pcName, double dDefault)
+{
+    const char *pcValue = getenv(pcName);
+
+    return (pcValue != NULL) ? strtod(pcValue, NULL) : dDefault;
+}
+
+/* SIM_PLANT<n>_<NAME> of heater n, else SIM_PLANT_<NAME> */
+static double SimPlant_dSeatParameter(uint8 u8Heater, const char *pcName, double dDefault)
+{
+    char acName[32];
+
+    snprintf(acName, sizeof(acName), "SIM_PLANT_%s", pcName);
+    dDefault = SimPlant_dParameter(acName, dDefault);
+    snprintf(acName, sizeof(acName), "SIM_PLANT%u_%s", (unsigned)u8Heater, pcName);
+    return SimPlant_dParameter(acName, dDefault);
+}
+
+static void SimPlant_vStep(double dSeconds)
+{
+    uint8 u8Heater;
+
+    for(u8Heater = 0; u8Heater < SIM_PLANT_HEATERS; u8Heater++)
+    {
+        SimPlant_Seat *pxSeat = &s_axSeats[u8Heater];
+
+        pxSeat->dBody   += ((s_dAmbient + (pxSeat->dRise * pxSeat->dDuty)) - pxSeat->dBody) * (dSeconds / pxSeat->dTauS);
+        pxSeat->dSensor += (pxSeat->dBody - pxSeat->dSensor) * (dSeconds / pxSeat->dLagS);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimPlant_vInit(void)
+{
+    uint8 u8Heater;
+
+    s_dAmbient = SimPlant_dParameter("SIM_PLANT_AMBIENT_C", 20.0);
+
+    for(u8Heater = 0; u8Heater < SIM_PLANT_HEATERS; u8Heater++)
+    {
+        s_axSeats[u8Heater].dRise = SimPlant_dSeatParameter(u8Heater, "RISE_C", 30.0);
+        s_axSeats[u8Heater].dTauS = SimPlant_dSeatParameter(u8Heater, "TAU_MS", 60000.0) / 1000.0;
+        s_axSeats[u8Heater].dLagS = SimPlant_dSeatParameter(u8Heater, "LAG_MS", 8000.0) / 1000.0;
+        s_axSeats[u8Heater].dBody = s_dAmbient;
+        s_axSeats[u8Heater].dSensor = s_dAmbient;
+        s_axSeats[u8Heater].dDuty = 0.0;
+    }
+    s_u64LastNs = 0;
+}
+
+void SimPlant_vDrive(uint8 u8Heater, uint16 u16Permille)
+{
+    if(u8Heater < SIM_PLANT_HEATERS)
+    {
+        s_axSeats[u8Heater].dDuty = (u16Permille > 1000) ? 1.0 : (u16Permille / 1000.0);
+    }
+}
+
+void SimPlant_vAdvance(uint64 u64Ns)
+{
+    while(u64Ns > SIM_PLANT_STEP_NS)
+    {
+        SimPlant_vStep(SIM_PLANT_STEP_NS / 1e9);
+        u64Ns -= SIM_PLANT_STEP_NS;
+    }
+    SimPlant_vStep(u64Ns / 1e9);
+}
+
+double SimPlant_dSensorC(uint8 u8Heater)
+{
+    return (u8Heater < SIM_PLANT_HEATERS) ? s_axSeats[u8Heater].dSensor : s_dAmbient;
+}
+
+uint32 SimPlant_u32SensorRaw(uint8 u8Heater)
+{
+    double dRaw = (SimPlant_dSensorC(u8Heater) * SIM_PLANT_ADC_FULL_SCALE / SIM_PLANT_SENSOR_SPAN_C) + 0.5;
+
+    if(dRaw < 0.0)
+    {
+        return 0;
+    }
+    return (dRaw > SIM_PLANT_ADC_FULL_SCALE) ? SIM_PLANT_ADC_FULL_SCALE : (uint32)dRaw;
+}
+
+void SimPlant_vService(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+
+    SimPlant_vAdvance(u64Now - s_u64LastNs);
+    s_u64LastNs = u64Now;
+}
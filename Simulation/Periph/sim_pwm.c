@@ -0,0 +1,105 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - PWM
+ *
+ * File Name: sim_pwm.c
+ *
+ * Description: Virtual PWM0 generators 0 and 1 counting down, outputs
+ *              M0PWM0..3. The model does not toggle the pins: each output hands
+ *              its mean level, the duty cycle set by its LOAD, compare and
+ *              generator actions, to the thermal plant (sim_plant.c).
+ *
+ *******************************************************************************/
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_PWM_BASE                 0x40028000UL
+#define SIM_PWM_OUTPUTS              4
+
+#define SIM_PWM_ENABLE               0x008
+#define SIM_PWM_GEN_FIRST            0x040
+#define SIM_PWM_GEN_STRIDE           0x040
+#define SIM_PWM_GEN_CTL              0x000
+#define SIM_PWM_GEN_LOAD             0x010
+#define SIM_PWM_GEN_CMPA             0x018
+#define SIM_PWM_GEN_GENA             0x020
+
+#define SIM_PWM_CTL_ENABLE           0x1
+
+/* Generator actions */
+#define SIM_PWM_ACT_INVERT           1
+#define SIM_PWM_ACT_LOW              2
+#define SIM_PWM_ACT_HIGH             3
+#define SIM_PWM_ACTLOAD_POS          2
+#define SIM_PWM_ACTCMPAD_POS         6
+#define SIM_PWM_ACTCMPBD_POS         10
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 SimPwm_u32Reg(uint8 u8Generator, uint32 u32Register)
+{
+    return *SimRegs_pu32Alias(SIM_PWM_BASE + SIM_PWM_GEN_FIRST + ((uint32)u8Generator * SIM_PWM_GEN_STRIDE) + u32Register);
+}
+
+/* Mean level of an output in permille over a period of its generator */
+static uint16 SimPwm_u16Duty(uint8 u8Output)
+{
+    uint8  u8Generator = (uint8)(u8Output / 2);
+    boolean bB = (u8Output & 1) ? TRUE : FALSE;
+    uint32 u32Load = SimPwm_u32Reg(u8Generator, SIM_PWM_GEN_LOAD) & 0xFFFF;
+    uint32 u32Cmp = SimPwm_u32Reg(u8Generator, SIM_PWM_GEN_CMPA + (bB ? 4 : 0)) & 0xFFFF;
+    uint32 u32Gen = SimPwm_u32Reg(u8Generator, SIM_PWM_GEN_GENA + (bB ? 4 : 0));
+    uint32 u32ActLoad = (u32Gen >> SIM_PWM_ACTLOAD_POS) & 0x3;
+    uint32 u32ActCmp = (u32Gen >> (bB ? SIM_PWM_ACTCMPBD_POS : SIM_PWM_ACTCMPAD_POS)) & 0x3;
+    uint32 u32LoadLevel;
+    uint32 u32CmpLevel;
+
+    if(!(*SimRegs_pu32Alias(SIM_PWM_BASE + SIM_PWM_ENABLE) & (1UL << u8Output)) ||
+       !(SimPwm_u32Reg(u8Generator, SIM_PWM_GEN_CTL) & SIM_PWM_CTL_ENABLE))
+    {
+        return 0;
+    }
+    if(u32Cmp > u32Load)
+    {
+        u32Cmp = u32Load;
+    }
+
+    /* Level from LOAD down to the compare value, then from it down to zero */
+    u32LoadLevel = (u32ActLoad == SIM_PWM_ACT_HIGH) ? 1U : 0U;
+    switch(u32ActCmp)
+    {
+    case SIM_PWM_ACT_INVERT: u32CmpLevel = 1U - u32LoadLevel; break;
+    case SIM_PWM_ACT_LOW:    u32CmpLevel = 0U;                break;
+    case SIM_PWM_ACT_HIGH:   u32CmpLevel = 1U;                break;
+    default:                 u32CmpLevel = u32LoadLevel;      break;
+    }
+    return (uint16)((((u32LoadLevel * (u32Load - u32Cmp)) + (u32CmpLevel * (u32Cmp + 1))) * 1000UL) / (u32Load + 1));
+}
+
+static void SimPwm_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    uint8 u8Output;
+
+    (void)u32Address;
+    (void)u32Value;
+    for(u8Output = 0; u8Output < SIM_PWM_OUTPUTS; u8Output++)
+    {
+        SimPlant_vDrive(u8Output, SimPwm_u16Duty(u8Output));
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimPwm_vInit(void)
+{
+    SimRegs_vTrapPage(SIM_PWM_BASE, NULL_PTR, NULL_PTR, SimPwm_vWrite);
+}
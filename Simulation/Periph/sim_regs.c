@@ -0,0 +1,415 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Virtual Register File
+ *
+ * File Name: sim_regs.c
+ *
+ * Description: Source file for the virtual TM4C123GH6PM register file.
+ *
+ * The register windows are backed by one memfd that is mapped twice: once at
+ * the real peripheral addresses (what the firmware sees) and once anywhere
+ * (the alias the peripheral models use). Pages owned by a model are kept
+ * PROT_NONE in the firmware view. An access faults, the SIGSEGV handler lets
+ * the model refresh the register, opens the page and single steps the
+ * faulting instruction with the x86 trap flag, and the SIGTRAP handler closes
+ * the page again and reports the access to the model. The interrupt signal of
+ * the FreeRTOS POSIX port is held off while the page is open, so an interrupt
+ * raised by the access is taken right after the instruction, as on the target.
+ *
+ * The plain 32-bit MOV forms the compiler emits for nearly every register
+ * access are emulated in the SIGSEGV handler instead, which saves the single
+ * step and both page protection changes.
+ *
+ *******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "tm4c123gh6pm_registers.h"
+
+#if !defined(__x86_64__)
+#error "The simulation register traps single step with the x86-64 trap flag"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_REGS_PERIPH_PAGES        (SIM_REGS_PERIPH_SIZE / SIM_REGS_PAGE_SIZE)
+#define SIM_REGS_PPB_PAGES           (SIM_REGS_PPB_SIZE / SIM_REGS_PAGE_SIZE)
+#define SIM_REGS_PAGES               (SIM_REGS_PERIPH_PAGES + SIM_REGS_PPB_PAGES)
+
+#define SIM_REGS_EFLAGS_TF           0x100
+#define SIM_REGS_PF_WRITE            0x2
+
+#define SIM_REGS_OP_STORE_R32        0x89    /* mov [mem], r32 */
+#define SIM_REGS_OP_LOAD_R32         0x8B    /* mov r32, [mem] */
+#define SIM_REGS_OP_STORE_IMM32      0xC7    /* mov [mem], imm32 */
+#define SIM_REGS_OP_LOAD_EAX_ABS     0xA1    /* movabs eax, [moffs64] */
+#define SIM_REGS_OP_STORE_EAX_ABS    0xA3    /* movabs [moffs64], eax */
+
+/* Must match portSIG_INTERRUPT in the POSIX port */
+#define SIM_REGS_SIG_INTERRUPT       SIGUSR1
+
+typedef struct
+{
+    SimRegs_ReadHook     pfRead;
+    SimRegs_ReadDoneHook pfReadDone;
+    SimRegs_WriteHook    pfWrite;
+} SimRegs_PageModel;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint8 *s_pu8Alias;
+static pthread_mutex_t s_xModelLock = PTHREAD_MUTEX_INITIALIZER;
+static SimRegs_PageModel s_axPageModels[SIM_REGS_PAGES];
+
+/* Access in flight on this thread, between the fault and the single step */
+static __thread uint32  s_u32TrapAddress;
+static __thread boolean s_bTrapWrite;
+static __thread boolean s_bTrapActive;
+static __thread boolean s_bInterruptWasMasked;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static sint32 SimRegs_s32PageIndex(uint32 u32Address)
+{
+    if((u32Address >= SIM_REGS_PERIPH_BASE) && (u32Address < (SIM_REGS_PERIPH_BASE + SIM_REGS_PERIPH_SIZE)))
+    {
+        return (sint32)((u32Address - SIM_REGS_PERIPH_BASE) / SIM_REGS_PAGE_SIZE);
+    }
+    if((u32Address >= SIM_REGS_PPB_BASE) && (u32Address < (SIM_REGS_PPB_BASE + SIM_REGS_PPB_SIZE)))
+    {
+        return (sint32)(SIM_REGS_PERIPH_PAGES + ((u32Address - SIM_REGS_PPB_BASE) / SIM_REGS_PAGE_SIZE));
+    }
+    return -1;
+}
+
+static void *SimRegs_pvPage(uint32 u32Address)
+{
+    return (void *)(uintptr_t)(u32Address & ~(SIM_REGS_PAGE_SIZE - 1));
+}
+
+/* General purpose registers in ModRM/REX numbering */
+static const int s_as32GregOf[16] =
+{
+    REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+    REG_R8,  REG_R9,  REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15
+};
+
+/* Length of the ModRM, SIB and displacement bytes starting at pu8ModRm */
+static uint8 SimRegs_u8ModRmLength(const uint8 *pu8ModRm)
+{
+    uint8 u8Mod = (uint8)(pu8ModRm[0] >> 6);
+    uint8 u8Rm = (uint8)(pu8ModRm[0] & 0x7);
+    uint8 u8Length = 1;
+
+    if((u8Mod != 3) && (u8Rm == 4))
+    {
+        u8Length++;                                     /* SIB */
+        if((u8Mod == 0) && ((pu8ModRm[1] & 0x7) == 5))
+        {
+            u8Length += 4;                              /* No base, disp32 */
+        }
+    }
+    else if((u8Mod == 0) && (u8Rm == 5))
+    {
+        u8Length += 4;                                  /* RIP relative disp32 */
+    }
+
+    if(u8Mod == 1)
+    {
+        u8Length += 1;
+    }
+    else if(u8Mod == 2)
+    {
+        u8Length += 4;
+    }
+    return u8Length;
+}
+
+/*
+ * Perform a 32-bit MOV to or from a trapped register without leaving the
+ * handler. Returns FALSE for any other instruction, which is single stepped.
+ */
+static boolean SimRegs_bEmulate(ucontext_t *pxContext, uint32 u32Address, sint32 s32Page)
+{
+    greg_t *pxGregs = pxContext->uc_mcontext.gregs;
+    const uint8 *pu8Code = (const uint8 *)(uintptr_t)pxGregs[REG_RIP];
+    const SimRegs_PageModel *pxModel = &s_axPageModels[s32Page];
+    uint8  u8Rex = 0;
+    uint8  u8Length;
+    uint8  u8Reg;
+    uint32 u32Value;
+
+    if((pu8Code[0] & 0xF0) == 0x40)
+    {
+        u8Rex = pu8Code[0];
+        pu8Code++;
+    }
+    if(u8Rex & 0x8)
+    {
+        return FALSE;                                   /* REX.W: 64-bit access */
+    }
+    u8Reg = (uint8)(((pu8Code[1] >> 3) & 0x7) | ((u8Rex & 0x4) ? 8 : 0));
+
+    switch(pu8Code[0])
+    {
+        case SIM_REGS_OP_LOAD_R32:
+        case SIM_REGS_OP_LOAD_EAX_ABS:
+            if(pxModel->pfRead != NULL)
+            {
+                pxModel->pfRead(u32Address);
+            }
+            u32Value = *SimRegs_pu32Alias(u32Address);
+            if(pxModel->pfReadDone != NULL)
+            {
+                pxModel->pfReadDone(u32Address);
+            }
+            if(pu8Code[0] == SIM_REGS_OP_LOAD_R32)
+            {
+                pxGregs[s_as32GregOf[u8Reg]] = (greg_t)u32Value;      /* Zero extends, as on x86-64 */
+                u8Length = (uint8)(1 + SimRegs_u8ModRmLength(&pu8Code[1]));
+            }
+            else
+            {
+                pxGregs[REG_RAX] = (greg_t)u32Value;
+                u8Length = 1 + 8;
+            }
+            break;
+
+        case SIM_REGS_OP_STORE_R32:
+        case SIM_REGS_OP_STORE_IMM32:
+        case SIM_REGS_OP_STORE_EAX_ABS:
+            if(pu8Code[0] == SIM_REGS_OP_STORE_R32)
+            {
+                u32Value = (uint32)pxGregs[s_as32GregOf[u8Reg]];
+                u8Length = (uint8)(1 + SimRegs_u8ModRmLength(&pu8Code[1]));
+            }
+            else if(pu8Code[0] == SIM_REGS_OP_STORE_IMM32)
+            {
+                if(((pu8Code[1] >> 3) & 0x7) != 0)
+                {
+                    return FALSE;
+                }
+                u8Length = (uint8)(1 + SimRegs_u8ModRmLength(&pu8Code[1]));
+                memcpy(&u32Value, &pu8Code[u8Length], sizeof(u32Value));
+                u8Length += 4;
+            }
+            else
+            {
+                u32Value = (uint32)pxGregs[REG_RAX];
+                u8Length = 1 + 8;
+            }
+            *SimRegs_pu32Alias(u32Address) = u32Value;
+            if(pxModel->pfWrite != NULL)
+            {
+                pxModel->pfWrite(u32Address, u32Value);
+            }
+            break;
+
+        default:
+            return FALSE;
+    }
+
+    pxGregs[REG_RIP] += (greg_t)(u8Length + ((u8Rex != 0) ? 1 : 0));
+    return TRUE;
+}
+
+static void SimRegs_vFatal(int s32Signal)
+{
+    /* Not a register access: let the default action report the crash */
+    signal(s32Signal, SIG_DFL);
+}
+
+static void SimRegs_vFaultHandler(int s32Signal, siginfo_t *pxInfo, void *pvContext)
+{
+    ucontext_t *pxContext = (ucontext_t *)pvContext;
+    uint32 u32Address = (uint32)(uintptr_t)pxInfo->si_addr;
+    sint32 s32Page = SimRegs_s32PageIndex(u32Address);
+    boolean bEmulated;
+
+    if(((uintptr_t)pxInfo->si_addr > 0xFFFFFFFFUL) || (s32Page < 0) || s_bTrapActive)
+    {
+        SimRegs_vFatal(s32Signal);
+        return;
+    }
+
+    SimRegs_vLock();
+    bEmulated = SimRegs_bEmulate(pxContext, u32Address, s32Page);
+    SimRegs_vUnlock();
+    if(bEmulated)
+    {
+        return;
+    }
+
+    s_u32TrapAddress = u32Address;
+    s_bTrapWrite = ((pxContext->uc_mcontext.gregs[REG_ERR] & SIM_REGS_PF_WRITE) != 0) ? TRUE : FALSE;
+    s_bTrapActive = TRUE;
+
+    if((!s_bTrapWrite) && (s_axPageModels[s32Page].pfRead != NULL))
+    {
+        SimRegs_vLock();
+        s_axPageModels[s32Page].pfRead(u32Address);
+        SimRegs_vUnlock();
+    }
+
+    mprotect(SimRegs_pvPage(u32Address), SIM_REGS_PAGE_SIZE, PROT_READ | PROT_WRITE);
+
+    /* Hold off simulated interrupts until the access has completed */
+    s_bInterruptWasMasked = sigismember(&pxContext->uc_sigmask, SIM_REGS_SIG_INTERRUPT) ? TRUE : FALSE;
+    sigaddset(&pxContext->uc_sigmask, SIM_REGS_SIG_INTERRUPT);
+
+    pxContext->uc_mcontext.gregs[REG_EFL] |= SIM_REGS_EFLAGS_TF;
+}
+
+static void SimRegs_vStepHandler(int s32Signal, siginfo_t *pxInfo, void *pvContext)
+{
+    ucontext_t *pxContext = (ucontext_t *)pvContext;
+    sint32 s32Page;
+
+    (void)pxInfo;
+
+    if(!s_bTrapActive)
+    {
+        SimRegs_vFatal(s32Signal);
+        return;
+    }
+
+    pxContext->uc_mcontext.gregs[REG_EFL] &= ~SIM_REGS_EFLAGS_TF;
+    mprotect(SimRegs_pvPage(s_u32TrapAddress), SIM_REGS_PAGE_SIZE, PROT_NONE);
+    s_bTrapActive = FALSE;
+
+    s32Page = SimRegs_s32PageIndex(s_u32TrapAddress);
+    SimRegs_vLock();
+    if(s_bTrapWrite)
+    {
+        if(s_axPageModels[s32Page].pfWrite != NULL)
+        {
+            s_axPageModels[s32Page].pfWrite(s_u32TrapAddress, *SimRegs_pu32Alias(s_u32TrapAddress & ~3UL));
+        }
+    }
+    else if(s_axPageModels[s32Page].pfReadDone != NULL)
+    {
+        s_axPageModels[s32Page].pfReadDone(s_u32TrapAddress);
+    }
+    SimRegs_vUnlock();
+
+    if(!s_bInterruptWasMasked)
+    {
+        sigdelset(&pxContext->uc_sigmask, SIM_REGS_SIG_INTERRUPT);
+    }
+}
+
+static void SimRegs_vMapWindow(int s32Fd, uint32 u32Base, uint32 u32Size, off_t xOffset)
+{
+    void *pvMap = mmap((void *)(uintptr_t)u32Base, u32Size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_FIXED_NOREPLACE, s32Fd, xOffset);
+
+    if(pvMap != (void *)(uintptr_t)u32Base)
+    {
+        fprintf(stderr, "[sim] cannot map the register window at 0x%08lX\n", (unsigned long)u32Base);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimRegs_vInit(void)
+{
+    struct sigaction xAction;
+    size_t xTotal = SIM_REGS_PERIPH_SIZE + SIM_REGS_PPB_SIZE;
+    int s32Fd = memfd_create("tm4c123gh6pm-registers", 0);
+
+    if((s32Fd < 0) || (ftruncate(s32Fd, (off_t)xTotal) != 0))
+    {
+        perror("[sim] register file");
+        exit(EXIT_FAILURE);
+    }
+
+    SimRegs_vMapWindow(s32Fd, SIM_REGS_PERIPH_BASE, SIM_REGS_PERIPH_SIZE, 0);
+    SimRegs_vMapWindow(s32Fd, SIM_REGS_PPB_BASE, SIM_REGS_PPB_SIZE, SIM_REGS_PERIPH_SIZE);
+
+    s_pu8Alias = mmap(NULL, xTotal, PROT_READ | PROT_WRITE, MAP_SHARED, s32Fd, 0);
+    if(s_pu8Alias == MAP_FAILED)
+    {
+        perror("[sim] register alias");
+        exit(EXIT_FAILURE);
+    }
+    close(s32Fd);
+
+    memset(&xAction, 0, sizeof(xAction));
+    xAction.sa_flags = SA_SIGINFO;
+    sigemptyset(&xAction.sa_mask);
+    sigaddset(&xAction.sa_mask, SIM_REGS_SIG_INTERRUPT);
+
+    xAction.sa_sigaction = SimRegs_vFaultHandler;
+    sigaction(SIGSEGV, &xAction, NULL);
+    xAction.sa_sigaction = SimRegs_vStepHandler;
+    sigaction(SIGTRAP, &xAction, NULL);
+}
+
+void SimRegs_vTrapPage(uint32 u32PageAddress, SimRegs_ReadHook pfRead,
+                       SimRegs_ReadDoneHook pfReadDone, SimRegs_WriteHook pfWrite)
+{
+    sint32 s32Page = SimRegs_s32PageIndex(u32PageAddress);
+
+    if(s32Page < 0)
+    {
+        return;
+    }
+
+    s_axPageModels[s32Page].pfRead = pfRead;
+    s_axPageModels[s32Page].pfReadDone = pfReadDone;
+    s_axPageModels[s32Page].pfWrite = pfWrite;
+    mprotect(SimRegs_pvPage(u32PageAddress), SIM_REGS_PAGE_SIZE, PROT_NONE);
+}
+
+volatile uint32 *SimRegs_pu32Alias(uint32 u32Address)
+{
+    sint32 s32Page = SimRegs_s32PageIndex(u32Address);
+    uint32 u32Offset;
+
+    if(s32Page >= (sint32)SIM_REGS_PERIPH_PAGES)
+    {
+        u32Offset = SIM_REGS_PERIPH_SIZE + (u32Address - SIM_REGS_PPB_BASE);
+    }
+    else
+    {
+        u32Offset = u32Address - SIM_REGS_PERIPH_BASE;
+    }
+
+    return (volatile uint32 *)(void *)(s_pu8Alias + u32Offset);
+}
+
+void SimRegs_vLock(void)
+{
+    pthread_mutex_lock(&s_xModelLock);
+}
+
+void SimRegs_vUnlock(void)
+{
+    pthread_mutex_unlock(&s_xModelLock);
+}
+
+void SimRegs_vRaiseInterrupt(uint32 u32IrqNumber)
+{
+    SimNvic_vRaise(u32IrqNumber);
+}
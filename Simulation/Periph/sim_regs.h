@@ -0,0 +1,90 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Virtual Register File
+ *
+ * File Name: sim_regs.h
+ *
+ * Description: Header file for the virtual TM4C123GH6PM register file used by
+ *              the POSIX simulation build. The peripheral address space is
+ *              mapped at its real addresses so tm4c123gh6pm_registers.h and the
+ *              MCAL drivers are used unchanged. Accesses to pages that have a
+ *              peripheral model are trapped and forwarded to that model.
+ *
+ *******************************************************************************/
+
+#ifndef SIM_REGS_H_
+#define SIM_REGS_H_
+
+#include <stdint.h>
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Peripheral (APB/AHB + System Control + uDMA) and Private Peripheral Bus windows */
+#define SIM_REGS_PERIPH_BASE         0x40000000UL
+#define SIM_REGS_PERIPH_SIZE         0x00100000UL
+#define SIM_REGS_PPB_BASE            0xE0000000UL
+#define SIM_REGS_PPB_SIZE            0x00010000UL
+#define SIM_REGS_PAGE_SIZE           0x00001000UL
+
+/*
+ * Model side access to a register, bypassing the access traps.
+ * Takes a register from tm4c123gh6pm_registers.h, e.g. SIM_REG(GPIO_PORTF_RIS_REG) |= (1<<4);
+ */
+#define SIM_REG(REG)                 (*SimRegs_pu32Alias((uint32)(uintptr_t)&(REG)))
+
+/* NVIC interrupt numbers (vector number - 16) of the modelled peripherals */
+#define SIM_IRQ_GPIOA                0
+#define SIM_IRQ_UART0                5
+#define SIM_IRQ_ADC0_SEQ0            14
+#define SIM_IRQ_ADC0_SEQ1            15
+#define SIM_IRQ_ADC0_SEQ2            16
+#define SIM_IRQ_ADC0_SEQ3            17
+#define SIM_IRQ_GPIOF                30
+#define SIM_IRQ_ADC1_SEQ0            48
+#define SIM_IRQ_ADC1_SEQ1            49
+#define SIM_IRQ_ADC1_SEQ2            50
+#define SIM_IRQ_ADC1_SEQ3            51
+#define SIM_IRQ_WTIMER0A             94
+#define SIM_IRQ_WTIMER0B             95
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Called before a trapped register is read, to refresh its value */
+typedef void (*SimRegs_ReadHook)(uint32 u32Address);
+
+/* Called after a trapped register is read, for read side effects (FIFO pops) */
+typedef void (*SimRegs_ReadDoneHook)(uint32 u32Address);
+
+/* Called after a trapped register is written, with the value that was written */
+typedef void (*SimRegs_WriteHook)(uint32 u32Address, uint32 u32Value);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Map the register file and install the access traps. Must run before any register access. */
+void SimRegs_vInit(void);
+
+/* Forward every access to the 4 KB register page at u32PageAddress to a peripheral model */
+void SimRegs_vTrapPage(uint32 u32PageAddress, SimRegs_ReadHook pfRead,
+                       SimRegs_ReadDoneHook pfReadDone, SimRegs_WriteHook pfWrite);
+
+/* Untrapped view of a register, for the peripheral models */
+volatile uint32 *SimRegs_pu32Alias(uint32 u32Address);
+
+/*
+ * Serialise the peripheral models. The trap handlers hold the lock around every
+ * hook; code outside the hooks (the service thread) takes it explicitly.
+ */
+void SimRegs_vLock(void);
+void SimRegs_vUnlock(void);
+
+/* Pend an interrupt on the simulated NVIC, it is taken once enabled in NVIC_ENx */
+void SimRegs_vRaiseInterrupt(uint32 u32IrqNumber);
+
+#endif /* SIM_REGS_H_ */
@@ -0,0 +1,138 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - System Control
+ *
+ * File Name: sim_sysctl.c
+ *
+ * Description: Reset values of the System Control block and the clock tree
+ *              (PIOSC/MOSC, PLL and system divider) of the virtual TM4C123.
+ *
+ *******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <time.h>
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_SYSCTL_PIOSC_HZ          16000000UL
+#define SIM_SYSCTL_LFIOSC_HZ         30000UL
+#define SIM_SYSCTL_PLL_HZ            400000000UL
+
+#define SIM_SYSCTL_RCC_RESET         0x078E3AD1UL
+#define SIM_SYSCTL_RCC2_RESET        0x07C06810UL
+#define SIM_SYSCTL_RIS_PLLLRIS       (1UL << 6)
+
+/* Crystal frequencies selected by RCC.XTAL (0x06 .. 0x15) */
+static const uint32 s_au32XtalHz[] =
+{
+    4000000UL,  4096000UL,  4915200UL,  5000000UL,  5120000UL,  6000000UL,
+    6144000UL,  7372800UL,  8000000UL,  8192000UL,  10000000UL, 12000000UL,
+    12288000UL, 13560000UL, 14318180UL, 16000000UL, 16384000UL, 18000000UL,
+    20000000UL, 24000000UL, 25000000UL
+};
+
+static uint64 s_u64StartNs;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint64 SimSysCtl_u64HostNs(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64)xNow.tv_sec * 1000000000ULL) + (uint64)xNow.tv_nsec;
+}
+
+static uint32 SimSysCtl_u32OscHz(uint32 u32OscSrc, uint32 u32Rcc)
+{
+    uint32 u32Xtal = (u32Rcc >> 6) & 0x1F;
+
+    switch(u32OscSrc)
+    {
+        case 0:  return ((u32Xtal >= 0x06) && (u32Xtal <= 0x1A)) ? s_au32XtalHz[u32Xtal - 0x06] : SIM_SYSCTL_PIOSC_HZ;
+        case 1:  return SIM_SYSCTL_PIOSC_HZ;
+        case 2:  return SIM_SYSCTL_PIOSC_HZ / 4;
+        default: return SIM_SYSCTL_LFIOSC_HZ;
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimSysCtl_vInit(void)
+{
+    s_u64StartNs = SimSysCtl_u64HostNs();
+
+    SIM_REG(SYSCTL_RCC_REG)  = SIM_SYSCTL_RCC_RESET;
+    SIM_REG(SYSCTL_RCC2_REG) = SIM_SYSCTL_RCC2_RESET;
+
+    /* The PLL is always locked and every peripheral is ready right away */
+    SIM_REG(SYSCTL_RIS_REG)      = SIM_SYSCTL_RIS_PLLLRIS;
+    SIM_REG(SYSCTL_PRWD_REG)     = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRTIMER_REG)  = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRGPIO_REG)   = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRDMA_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRHIB_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRUART_REG)   = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRSSI_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRI2C_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRUSB_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRCAN_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRADC_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRACMP_REG)   = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRPWM_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRQEI_REG)    = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PREEPROM_REG) = 0xFFFFFFFFUL;
+    SIM_REG(SYSCTL_PRWTIMER_REG) = 0xFFFFFFFFUL;
+}
+
+uint32 SimSysCtl_u32ClockHz(void)
+{
+    uint32 u32Rcc  = SIM_REG(SYSCTL_RCC_REG);
+    uint32 u32Rcc2 = SIM_REG(SYSCTL_RCC2_REG);
+    uint32 u32Osc;
+    uint32 u32Divisor;
+
+    if(u32Rcc2 & (1UL << 31))           /* USERCC2 */
+    {
+        u32Osc = SimSysCtl_u32OscHz((u32Rcc2 >> 4) & 0x7, u32Rcc);
+        if(u32Rcc2 & (1UL << 30))       /* DIV400: SYSDIV2 and SYSDIV2LSB divide the 400 MHz PLL */
+        {
+            u32Divisor = ((((u32Rcc2 >> 23) & 0x3F) << 1) | ((u32Rcc2 >> 22) & 0x1)) + 1;
+            return (u32Rcc2 & (1UL << 11)) ? (u32Osc / u32Divisor) : (SIM_SYSCTL_PLL_HZ / u32Divisor);
+        }
+        u32Divisor = ((u32Rcc2 >> 23) & 0x3F) + 1;
+        return (u32Rcc2 & (1UL << 11)) ? (u32Osc / u32Divisor) : ((SIM_SYSCTL_PLL_HZ / 2) / u32Divisor);
+    }
+
+    u32Osc = SimSysCtl_u32OscHz((u32Rcc >> 4) & 0x3, u32Rcc);
+    if(u32Rcc & (1UL << 22))            /* USESYSDIV */
+    {
+        u32Divisor = ((u32Rcc >> 23) & 0xF) + 1;
+        return (u32Rcc & (1UL << 11)) ? (u32Osc / u32Divisor) : ((SIM_SYSCTL_PLL_HZ / 2) / u32Divisor);
+    }
+    return (u32Rcc & (1UL << 11)) ? u32Osc : (SIM_SYSCTL_PLL_HZ / 2);
+}
+
+uint64 SimSysCtl_u64NowNs(void)
+{
+    return SimSysCtl_u64HostNs() - s_u64StartNs;
+}
+
+uint64 SimSysCtl_u64Cycles(void)
+{
+    uint64 u64Ns = SimSysCtl_u64NowNs();
+    uint64 u64Hz = SimSysCtl_u32ClockHz();
+
+    return ((u64Ns / 1000000000ULL) * u64Hz) + (((u64Ns % 1000000000ULL) * u64Hz) / 1000000000ULL);
+}
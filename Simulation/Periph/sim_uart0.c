@@ -0,0 +1,417 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - UART0
+ *
+ * File Name: sim_uart0.c
+ *
+ * Description: Virtual UART0 connected to a pseudo terminal. The transmitter
+ *              shifts one frame per bit time derived from IBRD/FBRD, LCRH and
+ *              the system clock, so polling drivers wait on the wire exactly as
+ *              long as they do on the target. The TX interrupt follows the
+ *              IFLS level and, with TXDMAE set, uDMA channel 9 keeps the TX
+ *              FIFO full; its completion is signalled on the UART0 vector.
+ *
+ *              SIM_UART0=stdout     send UART0 output to stdout instead of a pty
+ *              SIM_UART0_LINK=path  create a symlink to the pty slave
+ *              SIM_UART0_INPUT="2000:tune 0,9000:gains"  receive each line,
+ *                                   ended by \r, at the given ms after start;
+ *                                   with the pty as well as with stdout
+ *
+ *******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_UART0_BASE               0x4000C000UL
+#define SIM_UART0_DR                 0x000
+#define SIM_UART0_FR                 0x018
+#define SIM_UART0_CTL                0x030
+#define SIM_UART0_IM                 0x038
+#define SIM_UART0_RIS                0x03C
+#define SIM_UART0_MIS                0x040
+#define SIM_UART0_ICR                0x044
+#define SIM_UART0_DMACTL             0x048
+
+#define SIM_UART0_FIFO_DEPTH         16
+
+#define SIM_UART0_FR_BUSY            (1UL << 3)
+#define SIM_UART0_FR_RXFE            (1UL << 4)
+#define SIM_UART0_FR_TXFF            (1UL << 5)
+#define SIM_UART0_FR_RXFF            (1UL << 6)
+#define SIM_UART0_FR_TXFE            (1UL << 7)
+
+#define SIM_UART0_RIS_RX             (1UL << 4)
+#define SIM_UART0_RIS_TX             (1UL << 5)
+
+#define SIM_UART0_LCRH_FEN           (1UL << 4)
+#define SIM_UART0_CTL_HSE            (1UL << 5)
+#define SIM_UART0_IFLS_TX_MASK       0x7
+#define SIM_UART0_DMACTL_TXDMAE      (1UL << 1)
+
+#define SIM_UART0_TX_UDMA_CHANNEL    9
+
+#define SIM_UART0_INPUT_LINES        16
+#define SIM_UART0_INPUT_LENGTH       32
+
+typedef struct
+{
+    uint8 au8Data[SIM_UART0_FIFO_DEPTH];
+    uint8 u8Head;
+    uint8 u8Count;
+} SimUart0_Fifo;
+
+typedef struct
+{
+    uint64 u64AtNs;
+    char   acLine[SIM_UART0_INPUT_LENGTH + 2];  /* With its \r */
+} SimUart0_Input;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* TX interrupt level in eighths of the FIFO for IFLS TXIFLSEL 0..4 */
+static const uint8 s_au8TxLevelEighths[] = { 1, 2, 4, 6, 7 };
+
+static SimUart0_Fifo s_xTxFifo;
+static SimUart0_Fifo s_xRxFifo;
+static uint64 s_u64LineFreeNs;       /* When the shift register finishes the current frame */
+static int s_s32OutFd = -1;
+static int s_s32InFd = -1;
+
+static SimUart0_Input s_axInput[SIM_UART0_INPUT_LINES];
+static uint8 s_u8InputLines;
+static uint8 s_u8InputLine;         /* Next line to receive */
+static uint8 s_u8InputChar;         /* Next character of it */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static volatile uint32 *SimUart0_pu32Reg(uint32 u32Offset)
+{
+    return SimRegs_pu32Alias(SIM_UART0_BASE + u32Offset);
+}
+
+static uint8 SimUart0_u8Depth(void)
+{
+    return (SIM_REG(UART0_LCRH_REG) & SIM_UART0_LCRH_FEN) ? SIM_UART0_FIFO_DEPTH : 1;
+}
+
+static void SimUart0_vPush(SimUart0_Fifo *pxFifo, uint8 u8Data)
+{
+    pxFifo->au8Data[(pxFifo->u8Head + pxFifo->u8Count) % SIM_UART0_FIFO_DEPTH] = u8Data;
+    pxFifo->u8Count++;
+}
+
+static uint8 SimUart0_u8Pop(SimUart0_Fifo *pxFifo)
+{
+    uint8 u8Data = pxFifo->au8Data[pxFifo->u8Head];
+
+    pxFifo->u8Head = (uint8)((pxFifo->u8Head + 1) % SIM_UART0_FIFO_DEPTH);
+    pxFifo->u8Count--;
+    return u8Data;
+}
+
+/* Duration of one frame on the wire in ns */
+static uint64 SimUart0_u64FrameNs(void)
+{
+    uint32 u32Lcrh = SIM_REG(UART0_LCRH_REG);
+    uint64 u64Divisor64 = ((uint64)SIM_REG(UART0_IBRD_REG) * 64) + (SIM_REG(UART0_FBRD_REG) & 0x3F);
+    uint64 u64ClkDiv = (SIM_REG(UART0_CTL_REG) & SIM_UART0_CTL_HSE) ? 8 : 16;
+    uint64 u64Bits = 1 + (5 + ((u32Lcrh >> 5) & 0x3)) + ((u32Lcrh & 0x2) ? 1 : 0) + ((u32Lcrh & 0x8) ? 2 : 1);
+
+    if(u64Divisor64 == 0)
+    {
+        u64Divisor64 = 64;
+    }
+    /* Bit time = ClkDiv * (IBRD + FBRD/64) / SysClk */
+    return (u64Bits * u64ClkDiv * u64Divisor64 * 1000000000ULL) / ((uint64)SimSysCtl_u32ClockHz() * 64);
+}
+
+static void SimUart0_vUpdateFlags(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+    uint32 u32Fr = 0;
+    uint32 u32Ris = *SimUart0_pu32Reg(SIM_UART0_RIS);
+    uint8  u8Depth = SimUart0_u8Depth();
+    uint32 u32TxLevel = SIM_REG(UART0_IFLS_REG) & SIM_UART0_IFLS_TX_MASK;
+
+    u32Fr |= (s_xTxFifo.u8Count == 0) ? SIM_UART0_FR_TXFE : 0;
+    u32Fr |= (s_xTxFifo.u8Count >= u8Depth) ? SIM_UART0_FR_TXFF : 0;
+    u32Fr |= (s_xRxFifo.u8Count == 0) ? SIM_UART0_FR_RXFE : 0;
+    u32Fr |= (s_xRxFifo.u8Count >= u8Depth) ? SIM_UART0_FR_RXFF : 0;
+    u32Fr |= ((s_xTxFifo.u8Count != 0) || (s_u64LineFreeNs > u64Now)) ? SIM_UART0_FR_BUSY : 0;
+    *SimUart0_pu32Reg(SIM_UART0_FR) = u32Fr;
+
+    /* Interrupt levels: TX at or below the IFLS level, RX at or above half full (IFLS reset value) */
+    if(u32TxLevel > 4)
+    {
+        u32TxLevel = 4;
+    }
+    if(s_xTxFifo.u8Count <= ((u8Depth * s_au8TxLevelEighths[u32TxLevel]) / 8))
+    {
+        u32Ris |= SIM_UART0_RIS_TX;
+    }
+    if(s_xRxFifo.u8Count >= ((u8Depth + 1) / 2))
+    {
+        u32Ris |= SIM_UART0_RIS_RX;
+    }
+    *SimUart0_pu32Reg(SIM_UART0_RIS) = u32Ris;
+    *SimUart0_pu32Reg(SIM_UART0_MIS) = u32Ris & *SimUart0_pu32Reg(SIM_UART0_IM);
+}
+
+static void SimUart0_vRaiseIfPending(uint32 u32MisBefore)
+{
+    uint32 u32Mis = *SimUart0_pu32Reg(SIM_UART0_MIS);
+
+    if(u32Mis & ~u32MisBefore)
+    {
+        SimRegs_vRaiseInterrupt(SIM_IRQ_UART0);
+    }
+}
+
+/* Queue a frame for the transmitter, if it is enabled (UARTEN and TXE) and the FIFO has room */
+static boolean SimUart0_bTransmit(uint8 u8Data)
+{
+    uint64 u64Now;
+
+    if(((SIM_REG(UART0_CTL_REG) & 0x101) != 0x101) || (s_xTxFifo.u8Count >= SimUart0_u8Depth()))
+    {
+        return FALSE;
+    }
+    u64Now = SimSysCtl_u64NowNs();
+    if((s_xTxFifo.u8Count == 0) && (s_u64LineFreeNs < u64Now))
+    {
+        s_u64LineFreeNs = u64Now;   /* Line was idle */
+    }
+    SimUart0_vPush(&s_xTxFifo, u8Data);
+    return TRUE;
+}
+
+/* The TX uDMA request stays active while the FIFO has room */
+static void SimUart0_vDmaFill(void)
+{
+    uint32 u32Data;
+    uint8  u8Result = SIM_UDMA_MOVED;
+
+    while((*SimUart0_pu32Reg(SIM_UART0_DMACTL) & SIM_UART0_DMACTL_TXDMAE) && (u8Result == SIM_UDMA_MOVED) &&
+          ((SIM_REG(UART0_CTL_REG) & 0x101) == 0x101) && (s_xTxFifo.u8Count < SimUart0_u8Depth()))
+    {
+        u8Result = SimUdma_u8PeripheralFetch(SIM_UART0_TX_UDMA_CHANNEL, &u32Data);
+        if(u8Result != SIM_UDMA_IGNORED)
+        {
+            (void)SimUart0_bTransmit((uint8)u32Data);
+        }
+    }
+    if(u8Result == SIM_UDMA_DONE)
+    {
+        SimRegs_vRaiseInterrupt(SIM_IRQ_UART0);
+    }
+}
+
+/* Move frames that finished shifting out of the transmitter */
+static void SimUart0_vDrain(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+    uint64 u64Frame = SimUart0_u64FrameNs();
+    uint8  u8Data;
+
+    while((s_xTxFifo.u8Count != 0) && (s_u64LineFreeNs <= u64Now))
+    {
+        u8Data = SimUart0_u8Pop(&s_xTxFifo);
+        s_u64LineFreeNs += u64Frame;
+        if(s_s32OutFd >= 0)
+        {
+            (void)!write(s_s32OutFd, &u8Data, 1);
+        }
+    }
+    SimUart0_vDmaFill();
+}
+
+static void SimUart0_vRead(uint32 u32Address)
+{
+    uint32 u32Offset = u32Address & 0xFFC;
+
+    SimUart0_vDrain();
+    SimUart0_vUpdateFlags();
+    if((u32Offset == SIM_UART0_DR) && (s_xRxFifo.u8Count != 0))
+    {
+        *SimUart0_pu32Reg(SIM_UART0_DR) = s_xRxFifo.au8Data[s_xRxFifo.u8Head];
+    }
+}
+
+static void SimUart0_vReadDone(uint32 u32Address)
+{
+    uint32 u32MisBefore = *SimUart0_pu32Reg(SIM_UART0_MIS);
+
+    if(((u32Address & 0xFFC) == SIM_UART0_DR) && (s_xRxFifo.u8Count != 0))
+    {
+        (void)SimUart0_u8Pop(&s_xRxFifo);
+        *SimUart0_pu32Reg(SIM_UART0_RIS) &= ~SIM_UART0_RIS_RX;
+        SimUart0_vUpdateFlags();
+        SimUart0_vRaiseIfPending(u32MisBefore);
+    }
+}
+
+static void SimUart0_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    uint32 u32Offset = u32Address & 0xFFC;
+    uint32 u32MisBefore;
+
+    SimUart0_vDrain();
+    u32MisBefore = *SimUart0_pu32Reg(SIM_UART0_MIS);
+
+    if(u32Offset == SIM_UART0_DR)
+    {
+        if(SimUart0_bTransmit((uint8)u32Value))
+        {
+            /* The TX interrupt condition is re-armed by a write that goes above the level */
+            *SimUart0_pu32Reg(SIM_UART0_RIS) &= ~SIM_UART0_RIS_TX;
+            SimUart0_vDrain();
+        }
+    }
+    else if(u32Offset == SIM_UART0_DMACTL)
+    {
+        SimUart0_vDmaFill();
+    }
+    else if(u32Offset == SIM_UART0_ICR)
+    {
+        *SimUart0_pu32Reg(SIM_UART0_RIS) &= ~u32Value;
+        *SimUart0_pu32Reg(SIM_UART0_ICR) = 0;
+        SimUart0_vUpdateFlags();
+        return;
+    }
+
+    SimUart0_vUpdateFlags();
+    SimUart0_vRaiseIfPending(u32MisBefore);
+}
+
+static void SimUart0_vOpenPty(void)
+{
+    struct termios xTio;
+    const char *pcLink = getenv("SIM_UART0_LINK");
+    int s32Master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    int s32Slave;
+
+    if((s32Master < 0) || (grantpt(s32Master) != 0) || (unlockpt(s32Master) != 0))
+    {
+        perror("[sim] UART0 pty");
+        return;
+    }
+
+    /* Keep the slave open so the master never sees a hang up, in raw mode so \r\n passes through */
+    s32Slave = open(ptsname(s32Master), O_RDWR | O_NOCTTY);
+    if((s32Slave >= 0) && (tcgetattr(s32Slave, &xTio) == 0))
+    {
+        cfmakeraw(&xTio);
+        tcsetattr(s32Slave, TCSANOW, &xTio);
+    }
+
+    s_s32OutFd = s32Master;
+    s_s32InFd = s32Master;
+    SimPeriph_vLog("UART0 on %s\n", ptsname(s32Master));
+
+    if(pcLink != NULL)
+    {
+        unlink(pcLink);
+        if(symlink(ptsname(s32Master), pcLink) == 0)
+        {
+            SimPeriph_vLog("UART0 linked at %s\n", pcLink);
+        }
+    }
+}
+
+static void SimUart0_vParseInput(const char *pcScript)
+{
+    unsigned long ulMs;
+    int s32Used;
+
+    while((pcScript != NULL) && (s_u8InputLines < SIM_UART0_INPUT_LINES) &&
+          (sscanf(pcScript, "%lu:%32[^,]%n", &ulMs, s_axInput[s_u8InputLines].acLine, &s32Used) == 2))
+    {
+        s_axInput[s_u8InputLines].u64AtNs = (uint64)ulMs * 1000000ULL;
+        strcat(s_axInput[s_u8InputLines].acLine, "\r");
+        s_u8InputLines++;
+        pcScript = strchr(pcScript + s32Used, ',');
+        pcScript = (pcScript != NULL) ? (pcScript + 1) : NULL;
+    }
+}
+
+/* Scripted lines that are due, in order, as long as the FIFO has room */
+static void SimUart0_vReceiveInput(void)
+{
+    uint64 u64Now = SimSysCtl_u64NowNs();
+    const SimUart0_Input *pxInput;
+
+    while((s_u8InputLine < s_u8InputLines) && (u64Now >= s_axInput[s_u8InputLine].u64AtNs) &&
+          (s_xRxFifo.u8Count < SimUart0_u8Depth()))
+    {
+        pxInput = &s_axInput[s_u8InputLine];
+        SimUart0_vPush(&s_xRxFifo, (uint8)pxInput->acLine[s_u8InputChar++]);
+        if(pxInput->acLine[s_u8InputChar] == '\0')
+        {
+            s_u8InputLine++;
+            s_u8InputChar = 0;
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimUart0_vInit(void)
+{
+    const char *pcMode = getenv("SIM_UART0");
+
+    if((pcMode != NULL) && (strcmp(pcMode, "stdout") == 0))
+    {
+        s_s32OutFd = STDOUT_FILENO;
+    }
+    else
+    {
+        SimUart0_vOpenPty();
+    }
+
+    SimUart0_vParseInput(getenv("SIM_UART0_INPUT"));
+
+    *SimUart0_pu32Reg(SIM_UART0_FR) = SIM_UART0_FR_TXFE | SIM_UART0_FR_RXFE;
+    SimRegs_vTrapPage(SIM_UART0_BASE, SimUart0_vRead, SimUart0_vReadDone, SimUart0_vWrite);
+}
+
+void SimUart0_vService(void)
+{
+    uint32 u32MisBefore = *SimUart0_pu32Reg(SIM_UART0_MIS);
+    uint8  u8Data;
+
+    SimUart0_vDrain();
+
+    /* Receive from the pty, RXE and UARTEN */
+    while((s_s32InFd >= 0) && ((SIM_REG(UART0_CTL_REG) & 0x201) == 0x201) &&
+          (s_xRxFifo.u8Count < SimUart0_u8Depth()) && (read(s_s32InFd, &u8Data, 1) == 1))
+    {
+        SimUart0_vPush(&s_xRxFifo, u8Data);
+    }
+    if((SIM_REG(UART0_CTL_REG) & 0x201) == 0x201)
+    {
+        SimUart0_vReceiveInput();
+    }
+
+    SimUart0_vUpdateFlags();
+    SimUart0_vRaiseIfPending(u32MisBefore);
+}
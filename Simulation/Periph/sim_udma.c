@@ -0,0 +1,235 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - uDMA
+ *
+ * File Name: sim_udma.c
+ *
+ * Description: Virtual micro DMA controller for peripheral transfers. The
+ *              channel control table lives in the firmware's own memory, as on
+ *              the target; a peripheral model hands each item of a receive
+ *              request to SimUdma_u8PeripheralRequest and takes each item of a
+ *              transmit request from SimUdma_u8PeripheralFetch, which go
+ *              through the active control structure of the channel in basic or
+ *              ping-pong mode and report the completion of a structure.
+ *
+ *******************************************************************************/
+
+#include <stdint.h>
+
+#include "sim_periph.h"
+#include "sim_regs.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_UDMA_ALT_OFFSET          0x200
+#define SIM_UDMA_STRUCT_SIZE         16
+
+#define SIM_UDMA_CTL_MODE_MASK       0x7
+#define SIM_UDMA_CTL_XFER_MASK       0x3FF0
+#define SIM_UDMA_CTL_XFER_POS        4
+#define SIM_UDMA_MODE_STOP           0x0
+#define SIM_UDMA_MODE_PINGPONG       0x3
+
+typedef struct
+{
+    uint32 u32SrcEnd;
+    uint32 u32DstEnd;
+    uint32 u32Control;
+    uint32 u32Reserved;
+} SimUdma_Structure;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Control structure in firmware memory; the sim binary keeps its data below 4 GB */
+static SimUdma_Structure *SimUdma_pxStructure(uint8 u8Channel, boolean bAlternate)
+{
+    uint32 u32Address = SIM_REG(UDMA_CTLBASE_REG) + (bAlternate ? SIM_UDMA_ALT_OFFSET : 0) +
+                        ((uint32)u8Channel * SIM_UDMA_STRUCT_SIZE);
+
+    return (SimUdma_Structure *)(uintptr_t)u32Address;
+}
+
+/* SET/CLR register pairs: the state is kept here, a write only carries the bits to change */
+typedef struct
+{
+    volatile uint32 *pu32Set;
+    volatile uint32 *pu32Clear;
+    uint32 u32State;
+} SimUdma_SetClear;
+
+static SimUdma_SetClear s_axSetClear[] =
+{
+    { &UDMA_USEBURSTSET_REG, &UDMA_USEBURSTCLR_R,  0 },
+    { &UDMA_REQMASKSET_REG,  &UDMA_REQMASKCLR_REG, 0 },
+    { &UDMA_ENASET_REG,      &UDMA_ENACLR_REG,     0 },
+    { &UDMA_ALTSET_REG,      &UDMA_ALTCLR_REG,     0 },
+    { &UDMA_PRIOSET_REG,     &UDMA_PRIOCLR_REG,    0 },
+};
+
+#define SIM_UDMA_REQMASK             (&s_axSetClear[1])
+#define SIM_UDMA_ENABLE              (&s_axSetClear[2])
+#define SIM_UDMA_ALT                 (&s_axSetClear[3])
+
+static uint32 s_u32ChannelIs;
+
+static void SimUdma_vSetState(SimUdma_SetClear *pxPair, uint32 u32State)
+{
+    pxPair->u32State = u32State;
+    *SimRegs_pu32Alias((uint32)(uintptr_t)pxPair->pu32Set) = u32State;
+    *SimRegs_pu32Alias((uint32)(uintptr_t)pxPair->pu32Clear) = 0;
+}
+
+static void SimUdma_vWrite(uint32 u32Address, uint32 u32Value)
+{
+    uint8 u8Pair;
+
+    for(u8Pair = 0; u8Pair < (sizeof(s_axSetClear) / sizeof(s_axSetClear[0])); u8Pair++)
+    {
+        SimUdma_SetClear *pxPair = &s_axSetClear[u8Pair];
+
+        if(u32Address == (uint32)(uintptr_t)pxPair->pu32Set)
+        {
+            SimUdma_vSetState(pxPair, pxPair->u32State | u32Value);
+        }
+        else if(u32Address == (uint32)(uintptr_t)pxPair->pu32Clear)
+        {
+            SimUdma_vSetState(pxPair, pxPair->u32State & ~u32Value);
+        }
+    }
+
+    if(u32Address == (uint32)(uintptr_t)&UDMA_CTLBASE_REG)
+    {
+        SIM_REG(UDMA_CTLBASE_REG) = u32Value & ~0x3FFUL;
+        SIM_REG(UDMA_ALTBASE_REG) = SIM_REG(UDMA_CTLBASE_REG) + SIM_UDMA_ALT_OFFSET;
+    }
+    else if(u32Address == (uint32)(uintptr_t)&UDMA_CHIS_REG)
+    {
+        /* Write 1 to clear */
+        s_u32ChannelIs &= ~u32Value;
+        SIM_REG(UDMA_CHIS_REG) = s_u32ChannelIs;
+    }
+}
+
+/* Control structure the channel works on, NULL while it does not take requests */
+static SimUdma_Structure *SimUdma_pxActive(uint8 u8Channel)
+{
+    uint32 u32Bit = 1UL << u8Channel;
+    SimUdma_Structure *pxStructure;
+
+    if(!(SIM_REG(UDMA_CFG_REG) & 0x1) || !(SIM_UDMA_ENABLE->u32State & u32Bit) ||
+       (SIM_UDMA_REQMASK->u32State & u32Bit))
+    {
+        return NULL_PTR;
+    }
+
+    pxStructure = SimUdma_pxStructure(u8Channel, (SIM_UDMA_ALT->u32State & u32Bit) ? TRUE : FALSE);
+    if((pxStructure->u32Control & SIM_UDMA_CTL_MODE_MASK) == SIM_UDMA_MODE_STOP)
+    {
+        SimUdma_vSetState(SIM_UDMA_ENABLE, SIM_UDMA_ENABLE->u32State & ~u32Bit);
+        return NULL_PTR;
+    }
+    return pxStructure;
+}
+
+/* Address of the next item on one side: the end pointer minus the items still to go after it */
+static uint32 SimUdma_u32Item(uint32 u32End, uint32 u32Control, uint32 u32Inc)
+{
+    uint32 u32Remaining = ((u32Control & SIM_UDMA_CTL_XFER_MASK) >> SIM_UDMA_CTL_XFER_POS) + 1;
+
+    u32Inc = (u32Inc == 3) ? 0 : (1UL << u32Inc);
+    return u32End - ((u32Remaining - 1) * u32Inc);
+}
+
+/* Count one item off the structure and handle its completion */
+static uint8 SimUdma_u8Advance(uint8 u8Channel, SimUdma_Structure *pxStructure)
+{
+    uint32 u32Bit = 1UL << u8Channel;
+    uint32 u32Control = pxStructure->u32Control;
+    uint32 u32Mode = u32Control & SIM_UDMA_CTL_MODE_MASK;
+    uint32 u32Remaining = ((u32Control & SIM_UDMA_CTL_XFER_MASK) >> SIM_UDMA_CTL_XFER_POS) + 1;
+    boolean bAlternate = (SIM_UDMA_ALT->u32State & u32Bit) ? TRUE : FALSE;
+
+    if(u32Remaining > 1)
+    {
+        pxStructure->u32Control = (u32Control & ~SIM_UDMA_CTL_XFER_MASK) | ((u32Remaining - 2) << SIM_UDMA_CTL_XFER_POS);
+        return SIM_UDMA_MOVED;
+    }
+
+    /* Structure done: it reads back as stopped, ping-pong switches to the other one */
+    pxStructure->u32Control = u32Control & ~(SIM_UDMA_CTL_XFER_MASK | SIM_UDMA_CTL_MODE_MASK);
+    s_u32ChannelIs |= u32Bit;
+    SIM_REG(UDMA_CHIS_REG) = s_u32ChannelIs;
+    if(u32Mode == SIM_UDMA_MODE_PINGPONG)
+    {
+        SimUdma_vSetState(SIM_UDMA_ALT, SIM_UDMA_ALT->u32State ^ u32Bit);
+        if((SimUdma_pxStructure(u8Channel, !bAlternate)->u32Control & SIM_UDMA_CTL_MODE_MASK) == SIM_UDMA_MODE_STOP)
+        {
+            SimUdma_vSetState(SIM_UDMA_ENABLE, SIM_UDMA_ENABLE->u32State & ~u32Bit);
+        }
+    }
+    else
+    {
+        SimUdma_vSetState(SIM_UDMA_ENABLE, SIM_UDMA_ENABLE->u32State & ~u32Bit);
+    }
+    return SIM_UDMA_DONE;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void SimUdma_vInit(void)
+{
+    SimRegs_vTrapPage((uint32)(uintptr_t)&UDMA_STAT_REG, NULL_PTR, NULL_PTR, SimUdma_vWrite);
+}
+
+uint8 SimUdma_u8PeripheralRequest(uint8 u8Channel, uint32 u32Data)
+{
+    SimUdma_Structure *pxStructure = SimUdma_pxActive(u8Channel);
+    uint32 u32Control;
+    uint32 u32Dst;
+
+    if(pxStructure == NULL_PTR)
+    {
+        return SIM_UDMA_IGNORED;
+    }
+
+    /* Store the item at the position the remaining count points to */
+    u32Control = pxStructure->u32Control;
+    u32Dst = SimUdma_u32Item(pxStructure->u32DstEnd, u32Control, (u32Control >> 30) & 0x3);
+    switch((u32Control >> 28) & 0x3)
+    {
+    case 0:  *(volatile uint8 *)(uintptr_t)u32Dst = (uint8)u32Data;   break;
+    case 1:  *(volatile uint16 *)(uintptr_t)u32Dst = (uint16)u32Data; break;
+    default: *(volatile uint32 *)(uintptr_t)u32Dst = u32Data;         break;
+    }
+    return SimUdma_u8Advance(u8Channel, pxStructure);
+}
+
+uint8 SimUdma_u8PeripheralFetch(uint8 u8Channel, uint32 *pu32Data)
+{
+    SimUdma_Structure *pxStructure = SimUdma_pxActive(u8Channel);
+    uint32 u32Control;
+    uint32 u32Src;
+
+    if(pxStructure == NULL_PTR)
+    {
+        return SIM_UDMA_IGNORED;
+    }
+
+    /* Load the item at the position the remaining count points to */
+    u32Control = pxStructure->u32Control;
+    u32Src = SimUdma_u32Item(pxStructure->u32SrcEnd, u32Control, (u32Control >> 26) & 0x3);
+    switch((u32Control >> 24) & 0x3)
+    {
+    case 0:  *pu32Data = *(volatile uint8 *)(uintptr_t)u32Src;  break;
+    case 1:  *pu32Data = *(volatile uint16 *)(uintptr_t)u32Src; break;
+    default: *pu32Data = *(volatile uint32 *)(uintptr_t)u32Src; break;
+    }
+    return SimUdma_u8Advance(u8Channel, pxStructure);
+}
@@ -0,0 +1,219 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Tools
+ *
+ * File Name: insn_count.c
+ *
+ * Description: Instruction counter of a target build. Reads the disassembly
+ *              of an ELF file of the Cortex-M4F build (objdump -d
+ *              --no-show-raw-insn) and prints, for each function named, its
+ *              instructions and those of every function it calls or jumps
+ *              to, down to the leaves. The literal pool words are not
+ *              counted.
+ *
+ *              insn_count function... < disassembly
+ *
+ *              The counts are of the code, not of a run: a branch skips part
+ *              of it, and a routine with special cases (the software double
+ *              routines handle the zeros, the infinities and the NaNs) runs
+ *              far fewer instructions than it holds. They compare how much
+ *              code each path takes in; make -C Simulation m4count prints
+ *              them for the conversions of bench_temperature.
+ *
+ *              Exits with 1 when a function named is not in the disassembly.
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define COUNT_LINE_MAX          512
+#define COUNT_NAME_MAX          64
+#define COUNT_FUNCTIONS_MAX     4096
+#define COUNT_CALLEES_MAX       16
+
+typedef struct
+{
+    char   acName[COUNT_NAME_MAX];
+    uint32 u32Instructions;
+    uint8  u8Callees;
+    char   aacCallees[COUNT_CALLEES_MAX][COUNT_NAME_MAX];  /* Found once the whole disassembly is read */
+} Count_Function;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Count_Function s_axFunctions[COUNT_FUNCTIONS_MAX];
+static uint16 s_u16Functions;
+static boolean s_abCounted[COUNT_FUNCTIONS_MAX];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static sint32 Count_s32Find(const char *pcName)
+{
+    uint16 u16Index;
+
+    for(u16Index = 0; u16Index < s_u16Functions; u16Index++)
+    {
+        if(strcmp(s_axFunctions[u16Index].acName, pcName) == 0)
+        {
+            return u16Index;
+        }
+    }
+    return -1;
+}
+
+/* Target of a branch, "<name>" without an offset, or an empty string */
+static void Count_vTarget(const char *pcOperands, char *pcName)
+{
+    const char *pcStart = strchr(pcOperands, '<');
+    size_t xLength;
+
+    pcName[0] = '\0';
+    if(pcStart == NULL)
+    {
+        return;
+    }
+    pcStart++;
+    xLength = strcspn(pcStart, ">");
+    if((pcStart[xLength] != '>') || (memchr(pcStart, '+', xLength) != NULL) || (xLength >= COUNT_NAME_MAX))
+    {
+        return;
+    }
+    memcpy(pcName, pcStart, xLength);
+    pcName[xLength] = '\0';
+}
+
+static boolean Count_bIsBranch(const char *pcMnemonic)
+{
+    static const char *const apcBranches[] = { "bl", "b", "b.w", "b.n", "blx" };
+    size_t xIndex;
+
+    for(xIndex = 0; xIndex < sizeof(apcBranches) / sizeof(apcBranches[0]); xIndex++)
+    {
+        if(strcmp(pcMnemonic, apcBranches[xIndex]) == 0)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void Count_vLine(char *pcLine)
+{
+    Count_Function *pxFunction;
+    char acMnemonic[16];
+    char acName[COUNT_NAME_MAX];
+    unsigned long ulAddress;
+    int s32Used = 0;
+    uint8 u8Callee;
+
+    /* "00001234 <name>:" starts a function */
+    if((sscanf(pcLine, "%lx <%63[^>]>:", &ulAddress, acName) == 2) && (pcLine[0] != ' '))
+    {
+        if(s_u16Functions < COUNT_FUNCTIONS_MAX)
+        {
+            pxFunction = &s_axFunctions[s_u16Functions++];
+            memset(pxFunction, 0, sizeof(*pxFunction));
+            strcpy(pxFunction->acName, acName);
+        }
+        return;
+    }
+
+    /* "    1234:\tmnemonic\toperands", data as ".word" */
+    if((s_u16Functions == 0) || (sscanf(pcLine, " %lx: %15s %n", &ulAddress, acMnemonic, &s32Used) != 2) ||
+       (acMnemonic[0] == '.') || (strcmp(acMnemonic, "<unknown>") == 0))
+    {
+        return;
+    }
+    pxFunction = &s_axFunctions[s_u16Functions - 1];
+    pxFunction->u32Instructions++;
+    if(!Count_bIsBranch(acMnemonic))
+    {
+        return;
+    }
+    Count_vTarget(pcLine + s32Used, acName);
+    if((acName[0] == '\0') || (strcmp(acName, pxFunction->acName) == 0))
+    {
+        return;
+    }
+    for(u8Callee = 0; u8Callee < pxFunction->u8Callees; u8Callee++)
+    {
+        if(strcmp(pxFunction->aacCallees[u8Callee], acName) == 0)
+        {
+            return;
+        }
+    }
+    if(pxFunction->u8Callees < COUNT_CALLEES_MAX)
+    {
+        strcpy(pxFunction->aacCallees[pxFunction->u8Callees++], acName);
+    }
+}
+
+/* Instructions of a function and of the ones it calls not counted yet, each printed once */
+static uint32 Count_u32Tree(uint16 u16Index, uint8 u8Depth)
+{
+    const Count_Function *pxFunction = &s_axFunctions[u16Index];
+    uint32 u32Total = pxFunction->u32Instructions;
+    sint32 s32Callee;
+    uint8 u8Callee;
+
+    s_abCounted[u16Index] = TRUE;
+    printf("  %*s%-*s %6u\n", u8Depth * 2, "", 32 - (u8Depth * 2), pxFunction->acName, pxFunction->u32Instructions);
+    for(u8Callee = 0; u8Callee < pxFunction->u8Callees; u8Callee++)
+    {
+        s32Callee = Count_s32Find(pxFunction->aacCallees[u8Callee]);
+        if((s32Callee >= 0) && !s_abCounted[s32Callee])
+        {
+            u32Total += Count_u32Tree((uint16)s32Callee, (uint8)(u8Depth + 1));
+        }
+    }
+    return u32Total;
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    char acLine[COUNT_LINE_MAX];
+    sint32 s32Index;
+    int s32Arg;
+    int s32Result = EXIT_SUCCESS;
+
+    if(argc < 2)
+    {
+        fprintf(stderr, "usage: insn_count function... < disassembly\n");
+        return EXIT_FAILURE;
+    }
+    while(fgets(acLine, sizeof(acLine), stdin) != NULL)
+    {
+        Count_vLine(acLine);
+    }
+
+    for(s32Arg = 1; s32Arg < argc; s32Arg++)
+    {
+        s32Index = Count_s32Find(argv[s32Arg]);
+        if(s32Index < 0)
+        {
+            fprintf(stderr, "[count] %s not found\n", argv[s32Arg]);
+            s32Result = EXIT_FAILURE;
+            continue;
+        }
+        memset(s_abCounted, 0, sizeof(s_abCounted));
+        printf("%s\n", argv[s32Arg]);
+        printf("  %-32s %6u instructions\n", "with the functions called", Count_u32Tree((uint16)s32Index, 0));
+    }
+    return s32Result;
+}
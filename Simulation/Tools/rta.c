@@ -0,0 +1,736 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Tools
+ *
+ * File Name: rta.c
+ *
+ * Description: Offline schedulability analyzer of the task set. Reads the
+ *              task set description (taskset.txt): the tasks of main() with
+ *              their priority, period or minimum inter-arrival time, deadline
+ *              and worst case execution time, the interrupts with theirs, and
+ *              the longest sections that run with the scheduler suspended or
+ *              the interrupts masked. It then prints:
+ *                - the utilisation of the tasks and interrupts against the
+ *                  Liu & Layland bound, a sufficient test only
+ *                - the tasks whose priority does not follow their deadline
+ *                  (rate monotonic when the deadline is the period)
+ *                - the worst case response time of every task, from the
+ *                  fixed priority response time analysis:
+ *                      R = C + B + sum(ceil(R / Tj) * Cj)
+ *                  over the interrupts and the other tasks of the same or a
+ *                  higher priority (the kernel time slices equal priorities),
+ *                  B being the longest section of a lower priority task
+ *
+ *              rta [-m capture] [taskset]
+ *                -m      take the execution times measured in the kernel
+ *                        trace dumps of a UART0 capture of the target (see
+ *                        trace.h) where they are longer than the estimates
+ *
+ *              A job of a task is measured from its switch in to the switch
+ *              to a task that is not of a higher priority, without the time
+ *              of the handlers it was interrupted by; an interrupt from the
+ *              entry to the exit of its handler. The kernel names are cut
+ *              to configMAX_TASK_NAME_LEN, so a measurement goes to every
+ *              task whose name starts with the kernel one.
+ *
+ *              Exits with 1 when a task misses its deadline.
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest run of bytes between two delimiters that is kept, text included */
+#define RTA_CHUNK_MAX           1024
+#define RTA_LINE_MAX            256
+
+#define RTA_NAME_MAX            40
+#define RTA_TASKS_MAX           32
+#define RTA_ISRS_MAX            16
+#define RTA_LOCKS_MAX           16
+
+/* Kernel task numbers and interrupt numbers of the trace records */
+#define RTA_KERNEL_TASKS_MAX    256
+#define RTA_IRQS_MAX            256
+#define RTA_IRQ_NONE            (-1)
+
+#define RTA_US_PER_MS           1000UL
+
+typedef struct
+{
+    char   acName[RTA_NAME_MAX];
+    uint32 u32Priority;
+    uint32 u32Period;           /* usec */
+    uint32 u32Deadline;         /* usec */
+    uint32 u32Wcet;             /* usec, from the task set */
+    uint32 u32Measured;         /* usec, from the capture, 0 if none */
+} Rta_Task;
+
+typedef struct
+{
+    char   acName[RTA_NAME_MAX];
+    sint32 s32Irq;              /* RTA_IRQ_NONE if not traced */
+    uint32 u32Period;
+    uint32 u32Wcet;
+    uint32 u32Measured;
+} Rta_Isr;
+
+typedef struct
+{
+    char   acName[RTA_NAME_MAX];
+    uint32 u32Priority;         /* Of the task running the section */
+    uint32 u32Duration;
+} Rta_Lock;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Rta_Task s_axTasks[RTA_TASKS_MAX];
+static Rta_Isr  s_axIsrs[RTA_ISRS_MAX];
+static Rta_Lock s_axLocks[RTA_LOCKS_MAX];
+static size_t   s_xTasks;
+static size_t   s_xIsrs;
+static size_t   s_xLocks;
+static uint32   s_u32Switch;    /* usec per job */
+
+/* Capture: names and measurements by kernel task number, trace decoding state */
+static char    s_aacKernelNames[RTA_KERNEL_TASKS_MAX][RTA_NAME_MAX];
+static uint64  s_au64JobMax[RTA_KERNEL_TASKS_MAX];      /* cycles */
+static uint64  s_au64IrqMax[RTA_IRQS_MAX];              /* cycles */
+static uint64  s_au64JobRun[RTA_KERNEL_TASKS_MAX];      /* cycles of the job in progress */
+static boolean s_abJobOpen[RTA_KERNEL_TASKS_MAX];
+static uint64  s_u64Cycles;
+static uint32  s_u32LastTime;
+static boolean s_bInDump;
+static uint16  s_u16NextFrame;
+static boolean s_bRunning;
+static uint8   s_u8Running;
+static uint64  s_u64RunStart;
+static uint64  s_u64IsrCycles;          /* Handler time within the current run */
+static uint64  s_au64IrqStart[RTA_IRQS_MAX];
+static uint8   s_u8IrqDepth;
+static uint64  s_u64NestStart;          /* Entry of the outermost handler */
+static unsigned long s_ulDumps;
+static unsigned long s_ulJobs;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Task set line "keyword fields... name", the name may contain spaces */
+static boolean Rta_bParseLine(char *pcLine, unsigned uLine)
+{
+    char   acKeyword[16];
+    char   acDeadline[16];
+    char   acIrq[16];
+    unsigned uA;
+    unsigned uB;
+    unsigned uC;
+    int    s32Used = 0;
+    char  *pcEnd;
+
+    pcLine[strcspn(pcLine, "#\r\n")] = '\0';
+    if(sscanf(pcLine, "%15s", acKeyword) != 1)
+    {
+        return TRUE;
+    }
+    if(strcmp(acKeyword, "switch") == 0)
+    {
+        return sscanf(pcLine, "%*s %u", &s_u32Switch) == 1;
+    }
+    if(strcmp(acKeyword, "isr") == 0)
+    {
+        Rta_Isr *pxIsr = &s_axIsrs[s_xIsrs];
+
+        if((s_xIsrs == RTA_ISRS_MAX) ||
+           (sscanf(pcLine, "%*s %u %u %15s %n", &uA, &uB, acIrq, &s32Used) != 3) || (s32Used == 0))
+        {
+            return FALSE;
+        }
+        pxIsr->u32Period = uA * RTA_US_PER_MS;
+        pxIsr->u32Wcet = uB;
+        pxIsr->s32Irq = (strcmp(acIrq, "-") == 0) ? RTA_IRQ_NONE : (sint32)strtol(acIrq, &pcEnd, 10);
+        snprintf(pxIsr->acName, RTA_NAME_MAX, "%s", pcLine + s32Used);
+        s_xIsrs++;
+        return (pxIsr->u32Period != 0) && (pxIsr->s32Irq < RTA_IRQS_MAX);
+    }
+    if(strcmp(acKeyword, "task") == 0)
+    {
+        Rta_Task *pxTask = &s_axTasks[s_xTasks];
+
+        if((s_xTasks == RTA_TASKS_MAX) ||
+           (sscanf(pcLine, "%*s %u %u %15s %u %n", &uA, &uB, acDeadline, &uC, &s32Used) != 4) || (s32Used == 0))
+        {
+            return FALSE;
+        }
+        pxTask->u32Priority = uA;
+        pxTask->u32Period = uB * RTA_US_PER_MS;
+        pxTask->u32Deadline = (strcmp(acDeadline, "-") == 0) ? pxTask->u32Period :
+                              (uint32)strtoul(acDeadline, &pcEnd, 10) * RTA_US_PER_MS;
+        pxTask->u32Wcet = uC;
+        snprintf(pxTask->acName, RTA_NAME_MAX, "%s", pcLine + s32Used);
+        s_xTasks++;
+        return (pxTask->u32Period != 0) && (pxTask->u32Deadline != 0);
+    }
+    if(strcmp(acKeyword, "lock") == 0)
+    {
+        Rta_Lock *pxLock = &s_axLocks[s_xLocks];
+
+        if((s_xLocks == RTA_LOCKS_MAX) ||
+           (sscanf(pcLine, "%*s %u %u %n", &uA, &uB, &s32Used) != 2) || (s32Used == 0))
+        {
+            return FALSE;
+        }
+        pxLock->u32Priority = uA;
+        pxLock->u32Duration = uB;
+        snprintf(pxLock->acName, RTA_NAME_MAX, "%s", pcLine + s32Used);
+        s_xLocks++;
+        return TRUE;
+    }
+    fprintf(stderr, "[rta] line %u: unknown keyword %s\n", uLine, acKeyword);
+    return FALSE;
+}
+
+static boolean Rta_bReadTaskSet(FILE *pxInput)
+{
+    char acLine[RTA_LINE_MAX];
+    unsigned uLine = 0;
+
+    while(fgets(acLine, sizeof(acLine), pxInput) != NULL)
+    {
+        uLine++;
+        if(!Rta_bParseLine(acLine, uLine))
+        {
+            fprintf(stderr, "[rta] line %u: bad entry\n", uLine);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* Priority of a kernel task, from the first task set entry its name starts; 0 if none (idle) */
+static uint32 Rta_u32KernelPriority(uint8 u8Task)
+{
+    size_t xLength = strlen(s_aacKernelNames[u8Task]);
+    size_t xTask;
+
+    for(xTask = 0; (xLength != 0) && (xTask < s_xTasks); xTask++)
+    {
+        if(strncmp(s_axTasks[xTask].acName, s_aacKernelNames[u8Task], xLength) == 0)
+        {
+            return s_axTasks[xTask].u32Priority;
+        }
+    }
+    return 0;
+}
+
+static void Rta_vEndJob(uint8 u8Task)
+{
+    if(s_abJobOpen[u8Task] && (s_au64JobRun[u8Task] > s_au64JobMax[u8Task]))
+    {
+        s_au64JobMax[u8Task] = s_au64JobRun[u8Task];
+    }
+    s_ulJobs += s_abJobOpen[u8Task] ? 1 : 0;
+    s_abJobOpen[u8Task] = FALSE;
+    s_au64JobRun[u8Task] = 0;
+}
+
+/* The running task is switched out for u8Next */
+static void Rta_vSwitch(uint8 u8Next)
+{
+    if(s_bRunning && (s_u8Running != u8Next))
+    {
+        s_au64JobRun[s_u8Running] += (s_u64Cycles - s_u64RunStart) - s_u64IsrCycles;
+        /* Only a higher priority task preempts the job, otherwise it has blocked */
+        if(Rta_u32KernelPriority(u8Next) <= Rta_u32KernelPriority(s_u8Running))
+        {
+            Rta_vEndJob(s_u8Running);
+        }
+    }
+    if(!s_bRunning || (s_u8Running != u8Next))
+    {
+        s_u64RunStart = s_u64Cycles;
+        s_u64IsrCycles = 0;
+        s_abJobOpen[u8Next] = TRUE;
+    }
+    s_bRunning = TRUE;
+    s_u8Running = u8Next;
+}
+
+/* Start of a dump: the jobs cut by the previous one are not measured */
+static void Rta_vStartDump(void)
+{
+    memset(s_abJobOpen, 0, sizeof(s_abJobOpen));
+    memset(s_au64JobRun, 0, sizeof(s_au64JobRun));
+    s_bRunning = FALSE;
+    s_u8IrqDepth = 0;
+    s_bInDump = TRUE;
+    s_ulDumps++;
+}
+
+static void Rta_vRecord(const uint8 *pu8Record, boolean bFirst)
+{
+    uint32 u32Time = Telemetry_u32Get32(pu8Record);
+    uint8  u8Event = pu8Record[4];
+    uint8  u8Task = pu8Record[5];
+    uint8  u8Irq = pu8Record[7];
+
+    if(bFirst)
+    {
+        s_u64Cycles = u32Time;
+    }
+    else
+    {
+        s_u64Cycles += (uint32)(u32Time - s_u32LastTime);
+    }
+    s_u32LastTime = u32Time;
+
+    switch(u8Event)
+    {
+    case TRACE_EVENT_SWITCH_IN:
+        Rta_vSwitch(u8Task);
+        break;
+    case TRACE_EVENT_ISR_ENTER:
+        s_au64IrqStart[u8Irq] = s_u64Cycles;
+        if(s_u8IrqDepth++ == 0)
+        {
+            s_u64NestStart = s_u64Cycles;
+        }
+        break;
+    case TRACE_EVENT_ISR_EXIT:
+        if(s_u8IrqDepth == 0)
+        {
+            break;      /* Entered before the oldest record */
+        }
+        if((s_u64Cycles - s_au64IrqStart[u8Irq]) > s_au64IrqMax[u8Irq])
+        {
+            s_au64IrqMax[u8Irq] = s_u64Cycles - s_au64IrqStart[u8Irq];
+        }
+        if(--s_u8IrqDepth == 0)
+        {
+            s_u64IsrCycles += s_u64Cycles - s_u64NestStart;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void Rta_vTraceFrame(const uint8 *pu8Payload, uint16 u16Length)
+{
+    uint16 u16Frame = Telemetry_u16Get16(&pu8Payload[1]);
+    uint16 u16Offset;
+
+    if((u16Length < TELEMETRY_TRACE_HEADER_LENGTH) ||
+       (((u16Length - TELEMETRY_TRACE_HEADER_LENGTH) % TELEMETRY_TRACE_RECORD_LENGTH) != 0))
+    {
+        return;
+    }
+    if(u16Frame == 0)
+    {
+        Rta_vStartDump();
+    }
+    else if(!s_bInDump || (u16Frame != s_u16NextFrame))
+    {
+        /* A lost frame breaks the jobs, wait for the next dump */
+        s_bInDump = FALSE;
+        return;
+    }
+    s_u16NextFrame = (uint16)(u16Frame + 1);
+
+    for(u16Offset = TELEMETRY_TRACE_HEADER_LENGTH; u16Offset < u16Length; u16Offset += TELEMETRY_TRACE_RECORD_LENGTH)
+    {
+        Rta_vRecord(&pu8Payload[u16Offset], (u16Frame == 0) && (u16Offset == TELEMETRY_TRACE_HEADER_LENGTH));
+    }
+}
+
+static void Rta_vNoteNames(const uint8 *pu8Chunk, uint16 u16Length)
+{
+    char acLine[RTA_CHUNK_MAX + 1];
+    char acName[RTA_NAME_MAX];
+    char *pcLine;
+    unsigned uNumber;
+
+    memcpy(acLine, pu8Chunk, u16Length);
+    acLine[u16Length] = '\0';
+    for(pcLine = strtok(acLine, "\r\n"); pcLine != NULL; pcLine = strtok(NULL, "\r\n"))
+    {
+        if((sscanf(pcLine, "Task %u: %39[^\r\n]", &uNumber, acName) == 2) && (uNumber < RTA_KERNEL_TASKS_MAX))
+        {
+            strcpy(s_aacKernelNames[uNumber], acName);
+        }
+    }
+}
+
+/* One run of bytes between two delimiters: the text on the names pass, the trace frames on the other */
+static void Rta_vChunk(const uint8 *pu8Chunk, uint16 u16Length, boolean bNames)
+{
+    uint8  au8Payload[RTA_CHUNK_MAX];
+    uint16 u16Payload;
+
+    if(u16Length == 0)
+    {
+        return;
+    }
+    u16Payload = Telemetry_u16DecodeFrame(pu8Chunk, u16Length, au8Payload);
+    if(u16Payload == 0)
+    {
+        if(bNames)
+        {
+            Rta_vNoteNames(pu8Chunk, u16Length);
+        }
+    }
+    else if(!bNames && (au8Payload[0] == TELEMETRY_FRAME_TRACE))
+    {
+        Rta_vTraceFrame(au8Payload, u16Payload);
+    }
+}
+
+static uint32 Rta_u32CyclesToUs(uint64 u64Cycles)
+{
+    return (uint32)((u64Cycles + CLOCK_CYCLES_PER_US - 1) / CLOCK_CYCLES_PER_US);
+}
+
+/*
+ * Read the capture, then hand the measurements to the task set. The task
+ * names are only posted once, so the whole capture is read before the jobs
+ * are measured: the dumps are decoded in a second pass.
+ */
+static boolean Rta_bReadCapture(const char *pcPath)
+{
+    static uint8 au8Chunk[RTA_CHUNK_MAX];
+    FILE  *pxInput;
+    uint16 u16Length;
+    size_t xKernel;
+    size_t xEntry;
+    uint32 u32Measured;
+    int    s32Byte;
+    int    s32Pass;
+
+    if((pxInput = fopen(pcPath, "rb")) == NULL)
+    {
+        perror(pcPath);
+        return FALSE;
+    }
+    for(s32Pass = 0; s32Pass < 2; s32Pass++)
+    {
+        rewind(pxInput);
+        u16Length = 0;
+        while((s32Byte = fgetc(pxInput)) != EOF)
+        {
+            if(s32Byte == 0)
+            {
+                Rta_vChunk(au8Chunk, u16Length, (s32Pass == 0));
+                u16Length = 0;
+            }
+            else if(u16Length < RTA_CHUNK_MAX)
+            {
+                au8Chunk[u16Length++] = (uint8)s32Byte;
+            }
+        }
+        Rta_vChunk(au8Chunk, u16Length, (s32Pass == 0));
+    }
+    fclose(pxInput);
+    if(s_ulDumps == 0)
+    {
+        fprintf(stderr, "[rta] no trace dump in %s\n", pcPath);
+        return FALSE;
+    }
+
+    for(xKernel = 0; xKernel < RTA_KERNEL_TASKS_MAX; xKernel++)
+    {
+        size_t xLength = strlen(s_aacKernelNames[xKernel]);
+
+        u32Measured = Rta_u32CyclesToUs(s_au64JobMax[xKernel]);
+        for(xEntry = 0; (xLength != 0) && (xEntry < s_xTasks); xEntry++)
+        {
+            if((strncmp(s_axTasks[xEntry].acName, s_aacKernelNames[xKernel], xLength) == 0) &&
+               (u32Measured > s_axTasks[xEntry].u32Measured))
+            {
+                s_axTasks[xEntry].u32Measured = u32Measured;
+            }
+        }
+    }
+    for(xEntry = 0; xEntry < s_xIsrs; xEntry++)
+    {
+        if(s_axIsrs[xEntry].s32Irq != RTA_IRQ_NONE)
+        {
+            s_axIsrs[xEntry].u32Measured = Rta_u32CyclesToUs(s_au64IrqMax[s_axIsrs[xEntry].s32Irq]);
+        }
+    }
+    printf("Capture %s: %lu trace dumps, %lu jobs measured\n\n", pcPath, s_ulDumps, s_ulJobs);
+    return TRUE;
+}
+
+/* Execution time used by the analysis: the longer of the estimate and the measurement, with the switches */
+static uint32 Rta_u32TaskCost(const Rta_Task *pxTask)
+{
+    return ((pxTask->u32Measured > pxTask->u32Wcet) ? pxTask->u32Measured : pxTask->u32Wcet) + s_u32Switch;
+}
+
+static uint32 Rta_u32IsrCost(const Rta_Isr *pxIsr)
+{
+    return ((pxIsr->u32Measured > pxIsr->u32Wcet) ? pxIsr->u32Measured : pxIsr->u32Wcet) + s_u32Switch;
+}
+
+/* Longest section of a lower priority task */
+static uint32 Rta_u32Blocking(const Rta_Task *pxTask, const char **ppcLock)
+{
+    uint32 u32Blocking = 0;
+    size_t xLock;
+
+    *ppcLock = "";
+    for(xLock = 0; xLock < s_xLocks; xLock++)
+    {
+        if((s_axLocks[xLock].u32Priority < pxTask->u32Priority) && (s_axLocks[xLock].u32Duration > u32Blocking))
+        {
+            u32Blocking = s_axLocks[xLock].u32Duration;
+            *ppcLock = s_axLocks[xLock].acName;
+        }
+    }
+    return u32Blocking;
+}
+
+static uint32 Rta_u32Ceil(uint32 u32Time, uint32 u32Period)
+{
+    return (u32Time + u32Period - 1) / u32Period;
+}
+
+/* Worst case response time, stops above the deadline so a diverging set ends */
+static uint32 Rta_u32Response(size_t xTask, uint32 u32Blocking)
+{
+    const Rta_Task *pxTask = &s_axTasks[xTask];
+    uint32 u32Response = 0;
+    uint32 u32Next = Rta_u32TaskCost(pxTask) + u32Blocking;
+    size_t xOther;
+
+    while((u32Next != u32Response) && (u32Next <= pxTask->u32Deadline))
+    {
+        u32Response = u32Next;
+        u32Next = Rta_u32TaskCost(pxTask) + u32Blocking;
+        for(xOther = 0; xOther < s_xIsrs; xOther++)
+        {
+            u32Next += Rta_u32Ceil(u32Response, s_axIsrs[xOther].u32Period) * Rta_u32IsrCost(&s_axIsrs[xOther]);
+        }
+        for(xOther = 0; xOther < s_xTasks; xOther++)
+        {
+            if((xOther != xTask) && (s_axTasks[xOther].u32Priority >= pxTask->u32Priority))
+            {
+                u32Next += Rta_u32Ceil(u32Response, s_axTasks[xOther].u32Period) * Rta_u32TaskCost(&s_axTasks[xOther]);
+            }
+        }
+    }
+    return u32Next;
+}
+
+/* n (2^(1/n) - 1), the root by Newton's method to keep the tools off libm */
+static double Rta_dLiuLaylandBound(size_t xCount)
+{
+    double dRoot = 1.5;
+    double dPower;
+    size_t xIteration;
+    size_t xFactor;
+
+    for(xIteration = 0; xIteration < 64; xIteration++)
+    {
+        dPower = 1.0;
+        for(xFactor = 1; xFactor < xCount; xFactor++)
+        {
+            dPower *= dRoot;
+        }
+        dRoot -= ((dPower * dRoot) - 2.0) / ((double)xCount * dPower);
+    }
+    return (double)xCount * (dRoot - 1.0);
+}
+
+static void Rta_vUtilisation(void)
+{
+    double dUtilisation = 0.0;
+    double dBound = Rta_dLiuLaylandBound(s_xTasks + s_xIsrs);
+    size_t xEntry;
+
+    for(xEntry = 0; xEntry < s_xIsrs; xEntry++)
+    {
+        dUtilisation += (double)Rta_u32IsrCost(&s_axIsrs[xEntry]) / s_axIsrs[xEntry].u32Period;
+    }
+    printf("Interrupts: %5.2f %% of the CPU\n", 100.0 * dUtilisation);
+    for(xEntry = 0; xEntry < s_xTasks; xEntry++)
+    {
+        dUtilisation += (double)Rta_u32TaskCost(&s_axTasks[xEntry]) / s_axTasks[xEntry].u32Period;
+    }
+    printf("Utilisation: %5.2f %%, Liu & Layland bound for %lu tasks and interrupts %5.2f %%: %s\n",
+           100.0 * dUtilisation, (unsigned long)(s_xTasks + s_xIsrs), 100.0 * dBound,
+           (dUtilisation <= dBound) ? "schedulable" : "not proven, see the response times");
+}
+
+/* Tasks below another one with a longer deadline, named with the highest of those */
+static void Rta_vPriorityOrder(void)
+{
+    const Rta_Task *pxAbove;
+    size_t xTask;
+    size_t xOther;
+
+    for(xTask = 0; xTask < s_xTasks; xTask++)
+    {
+        pxAbove = NULL;
+        for(xOther = 0; xOther < s_xTasks; xOther++)
+        {
+            if((s_axTasks[xOther].u32Deadline > s_axTasks[xTask].u32Deadline) &&
+               (s_axTasks[xOther].u32Priority > s_axTasks[xTask].u32Priority) &&
+               ((pxAbove == NULL) || (s_axTasks[xOther].u32Priority > pxAbove->u32Priority)))
+            {
+                pxAbove = &s_axTasks[xOther];
+            }
+        }
+        if(pxAbove != NULL)
+        {
+            printf("Not deadline monotonic: %s (priority %u, deadline %lu ms) is below %s (priority %u, deadline %lu ms)\n",
+                   s_axTasks[xTask].acName, s_axTasks[xTask].u32Priority,
+                   (unsigned long)(s_axTasks[xTask].u32Deadline / RTA_US_PER_MS),
+                   pxAbove->acName, pxAbove->u32Priority, (unsigned long)(pxAbove->u32Deadline / RTA_US_PER_MS));
+        }
+    }
+}
+
+/* One line per task, highest priority first; FALSE if one misses its deadline */
+static boolean Rta_bResponseTimes(void)
+{
+    const char *pcLock;
+    boolean bSchedulable = TRUE;
+    uint32 u32Blocking;
+    uint32 u32Response;
+    uint32 u32Priority;
+    size_t xTask;
+    char   acMeasured[16];
+
+    printf("\n%-4s %-28s %7s %7s %7s %7s %7s %8s %8s\n",
+           "prio", "task", "T ms", "D ms", "C us", "meas us", "B us", "R us", "slack us");
+    for(u32Priority = configMAX_PRIORITIES; u32Priority-- > 0;)
+    {
+        for(xTask = 0; xTask < s_xTasks; xTask++)
+        {
+            if(s_axTasks[xTask].u32Priority != u32Priority)
+            {
+                continue;
+            }
+            u32Blocking = Rta_u32Blocking(&s_axTasks[xTask], &pcLock);
+            u32Response = Rta_u32Response(xTask, u32Blocking);
+            if(s_axTasks[xTask].u32Measured != 0)
+            {
+                snprintf(acMeasured, sizeof(acMeasured), "%u", s_axTasks[xTask].u32Measured);
+            }
+            else
+            {
+                strcpy(acMeasured, "-");
+            }
+            if(u32Response <= s_axTasks[xTask].u32Deadline)
+            {
+                printf("%-4u %-28.28s %7lu %7lu %7u %7s %7u %8u %8u\n", u32Priority, s_axTasks[xTask].acName,
+                       (unsigned long)(s_axTasks[xTask].u32Period / RTA_US_PER_MS),
+                       (unsigned long)(s_axTasks[xTask].u32Deadline / RTA_US_PER_MS),
+                       s_axTasks[xTask].u32Wcet, acMeasured, u32Blocking, u32Response,
+                       s_axTasks[xTask].u32Deadline - u32Response);
+            }
+            else
+            {
+                printf("%-4u %-28.28s %7lu %7lu %7u %7s %7u %8s %8s  MISS\n", u32Priority, s_axTasks[xTask].acName,
+                       (unsigned long)(s_axTasks[xTask].u32Period / RTA_US_PER_MS),
+                       (unsigned long)(s_axTasks[xTask].u32Deadline / RTA_US_PER_MS),
+                       s_axTasks[xTask].u32Wcet, acMeasured, u32Blocking, "> D", "-");
+                bSchedulable = FALSE;
+            }
+        }
+    }
+    return bSchedulable;
+}
+
+static void Rta_vIsrs(void)
+{
+    size_t xIsr;
+    char   acMeasured[16];
+
+    printf("\n%-4s %-28s %7s %7s %7s\n", "irq", "interrupt", "T ms", "C us", "meas us");
+    for(xIsr = 0; xIsr < s_xIsrs; xIsr++)
+    {
+        if(s_axIsrs[xIsr].u32Measured != 0)
+        {
+            snprintf(acMeasured, sizeof(acMeasured), "%u", s_axIsrs[xIsr].u32Measured);
+        }
+        else
+        {
+            strcpy(acMeasured, "-");
+        }
+        if(s_axIsrs[xIsr].s32Irq != RTA_IRQ_NONE)
+        {
+            printf("%-4d ", (int)s_axIsrs[xIsr].s32Irq);
+        }
+        else
+        {
+            printf("%-4s ", "-");
+        }
+        printf("%-28.28s %7lu %7u %7s\n", s_axIsrs[xIsr].acName,
+               (unsigned long)(s_axIsrs[xIsr].u32Period / RTA_US_PER_MS), s_axIsrs[xIsr].u32Wcet, acMeasured);
+    }
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    const char *pcCapture = NULL;
+    FILE *pxInput = stdin;
+    boolean bSchedulable;
+    size_t xTask;
+    int   s32Arg;
+
+    for(s32Arg = 1; s32Arg < argc; s32Arg++)
+    {
+        if((strcmp(argv[s32Arg], "-m") == 0) && (s32Arg + 1 < argc))
+        {
+            pcCapture = argv[++s32Arg];
+        }
+        else if((pxInput = fopen(argv[s32Arg], "r")) == NULL)
+        {
+            perror(argv[s32Arg]);
+            return 2;
+        }
+    }
+    if(!Rta_bReadTaskSet(pxInput))
+    {
+        return 2;
+    }
+    for(xTask = 0; xTask < s_xTasks; xTask++)
+    {
+        if(s_axTasks[xTask].u32Priority >= configMAX_PRIORITIES)
+        {
+            fprintf(stderr, "[rta] %s: priority %u above configMAX_PRIORITIES - 1\n",
+                    s_axTasks[xTask].acName, s_axTasks[xTask].u32Priority);
+            return 2;
+        }
+    }
+    if((pcCapture != NULL) && !Rta_bReadCapture(pcCapture))
+    {
+        return 2;
+    }
+
+    printf("Switch overhead %u us per job and interrupt\n", s_u32Switch);
+    Rta_vUtilisation();
+    Rta_vPriorityOrder();
+    Rta_vIsrs();
+    bSchedulable = Rta_bResponseTimes();
+    printf("\n%s\n", bSchedulable ? "All deadlines met" : "Deadlines missed");
+    return bSchedulable ? 0 : 1;
+}
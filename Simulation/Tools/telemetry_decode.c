@@ -0,0 +1,493 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Tools
+ *
+ * File Name: telemetry_decode.c
+ *
+ * Description: Host decoder of the UART0 telemetry frames (see telemetry.h).
+ *              Reads the UART0 byte stream from a file, a serial device or
+ *              stdin, prints one line per seat report, rebuilds the text of
+ *              the deferred log records from the format table of the build
+ *              (log_formats.h), prints the latency reports of the control
+ *              paths and the scheduling statistics of the periodic tasks in
+ *              usec, and passes the text between frames through
+ *              unchanged. Frames with a bad CRC and gaps in the sequence
+ *              numbers are counted on stderr; kernel trace frames are
+ *              skipped, trace_export converts them.
+ *
+ *              telemetry_decode [-c | -s] [input]
+ *                -c      CSV of the seat reports only: seq,time_ms,seat,
+ *                        temperature,level,intensity,flags
+ *                -s      stack sizing report only: the depth, the highest
+ *                        watermark and a recommended depth of every task
+ *                        stack and of the main stack. Run it on a capture of
+ *                        the target: the simulated tasks run on host threads,
+ *                        so their stacks barely fill.
+ *
+ *              SIM_UART0=stdout build/seat_heater_sim | build/telemetry_decode
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry.h"
+#include "log_formats.h"
+#include "latency.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest run of bytes between two delimiters that is kept, text included */
+#define DECODE_CHUNK_MAX        1024
+
+/* Timestamp units (usec) per msec */
+#define DECODE_TICKS_PER_MS     1000
+
+/* Stack report: kernel task numbers followed (0 is the main stack) */
+#define DECODE_STACKS_MAX       32
+#define DECODE_TASK_NAME_MAX    24
+
+/* Recommended stack: the high watermark plus a quarter, at least DECODE_STACK_MARGIN_MIN words, in blocks of 8 words */
+#define DECODE_STACK_MARGIN_MIN 16
+#define DECODE_STACK_RECOMMEND(USED) \
+    ((((USED) + (((USED) / 4 > DECODE_STACK_MARGIN_MIN) ? (USED) / 4 : DECODE_STACK_MARGIN_MIN)) + 7) & ~7UL)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Heater intensity codes of main.c */
+static const char *const s_apcIntensities[] = { "low", "medium", "high", "disabled" };
+static const char *const s_apcSeats[] = { "Driver", "Passenger" };
+
+static const char *const s_apcLogFormats[LOG_FORMATS_NUM] = { LOG_FORMATS(LOG_FORMAT_STRING) };
+
+/* Control paths of latency.h */
+static const char *const s_apcLatencyPaths[LATENCY_PATHS_NUM] =
+{
+    "sensor -> heater task", "sensor -> heater output", "button -> confirmed", "button -> level",
+};
+
+static boolean s_bCsv;
+static boolean s_bStackReport;
+static unsigned long s_ulFrames;
+static unsigned long s_ulBadFrames;
+static unsigned long s_ulLostFrames;
+/* Next sequence number expected of each frame type */
+static boolean s_abHaveSequence[TELEMETRY_FRAME_PERIODIC + 1];
+static uint16  s_au16NextSequence[TELEMETRY_FRAME_PERIODIC + 1];
+
+/* Stack report, by kernel task number; the names come from the "Task N: name" lines */
+typedef struct
+{
+    char   acName[DECODE_TASK_NAME_MAX];
+    uint32 u32Used;
+    uint32 u32Depth;
+} Decode_Stack;
+
+static Decode_Stack s_axStacks[DECODE_STACKS_MAX];
+
+/* Last timestamp seen, unwrapped to 64 bits (the 32-bit usec wrap every 71 min) */
+static uint64  s_u64Timestamp;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static const char *Decode_pcSeatName(uint8 u8Seat)
+{
+    static char acName[12];
+
+    if(u8Seat < sizeof(s_apcSeats) / sizeof(s_apcSeats[0]))
+    {
+        return s_apcSeats[u8Seat];
+    }
+    snprintf(acName, sizeof(acName), "Seat %u", (unsigned)u8Seat);
+    return acName;
+}
+
+/* Extend a 32-bit timestamp next to the last one seen, backwards or forwards */
+static uint64 Decode_u64Timestamp(uint32 u32Timestamp)
+{
+    s_u64Timestamp += (uint64)(sint64)(sint32)(u32Timestamp - (uint32)s_u64Timestamp);
+    return s_u64Timestamp;
+}
+
+static void Decode_vPrintReport(const Telemetry_SeatsReport *pxReport)
+{
+    const Telemetry_Seat *pxSeat;
+    uint64 u64Timestamp = Decode_u64Timestamp(pxReport->u32Timestamp);
+    uint8 u8Seat;
+
+    for(u8Seat = 0; u8Seat < pxReport->u8Seats; u8Seat++)
+    {
+        pxSeat = &pxReport->axSeats[u8Seat];
+        if(s_bCsv)
+        {
+            printf("%u,%lu.%03lu,%u,%u.%02u,%u,%u,%u\n", (unsigned)pxReport->u16Sequence,
+                   (unsigned long)(u64Timestamp / DECODE_TICKS_PER_MS),
+                   (unsigned long)(u64Timestamp % DECODE_TICKS_PER_MS), (unsigned)u8Seat,
+                   (unsigned)(pxSeat->u16Temperature / 100), (unsigned)(pxSeat->u16Temperature % 100),
+                   (unsigned)pxSeat->u8Level, (unsigned)pxSeat->u8Intensity, (unsigned)pxSeat->u8Flags);
+        }
+        else
+        {
+            printf("#%-5u %9.1f ms  %-9s %2u.%02u degC  level %2u  intensity %s%s\n",
+                   (unsigned)pxReport->u16Sequence, (double)u64Timestamp / DECODE_TICKS_PER_MS,
+                   Decode_pcSeatName(u8Seat),
+                   (unsigned)(pxSeat->u16Temperature / 100), (unsigned)(pxSeat->u16Temperature % 100),
+                   (unsigned)pxSeat->u8Level,
+                   (pxSeat->u8Intensity < 4) ? s_apcIntensities[pxSeat->u8Intensity] : "?",
+                   ((pxSeat->u8Flags & TELEMETRY_FLAG_SENSOR_FAILURE) != 0) ? "  SENSOR FAILURE" : "");
+        }
+    }
+    fflush(stdout);
+}
+
+static void Decode_vCheckSequence(uint8 u8Type, uint16 u16Sequence)
+{
+    static const char *const apcTypes[TELEMETRY_FRAME_PERIODIC + 1] =
+    {
+        "?", "seats", "log", "trace", "latency", "periodic",
+    };
+    uint16 u16Lost = (uint16)(u16Sequence - s_au16NextSequence[u8Type]);
+
+    if(s_abHaveSequence[u8Type] && (u16Lost != 0))
+    {
+        s_ulLostFrames += u16Lost;
+        fprintf(stderr, "[decode] %u %s frames lost before #%u\n", (unsigned)u16Lost, apcTypes[u8Type],
+                (unsigned)u16Sequence);
+    }
+    s_abHaveSequence[u8Type] = TRUE;
+    s_au16NextSequence[u8Type] = (uint16)(u16Sequence + 1);
+}
+
+static void Decode_vPrintLatency(const Telemetry_LatencyReport *pxReport)
+{
+    const Telemetry_Latency *pxSeat;
+    uint8 u8Seat;
+
+    for(u8Seat = 0; u8Seat < pxReport->u8Seats; u8Seat++)
+    {
+        pxSeat = &pxReport->axSeats[u8Seat];
+        if(pxSeat->u32Samples == 0)
+        {
+            continue;
+        }
+        printf("[latency] %-24s %-9s %6lu samples  min %9.1f  p99 %9.1f  max %9.1f us\n",
+               (pxReport->u8Path < LATENCY_PATHS_NUM) ? s_apcLatencyPaths[pxReport->u8Path] : "?",
+               Decode_pcSeatName(u8Seat), (unsigned long)pxSeat->u32Samples,
+               (double)pxSeat->u32Min / CLOCK_CYCLES_PER_US, (double)pxSeat->u32P99 / CLOCK_CYCLES_PER_US,
+               (double)pxSeat->u32Max / CLOCK_CYCLES_PER_US);
+    }
+    fflush(stdout);
+}
+
+static void Decode_vPrintPeriodic(const Telemetry_PeriodicReport *pxReport)
+{
+    const Telemetry_Periodic *pxTask;
+    uint8 u8Task;
+
+    for(u8Task = 0; u8Task < pxReport->u8Tasks; u8Task++)
+    {
+        pxTask = &pxReport->axTasks[u8Task];
+        printf("[periodic] %2u %-22s prio %u  T %4u ms  D %4u ms  %6lu jobs  %lu deadline misses  %lu skipped"
+               "  jitter max %9.1f  response max %9.1f us\n",
+               (unsigned)pxTask->u8Task,
+               ((pxTask->u8Task < DECODE_STACKS_MAX) && (s_axStacks[pxTask->u8Task].acName[0] != '\0')) ?
+               s_axStacks[pxTask->u8Task].acName : "?",
+               (unsigned)pxTask->u8Priority, (unsigned)pxTask->u16PeriodMs, (unsigned)pxTask->u16DeadlineMs,
+               (unsigned long)pxTask->u32Jobs, (unsigned long)pxTask->u32DeadlineMisses,
+               (unsigned long)pxTask->u32Overruns, (double)pxTask->u32MaxJitter / CLOCK_CYCLES_PER_US,
+               (double)pxTask->u32MaxResponse / CLOCK_CYCLES_PER_US);
+    }
+    fflush(stdout);
+}
+
+/* Keep the highest watermark of each stack record */
+static void Decode_vNoteStack(uint16 u16Format, const uint32 *pu32Args)
+{
+    Decode_Stack *pxStack;
+
+    if(u16Format == LOG_FMT_TASK_STACK)
+    {
+        if((pu32Args[0] == 0) || (pu32Args[0] >= DECODE_STACKS_MAX))
+        {
+            return;
+        }
+        pxStack = &s_axStacks[pu32Args[0]];
+        pu32Args++;
+    }
+    else if(u16Format == LOG_FMT_MAIN_STACK)
+    {
+        pxStack = &s_axStacks[0];
+    }
+    else
+    {
+        return;
+    }
+    if(pu32Args[0] > pxStack->u32Used)
+    {
+        pxStack->u32Used = pu32Args[0];
+    }
+    pxStack->u32Depth = pu32Args[1];
+}
+
+/* Pick the task names out of a text chunk */
+static void Decode_vNoteTaskNames(const uint8 *pu8Chunk, uint16 u16Length)
+{
+    char acLine[DECODE_CHUNK_MAX + 1];
+    char acName[DECODE_TASK_NAME_MAX];
+    char *pcLine;
+    unsigned uNumber;
+
+    memcpy(acLine, pu8Chunk, u16Length);
+    acLine[u16Length] = '\0';
+    for(pcLine = strtok(acLine, "\r\n"); pcLine != NULL; pcLine = strtok(NULL, "\r\n"))
+    {
+        if((sscanf(pcLine, "Task %u: %23[^\r\n]", &uNumber, acName) == 2) &&
+           (uNumber != 0) && (uNumber < DECODE_STACKS_MAX))
+        {
+            strcpy(s_axStacks[uNumber].acName, acName);
+        }
+    }
+}
+
+static void Decode_vPrintStackReport(void)
+{
+    const Decode_Stack *pxStack;
+    unsigned long ulReclaimable = 0;
+    unsigned long ulRecommended;
+    uint8 u8Stack;
+
+    printf("Stack sizing in words, recommended = high watermark + 25%% (at least %u words), in blocks of 8\n",
+           DECODE_STACK_MARGIN_MIN);
+    printf("  task                         depth   used  recommended\n");
+    for(u8Stack = 0; u8Stack < DECODE_STACKS_MAX; u8Stack++)
+    {
+        pxStack = &s_axStacks[u8Stack];
+        if(pxStack->u32Depth == 0)
+        {
+            continue;
+        }
+        ulRecommended = DECODE_STACK_RECOMMEND(pxStack->u32Used);
+        if(u8Stack == 0)
+        {
+            printf("  main stack (interrupts)  ");
+        }
+        else
+        {
+            printf("  %2u %-22s", (unsigned)u8Stack, (pxStack->acName[0] != '\0') ? pxStack->acName : "?");
+        }
+        printf("  %6lu %6lu  %6lu\n", (unsigned long)pxStack->u32Depth, (unsigned long)pxStack->u32Used, ulRecommended);
+        if(pxStack->u32Depth > ulRecommended)
+        {
+            ulReclaimable += pxStack->u32Depth - ulRecommended;
+        }
+    }
+    printf("  reclaimable %lu words (%lu bytes)\n", ulReclaimable, ulReclaimable * 4);
+}
+
+/* Rebuild the text of every record of a deferred log payload */
+static boolean Decode_bPrintLog(const uint8 *pu8Payload, uint16 u16Length)
+{
+    uint16 u16Offset = TELEMETRY_LOG_HEADER_LENGTH;
+    uint32 au32Args[TELEMETRY_LOG_ARGS_MAX];
+    uint16 u16Format;
+    uint64 u64Timestamp;
+    uint8  u8Args;
+    uint8  u8Arg;
+
+    if(u16Length < TELEMETRY_LOG_HEADER_LENGTH)
+    {
+        return FALSE;
+    }
+    Decode_vCheckSequence(TELEMETRY_FRAME_LOG, Telemetry_u16Get16(&pu8Payload[1]));
+
+    while(u16Offset + TELEMETRY_LOG_RECORD_LENGTH <= u16Length)
+    {
+        u16Format = Telemetry_u16Get16(&pu8Payload[u16Offset]);
+        u8Args = pu8Payload[u16Offset + 2];
+        u64Timestamp = Decode_u64Timestamp(Telemetry_u32Get32(&pu8Payload[u16Offset + 3]));
+        u16Offset += TELEMETRY_LOG_RECORD_LENGTH;
+        if((u8Args > TELEMETRY_LOG_ARGS_MAX) || (u16Offset + (u8Args * 4) > u16Length))
+        {
+            return FALSE;
+        }
+        for(u8Arg = 0; u8Arg < TELEMETRY_LOG_ARGS_MAX; u8Arg++)
+        {
+            au32Args[u8Arg] = (u8Arg < u8Args) ? Telemetry_u32Get32(&pu8Payload[u16Offset + (u8Arg * 4)]) : 0;
+        }
+        u16Offset += u8Args * 4;
+
+        Decode_vNoteStack(u16Format, au32Args);
+        if(s_bCsv || s_bStackReport)
+        {
+            continue;
+        }
+        printf("[%9.1f ms] ", (double)u64Timestamp / DECODE_TICKS_PER_MS);
+        if(u16Format < LOG_FORMATS_NUM)
+        {
+            printf(s_apcLogFormats[u16Format], (unsigned)au32Args[0], (unsigned)au32Args[1], (unsigned)au32Args[2]);
+            printf("\n");
+        }
+        else
+        {
+            printf("unknown format %u: %u %u %u\n", (unsigned)u16Format,
+                   (unsigned)au32Args[0], (unsigned)au32Args[1], (unsigned)au32Args[2]);
+        }
+    }
+    fflush(stdout);
+    return (u16Offset == u16Length);
+}
+
+static boolean Decode_bIsText(const uint8 *pu8Chunk, uint16 u16Length)
+{
+    uint16 u16Byte;
+
+    for(u16Byte = 0; u16Byte < u16Length; u16Byte++)
+    {
+        if((pu8Chunk[u16Byte] < ' ') && (pu8Chunk[u16Byte] != '\r') &&
+           (pu8Chunk[u16Byte] != '\n') && (pu8Chunk[u16Byte] != '\t'))
+        {
+            return FALSE;
+        }
+        if(pu8Chunk[u16Byte] > '~')
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* One run of bytes between two delimiters */
+static void Decode_vChunk(const uint8 *pu8Chunk, uint16 u16Length)
+{
+    uint8  au8Payload[DECODE_CHUNK_MAX];
+    uint16 u16Payload;
+    Telemetry_SeatsReport xReport;
+    Telemetry_LatencyReport xLatency;
+    Telemetry_PeriodicReport xPeriodic;
+
+    if(u16Length == 0)
+    {
+        return;
+    }
+
+    u16Payload = Telemetry_u16DecodeFrame(pu8Chunk, u16Length, au8Payload);
+    if((u16Payload != 0) && Telemetry_bParseSeatsReport(au8Payload, u16Payload, &xReport))
+    {
+        s_ulFrames++;
+        Decode_vCheckSequence(TELEMETRY_FRAME_SEATS, xReport.u16Sequence);
+        if(!s_bStackReport)
+        {
+            Decode_vPrintReport(&xReport);
+        }
+    }
+    else if((u16Payload != 0) && (au8Payload[0] == TELEMETRY_FRAME_LOG))
+    {
+        s_ulFrames++;
+        if(!Decode_bPrintLog(au8Payload, u16Payload))
+        {
+            s_ulBadFrames++;
+            fprintf(stderr, "[decode] malformed log frame of %u bytes\n", (unsigned)u16Payload);
+        }
+    }
+    else if((u16Payload != 0) && Telemetry_bParseLatencyReport(au8Payload, u16Payload, &xLatency))
+    {
+        s_ulFrames++;
+        Decode_vCheckSequence(TELEMETRY_FRAME_LATENCY, xLatency.u16Sequence);
+        if(!s_bCsv && !s_bStackReport)
+        {
+            Decode_vPrintLatency(&xLatency);
+        }
+    }
+    else if((u16Payload != 0) && Telemetry_bParsePeriodicReport(au8Payload, u16Payload, &xPeriodic))
+    {
+        s_ulFrames++;
+        Decode_vCheckSequence(TELEMETRY_FRAME_PERIODIC, xPeriodic.u16Sequence);
+        if(!s_bCsv && !s_bStackReport)
+        {
+            Decode_vPrintPeriodic(&xPeriodic);
+        }
+    }
+    else if((u16Payload != 0) && (au8Payload[0] == TELEMETRY_FRAME_TRACE))
+    {
+        /* Kernel trace dumps are for trace_export */
+        s_ulFrames++;
+    }
+    else if(Decode_bIsText(pu8Chunk, u16Length))
+    {
+        /* The text reports share the line with the frames */
+        Decode_vNoteTaskNames(pu8Chunk, u16Length);
+        if(!s_bCsv && !s_bStackReport)
+        {
+            fwrite(pu8Chunk, 1, u16Length, stdout);
+            fflush(stdout);
+        }
+    }
+    else
+    {
+        s_ulBadFrames++;
+        fprintf(stderr, "[decode] bad frame of %u bytes\n", (unsigned)u16Length);
+    }
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    static uint8 au8Chunk[DECODE_CHUNK_MAX];
+    uint16 u16Length = 0;
+    FILE  *pxInput = stdin;
+    int    s32Byte;
+    int    s32Arg;
+
+    for(s32Arg = 1; s32Arg < argc; s32Arg++)
+    {
+        if(strcmp(argv[s32Arg], "-c") == 0)
+        {
+            s_bCsv = TRUE;
+        }
+        else if(strcmp(argv[s32Arg], "-s") == 0)
+        {
+            s_bStackReport = TRUE;
+        }
+        else if((pxInput = fopen(argv[s32Arg], "rb")) == NULL)
+        {
+            perror(argv[s32Arg]);
+            return 1;
+        }
+    }
+
+    if(s_bCsv)
+    {
+        printf("seq,time_ms,seat,temperature,level,intensity,flags\n");
+    }
+
+    while((s32Byte = fgetc(pxInput)) != EOF)
+    {
+        if(s32Byte == 0)
+        {
+            Decode_vChunk(au8Chunk, u16Length);
+            u16Length = 0;
+        }
+        else if(u16Length < DECODE_CHUNK_MAX)
+        {
+            au8Chunk[u16Length++] = (uint8)s32Byte;
+        }
+    }
+    Decode_vChunk(au8Chunk, u16Length);
+
+    if(s_bStackReport)
+    {
+        Decode_vPrintStackReport();
+    }
+    fprintf(stderr, "[decode] %lu frames, %lu bad, %lu lost\n", s_ulFrames, s_ulBadFrames, s_ulLostFrames);
+    return 0;
+}
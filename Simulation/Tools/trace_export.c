@@ -0,0 +1,572 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Tools
+ *
+ * File Name: trace_export.c
+ *
+ * Description: Host converter of the kernel trace dumps (see trace.h) to the
+ *              Chrome trace event JSON format, which ui.perfetto.dev and
+ *              chrome://tracing open. Reads the UART0 byte stream like
+ *              telemetry_decode, takes the task names from the "Task N:"
+ *              lines and the object names from the "Object N type T:" lines,
+ *              and writes one dump as:
+ *                - a track per task, with a slice for every run of the task
+ *                - a track per traced interrupt, with a slice per handler
+ *                  run, and a SysTick track with the kernel ticks
+ *                - an instant per kernel event on the track of the task or
+ *                  interrupt that caused it, with flow arrows from each give,
+ *                  send, set, notify or timer command to the event consuming
+ *                  it, so a button press can be followed from its interrupt
+ *                  through the debounce timer and the event group to the
+ *                  task handling it
+ *
+ *              trace_export [-n dump] [input] > trace.json
+ *                -n      dump to convert, from 1, the last one by default
+ *
+ *              Times are in usec from the WTimer0 timebase, matching the log
+ *              timestamps of telemetry_decode.
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry.h"
+#include "trace.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest run of bytes between two delimiters that is kept, text included */
+#define EXPORT_CHUNK_MAX        1024
+
+#define EXPORT_NAME_MAX         32
+#define EXPORT_TASKS_MAX        256
+#define EXPORT_OBJECTS_MAX      256
+#define EXPORT_IRQS_MAX         256
+
+/* Track ids: tasks use their kernel number, interrupts and the tick go above */
+#define EXPORT_TID_IRQ(IRQ)     (1000 + (IRQ))
+#define EXPORT_TID_TICK         999
+#define EXPORT_PID              1
+
+/* Flow keys: the object number, or the task notified */
+#define EXPORT_FLOW_NOTIFY(TASK) (EXPORT_OBJECTS_MAX + (TASK))
+#define EXPORT_FLOWS_MAX        (EXPORT_OBJECTS_MAX + EXPORT_TASKS_MAX)
+
+typedef struct
+{
+    uint32 u32Time;
+    uint8  u8Event;
+    uint8  u8Task;
+    uint8  u8Object;
+    uint8  u8Param;
+} Export_Record;
+
+typedef struct
+{
+    Export_Record *pxRecords;
+    size_t  xRecords;
+    boolean bComplete;          /* No frame missing */
+} Export_Dump;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Interrupts of tm4c123gh6pm_startup_ccs.c, by interrupt number */
+static const char *const s_apcIrqNames[] =
+{
+    "GPIO Port A", "GPIO Port B", "GPIO Port C", "GPIO Port D", "GPIO Port E",
+    "UART0", "UART1", "SSI0", "I2C0", "PWM Fault", "PWM Generator 0",
+    "PWM Generator 1", "PWM Generator 2", "Quadrature Encoder 0",
+    "ADC Sequence 0", "ADC Sequence 1", "ADC Sequence 2", "ADC Sequence 3",
+    "Watchdog timer", "Timer 0A", "Timer 0B", "Timer 1A", "Timer 1B",
+    "Timer 2A", "Timer 2B", "Analog Comparator 0", "Analog Comparator 1",
+    "Analog Comparator 2", "System Control", "FLASH Control", "GPIO Port F",
+};
+
+/* Kernel queue types (queueQUEUE_TYPE_*), then the trace object types */
+static const char *const s_apcQueueTypes[] =
+{
+    "Queue", "Mutex", "Counting semaphore", "Binary semaphore", "Recursive mutex",
+};
+
+/* Timer commands of timers.c (tmrCOMMAND_*) */
+static const char *const s_apcTimerCommands[] =
+{
+    "start", "start", "reset", "stop", "change period", "delete",
+    "start from ISR", "reset from ISR", "stop from ISR", "change period from ISR",
+};
+
+static char    s_aacTaskNames[EXPORT_TASKS_MAX][EXPORT_NAME_MAX];
+static char    s_aacObjectNames[EXPORT_OBJECTS_MAX][EXPORT_NAME_MAX];
+static sint32  s_as32ObjectTypes[EXPORT_OBJECTS_MAX];          /* -1 until known */
+
+static Export_Dump *s_pxDumps;
+static size_t  s_xDumps;
+static uint16  s_u16NextFrame;
+static unsigned long s_ulBadFrames;
+
+/* Conversion state */
+static uint64  s_u64Cycles;
+static uint32  s_u32LastTime;
+static boolean s_bFirstEvent = TRUE;
+static unsigned long s_ulFlows;
+static unsigned long s_aulFlowPending[EXPORT_FLOWS_MAX];       /* Flow id waiting for its consumer, 0 if none */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Pick the task and object names out of a text chunk */
+static void Export_vNoteNames(const uint8 *pu8Chunk, uint16 u16Length)
+{
+    char acLine[EXPORT_CHUNK_MAX + 1];
+    char acName[EXPORT_NAME_MAX];
+    char *pcLine;
+    unsigned uNumber;
+    unsigned uType;
+
+    memcpy(acLine, pu8Chunk, u16Length);
+    acLine[u16Length] = '\0';
+    for(pcLine = strtok(acLine, "\r\n"); pcLine != NULL; pcLine = strtok(NULL, "\r\n"))
+    {
+        acName[0] = '\0';
+        if((sscanf(pcLine, "Task %u: %31[^\r\n]", &uNumber, acName) == 2) && (uNumber < EXPORT_TASKS_MAX))
+        {
+            strcpy(s_aacTaskNames[uNumber], acName);
+        }
+        else if((sscanf(pcLine, "Object %u type %u: %31[^\r\n]", &uNumber, &uType, acName) >= 2) &&
+                (uNumber < EXPORT_OBJECTS_MAX))
+        {
+            s_as32ObjectTypes[uNumber] = (sint32)uType;
+            strcpy(s_aacObjectNames[uNumber], acName);
+        }
+    }
+}
+
+/* Append the records of one trace frame to the dump it belongs to */
+static void Export_vTraceFrame(const uint8 *pu8Payload, uint16 u16Length)
+{
+    Export_Dump *pxDump;
+    Export_Record *pxRecord;
+    uint16 u16Frame = Telemetry_u16Get16(&pu8Payload[1]);
+    uint16 u16Offset;
+
+    if((u16Length < TELEMETRY_TRACE_HEADER_LENGTH) ||
+       (((u16Length - TELEMETRY_TRACE_HEADER_LENGTH) % TELEMETRY_TRACE_RECORD_LENGTH) != 0))
+    {
+        s_ulBadFrames++;
+        return;
+    }
+    if(u16Frame == 0)
+    {
+        s_pxDumps = realloc(s_pxDumps, (s_xDumps + 1) * sizeof(Export_Dump));
+        s_pxDumps[s_xDumps].pxRecords = NULL;
+        s_pxDumps[s_xDumps].xRecords = 0;
+        s_pxDumps[s_xDumps].bComplete = TRUE;
+        s_xDumps++;
+        s_u16NextFrame = 0;
+    }
+    else if(s_xDumps == 0)
+    {
+        return;         /* The capture started within a dump */
+    }
+    pxDump = &s_pxDumps[s_xDumps - 1];
+    if(u16Frame != s_u16NextFrame)
+    {
+        fprintf(stderr, "[export] dump %lu: frames %u to %u lost\n", (unsigned long)s_xDumps,
+                (unsigned)s_u16NextFrame, (unsigned)(u16Frame - 1));
+        pxDump->bComplete = FALSE;
+    }
+    s_u16NextFrame = (uint16)(u16Frame + 1);
+
+    for(u16Offset = TELEMETRY_TRACE_HEADER_LENGTH; u16Offset < u16Length; u16Offset += TELEMETRY_TRACE_RECORD_LENGTH)
+    {
+        pxDump->pxRecords = realloc(pxDump->pxRecords, (pxDump->xRecords + 1) * sizeof(Export_Record));
+        pxRecord = &pxDump->pxRecords[pxDump->xRecords++];
+        pxRecord->u32Time = Telemetry_u32Get32(&pu8Payload[u16Offset]);
+        pxRecord->u8Event = pu8Payload[u16Offset + 4];
+        pxRecord->u8Task = pu8Payload[u16Offset + 5];
+        pxRecord->u8Object = pu8Payload[u16Offset + 6];
+        pxRecord->u8Param = pu8Payload[u16Offset + 7];
+    }
+}
+
+/* One run of bytes between two delimiters */
+static void Export_vChunk(const uint8 *pu8Chunk, uint16 u16Length)
+{
+    uint8  au8Payload[EXPORT_CHUNK_MAX];
+    uint16 u16Payload;
+
+    if(u16Length == 0)
+    {
+        return;
+    }
+    u16Payload = Telemetry_u16DecodeFrame(pu8Chunk, u16Length, au8Payload);
+    if(u16Payload != 0)
+    {
+        if(au8Payload[0] == TELEMETRY_FRAME_TRACE)
+        {
+            Export_vTraceFrame(au8Payload, u16Payload);
+        }
+    }
+    else
+    {
+        /* Text or a damaged frame, only the names matter here */
+        Export_vNoteNames(pu8Chunk, u16Length);
+    }
+}
+
+static const char *Export_pcTaskName(uint8 u8Task)
+{
+    static char acName[EXPORT_NAME_MAX];
+
+    if(s_aacTaskNames[u8Task][0] != '\0')
+    {
+        return s_aacTaskNames[u8Task];
+    }
+    snprintf(acName, sizeof(acName), "Task %u", (unsigned)u8Task);
+    return acName;
+}
+
+static const char *Export_pcObjectType(uint8 u8Object)
+{
+    sint32 s32Type = s_as32ObjectTypes[u8Object];
+
+    if((s32Type >= 0) && ((size_t)s32Type < sizeof(s_apcQueueTypes) / sizeof(s_apcQueueTypes[0])))
+    {
+        return s_apcQueueTypes[s32Type];
+    }
+    if(s32Type == TRACE_OBJECT_EVENT_GROUP)
+    {
+        return "Event group";
+    }
+    if(s32Type == TRACE_OBJECT_TIMER)
+    {
+        return "Timer";
+    }
+    return "Object";
+}
+
+static const char *Export_pcObjectName(uint8 u8Object)
+{
+    static char acName[EXPORT_NAME_MAX + 24];
+
+    if(s_aacObjectNames[u8Object][0] != '\0')
+    {
+        return s_aacObjectNames[u8Object];
+    }
+    snprintf(acName, sizeof(acName), "%s %u", Export_pcObjectType(u8Object), (unsigned)u8Object);
+    return acName;
+}
+
+static boolean Export_bIsSemaphore(uint8 u8Object)
+{
+    return (s_as32ObjectTypes[u8Object] > TRACE_OBJECT_QUEUE) && (s_as32ObjectTypes[u8Object] <= TRACE_OBJECT_RECURSIVE_MUTEX);
+}
+
+static double Export_dUs(uint64 u64Cycles)
+{
+    return (double)u64Cycles / CLOCK_CYCLES_PER_US;
+}
+
+static void Export_vSeparator(void)
+{
+    printf(s_bFirstEvent ? "\n  " : ",\n  ");
+    s_bFirstEvent = FALSE;
+}
+
+static void Export_vThreadName(unsigned uTid, const char *pcName, unsigned uSort)
+{
+    Export_vSeparator();
+    printf("{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+           EXPORT_PID, uTid, pcName);
+    Export_vSeparator();
+    printf("{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%u}}",
+           EXPORT_PID, uTid, uSort);
+}
+
+static void Export_vSlice(unsigned uTid, const char *pcName, uint64 u64Start, uint64 u64End)
+{
+    Export_vSeparator();
+    printf("{\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f}",
+           EXPORT_PID, uTid, pcName, Export_dUs(u64Start), Export_dUs(u64End - u64Start));
+}
+
+static void Export_vInstant(unsigned uTid, const char *pcName, uint64 u64Time, const char *pcArgs)
+{
+    Export_vSeparator();
+    printf("{\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,\"args\":{%s}}",
+           EXPORT_PID, uTid, pcName, Export_dUs(u64Time), pcArgs);
+}
+
+/* Start a flow arrow at a producer, or end the pending one at its consumer */
+static void Export_vFlow(boolean bStart, unsigned uKey, unsigned uTid, uint64 u64Time)
+{
+    unsigned long ulId;
+
+    if(bStart)
+    {
+        ulId = ++s_ulFlows;
+        s_aulFlowPending[uKey] = ulId;
+        Export_vSeparator();
+        printf("{\"ph\":\"s\",\"cat\":\"kernel\",\"name\":\"wake\",\"id\":%lu,\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+               ulId, EXPORT_PID, uTid, Export_dUs(u64Time));
+    }
+    else if(s_aulFlowPending[uKey] != 0)
+    {
+        ulId = s_aulFlowPending[uKey];
+        s_aulFlowPending[uKey] = 0;
+        Export_vSeparator();
+        printf("{\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"kernel\",\"name\":\"wake\",\"id\":%lu,\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+               ulId, EXPORT_PID, uTid, Export_dUs(u64Time));
+    }
+}
+
+/* One kernel event, on the track of whoever caused it */
+static void Export_vKernelEvent(const Export_Record *pxRecord, unsigned uTid, uint64 u64Time)
+{
+    char acName[2 * EXPORT_NAME_MAX + 32];
+    char acArgs[2 * EXPORT_NAME_MAX + 64];
+    boolean bSemaphore = Export_bIsSemaphore(pxRecord->u8Object);
+    const char *pcObject = Export_pcObjectName(pxRecord->u8Object);
+    sint32 s32Flow = -1;                /* Flow key */
+    boolean bFlowStart = FALSE;
+
+    snprintf(acArgs, sizeof(acArgs), "\"object\":%u,\"param\":%u",
+             (unsigned)pxRecord->u8Object, (unsigned)pxRecord->u8Param);
+    switch(pxRecord->u8Event)
+    {
+    case TRACE_EVENT_QUEUE_SEND:
+    case TRACE_EVENT_QUEUE_SEND_FROM_ISR:
+        snprintf(acName, sizeof(acName), "%s %s", bSemaphore ? "Give" : "Send to", pcObject);
+        s32Flow = pxRecord->u8Object;
+        bFlowStart = TRUE;
+        break;
+    case TRACE_EVENT_QUEUE_RECEIVE:
+    case TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR:
+        snprintf(acName, sizeof(acName), "%s %s", bSemaphore ? "Take" : "Receive from", pcObject);
+        s32Flow = pxRecord->u8Object;
+        break;
+    case TRACE_EVENT_QUEUE_BLOCK:
+        snprintf(acName, sizeof(acName), "Block on %s", pcObject);
+        break;
+    case TRACE_EVENT_GROUP_SET:
+    case TRACE_EVENT_GROUP_SET_FROM_ISR:
+        snprintf(acName, sizeof(acName), "Set bits 0x%02X of %s", (unsigned)pxRecord->u8Param, pcObject);
+        s32Flow = pxRecord->u8Object;
+        bFlowStart = TRUE;
+        break;
+    case TRACE_EVENT_GROUP_WAIT_BLOCK:
+        snprintf(acName, sizeof(acName), "Wait for bits 0x%02X of %s", (unsigned)pxRecord->u8Param, pcObject);
+        break;
+    case TRACE_EVENT_GROUP_WAIT_END:
+        snprintf(acName, sizeof(acName), "Woken by bits 0x%02X of %s", (unsigned)pxRecord->u8Param, pcObject);
+        s32Flow = pxRecord->u8Object;
+        break;
+    case TRACE_EVENT_NOTIFY:
+    case TRACE_EVENT_NOTIFY_FROM_ISR:
+        snprintf(acName, sizeof(acName), "Notify %s", Export_pcTaskName(pxRecord->u8Param));
+        s32Flow = EXPORT_FLOW_NOTIFY(pxRecord->u8Param);
+        bFlowStart = TRUE;
+        break;
+    case TRACE_EVENT_NOTIFY_TAKE:
+        snprintf(acName, sizeof(acName), "Take notification");
+        s32Flow = EXPORT_FLOW_NOTIFY(pxRecord->u8Task);
+        break;
+    case TRACE_EVENT_TIMER_COMMAND:
+        snprintf(acName, sizeof(acName), "%s %s", pcObject,
+                 (pxRecord->u8Param < sizeof(s_apcTimerCommands) / sizeof(s_apcTimerCommands[0])) ?
+                 s_apcTimerCommands[pxRecord->u8Param] : "command");
+        s32Flow = pxRecord->u8Object;
+        bFlowStart = TRUE;
+        break;
+    case TRACE_EVENT_TIMER_EXPIRED:
+        snprintf(acName, sizeof(acName), "%s expired", pcObject);
+        s32Flow = pxRecord->u8Object;
+        break;
+    default:
+        snprintf(acName, sizeof(acName), "Event 0x%02X", (unsigned)pxRecord->u8Event);
+        break;
+    }
+
+    Export_vInstant(uTid, acName, u64Time, acArgs);
+    if(s32Flow >= 0)
+    {
+        Export_vFlow(bFlowStart, (unsigned)s32Flow, uTid, u64Time);
+    }
+}
+
+static void Export_vDump(const Export_Dump *pxDump)
+{
+    const Export_Record *pxRecord;
+    boolean abTaskSeen[EXPORT_TASKS_MAX] = { FALSE };
+    boolean abIrqSeen[EXPORT_IRQS_MAX] = { FALSE };
+    uint64  au64IrqStart[EXPORT_IRQS_MAX];
+    uint8   au8IrqStack[EXPORT_IRQS_MAX];
+    uint8   u8IrqDepth = 0;
+    boolean bRunning = FALSE;
+    uint8   u8Running = 0;
+    uint64  u64RunStart = 0;
+    char    acName[EXPORT_NAME_MAX + 24];
+    char    acArgs[16];
+    unsigned uTid;
+    size_t  xRecord;
+
+    if(pxDump->xRecords == 0)
+    {
+        return;
+    }
+    s_u64Cycles = pxDump->pxRecords[0].u32Time;
+    s_u32LastTime = pxDump->pxRecords[0].u32Time;
+
+    for(xRecord = 0; xRecord < pxDump->xRecords; xRecord++)
+    {
+        pxRecord = &pxDump->pxRecords[xRecord];
+        /* The records are in order, so the time only moves forwards */
+        s_u64Cycles += (uint32)(pxRecord->u32Time - s_u32LastTime);
+        s_u32LastTime = pxRecord->u32Time;
+        abTaskSeen[pxRecord->u8Task] = TRUE;
+        uTid = (u8IrqDepth != 0) ? EXPORT_TID_IRQ(au8IrqStack[u8IrqDepth - 1]) : pxRecord->u8Task;
+
+        switch(pxRecord->u8Event)
+        {
+        case TRACE_EVENT_SWITCH_IN:
+            if(bRunning && (u8Running != pxRecord->u8Task))
+            {
+                Export_vSlice(u8Running, Export_pcTaskName(u8Running), u64RunStart, s_u64Cycles);
+            }
+            if(!bRunning || (u8Running != pxRecord->u8Task))
+            {
+                u64RunStart = s_u64Cycles;
+            }
+            bRunning = TRUE;
+            u8Running = pxRecord->u8Task;
+            break;
+        case TRACE_EVENT_TICK:
+            snprintf(acArgs, sizeof(acArgs), "\"tick\":%u", (unsigned)pxRecord->u8Param);
+            Export_vInstant(EXPORT_TID_TICK, "Tick", s_u64Cycles, acArgs);
+            break;
+        case TRACE_EVENT_ISR_ENTER:
+            abIrqSeen[pxRecord->u8Param] = TRUE;
+            au64IrqStart[pxRecord->u8Param] = s_u64Cycles;
+            if(u8IrqDepth < EXPORT_IRQS_MAX)
+            {
+                au8IrqStack[u8IrqDepth++] = pxRecord->u8Param;
+            }
+            break;
+        case TRACE_EVENT_ISR_EXIT:
+            if((u8IrqDepth != 0) && (au8IrqStack[u8IrqDepth - 1] == pxRecord->u8Param))
+            {
+                u8IrqDepth--;
+                snprintf(acName, sizeof(acName), "IRQ %u", (unsigned)pxRecord->u8Param);
+                Export_vSlice(EXPORT_TID_IRQ(pxRecord->u8Param), acName,
+                              au64IrqStart[pxRecord->u8Param], s_u64Cycles);
+            }
+            break;
+        default:
+            Export_vKernelEvent(pxRecord, uTid, s_u64Cycles);
+            break;
+        }
+    }
+    if(bRunning)
+    {
+        Export_vSlice(u8Running, Export_pcTaskName(u8Running), u64RunStart, s_u64Cycles);
+    }
+
+    /* Track names, interrupts first */
+    for(uTid = 0; uTid < EXPORT_IRQS_MAX; uTid++)
+    {
+        if(abIrqSeen[uTid])
+        {
+            snprintf(acName, sizeof(acName), "IRQ %u %s", uTid,
+                     (uTid < sizeof(s_apcIrqNames) / sizeof(s_apcIrqNames[0])) ? s_apcIrqNames[uTid] : "");
+            Export_vThreadName(EXPORT_TID_IRQ(uTid), acName, uTid);
+        }
+    }
+    Export_vThreadName(EXPORT_TID_TICK, "SysTick", EXPORT_IRQS_MAX);
+    for(uTid = 0; uTid < EXPORT_TASKS_MAX; uTid++)
+    {
+        if(abTaskSeen[uTid])
+        {
+            snprintf(acName, sizeof(acName), "%u %.31s", uTid, Export_pcTaskName((uint8)uTid));
+            Export_vThreadName(uTid, acName, EXPORT_IRQS_MAX + 1 + uTid);
+        }
+    }
+    Export_vSeparator();
+    printf("{\"ph\":\"M\",\"pid\":%u,\"name\":\"process_name\",\"args\":{\"name\":\"Seat heater kernel trace\"}}",
+           EXPORT_PID);
+}
+
+/*******************************************************************************
+ *                                   Main                                      *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    static uint8 au8Chunk[EXPORT_CHUNK_MAX];
+    uint16 u16Length = 0;
+    FILE  *pxInput = stdin;
+    long   s32Dump = 0;
+    int    s32Byte;
+    int    s32Arg;
+
+    for(s32Arg = 1; s32Arg < argc; s32Arg++)
+    {
+        if((strcmp(argv[s32Arg], "-n") == 0) && (s32Arg + 1 < argc))
+        {
+            s32Dump = strtol(argv[++s32Arg], NULL, 10);
+        }
+        else if((pxInput = fopen(argv[s32Arg], "rb")) == NULL)
+        {
+            perror(argv[s32Arg]);
+            return 1;
+        }
+    }
+    for(s32Arg = 0; s32Arg < EXPORT_OBJECTS_MAX; s32Arg++)
+    {
+        s_as32ObjectTypes[s32Arg] = -1;
+    }
+
+    while((s32Byte = fgetc(pxInput)) != EOF)
+    {
+        if(s32Byte == 0)
+        {
+            Export_vChunk(au8Chunk, u16Length);
+            u16Length = 0;
+        }
+        else if(u16Length < EXPORT_CHUNK_MAX)
+        {
+            au8Chunk[u16Length++] = (uint8)s32Byte;
+        }
+    }
+    Export_vChunk(au8Chunk, u16Length);
+
+    if(s_xDumps == 0)
+    {
+        fprintf(stderr, "[export] no trace dump in the input\n");
+        return 1;
+    }
+    if(s32Dump == 0)
+    {
+        s32Dump = (long)s_xDumps;
+    }
+    if((s32Dump < 1) || ((size_t)s32Dump > s_xDumps))
+    {
+        fprintf(stderr, "[export] dump %ld out of 1..%lu\n", s32Dump, (unsigned long)s_xDumps);
+        return 1;
+    }
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    Export_vDump(&s_pxDumps[s32Dump - 1]);
+    printf("\n]}\n");
+    fprintf(stderr, "[export] dump %ld of %lu: %lu records%s, %lu bad frames\n", s32Dump, (unsigned long)s_xDumps,
+            (unsigned long)s_pxDumps[s32Dump - 1].xRecords,
+            s_pxDumps[s32Dump - 1].bComplete ? "" : " (frames missing)", s_ulBadFrames);
+    return 0;
+}
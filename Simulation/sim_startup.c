@@ -0,0 +1,42 @@
+ /******************************************************************************
+ *
+ * Module: Simulation - Startup
+ *
+ * File Name: sim_startup.c
+ *
+ * Description: Host counterpart of tm4c123gh6pm_startup_ccs.c. Brings up the
+ *              virtual peripherals before main() and installs the interrupt
+ *              handlers of the application in the simulated NVIC, at the same
+ *              interrupt numbers as the target vector table.
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "sim_periph.h"
+#include "sim_regs.h"
+
+/*******************************************************************************
+ *                         External Interrupt Handlers                         *
+ *******************************************************************************/
+
+extern void GPIOPortA_Handler(void);
+extern void GPIOPortF_Handler(void);
+
+extern void ADC0Seq0_Handler(void);
+
+extern void UART0_Handler(void);
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+/* Runs before main(), in place of ResetISR on the target */
+__attribute__((constructor)) static void SimStartup_vReset(void)
+{
+    SimPeriph_vInit();
+
+    vPortSetInterruptHandler(SIM_IRQ_GPIOA,     GPIOPortA_Handler);
+    vPortSetInterruptHandler(SIM_IRQ_UART0,     UART0_Handler);
+    vPortSetInterruptHandler(SIM_IRQ_ADC0_SEQ0, ADC0Seq0_Handler);
+    vPortSetInterruptHandler(SIM_IRQ_GPIOF,     GPIOPortF_Handler);
+}
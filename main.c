@@ -1,25 +1,30 @@
 /* Kernel includes. */
 #include "FreeRTOS.h"
 #include "task.h"
-#include "event_groups.h"
 #include "semphr.h"
-#include "event_groups.h"
 
 #include "adc.h"
+#include "udma.h"
 #include "gpio.h"
 #include "uart0.h"
 #include "GPTM.h"
+#include "clock.h"
+#include "debounce.h"
+#include "temperature.h"
+#include "log.h"
+#include "telemetry.h"
+#include "runtime.h"
+#include "stack.h"
+#include "trace.h"
+#include "latency.h"
+#include "periodic.h"
+#include "sample.h"
+#include "heater.h"
+#include "pid.h"
+#include "tune.h"
+#include "console.h"
 #include "tm4c123gh6pm_registers.h"
 
-
-#define NUMBER_OF_ITERATIONS_PER_ONE_MILI_SECOND 369
-
-void Delay_MS(unsigned long long n)
-{
-    volatile unsigned long long count = 0;
-    while(count++ < (NUMBER_OF_ITERATIONS_PER_ONE_MILI_SECOND * n) );
-}
-
 /*
  *  Heater is initially @ off state, each button press will
  *  move to the next state.
@@ -33,6 +38,23 @@ void Delay_MS(unsigned long long n)
 #define MAKE_HEATER_MEDIUM_LEVEL     30
 #define MAKE_HEATER_HIGH_LEVEL       35
 
+/*
+ * Auto-tuning (see tune.h): a seat is tuned around its desired level, or
+ * around MAKE_HEATER_TUNE_LEVEL while it is off. The end of line tester, like
+ * anyone on the console, starts it with the "tune" command:
+ *
+ *  tune [seat]     tune the seat, or every seat, and store the gains found
+ *  abort [seat]    stop the tuning of the seat, or of every seat
+ *  gains [seat]    report the gains of the seat, or of every seat
+ *  trace           dump the kernel trace of the next button press handled
+ */
+#define MAKE_HEATER_TUNE_LEVEL       MAKE_HEATER_MEDIUM_LEVEL
+
+/* Console requests to the heater task, about the tuning of a seat */
+#define SEAT_TUNE_NONE               0
+#define SEAT_TUNE_START              1
+#define SEAT_TUNE_ABORT              2
+
 /*
  * If the temperature sensor reading exceeds the below range
  * the heater should be disabled and the red led should turns on
@@ -42,20 +64,17 @@ void Delay_MS(unsigned long long n)
 #define MINIMUM_TEMP_ACCEPTED        5
 
 /*
- *  Heater intensity depends on the value which is coming from
- *  the temperature sensor, if current temp. less than desired temp by (Desired Temp. - Temp. Sensor value) :
- *  HEATER_HIGH_INTENSITY_LIMIT -------> high intensity needed --------> turn on cyan led
- *  HEATER_MEDIUM_INTENSITY_LOW_LIMIT to HEATER_MEDIUM_INTENSITY_HIGH_LIMIT -------> medium intensity needed --------> turn on blue led
- *  HEATER_LOW_INTENSITY_LOW_LIMIT to  HEATER_LOW_INTENSITY_HIGH_LIMIT-------> medium intensity needed --------> turn on green led
+ *  The heater of a seat is driven by its PI loop (see heater.h) at a duty cycle
+ *  in permille, from the desired level and each temperature sensor sample.
+ *  The intensity shows the duty cycle in bands:
+ *  above HEATER_MEDIUM_INTENSITY_MAX_DUTY -------> high intensity --------> turn on cyan led
+ *  up to HEATER_MEDIUM_INTENSITY_MAX_DUTY -------> medium intensity ------> turn on blue led
+ *  up to HEATER_LOW_INTENSITY_MAX_DUTY ----------> low intensity ---------> turn on green led
+ *  0 ---------------------------------------------> heater disabled -------> leds off
  */
 
-#define HEATER_HIGH_INTENSITY_LIMIT             10
-
-#define HEATER_MEDIUM_INTENSITY_LOW_LIMIT       5
-#define HEATER_MEDIUM_INTENSITY_HIGH_LIMIT      10
-
-#define HEATER_LOW_INTENSITY_LOW_LIMIT          2
-#define HEATER_LOW_INTENSITY_HIGH_LIMIT         5
+#define HEATER_LOW_INTENSITY_MAX_DUTY           333
+#define HEATER_MEDIUM_INTENSITY_MAX_DUTY        667
 
 /*
  * Macros Mapped to the intensity of the heater
@@ -67,143 +86,430 @@ void Delay_MS(unsigned long long n)
 #define HEATER_DISABLED         3
 
 /*
- * Masks for ButtonsEventGroup
+ * Bit of each seat in the notification of the heater level task, set when one
+ * of its buttons is pressed
  */
 
-#define DRIVER_BUTTON_BIT_MASK                   (1UL << 0UL)
-#define PASSENGER_BUTTON_BIT_MASK                (1UL << 1UL)
+#define SEAT_BUTTON_BIT_MASK(SEAT)               (1UL << (SEAT))
 
+/*
+ * Heater outputs of the seats. The board has a single one, the RGB LED,
+ * which every seat drives.
+ */
+#define HEATER_OUTPUT_RGB_LED                    0
 
-#define DRIVER_SENSOR_FAILURE_BIT_MASK           (1UL << 2UL)
-#define PASSENGER_SENSOR_FAILURE_BIT_MASK        (1UL << 3UL)
+/*
+ * Temperature sampling period. Timer0A triggers the ADC sequence ADC_OVERSAMPLING
+ * times per period, the uDMA captures the conversions and each published
+ * temperature is the average of the ADC_OVERSAMPLING samples of its period.
+ */
+#define ADC_SAMPLE_PERIOD_MS                     500
+#define ADC_OVERSAMPLING                         16
+#define ADC_SAMPLE_PERIOD_TICKS                  (((configCPU_CLOCK_HZ / 1000) * ADC_SAMPLE_PERIOD_MS) / ADC_OVERSAMPLING)
 
+/*
+ * Run time statistics: the task loads are sampled every RUNTIME_SAMPLE_PERIOD_MS
+ * and reported over a sliding window of RUNTIME_WINDOW_SAMPLES samples (1 sec)
+ */
+#define RUNTIME_SAMPLE_PERIOD_MS                 250
 
-/* The HW setup function */
-static void prvSetupHardware( void );
+/*
+ * Console polling period: within it a line must fit the 16 characters of the
+ * UART0 receive FIFO (see console.h)
+ */
+#define CONSOLE_POLL_PERIOD_MS                   100
 
-/* Semaphores given From ADC as an indication that the conversion is done
- * to tell heater handling task it can starts its functionality
+/*
+ * Seats of the seat table (see axSeats), each one is a sensor step of the ADC sequence
  */
-xSemaphoreHandle xDriverHeaterSemaphore;
-xSemaphoreHandle xPassengerHeaterSemaphore;
+#define DRIVER_SEAT                              0
+#define PASSENGER_SEAT                           1
+#define SEATS_NUM                                2
 
-/* Task Handles */
+#define ADC_CAPTURE_SAMPLES                      (ADC_OVERSAMPLING * SEATS_NUM)
 
-TaskHandle_t xDesiredHeaterLevelHandle;
-TaskHandle_t xHeaterIntensityDriverHandle;
-TaskHandle_t xHeaterIntensityPassengerHandle;
-TaskHandle_t xADC_GetSensorValueHandle;
-TaskHandle_t xPrintTemperatureHandle;
-TaskHandle_t xDriverTemperatureSensorFailureHandle;
-TaskHandle_t xPassengerTemperatureSensorFailureHandle;
-TaskHandle_t xRunTimeMeasurementsHandle;
+/*
+ * Seats with their control path latencies measured (see latency.h), the first
+ * ones of the seat table
+ */
+#define LATENCY_SEATS_NUM                        ((SEATS_NUM < LATENCY_SEATS_MAX) ? SEATS_NUM : LATENCY_SEATS_MAX)
 
-/* Event Group set when the button pressed to change the heater level */
+/*
+ * Period of the telemetry frame reporting every seat, about 22 bytes on UART0
+ */
+#define TELEMETRY_PERIOD_MS                      1000
+
+/*
+ * Stack depth of each task in words, all stacks are allocated statically with
+ * room for their MPU guard (see stack.h)
+ */
+#define HEATER_LEVEL_TASK_STACK_SIZE             256
+#define HEATER_INTENSITY_TASK_STACK_SIZE         256
+#define PRINT_TEMPERATURE_TASK_STACK_SIZE        256
+#define RUNTIME_TASK_STACK_SIZE                  256
+#define CONTROL_TASK_STACK_SIZE                  256
+#define CONSOLE_TASK_STACK_SIZE                  256
+
+/*
+ * Events queued for the control task (CONTROL_QUEUE_SET in FreeRTOSConfig.h):
+ * at most a button and a sensor failure pending per seat. The sample ready
+ * event is the heater semaphore, the other member of the set.
+ */
+#define CONTROL_EVENT_QUEUE_LENGTH               (2 * SEATS_NUM)
+#define CONTROL_QUEUE_SET_LENGTH                 (CONTROL_EVENT_QUEUE_LENGTH + 1)
 
-EventGroupHandle_t xButtonsEventGroups;
+/*
+ * Index of the task notification signalling the heater level and intensity
+ * tasks (configTASK_NOTIFICATION_ARRAY_ENTRIES). Index 0 is left to the
+ * stream buffers, which block their tasks on it, and to the log service.
+ */
+#define CONTROL_NOTIFY_INDEX                     1
 
-/* Driver and Passenger current & next states which are initially MAKE_HEATER_OFF*/
+/*
+ * Interrupt numbers of the traced handlers (see trace.h), as in the vector
+ * table of tm4c123gh6pm_startup_ccs.c
+ */
+#define GPIOA_IRQ_NUMBER                         0
+#define ADC0_SEQ0_IRQ_NUMBER                     14
+#define GPIOF_IRQ_NUMBER                         30
 
-uint8_t ui8DriverSeatCurrentState = MAKE_HEATER_OFF;
-uint8_t ui8PassengerSeatCurrentState = MAKE_HEATER_OFF ;
+#if (SEATS_NUM > ADC_SEQ0_MAX_SAMPLES)
+#error "Every seat sensor needs a step of the ADC sequence"
+#endif
 
-uint32_t ui32DriverTimeSample    = 0;
-uint32_t ui32PassengerTimeSample = 0 ;
+#if (SEATS_NUM > HEATER_CHANNELS_MAX)
+#error "Every seat needs a heater channel"
+#endif
 
-uint8_t ui8DriverSeatNextState     = MAKE_HEATER_OFF;
-uint8_t ui8PassengerSeatNextState  = MAKE_HEATER_OFF;
+#if (SEATS_NUM > TUNE_SEATS_MAX)
+#error "The EEPROM must hold the tuned gains of every seat"
+#endif
 
-/* Driver and Passenger Heater states which is initially HEATER_DISABLED*/
+#if (SEATS_NUM > SAMPLE_RING_RECORDS)
+#error "The sample ring must hold a capture of every seat"
+#endif
 
-uint8_t ui8DriverHeaterIntensity    = HEATER_DISABLED;
-uint8_t ui8PassengerHeaterIntensity = HEATER_DISABLED;
+#if (SEATS_NUM > TELEMETRY_SEATS_MAX) || (TELEMETRY_FRAME_MAX_LENGTH > LOG_MESSAGE_MAX_LENGTH)
+#error "A telemetry frame of all the seats must fit in one log message"
+#endif
 
-/* Driver and Passenger states before failure and time of failure */
-uint8   ui8DriverFailureFlag;
-uint8_t ui8DriverStateBeforeFailure;
-uint32_t ui32DriverFailureTime;
+#if (LATENCY_SEATS_NUM > TELEMETRY_LATENCY_SEATS_MAX) || \
+    (TELEMETRY_LATENCY_FRAME_MAX_LENGTH > LOG_MESSAGE_MAX_LENGTH)
+#error "A latency report of the measured seats must fit in one log message"
+#endif
 
-uint8   ui8PassengerFailureFlag;
-uint8_t ui8PassengerStateBeforeFailure;
-uint32_t ui32PassengerFailureTime;
+#if (PERIODIC_TASKS_MAX > TELEMETRY_PERIODIC_TASKS_MAX) || (TELEMETRY_PERIODIC_FRAME_MAX_LENGTH > LOG_MESSAGE_MAX_LENGTH)
+#error "A report of all the periodic tasks must fit in one log message"
+#endif
 
-/* Variables to store the ADC output (Temperature values) */
-uint32_t u32ADC_DriverValue;
-uint32_t u32ADC_PassengerValue;
 
 /* The HW setup function */
 static void prvSetupHardware( void );
 
+/*
+ * Fixed description of a seat: its sensor, the buttons changing its level,
+ * its button bit (SEAT_BUTTON_BIT_MASK), its intensity output and its heater
+ */
+typedef struct
+{
+    uint8       u8SensorChannel;    /* Analog input AINx */
+    uint8       u8ButtonsMask;      /* DEBOUNCE_BUTTON_MASK of each of its buttons */
+    uint32      u32ButtonBit;
+    uint8       u8Output;           /* HEATER_OUTPUT_xxx */
+    uint8       u8Heater;           /* Heater channel (heater.h) */
+} Seat_Descriptor;
+
+/* Events of the control task, the seat they are about if any */
+typedef enum
+{
+    CONTROL_EVENT_SAMPLE,       /* The sensors of every seat are converted */
+    CONTROL_EVENT_BUTTON,       /* A button of the seat is pressed */
+    CONTROL_EVENT_FAILURE,      /* The sensor of the seat has failed */
+    CONTROL_EVENT_TICK          /* Telemetry period, when the wait for the others times out */
+} Control_EventType;
+
+typedef struct
+{
+    uint8 u8Type;               /* Control_EventType */
+    uint8 u8Seat;
+} Control_Event;
+
+/* Run time state of a seat, levels in degC */
+typedef struct
+{
+    uint8  u8CurrentLevel;          /* Level the heater regulates to */
+    uint8  u8NextLevel;             /* Desired level, set by the buttons */
+    uint8  u8Intensity;
+    uint16 u16Duty;                 /* Heater duty cycle in permille */
+    uint8  u8FailureFlag;
+    uint8  u8LevelBeforeFailure;
+    uint64 u64TimeSample;           /* WTimer0 timebase in usec of the last sample taken without a sensor failure */
+    uint64 u64FailureTime;
+    Pid_Controller xPid;
+    boolean bGainsTuned;            /* The loop runs on tuned gains, not on those of heater.h */
+
+    /* Auto-tuning, the relay drives the heater while it runs */
+    Tune_Relay xTune;
+    volatile uint8 u8TuneRequest;   /* SEAT_TUNE_xxx, from the console task to the heater task */
+    volatile boolean bGainsToStore; /* Tuned, for the console task to store */
+
+    /* Latest converted temperature sample in 0.01 degC (see temperature.h),
+     * taken from the sample ring by the heater task */
+    uint32 u32Temperature;
+} Seat_State;
+
+/* The seat table: one descriptor per seat, its sensor at its own step of the ADC sequence */
+static const Seat_Descriptor axSeats[SEATS_NUM] =
+{
+    /* Driver seat: AIN0 (PE3), SW1 and the external button */
+    { 0, DEBOUNCE_BUTTON_MASK(DEBOUNCE_SW1) | DEBOUNCE_BUTTON_MASK(DEBOUNCE_EXT),
+      SEAT_BUTTON_BIT_MASK(DRIVER_SEAT), HEATER_OUTPUT_RGB_LED, 0 },
+    /* Passenger seat: AIN1 (PE2), SW2 */
+    { 1, DEBOUNCE_BUTTON_MASK(DEBOUNCE_SW2),
+      SEAT_BUTTON_BIT_MASK(PASSENGER_SEAT), HEATER_OUTPUT_RGB_LED, 1 },
+};
+
+/* Every seat is initially MAKE_HEATER_OFF with its heater HEATER_DISABLED */
+static Seat_State axSeatStates[SEATS_NUM];
+
+static const Pid_Gains xHeaterGains = { HEATER_PID_KP, HEATER_PID_KI, HEATER_PID_KD };
+
+#if CONTROL_QUEUE_SET
+/* Semaphore given From ADC as an indication that the conversion of every seat
+ * sensor is done, to tell the control task it can start its functionality.
+ * The tasks of the other architecture are notified directly. */
+xSemaphoreHandle xHeaterSemaphore;
+static StaticSemaphore_t xHeaterSemaphoreBuffer;
+
+/* The control task blocks on the heater semaphore and on the queue of the
+ * other events at once */
+static QueueSetHandle_t xControlQueueSet;
+static StaticQueue_t xControlQueueSetBuffer;
+static uint8 au8ControlQueueSetStorage[CONTROL_QUEUE_SET_LENGTH * sizeof(QueueSetMemberHandle_t)];
+
+static QueueHandle_t xControlEventQueue;
+static StaticQueue_t xControlEventQueueBuffer;
+static uint8 au8ControlEventQueueStorage[CONTROL_EVENT_QUEUE_LENGTH * sizeof(Control_Event)];
+#endif
+
+/* uDMA ping-pong capture of the seat sensors, one sampling period per half */
+static uint16 au16AdcCapture[2 * ADC_CAPTURE_SAMPLES];
+
+/* Task Handles */
+
+#if CONTROL_QUEUE_SET
+TaskHandle_t xControlHandle;
+#else
+TaskHandle_t xDesiredHeaterLevelHandle;
+TaskHandle_t xHeaterIntensityHandle;
+#endif
+
+/* Task stacks and TCBs, the idle and timer service tasks included */
+
+#if CONTROL_QUEUE_SET
+static StackType_t xControlStack[STACK_GUARD_WORDS + CONTROL_TASK_STACK_SIZE];
+#else
+static StackType_t xDesiredHeaterLevelStack[STACK_GUARD_WORDS + HEATER_LEVEL_TASK_STACK_SIZE];
+static StackType_t xHeaterIntensityStack[STACK_GUARD_WORDS + HEATER_INTENSITY_TASK_STACK_SIZE];
+static StackType_t xPrintTemperatureStack[STACK_GUARD_WORDS + PRINT_TEMPERATURE_TASK_STACK_SIZE];
+#endif
+static StackType_t xRunTimeMeasurementsStack[STACK_GUARD_WORDS + RUNTIME_TASK_STACK_SIZE];
+static StackType_t xConsoleStack[STACK_GUARD_WORDS + CONSOLE_TASK_STACK_SIZE];
+static StackType_t xIdleStack[STACK_GUARD_WORDS + configMINIMAL_STACK_SIZE];
+static StackType_t xTimerServiceStack[STACK_GUARD_WORDS + configTIMER_TASK_STACK_DEPTH];
+
+#if CONTROL_QUEUE_SET
+static StaticTask_t xControlTCB;
+#else
+static StaticTask_t xDesiredHeaterLevelTCB;
+static StaticTask_t xHeaterIntensityTCB;
+static StaticTask_t xPrintTemperatureTCB;
+#endif
+static StaticTask_t xRunTimeMeasurementsTCB;
+static StaticTask_t xConsoleTCB;
+static StaticTask_t xIdleTCB;
+static StaticTask_t xTimerServiceTCB;
+
+/* Start of the button path latencies (see latency.h), WTimer0 cycles.
+ * The edge time is taken by the first button edge after the debouncer unmasks
+ * the edges, and it is pending until the desired level task has handled the
+ * press. The sensor path starts at the timestamp of each sample record. */
+volatile uint32 u32ButtonEdgeCycles;
+volatile boolean bButtonEdgePending;
+
+/* Set by the console "trace" command: the next press handled triggers the kernel trace */
+static volatile boolean bTraceArmed;
+
 /* FreeRTOS tasks */
+#if CONTROL_QUEUE_SET
+void vControlTask(void *pvParameters);
+#else
 void vDesiredHeaterLevelTask(void *pvParameters);
-void vHeaterIntensityDriverTask(void *pvParameters);
-void vHeaterIntensityPassengerTask(void *pvParameters);
-void vADC_StartConversionTask(void *pvParameters);
-void vPrintTemperatureTask(void *pvParameters);
-void vDriverTemperatureSensorFailureTask(void *pvParameters);
-void vPassengerTemperatureSensorFailureTask(void *pvParameters);
-void vRunTimeMeasurementsTask(void *pvParameters);
+void vHeaterIntensityTask(void *pvParameters);
+#endif
+void vPrintTemperatureJob(void *pvParameters);
+void vRunTimeMeasurementsJob(void *pvParameters);
+void vConsoleJob(void *pvParameters);
 
 
 void ADC_Init(void);
-void vHeater_Action(uint8_t Temp_diff,uint8_t *Intensity_ReturnState,
-                    uint8 Seat_CurrentState,uint32_t UserTemperature,uint8 *TempSensorFailure_Flag);
-/*
- * Arrays for Run Time Measurements
- */
-uint32 ullTasksOutTime[9];
-uint32 ullTasksInTime[9];
-uint32 ullTasksTotalTime[9];
+static void prvButtonsPressed(uint8 u8PressedMask);
+static void prvButtonIsrMeasure(uint32 u32IsrStartCycles);
+static void prvPostTaskName(const RunTime_Task *pxTask);
+static void prvPostLatencies(void);
+static void prvPostPeriodic(void);
+static void prvSeatLevel(uint8 u8Seat);
+static void prvSeatsHeater(void);
+static void prvSeatHeater(const Sample_Record *pxSample);
+static void prvSeatFailure(uint8 u8Seat);
+static void prvSeatTuneRequest(uint8 u8Seat);
+static void prvSeatTuned(uint8 u8Seat);
+static void prvConsoleLine(uint8 u8Words, const char *const apcWords[]);
+static void prvPostGains(uint8 u8Seat);
+static void prvTracePress(void);
+#if CONTROL_QUEUE_SET
+static void prvControlPost(uint8 u8Type, uint8 u8Seat);
+#endif
+static void prvFillTelemetrySeat(Telemetry_Seat *pxReport, uint8 u8Seat);
+static uint32 prvAverageSensor(const uint16 *pu16Samples, uint8 u8Sensor);
+static void prvHeaterOutput(uint8 u8Output, uint8 u8Intensity, uint8 u8FailureFlag);
+void vHeater_Action(uint8 u8Seat, uint32 UserTemperature);
+
+/* Periodic tasks, their priorities in rate monotonic order (see periodic.h) */
+#if !CONTROL_QUEUE_SET
+static Periodic_Task xPrintTemperatureTask =
+{
+    "Temp. print", vPrintTemperatureJob, NULL, TELEMETRY_PERIOD_MS, 0, PERIODIC_PRIORITY_AUTO,
+    PRINT_TEMPERATURE_TASK_STACK_SIZE, xPrintTemperatureStack, &xPrintTemperatureTCB
+};
+#endif
+static Periodic_Task xRunTimeMeasurementsTask =
+{
+    "Run time", vRunTimeMeasurementsJob, NULL, RUNTIME_SAMPLE_PERIOD_MS, 0, PERIODIC_PRIORITY_AUTO,
+    RUNTIME_TASK_STACK_SIZE, xRunTimeMeasurementsStack, &xRunTimeMeasurementsTCB
+};
+/* A background service: at the lowest priority, whatever its rate, as it waits on the EEPROM */
+static Periodic_Task xConsoleTask =
+{
+    "Console", vConsoleJob, NULL, CONSOLE_POLL_PERIOD_MS, 0, PERIODIC_PRIORITY_LOWEST,
+    CONSOLE_TASK_STACK_SIZE, xConsoleStack, &xConsoleTCB
+};
+
+/* Duration of the last and of the longest button GPIO interrupt in CPU cycles */
+uint32 u32ButtonIsrCycles;
+uint32 u32ButtonIsrMaxCycles;
 
 int main()
 {
+    Pid_Gains xTunedGains;
+    uint8 u8Seat;
+
     /* Setup the hardware for use with the Tiva C board. */
     prvSetupHardware();
+    Stack_vInit();
 
-    /* Create a binary semaphore */
-
-    xDriverHeaterSemaphore = xSemaphoreCreateBinary();
-    xPassengerHeaterSemaphore = xSemaphoreCreateBinary();
-    xButtonsEventGroups = xEventGroupCreate();
-
-    /* Create Tasks here */
-    xTaskCreate(vDesiredHeaterLevelTask,"Heater Level Task", 256 , NULL, 2, &xDesiredHeaterLevelHandle);
+    /* Each seat runs on the gains tuned for it, when the EEPROM holds them */
+    (void)Tune_bInit();
+    for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
+    {
+        axSeatStates[u8Seat].u8CurrentLevel = MAKE_HEATER_OFF;
+        axSeatStates[u8Seat].u8NextLevel = MAKE_HEATER_OFF;
+        axSeatStates[u8Seat].u8Intensity = HEATER_DISABLED;
+        axSeatStates[u8Seat].bGainsTuned = Tune_bLoadGains(u8Seat, &xTunedGains);
+        Pid_vInit(&axSeatStates[u8Seat].xPid, axSeatStates[u8Seat].bGainsTuned ? &xTunedGains : &xHeaterGains,
+                  0, HEATER_DUTY_FULL);
+    }
 
-    xTaskCreate(vHeaterIntensityDriverTask,"Heater Intensity Task1", 256 , NULL, 2, &xHeaterIntensityDriverHandle);
-    xTaskCreate(vHeaterIntensityPassengerTask,"Heater Intensity Task2", 256 , NULL, 2, &xHeaterIntensityPassengerHandle);
+#if CONTROL_QUEUE_SET
+    /* Create a binary semaphore */
 
-    xTaskCreate(vADC_StartConversionTask,"ADC get Value", 256 , NULL, 4, &xADC_GetSensorValueHandle);
-    xTaskCreate(vPrintTemperatureTask,"Temp. print", 256 , NULL, 3, &xPrintTemperatureHandle);
+    xHeaterSemaphore = xSemaphoreCreateBinaryStatic(&xHeaterSemaphoreBuffer);
+    Trace_vNameObject((uint8)uxQueueGetQueueNumber(xHeaterSemaphore), "Heater semaphore");
+    /* This kernel has no static xQueueCreateSet(): a set is a queue of member handles */
+    xControlQueueSet = xQueueGenericCreateStatic(CONTROL_QUEUE_SET_LENGTH, sizeof(QueueSetMemberHandle_t),
+                                                 au8ControlQueueSetStorage, &xControlQueueSetBuffer, queueQUEUE_TYPE_SET);
+    xControlEventQueue = xQueueCreateStatic(CONTROL_EVENT_QUEUE_LENGTH, sizeof(Control_Event),
+                                            au8ControlEventQueueStorage, &xControlEventQueueBuffer);
+    xQueueAddToSet(xHeaterSemaphore, xControlQueueSet);
+    xQueueAddToSet(xControlEventQueue, xControlQueueSet);
+    Trace_vNameObject((uint8)uxQueueGetQueueNumber(xControlQueueSet), "Control queue set");
+    Trace_vNameObject((uint8)uxQueueGetQueueNumber(xControlEventQueue), "Control events");
+#endif
+    Debounce_vInit(prvButtonsPressed);
+    Log_vInit();
+    Console_vInit(prvConsoleLine);
+
+    /* Create Tasks here, one of each for all the seats */
+#if CONTROL_QUEUE_SET
+    xControlHandle = xTaskCreateStatic(vControlTask,"Control Task", CONTROL_TASK_STACK_SIZE , NULL, 2,
+                                       &xControlStack[STACK_GUARD_WORDS], &xControlTCB);
+#else
+    xDesiredHeaterLevelHandle = xTaskCreateStatic(vDesiredHeaterLevelTask,"Heater Level Task", HEATER_LEVEL_TASK_STACK_SIZE , NULL, 2,
+                                                  &xDesiredHeaterLevelStack[STACK_GUARD_WORDS], &xDesiredHeaterLevelTCB);
+
+    xHeaterIntensityHandle = xTaskCreateStatic(vHeaterIntensityTask,"Heater Intensity Task", HEATER_INTENSITY_TASK_STACK_SIZE , NULL, 2,
+                                               &xHeaterIntensityStack[STACK_GUARD_WORDS], &xHeaterIntensityTCB);
+
+    Periodic_vCreate(&xPrintTemperatureTask);
+#endif
+    Periodic_vCreate(&xRunTimeMeasurementsTask);
+    Periodic_vCreate(&xConsoleTask);
+    Periodic_vStart();
 
-    xTaskCreate(vDriverTemperatureSensorFailureTask,"Temperature Sensor failure", 256 , NULL, 3, &xDriverTemperatureSensorFailureHandle);
-    xTaskCreate(vPassengerTemperatureSensorFailureTask,"Temperature Sensor failure", 256 , NULL, 3, &xPassengerTemperatureSensorFailureHandle);
+    vTaskStartScheduler();
 
-    xTaskCreate(vRunTimeMeasurementsTask, "Run time", 256, NULL, 1, &xRunTimeMeasurementsHandle);
+    /* Should never reach here! The idle and timer service tasks are static,
+    so the scheduler cannot fail to start. */
+    for (;;);
 
-    /* Set Tag for each task */
-    vTaskSetApplicationTaskTag( xDesiredHeaterLevelHandle, ( TaskHookFunction_t ) 1 );
-    vTaskSetApplicationTaskTag( xHeaterIntensityDriverHandle, ( TaskHookFunction_t ) 2 );
-    vTaskSetApplicationTaskTag( xHeaterIntensityPassengerHandle, ( TaskHookFunction_t ) 3 );
-    vTaskSetApplicationTaskTag( xADC_GetSensorValueHandle, ( TaskHookFunction_t ) 4 );
-    vTaskSetApplicationTaskTag( xPrintTemperatureHandle, ( TaskHookFunction_t ) 5 );
-    vTaskSetApplicationTaskTag( xDriverTemperatureSensorFailureHandle, ( TaskHookFunction_t ) 6 );
-    vTaskSetApplicationTaskTag( xPassengerTemperatureSensorFailureHandle, ( TaskHookFunction_t ) 7 );
-    vTaskSetApplicationTaskTag( xRunTimeMeasurementsHandle, ( TaskHookFunction_t ) 8 );
+}
 
-    vTaskStartScheduler();
+/* Memory of the idle task, asked for by the kernel with configSUPPORT_STATIC_ALLOCATION */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &xIdleTCB;
+    *ppxIdleTaskStackBuffer = &xIdleStack[STACK_GUARD_WORDS];
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
 
-    /* Should never reach here!  If you do then there was not enough heap
-    available for the idle task to be created. */
-    for (;;);
+/* Memory of the timer service task, asked for by the kernel with configSUPPORT_STATIC_ALLOCATION */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &xTimerServiceTCB;
+    *ppxTimerTaskStackBuffer = &xTimerServiceStack[STACK_GUARD_WORDS];
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
 
+#if HEATER_SOFTWARE_PWM
+/* Time proportioned heater outputs, every tick */
+void vApplicationTickHook(void)
+{
+    Heater_vTickFromISR();
 }
+#endif
 
 static void prvSetupHardware( void )
 {
+    uint8 au8SensorChannels[SEATS_NUM];
+    uint8 u8Seat;
+
+    for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
+    {
+        au8SensorChannels[u8Seat] = axSeats[u8Seat].u8SensorChannel;
+    }
+
     /* Place here any needed HW initialization such as GPIO, UART, etc.  */
+    CLOCK_vInit();
     GPTM_WTimer0Init();
     UART0_Init();
-    ADC_vInit();
+    UDMA_vInit();
+    UART0_SetTxMode(UART0_TX_MODE_DMA);
+    ADC_vInit(au8SensorChannels, SEATS_NUM, ADC_TRIGGER_TIMER);
+    ADC_vCaptureInit(au16AdcCapture, ADC_CAPTURE_SAMPLES);
+    GPTM_Timer0ADCTriggerInit(ADC_SAMPLE_PERIOD_TICKS);
+    Heater_vInit(SEATS_NUM);
     GPIO_BuiltinButtonsLedsInit();
     GPIO_ButtonInit();
     GPIO_SW1EdgeTriggeredInterruptInit();
@@ -213,421 +519,800 @@ static void prvSetupHardware( void )
 
 /*
  * (Periodic Task)
- * Runtime Measurements task: Calculate the CPU Load
+ * Runtime Measurements job: Sample the run time counter of every task and
+ * report the CPU load of the busy tasks and of the whole CPU once per window,
+ * with every stack high watermark that rose since the last window, the
+ * latencies of every control path that ran and the scheduling statistics of
+ * the periodic tasks.
  */
 
-void vRunTimeMeasurementsTask(void *pvParameters)
+void vRunTimeMeasurementsJob(void *pvParameters)
 {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint32 time = 0;
-    const TickType_t xDelay2100ms = pdMS_TO_TICKS(2100);
-    for (;;)
+    static uint8 u8Sample = 0;
+    TaskHandle_t xIdle = xTaskGetIdleTaskHandle();
+    const RunTime_Task *pxTask;
+    const Stack_Task *pxStack;
+    uint8 u8Task;
+
+    RunTime_vSample();
+    for(u8Task = 0; u8Task < RunTime_u8Tasks(); u8Task++)
     {
-        uint8 ucCounter, ucCPU_Load;
-        uint32 ullTotalTasksTime = 0;
-        vTaskDelayUntil(&xLastWakeTime, xDelay2100ms);
-        for(ucCounter = 1; ucCounter < 7; ucCounter++)
+        if(RunTime_pxTask(u8Task)->bNew)
         {
-            ullTotalTasksTime += ullTasksTotalTime[ucCounter];
+            prvPostTaskName(RunTime_pxTask(u8Task));
         }
+    }
 
-        ucCPU_Load = (ullTotalTasksTime * 100) /  GPTM_WTimer0Read();
+    if(++u8Sample < RUNTIME_WINDOW_SAMPLES)
+    {
+        return;
+    }
+    u8Sample = 0;
 
-        taskENTER_CRITICAL();
-        UART0_SendString("\r\n");
-        UART0_SendString("CPU Load is ");
-        UART0_SendInteger(ucCPU_Load);
-        UART0_SendString("%\r\n");
-        UART0_SendString("---------------------------------------------------------\r\n");
-        taskEXIT_CRITICAL();
+    LOG_DEFER2(LOG_FMT_CPU_LOAD, RunTime_u16Load(), RunTime_u16PeakLoad());
+    for(u8Task = 0; u8Task < RunTime_u8Tasks(); u8Task++)
+    {
+        pxTask = RunTime_pxTask(u8Task);
+        if((pxTask->u16Load != 0) && (pxTask->xHandle != xIdle))
+        {
+            LOG_DEFER3(LOG_FMT_TASK_LOAD, pxTask->uxNumber, pxTask->u16Load, pxTask->u16PeakLoad);
+        }
+    }
+    Stack_vSample();
+    for(u8Task = 0; u8Task < Stack_u8Tasks(); u8Task++)
+    {
+        pxStack = Stack_pxTask(u8Task);
+        if(pxStack->bChanged)
+        {
+            LOG_DEFER3(LOG_FMT_TASK_STACK, pxStack->uxNumber, pxStack->u16Used, pxStack->u16Depth);
+        }
+    }
+    if(Stack_pxMain()->bChanged)
+    {
+        LOG_DEFER2(LOG_FMT_MAIN_STACK, Stack_pxMain()->u16Used, Stack_pxMain()->u16Depth);
+    }
+    prvPostLatencies();
+    prvPostPeriodic();
+    LOG_DEFER3(LOG_FMT_BUTTON_ISR, u32ButtonIsrCycles, u32ButtonIsrMaxCycles,
+               u32ButtonIsrMaxCycles / CLOCK_CYCLES_PER_US);
+    LOG_DEFER3(LOG_FMT_DROPPED, Log_u32Dropped(LOG_CHANNEL_TEMPERATURE),
+               Log_u32Dropped(LOG_CHANNEL_RUNTIME) + Log_u32Dropped(LOG_CHANNEL_CONSOLE), Log_u32DeferredDropped());
+    if(Sample_u32Dropped() != 0)
+    {
+        LOG_DEFER1(LOG_FMT_SAMPLES_DROPPED, Sample_u32Dropped());
     }
 }
 
-
 /*
- * (Event based Task)
- * Desired Heater Level Task: Waiting for Events to be set in xButtonsEventGroups
- * and depending on the bit that has been set (Driver or Passenger) , the task changes
- * the User current state to the next state and this task returns vHeaterIntensityDriverTask or vHeaterIntensityPassengerTask
- * to ready state when the state is MAKE_HEATER_LOW_LEVEL (the state after MAKE_HEATER_OFF)
+ * (Periodic Task)
+ * Console job: store the gains of every seat tuned since the last job in the
+ * EEPROM, send the kernel trace once it is triggered, then handle the command
+ * lines received (see prvConsoleLine). The dump blocks the job for seconds:
+ * that job is left out of the periodic statistics.
  */
 
-void vDesiredHeaterLevelTask(void *pvParameters)
+void vConsoleJob(void *pvParameters)
 {
-    const EventBits_t xBitsToWaitFor = (PASSENGER_BUTTON_BIT_MASK | DRIVER_BUTTON_BIT_MASK);
-    EventBits_t xEventGroupValue;
+    Seat_State *pxState;
+    Pid_Gains xGains;
+    uint8 u8Seat;
 
-    for(;;)
+    for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
     {
-        xEventGroupValue = xEventGroupWaitBits(xButtonsEventGroups, xBitsToWaitFor, pdTRUE, pdFALSE, portMAX_DELAY);
-        if(DRIVER_BUTTON_BIT_MASK & xEventGroupValue)
+        pxState = &axSeatStates[u8Seat];
+        if(!pxState->bGainsToStore)
         {
-            switch(ui8DriverSeatNextState)
-            {
-            case MAKE_HEATER_OFF:           ui8DriverSeatNextState = MAKE_HEATER_LOW_LEVEL;    break;
-            case MAKE_HEATER_LOW_LEVEL:     ui8DriverSeatNextState = MAKE_HEATER_MEDIUM_LEVEL; break;
-            case MAKE_HEATER_MEDIUM_LEVEL:  ui8DriverSeatNextState = MAKE_HEATER_HIGH_LEVEL;   break;
-            case MAKE_HEATER_HIGH_LEVEL:    ui8DriverSeatNextState = MAKE_HEATER_OFF;          break;
-            default: break;
-            }
-
-            if(ui8DriverSeatNextState == MAKE_HEATER_LOW_LEVEL)
-            {
-                vTaskResume(xHeaterIntensityDriverHandle);
-            }
+            continue;
         }
+        taskENTER_CRITICAL();
+        xGains = pxState->xPid.xGains;
+        pxState->bGainsToStore = FALSE;
+        taskEXIT_CRITICAL();
 
-        if(PASSENGER_BUTTON_BIT_MASK & xEventGroupValue)
+        if(Tune_bStoreGains(u8Seat, &xGains))
         {
-            switch(ui8PassengerSeatNextState)
-            {
-            case MAKE_HEATER_OFF:           ui8PassengerSeatNextState = MAKE_HEATER_LOW_LEVEL;    break;
-            case MAKE_HEATER_LOW_LEVEL:     ui8PassengerSeatNextState = MAKE_HEATER_MEDIUM_LEVEL; break;
-            case MAKE_HEATER_MEDIUM_LEVEL:  ui8PassengerSeatNextState = MAKE_HEATER_HIGH_LEVEL;   break;
-            case MAKE_HEATER_HIGH_LEVEL:    ui8PassengerSeatNextState = MAKE_HEATER_OFF;          break;
-            default: break;
-            }
-
-            if(ui8PassengerSeatNextState == MAKE_HEATER_LOW_LEVEL)
-            {
-                vTaskResume(xHeaterIntensityPassengerHandle);
-            }
+            LOG_DEFER1(LOG_FMT_GAINS_STORED, u8Seat);
         }
-
+        else
+        {
+            LOG_DEFER1(LOG_FMT_GAINS_NOT_STORED, u8Seat);
+        }
+        prvPostGains(u8Seat);
     }
+    if(Trace_bTriggered())
+    {
+        Trace_vDump(LOG_CHANNEL_CONSOLE);
+        Periodic_vDiscardJob(&xConsoleTask);
+    }
+    Console_vPoll();
 }
 
+
+#if CONTROL_QUEUE_SET
+
 /*
- * (Periodic Task)
- * ADc Start Converion Task: Start the Conversion of the ADC
- *
+ * (Event based Task)
+ * Control Task: runs every control activity of every seat to completion, one
+ * event at a time, blocked on the heater semaphore given by the ADC capture
+ * interrupt and on the queue of the other events:
+ *  - sample ready: the heater of each seat that is on
+ *  - button: the next desired level of the seat, then the kernel trace when armed
+ *  - failure: saves the state & time at which the failure of the seat occurred
+ *  - tick: the telemetry frame of all seats, once per TELEMETRY_PERIOD_MS; the
+ *    task times its own ticks with the timeout of its wait
  */
 
-void vADC_StartConversionTask(void *pvParameters)
+void vControlTask(void *pvParameters)
 {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xDelay500ms = pdMS_TO_TICKS(500);
+    const TickType_t xPeriod = pdMS_TO_TICKS(TELEMETRY_PERIOD_MS);
+    TickType_t xTick = xTaskGetTickCount() + xPeriod;
+    TickType_t xWait;
+    QueueSetMemberHandle_t xMember;
+    Control_Event xEvent;
+
     for(;;)
     {
+        /* No wait once the tick is due, a late tick is past it by less than a period */
+        xWait = xTick - xTaskGetTickCount();
+        xMember = xQueueSelectFromSet(xControlQueueSet, (xWait <= xPeriod) ? xWait : 0);
+        if(xMember == NULL)
+        {
+            xEvent.u8Type = CONTROL_EVENT_TICK;
+            xEvent.u8Seat = 0;
+            xTick += xPeriod;
+        }
+        else if(xMember == xHeaterSemaphore)
+        {
+            (void)xSemaphoreTake(xHeaterSemaphore, 0);
+            xEvent.u8Type = CONTROL_EVENT_SAMPLE;
+            xEvent.u8Seat = 0;
+        }
+        else if(xQueueReceive(xControlEventQueue, &xEvent, 0) != pdTRUE)
+        {
+            continue;
+        }
 
-        ADC0_vStartConversion();
-        ADC1_vStartConversion();
-
-        vTaskDelayUntil(&xLastWakeTime, xDelay500ms);
+        switch(xEvent.u8Type)
+        {
+        case CONTROL_EVENT_SAMPLE:
+            prvSeatsHeater();
+            break;
+        case CONTROL_EVENT_BUTTON:
+            prvSeatLevel(xEvent.u8Seat);
+            bButtonEdgePending = FALSE;
+            prvTracePress();
+            break;
+        case CONTROL_EVENT_FAILURE:
+            prvSeatFailure(xEvent.u8Seat);
+            break;
+        case CONTROL_EVENT_TICK:
+            vPrintTemperatureJob(NULL);
+            break;
+        default:
+            break;
+        }
     }
 }
 
+#else
+
 /*
- * (Event based task)
- * The Task is waiting for the Passenger semaphore
- * when it becomes true the passenger heater should start working.
- * If the user state is(MAKE_HEATER_OFF) the task suspends itself.
- * The task also saves the state and time when a failure occurs.
+ * (Event based Task)
+ * Desired Heater Level Task: Waiting for the button bits notified by the
+ * debouncer and for the bit of each seat that has been set, the task changes the desired
+ * level of that seat to the next one; the heater intensity task takes it over
+ * at the next sensor capture.
+ * The press handled after the console "trace" command triggers the kernel trace,
+ * which then holds the path of the press from the button interrupt to here.
  */
 
-void vHeaterIntensityDriverTask(void *pvParameters)
+void vDesiredHeaterLevelTask(void *pvParameters)
 {
-    uint32_t DriverTempDifference    = 0;
+    uint32_t ulButtonBits;
+    uint8 u8Seat;
+
     for(;;)
     {
-       if( pdTRUE == xSemaphoreTake(xDriverHeaterSemaphore,portMAX_DELAY) )
+        (void)xTaskNotifyWaitIndexed(CONTROL_NOTIFY_INDEX, 0, 0xFFFFFFFFUL, &ulButtonBits, portMAX_DELAY);
+        for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
         {
-
-            DriverTempDifference    = ui8DriverSeatCurrentState - u32ADC_DriverValue;
-            vHeater_Action(DriverTempDifference,&ui8DriverHeaterIntensity,
-                           ui8DriverSeatNextState,u32ADC_DriverValue,&ui8DriverFailureFlag);
-            if(ui8DriverSeatNextState == MAKE_HEATER_OFF)
+            if(axSeats[u8Seat].u32ButtonBit & ulButtonBits)
             {
-                vTaskSuspend(NULL);
+                prvSeatLevel(u8Seat);
             }
-            if(!ui8DriverFailureFlag)
-            {
-                ui8DriverSeatCurrentState = ui8DriverSeatNextState;
-                ui32DriverTimeSample = GPTM_WTimer0Read();
-            }
-            if(ui8DriverFailureFlag)
-            {
-                xEventGroupSetBits(xButtonsEventGroups, DRIVER_SENSOR_FAILURE_BIT_MASK);
-            }
-
         }
 
+        bButtonEdgePending = FALSE;
+        prvTracePress();
     }
 }
 
 /*
  * (Event based task)
- * The Task is waiting for the Passenger semaphore
- * when it becomes true the passenger heater should start working.
- * If the user state is(MAKE_HEATER_OFF) the task suspends itself.
- * The task also saves the state and time when a failure occurs.
+ * The Task is waiting for the notification of the ADC capture interrupt, once
+ * the sensors of every seat are converted, then runs the heater of each seat that is on.
+ * A seat switched to MAKE_HEATER_OFF has its heater disabled once and is left
+ * alone until its level is raised again.
  */
 
-void vHeaterIntensityPassengerTask(void *pvParameters)
+void vHeaterIntensityTask(void *pvParameters)
 {
-    uint32_t PassengerTempDifference = 0;
     for(;;)
     {
-
-        if( pdTRUE == xSemaphoreTake(xPassengerHeaterSemaphore,portMAX_DELAY) )
+        if( ulTaskNotifyTakeIndexed(CONTROL_NOTIFY_INDEX, pdTRUE, portMAX_DELAY) != 0 )
         {
-            PassengerTempDifference = ui8PassengerSeatCurrentState - u32ADC_PassengerValue;
-            vHeater_Action(PassengerTempDifference,&ui8PassengerHeaterIntensity,
-                           ui8PassengerSeatNextState,u32ADC_PassengerValue,&ui8PassengerFailureFlag);
+            prvSeatsHeater();
+        }
+    }
+}
 
-            if(ui8PassengerSeatNextState == MAKE_HEATER_OFF)
-            {
-                vTaskSuspend(NULL);
-            }
-            if(!ui8PassengerFailureFlag)
-            {
-                ui8PassengerSeatCurrentState = ui8PassengerSeatNextState;
-                ui32PassengerTimeSample = GPTM_WTimer0Read();
-            }
+#endif
 
-            if(ui8PassengerFailureFlag)
-            {
-                xEventGroupSetBits(xButtonsEventGroups, PASSENGER_SENSOR_FAILURE_BIT_MASK);
+/*(Periodic task, or the tick of the control task)
+ * Report application information of every seat
+ * (Temperature, Desired level, Heater intensity, Sensor failure)
+ * as one binary telemetry frame for all seats (see telemetry.h)
+ */
 
-            }
+void vPrintTemperatureJob(void *pvParameters)
+{
+    Telemetry_Seat axReports[SEATS_NUM];
+    Log_Message xFrame;
+    uint8 u8Seat;
 
-        }
+    for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
+    {
+        prvFillTelemetrySeat(&axReports[u8Seat], u8Seat);
     }
+    xFrame.u16Length = Telemetry_u16BuildSeatsFrame(axReports, SEATS_NUM, (uint32)GPTM_WTimer0ReadUs(), xFrame.au8Data);
+    Log_bPost(LOG_CHANNEL_TEMPERATURE, &xFrame);
 }
 
-/*(Periodic task)
- * Print application information of Driver & Passenger
- * (Temperature Current state,Heater intensity Level)
- */
 
-void vPrintTemperatureTask(void *pvParameters)
+/*************************************************/
+
+/* uDMA completion: a whole sampling period of the seat sensors is captured */
+void ADC0Seq0_Handler(void)
 {
-    const TickType_t xDelay1000ms = pdMS_TO_TICKS(1000);
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    for(;;)
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    const uint16 *pu16Samples;
+    Sample_Record xSample;
+    uint8 u8Seat;
+    xSample.u32Timestamp = GPTM_WTimer0Read32();
+    Trace_vIsrEnter(ADC0_SEQ0_IRQ_NUMBER);
+    SET_BIT(ADC0_ISC,0);
+    while( (pu16Samples = ADC0_pu16CaptureDone()) != NULL_PTR )
     {
-        UART0_SendString("Driver Temperature: ");
-        UART0_SendInteger(u32ADC_DriverValue);
-        UART0_SendString("\r\n");
-        switch(ui8DriverSeatNextState)
+        /* Convert, publish the finished samples of every seat, and only then wake the heater task */
+        for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
         {
-            case MAKE_HEATER_OFF:          UART0_SendString("Driver -> Heater is Disabled\r\n");                break;
-            case MAKE_HEATER_LOW_LEVEL:    UART0_SendString("Driver -> Low Heating Mode\r\n");                  break;
-            case MAKE_HEATER_MEDIUM_LEVEL: UART0_SendString("Driver -> Medium Heating Mode\r\n");               break;
-            case MAKE_HEATER_HIGH_LEVEL:   UART0_SendString("Driver -> Maximum Heating Mode\r\n");              break;
-            default: break;
+            xSample.u16Raw = (uint16)prvAverageSensor(pu16Samples, u8Seat);
+            xSample.u32Temperature = Temperature_u32FromRaw(xSample.u16Raw);
+            xSample.u8Seat = u8Seat;
+            (void)Sample_bPublishFromISR(&xSample);
         }
-        switch(ui8DriverHeaterIntensity)
+#if CONTROL_QUEUE_SET
+        xSemaphoreGiveFromISR(xHeaterSemaphore, &xHigherPriorityTaskWoken);
+#else
+        vTaskNotifyGiveIndexedFromISR(xHeaterIntensityHandle, CONTROL_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+#endif
+    }
+    Trace_vIsrExit(ADC0_SEQ0_IRQ_NUMBER);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void GPIOPortF_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32 u32IsrStartCycles = GPTM_WTimer0Read32();
+    Trace_vIsrEnter(GPIOF_IRQ_NUMBER);
+    u32ButtonEdgeCycles = u32IsrStartCycles;
+    bButtonEdgePending = TRUE;
+
+    /* SW1 (PF4) or SW2 (PF0) edge: the debouncer samples the buttons from here on */
+    Debounce_vEdgeFromISR(&xHigherPriorityTaskWoken);
+
+    Trace_vIsrExit(GPIOF_IRQ_NUMBER);
+    prvButtonIsrMeasure(u32IsrStartCycles);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+void GPIOPortA_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32 u32IsrStartCycles = GPTM_WTimer0Read32();
+    Trace_vIsrEnter(GPIOA_IRQ_NUMBER);
+    u32ButtonEdgeCycles = u32IsrStartCycles;
+    bButtonEdgePending = TRUE;
+
+    /* External button (PA4) edge */
+    Debounce_vEdgeFromISR(&xHigherPriorityTaskWoken);
+
+    Trace_vIsrExit(GPIOA_IRQ_NUMBER);
+    prvButtonIsrMeasure(u32IsrStartCycles);
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/*
+ * Called by the debouncer (timer service task) once a press is confirmed:
+ * each seat has its level changed by its own buttons (see axSeats).
+ */
+static void prvButtonsPressed(uint8 u8PressedMask)
+{
+    uint32 u32BitsToSet = 0;
+    uint32 u32Latency = GPTM_WTimer0Read32() - u32ButtonEdgeCycles;
+    uint8 u8Seat;
+
+    for(u8Seat = 0; u8Seat < SEATS_NUM; u8Seat++)
+    {
+        if(u8PressedMask & axSeats[u8Seat].u8ButtonsMask)
         {
-            case LOW_INTENSITY:     UART0_SendString("Driver Heater Intensity is Low Intensity\r\n");           break;
-            case MEDIUM_INTENSITY:  UART0_SendString("Driver Heater Intensity is Medium Intensity\r\n");        break;
-            case HIGH_INTENSITY:    UART0_SendString("Driver Heater Intensity is High Intensity\r\n");          break;
-            case HEATER_DISABLED:   UART0_SendString("Driver Heater is Disabled\r\n");                          break;
-            default: break;
+            u32BitsToSet |= axSeats[u8Seat].u32ButtonBit;
+            if(bButtonEdgePending)
+            {
+                Latency_vRecord(LATENCY_PATH_BUTTON_CONFIRM, u8Seat, u32Latency);
+            }
+#if CONTROL_QUEUE_SET
+            prvControlPost(CONTROL_EVENT_BUTTON, u8Seat);
+#endif
         }
-        UART0_SendString("\r\n");
-        UART0_SendString("---------------------------------------------------------\r\n");
-        UART0_SendString("\r\n");
-        vTaskDelayUntil(&xLastWakeTime,xDelay1000ms);
-        UART0_SendString("Passenger Temperature: ");
-        UART0_SendInteger(u32ADC_PassengerValue);
-        UART0_SendString("\r\n");
-        switch(ui8PassengerSeatNextState)
+    }
+#if CONTROL_QUEUE_SET
+    (void)u32BitsToSet;
+#else
+    if(u32BitsToSet != 0)
+    {
+        (void)xTaskNotifyIndexed(xDesiredHeaterLevelHandle, CONTROL_NOTIFY_INDEX, u32BitsToSet, eSetBits);
+    }
+#endif
+}
+
+/* Tell the host which task number is which task, once per task */
+static void prvPostTaskName(const RunTime_Task *pxTask)
+{
+    Log_Message xLine;
+
+    Log_vStart(&xLine);
+    Log_vAppendString(&xLine, "Task ");
+    Log_vAppendUnsigned(&xLine, pxTask->uxNumber);
+    Log_vAppendString(&xLine, ": ");
+    Log_vAppendString(&xLine, pxTask->pcName);
+    Log_vAppendString(&xLine, "\r\n");
+    (void)Log_bPostWait(LOG_CHANNEL_RUNTIME, &xLine, portMAX_DELAY);
+}
+
+/* One latency report frame per control path that got samples since the last one */
+static void prvPostLatencies(void)
+{
+    Telemetry_Latency axReports[LATENCY_SEATS_NUM];
+    Latency_Summary xSummary;
+    Log_Message xFrame;
+    uint8 u8Path;
+    uint8 u8Seat;
+
+    for(u8Path = 0; u8Path < LATENCY_PATHS_NUM; u8Path++)
+    {
+        if(!Latency_bPathUpdated(u8Path))
         {
-            case MAKE_HEATER_OFF:          UART0_SendString("Passenger -> Heater is Disabled\r\n");                break;
-            case MAKE_HEATER_LOW_LEVEL:    UART0_SendString("Passenger -> Low Heating Mode\r\n");                  break;
-            case MAKE_HEATER_MEDIUM_LEVEL: UART0_SendString("Passenger -> Medium Heating Mode\r\n");               break;
-            case MAKE_HEATER_HIGH_LEVEL:   UART0_SendString("Passenger -> Maximum Heating Mode\r\n");              break;
-            default: break;
+            continue;
         }
-        switch(ui8PassengerHeaterIntensity)
+        for(u8Seat = 0; u8Seat < LATENCY_SEATS_NUM; u8Seat++)
         {
-            case LOW_INTENSITY:     UART0_SendString("Passenger Heater Intensity is Low Intensity\r\n");           break;
-            case MEDIUM_INTENSITY:  UART0_SendString("Passenger Heater Intensity is Medium Intensity\r\n");        break;
-            case HIGH_INTENSITY:    UART0_SendString("Passenger Heater Intensity is High Intensity\r\n");          break;
-            case HEATER_DISABLED:   UART0_SendString("Passenger Heater is Disabled\r\n");                          break;
-            default: break;
+            if(!Latency_bSummary(u8Path, u8Seat, &xSummary))
+            {
+                xSummary.u32Samples = 0;
+                xSummary.u32Min = 0;
+                xSummary.u32P99 = 0;
+                xSummary.u32Max = 0;
+            }
+            axReports[u8Seat].u32Samples = xSummary.u32Samples;
+            axReports[u8Seat].u32Min = xSummary.u32Min;
+            axReports[u8Seat].u32P99 = xSummary.u32P99;
+            axReports[u8Seat].u32Max = xSummary.u32Max;
         }
-        UART0_SendString("\r\n");
-        UART0_SendString("---------------------------------------------------------\r\n");
-        UART0_SendString("\r\n");
-        vTaskDelayUntil(&xLastWakeTime,xDelay1000ms);
+        xFrame.u16Length = Telemetry_u16BuildLatencyFrame(u8Path, axReports, LATENCY_SEATS_NUM, xFrame.au8Data);
+        Log_bPost(LOG_CHANNEL_RUNTIME, &xFrame);
     }
 }
 
+/* One report of the scheduling statistics of every periodic task */
+static void prvPostPeriodic(void)
+{
+    Telemetry_Periodic axTasks[PERIODIC_TASKS_MAX];
+    const Periodic_Task *pxTask;
+    Periodic_Stats xStats;
+    TaskStatus_t xStatus;
+    Log_Message xFrame;
+    uint8 u8Task;
+
+    for(u8Task = 0; u8Task < Periodic_u8Tasks(); u8Task++)
+    {
+        pxTask = Periodic_pxTask(u8Task);
+        Periodic_vStats(u8Task, &xStats);
+        vTaskGetInfo(pxTask->xHandle, &xStatus, pdFALSE, eRunning);
+        axTasks[u8Task].u8Task = (uint8)xStatus.xTaskNumber;
+        axTasks[u8Task].u8Priority = (uint8)pxTask->uxPriority;
+        axTasks[u8Task].u16PeriodMs = (uint16)pxTask->u32PeriodMs;
+        axTasks[u8Task].u16DeadlineMs = (uint16)((pxTask->u32DeadlineMs != 0) ? pxTask->u32DeadlineMs : pxTask->u32PeriodMs);
+        axTasks[u8Task].u32Jobs = xStats.u32Jobs;
+        axTasks[u8Task].u32DeadlineMisses = xStats.u32DeadlineMisses;
+        axTasks[u8Task].u32Overruns = xStats.u32Overruns;
+        axTasks[u8Task].u32MaxJitter = xStats.u32MaxJitter;
+        axTasks[u8Task].u32MaxResponse = xStats.u32MaxResponse;
+    }
+    xFrame.u16Length = Telemetry_u16BuildPeriodicFrame(axTasks, Periodic_u8Tasks(), xFrame.au8Data);
+    Log_bPost(LOG_CHANNEL_RUNTIME, &xFrame);
+}
 
-/*
- * (Event Based Task)
- * When error occurs in Driver Temperature sensor this task should run
- * to save the state & time at which last failure occurs
- */
-
-void vDriverTemperatureSensorFailureTask(void *pvParameters)
+/* Next desired level of a seat, on a press of one of its buttons */
+static void prvSeatLevel(uint8 u8Seat)
 {
-    const EventBits_t xBitsToWaitFor = (DRIVER_SENSOR_FAILURE_BIT_MASK);
-    EventBits_t xEventGroupValue;
-    for(;;)
+    Seat_State *pxState = &axSeatStates[u8Seat];
+
+    switch(pxState->u8NextLevel)
     {
-        xEventGroupValue = xEventGroupWaitBits(xButtonsEventGroups, xBitsToWaitFor, pdTRUE, pdFALSE, portMAX_DELAY);
+    case MAKE_HEATER_OFF:           pxState->u8NextLevel = MAKE_HEATER_LOW_LEVEL;    break;
+    case MAKE_HEATER_LOW_LEVEL:     pxState->u8NextLevel = MAKE_HEATER_MEDIUM_LEVEL; break;
+    case MAKE_HEATER_MEDIUM_LEVEL:  pxState->u8NextLevel = MAKE_HEATER_HIGH_LEVEL;   break;
+    case MAKE_HEATER_HIGH_LEVEL:    pxState->u8NextLevel = MAKE_HEATER_OFF;          break;
+    default: break;
+    }
 
-        if(xEventGroupValue & DRIVER_SENSOR_FAILURE_BIT_MASK)
-        {
-            ui32DriverFailureTime = ui32DriverTimeSample;
-            ui8DriverStateBeforeFailure = ui8DriverSeatCurrentState;
-        }
+    LOG_DEFER2(LOG_FMT_SEAT_LEVEL, u8Seat, pxState->u8NextLevel);
+
+    if(bButtonEdgePending)
+    {
+        Latency_vRecord(LATENCY_PATH_BUTTON_LEVEL, u8Seat, GPTM_WTimer0Read32() - u32ButtonEdgeCycles);
+    }
+}
+
+/* Heater of the seats on every sample published since the last wake, in order */
+static void prvSeatsHeater(void)
+{
+    Sample_Record xSample;
+
+    while(Sample_bConsume(&xSample))
+    {
+        prvSeatHeater(&xSample);
     }
 }
 
 /*
- * (Event Based Task)
- * When error occurs in Passenger Temperature sensor this task should run
- * to save the state & time at which last failure occurs
+ * Heater of a seat on a sensor capture: drive its output from its temperature
+ * and its level. A failure of its sensor keeps the level and the time of the
+ * last sample taken without one, as the state before the failure.
  */
-void vPassengerTemperatureSensorFailureTask(void *pvParameters)
+static void prvSeatHeater(const Sample_Record *pxSample)
 {
-    const EventBits_t xBitsToWaitFor = (PASSENGER_SENSOR_FAILURE_BIT_MASK);
-    EventBits_t xEventGroupValue;
-    for(;;)
-    {
-        xEventGroupValue = xEventGroupWaitBits(xButtonsEventGroups, xBitsToWaitFor, pdTRUE, pdFALSE, portMAX_DELAY);
+    uint8 u8Seat = pxSample->u8Seat;
+    Seat_State *pxState = &axSeatStates[u8Seat];
+    uint32 u32Temperature = pxSample->u32Temperature;
 
-        if(xEventGroupValue & PASSENGER_SENSOR_FAILURE_BIT_MASK)
-        {
-            ui32PassengerFailureTime = ui32PassengerTimeSample;
-            ui8PassengerStateBeforeFailure = ui8PassengerSeatCurrentState;
-        }
+    /* The age of the sample is the time since its capture */
+    uint32 u32AgeCycles = GPTM_WTimer0Read32() - pxSample->u32Timestamp;
+
+    pxState->u32Temperature = u32Temperature;
+    if(pxState->u8TuneRequest != SEAT_TUNE_NONE)
+    {
+        prvSeatTuneRequest(u8Seat);
+    }
+    if((pxState->u8NextLevel == MAKE_HEATER_OFF) && (pxState->u8CurrentLevel == MAKE_HEATER_OFF) &&
+       (pxState->xTune.u8State != TUNE_STATE_RELAY))
+    {
+        return;
     }
-}
 
+    Latency_vRecord(LATENCY_PATH_SENSOR_WAKE, u8Seat, u32AgeCycles);
+    vHeater_Action(u8Seat, u32Temperature);
+    Latency_vRecord(LATENCY_PATH_SENSOR_HEATER, u8Seat, GPTM_WTimer0Read32() - pxSample->u32Timestamp);
 
-/*************************************************/
+    if(pxState->u8NextLevel == MAKE_HEATER_OFF)
+    {
+        /* Heater disabled, the seat is left alone until its level is raised */
+        pxState->u8CurrentLevel = MAKE_HEATER_OFF;
+    }
+    else if(!pxState->u8FailureFlag)
+    {
+        pxState->u8CurrentLevel = pxState->u8NextLevel;
+        pxState->u64TimeSample = GPTM_WTimer0ReadUs();
+    }
+    else
+    {
+#if CONTROL_QUEUE_SET
+        /* Handled once the heater of every seat has run on this capture */
+        prvControlPost(CONTROL_EVENT_FAILURE, u8Seat);
+#else
+        prvSeatFailure(u8Seat);
+#endif
+    }
+}
 
-void ADC0Seq3_Handler(void)
+/* Save the state & time at which the last failure of a seat sensor occurred */
+static void prvSeatFailure(uint8 u8Seat)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    SET_BIT(ADC0_ISC,3);
-    ADC0_vRead(&u32ADC_DriverValue);
-    xSemaphoreGiveFromISR(xDriverHeaterSemaphore, &xHigherPriorityTaskWoken);
-    u32ADC_DriverValue *= 45.0/4095;
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    Seat_State *pxState = &axSeatStates[u8Seat];
+
+    pxState->u64FailureTime = pxState->u64TimeSample;
+    pxState->u8LevelBeforeFailure = pxState->u8CurrentLevel;
+    LOG_DEFER3(LOG_FMT_SEAT_FAILURE, u8Seat, pxState->u8LevelBeforeFailure, (uint32)(pxState->u64FailureTime / 1000));
 }
-void ADC1Seq3_Handler(void)
+
+/* Start or stop the tuning of a seat, as the console asked, on its next sample */
+static void prvSeatTuneRequest(uint8 u8Seat)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    SET_BIT(ADC1_ISC,3);
-    ADC1_vRead(&u32ADC_PassengerValue);
-    xSemaphoreGiveFromISR(xPassengerHeaterSemaphore, &xHigherPriorityTaskWoken);
-    u32ADC_PassengerValue *= 45.0/4095;
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    Seat_State *pxState = &axSeatStates[u8Seat];
+    uint8 u8Request;
+    uint8 u8Level;
+
+    taskENTER_CRITICAL();
+    u8Request = pxState->u8TuneRequest;
+    pxState->u8TuneRequest = SEAT_TUNE_NONE;
+    taskEXIT_CRITICAL();
+
+    if(u8Request == SEAT_TUNE_START)
+    {
+        u8Level = (pxState->u8NextLevel != MAKE_HEATER_OFF) ? pxState->u8NextLevel : MAKE_HEATER_TUNE_LEVEL;
+        Tune_vStart(&pxState->xTune, (sint32)u8Level * TEMPERATURE_SCALE, ADC_SAMPLE_PERIOD_MS);
+        LOG_DEFER2(LOG_FMT_TUNE_START, u8Seat, u8Level);
+    }
+    else if((u8Request == SEAT_TUNE_ABORT) && (pxState->xTune.u8State == TUNE_STATE_RELAY))
+    {
+        Tune_vAbort(&pxState->xTune);
+        prvSeatTuned(u8Seat);
+    }
 }
 
-void GPIOPortF_Handler(void)
+/* End of the tuning of a seat: its loop closes again, on the gains found if any */
+static void prvSeatTuned(uint8 u8Seat)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    // Simple debounce delay
-    Delay_MS(300);
+    Seat_State *pxState = &axSeatStates[u8Seat];
+    const Tune_Relay *pxTune = &pxState->xTune;
 
-    if(GPIO_PORTF_RIS_REG & (1<<4))
+    if(pxTune->u8State == TUNE_STATE_DONE)
     {
-
-        xEventGroupSetBitsFromISR(xButtonsEventGroups, DRIVER_BUTTON_BIT_MASK,xHigherPriorityTaskWoken);
-        /* Clear Trigger flag for PF4 (Interrupt Flag) */
-        GPIO_PORTF_ICR_REG   |= (1<<4);
+        Pid_vSetGains(&pxState->xPid, &pxTune->xGains);
+        pxState->bGainsTuned = TRUE;
+        pxState->bGainsToStore = TRUE;
+        LOG_DEFER3(LOG_FMT_TUNE_DONE, u8Seat, pxTune->s32UltimateGain, pxTune->u32UltimatePeriodMs);
     }
-    if(GPIO_PORTF_RIS_REG & (1<<0))
+    else
     {
-        xEventGroupSetBitsFromISR(xButtonsEventGroups, PASSENGER_BUTTON_BIT_MASK,xHigherPriorityTaskWoken);
-        /* Clear Trigger flag for PF0 (Interrupt Flag) */
-        GPIO_PORTF_ICR_REG   |= (1<<0);
+        LOG_DEFER2(LOG_FMT_TUNE_FAILED, u8Seat, pxTune->u8Error);
     }
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    Pid_vReset(&pxState->xPid);
 }
-void GPIOPortA_Handler(void)
+
+/*
+ * A command line of the console (see MAKE_HEATER_TUNE_LEVEL), from the console
+ * task. The tuning requests are taken by the heater task on the next sample.
+ */
+static void prvConsoleLine(uint8 u8Words, const char *const apcWords[])
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    // Simple debounce delay
-    Delay_MS(300);
+    uint32 u32Seat = 0;
+    uint8 u8First = 0;
+    uint8 u8Last = SEATS_NUM - 1;
+    uint8 u8Seat;
 
-    if(GPIO_PORTA_RIS_REG & (1<<4))
+    if(u8Words > 1)
     {
+        if((u8Words > 2) || !Console_bNumber(apcWords[1], &u32Seat) || (u32Seat >= SEATS_NUM))
+        {
+            LOG_DEFER0(LOG_FMT_CONSOLE_UNKNOWN);
+            return;
+        }
+        u8First = (uint8)u32Seat;
+        u8Last = (uint8)u32Seat;
+    }
 
-        xEventGroupSetBitsFromISR(xButtonsEventGroups, DRIVER_BUTTON_BIT_MASK,xHigherPriorityTaskWoken);
-        /* Clear Trigger flag for PF4 (Interrupt Flag) */
-        GPIO_PORTA_ICR_REG   |= (1<<4);
+    for(u8Seat = u8First; u8Seat <= u8Last; u8Seat++)
+    {
+        if(Console_bIs(apcWords[0], "tune"))
+        {
+            axSeatStates[u8Seat].u8TuneRequest = SEAT_TUNE_START;
+        }
+        else if(Console_bIs(apcWords[0], "abort"))
+        {
+            axSeatStates[u8Seat].u8TuneRequest = SEAT_TUNE_ABORT;
+        }
+        else if(Console_bIs(apcWords[0], "gains"))
+        {
+            prvPostGains(u8Seat);
+        }
+        else if(Console_bIs(apcWords[0], "trace") && (u8Words == 1))
+        {
+            bTraceArmed = TRUE;
+            return;
+        }
+        else
+        {
+            LOG_DEFER0(LOG_FMT_CONSOLE_UNKNOWN);
+            return;
+        }
     }
+}
 
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+/* Report the gains a seat runs on, Q16 as in pid.h */
+static void prvPostGains(uint8 u8Seat)
+{
+    const Seat_State *pxState = &axSeatStates[u8Seat];
+    Log_Message xLine;
+
+    Log_vStart(&xLine);
+    Log_vAppendString(&xLine, "Seat ");
+    Log_vAppendUnsigned(&xLine, u8Seat);
+    Log_vAppendString(&xLine, " gains Kp ");
+    Log_vAppendUnsigned(&xLine, (uint32)pxState->xPid.xGains.s32Kp);
+    Log_vAppendString(&xLine, " Ki ");
+    Log_vAppendUnsigned(&xLine, (uint32)pxState->xPid.xGains.s32Ki);
+    Log_vAppendString(&xLine, " Kd ");
+    Log_vAppendUnsigned(&xLine, (uint32)pxState->xPid.xGains.s32Kd);
+    Log_vAppendString(&xLine, pxState->bGainsTuned ? "/65536, tuned\r\n" : "/65536, heater.h\r\n");
+    (void)Log_bPostWait(LOG_CHANNEL_CONSOLE, &xLine, portMAX_DELAY);
 }
-void ADC0Seq1_Handler(void)
+
+/* A press has been handled: stop the kernel trace on it if the console asked for it */
+static void prvTracePress(void)
 {
+    if(bTraceArmed)
+    {
+        bTraceArmed = FALSE;
+        Trace_vTrigger();
+    }
+}
 
+#if CONTROL_QUEUE_SET
+/* Queue an event for the control task, dropped when the queue is full: the
+ * next press or capture posts it again */
+static void prvControlPost(uint8 u8Type, uint8 u8Seat)
+{
+    Control_Event xEvent;
+
+    xEvent.u8Type = u8Type;
+    xEvent.u8Seat = u8Seat;
+    (void)xQueueSend(xControlEventQueue, &xEvent, 0);
 }
-void ADC1Seq1_Handler(void)
+#endif
+
+static void prvFillTelemetrySeat(Telemetry_Seat *pxReport, uint8 u8Seat)
 {
+    const Seat_State *pxState = &axSeatStates[u8Seat];
 
+    pxReport->u16Temperature = (uint16)pxState->u32Temperature;
+    pxReport->u8Level = pxState->u8NextLevel;
+    pxReport->u8Intensity = pxState->u8Intensity;
+    pxReport->u8Flags = (pxState->u8FailureFlag != 0) ? TELEMETRY_FLAG_SENSOR_FAILURE : 0;
 }
 
-/*
- * This function responsible for changing the intensity ( colors of the LED )
- *
- * (Temp_diff) ===> parameter refers to (Desired Temp. - Temp. Sensor value)
- *
- * returns void
- */
+/* Rounded mean of one sensor over a captured sampling period */
+static uint32 prvAverageSensor(const uint16 *pu16Samples, uint8 u8Sensor)
+{
+    uint32 u32Sum = 0;
+    uint8 u8Sample;
 
-void vHeater_Action(uint8_t Temp_diff,uint8_t *Intensity_ReturnState,
-                    uint8 Seat_CurrentState,uint32_t UserTemperature,uint8 *TempSensorFailure_Flag)
+    for(u8Sample = 0; u8Sample < ADC_OVERSAMPLING; u8Sample++)
+    {
+        u32Sum += pu16Samples[(u8Sample * SEATS_NUM) + u8Sensor];
+    }
+    return (u32Sum + (ADC_OVERSAMPLING / 2)) / ADC_OVERSAMPLING;
+}
+
+static void prvButtonIsrMeasure(uint32 u32IsrStartCycles)
 {
-    if((Seat_CurrentState == MAKE_HEATER_OFF))
+    u32ButtonIsrCycles = GPTM_WTimer0Read32() - u32IsrStartCycles;
+    if(u32ButtonIsrCycles > u32ButtonIsrMaxCycles)
     {
-        GPIO_RedLedOff();
-        GPIO_BlueLedOff();
-        GPIO_GreenLedOff();
-        *Intensity_ReturnState = HEATER_DISABLED;
+        u32ButtonIsrMaxCycles = u32ButtonIsrCycles;
     }
-    else
+}
+
+/* Drive a heater output with the intensity of its seat, or show the sensor failure */
+static void prvHeaterOutput(uint8 u8Output, uint8 u8Intensity, uint8 u8FailureFlag)
+{
+    switch(u8Output)
     {
-        if((UserTemperature > MAXIMUM_TEMP_ACCEPTED) || (UserTemperature < MINIMUM_TEMP_ACCEPTED))
+    case HEATER_OUTPUT_RGB_LED:
+        /* Red: sensor failure, cyan: high, blue: medium, green: low intensity */
+        if(u8FailureFlag)
         {
-            GPIO_GreenLedOff();
-            GPIO_BlueLedOff();
             GPIO_RedLedOn();
-            *TempSensorFailure_Flag = 1;
-            *Intensity_ReturnState = HEATER_DISABLED;
         }
-        else if((UserTemperature > Seat_CurrentState))
+        else
         {
-            *TempSensorFailure_Flag = 0;
             GPIO_RedLedOff();
+        }
+        if((u8Intensity == HIGH_INTENSITY) || (u8Intensity == MEDIUM_INTENSITY))
+        {
+            GPIO_BlueLedOn();
+        }
+        else
+        {
             GPIO_BlueLedOff();
+        }
+        if((u8Intensity == HIGH_INTENSITY) || (u8Intensity == LOW_INTENSITY))
+        {
+            GPIO_GreenLedOn();
+        }
+        else
+        {
             GPIO_GreenLedOff();
-            *Intensity_ReturnState = HEATER_DISABLED;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * This function responsible for driving the heater of a seat and its intensity
+ * ( colors of the LED ) on a temperature sample
+ *
+ * (UserTemperature) ===> Temp. Sensor value in 0.01 degC (TEMPERATURE_SCALE)
+ *
+ * The heater is disabled, and the PI loop of the seat opened, while the desired
+ * level is MAKE_HEATER_OFF or the sensor reads out of range (failure). The loop
+ * is then closed again from a zero integral.
+ *
+ * While the seat is tuned, whatever its level, the relay of the tuner drives
+ * the heater instead of the loop; a sensor failure ends the tuning.
+ *
+ * returns void
+ */
+
+void vHeater_Action(uint8 u8Seat, uint32 UserTemperature)
+{
+    Seat_State *pxState = &axSeatStates[u8Seat];
+    uint16 u16Duty = 0;
+    boolean bInRange = ((UserTemperature <= (MAXIMUM_TEMP_ACCEPTED * TEMPERATURE_SCALE)) &&
+                        (UserTemperature >= (MINIMUM_TEMP_ACCEPTED * TEMPERATURE_SCALE))) ? TRUE : FALSE;
+
+    pxState->u8FailureFlag = 0;
+    if(pxState->xTune.u8State == TUNE_STATE_RELAY)
+    {
+        if(bInRange)
+        {
+            u16Duty = Tune_u16Update(&pxState->xTune, (sint32)UserTemperature);
         }
         else
         {
-            *TempSensorFailure_Flag = 0;
-            if(Temp_diff >= HEATER_HIGH_INTENSITY_LIMIT)
-            {
-                GPIO_RedLedOff();
-                GPIO_GreenLedOn();
-                GPIO_BlueLedOn();
-                *Intensity_ReturnState = HIGH_INTENSITY;
-            }
-            else if( (Temp_diff >= HEATER_MEDIUM_INTENSITY_LOW_LIMIT) && (Temp_diff < HEATER_MEDIUM_INTENSITY_HIGH_LIMIT) )
-            {
-                GPIO_RedLedOff();
-                GPIO_GreenLedOff();
-                GPIO_BlueLedOn();
-                *Intensity_ReturnState = MEDIUM_INTENSITY;
-            }
-            else if( (Temp_diff >= HEATER_LOW_INTENSITY_LOW_LIMIT) && (Temp_diff < HEATER_LOW_INTENSITY_HIGH_LIMIT) )
-            {
-                GPIO_RedLedOff();
-                GPIO_BlueLedOff();
-                GPIO_GreenLedOn();
-                *Intensity_ReturnState = LOW_INTENSITY;
-            }
+            pxState->u8FailureFlag = 1;
+            Tune_vAbort(&pxState->xTune);
         }
+        if(pxState->xTune.u8State != TUNE_STATE_RELAY)
+        {
+            prvSeatTuned(u8Seat);
+        }
+    }
+    else if(pxState->u8NextLevel == MAKE_HEATER_OFF)
+    {
+        Pid_vReset(&pxState->xPid);
+    }
+    else if(!bInRange)
+    {
+        pxState->u8FailureFlag = 1;
+        Pid_vReset(&pxState->xPid);
+    }
+    else
+    {
+        u16Duty = (uint16)Pid_s32Update(&pxState->xPid, (sint32)pxState->u8NextLevel * TEMPERATURE_SCALE, (sint32)UserTemperature);
+    }
+
+    if(u16Duty == 0)
+    {
+        pxState->u8Intensity = HEATER_DISABLED;
+    }
+    else if(u16Duty <= HEATER_LOW_INTENSITY_MAX_DUTY)
+    {
+        pxState->u8Intensity = LOW_INTENSITY;
+    }
+    else if(u16Duty <= HEATER_MEDIUM_INTENSITY_MAX_DUTY)
+    {
+        pxState->u8Intensity = MEDIUM_INTENSITY;
+    }
+    else
+    {
+        pxState->u8Intensity = HIGH_INTENSITY;
     }
 
+    pxState->u16Duty = u16Duty;
+    Heater_vSetDuty(axSeats[u8Seat].u8Heater, u16Duty);
+    prvHeaterOutput(axSeats[u8Seat].u8Output, pxState->u8Intensity, pxState->u8FailureFlag);
 }